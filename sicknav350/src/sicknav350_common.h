@@ -0,0 +1,305 @@
+/*
+ * sicknav350_common.h
+ *
+ * Pieces shared by sicknav350_node and the sicknav350 nodelet.
+ *
+ * Released under BSD license.
+ */
+
+#ifndef SICKNAV350_COMMON_H
+#define SICKNAV350_COMMON_H
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <sicktoolbox/SickNAV350.hh>
+#include "ros/ros.h"
+#include <nav_msgs/Odometry.h>
+#include <diagnostic_updater/diagnostic_updater.h>
+#include <boost/thread.hpp>
+
+using namespace SickToolbox;
+
+// latest robot velocity from the odometry callback; injected into the NAV350 between telegrams
+class NavVelocity
+{
+public:
+  NavVelocity() : vx_(0), vy_(0), vth_(0) {}
+
+  void Set(const nav_msgs::Odometry &msg)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    vx_ = msg.twist.twist.linear.x;
+    vy_ = msg.twist.twist.linear.y;
+    vth_ = msg.twist.twist.angular.z;
+  }
+
+  void Get(double &vx, double &vy, double &vth)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    vx = vx_;
+    vy = vy_;
+    vth = vth_;
+  }
+
+private:
+  boost::mutex mutex_;
+  double vx_, vy_, vth_;
+};
+
+// converts a NAV350 pose (mm, mdeg) to the pose published as odometry (m, rad)
+inline void NavPoseToLaserPose(const sick_nav350_pose_tag &pose, double &x, double &y, double &phi)
+{
+  phi = (double)pose.phi - 180000 - 1250 - 300;
+  phi = phi/1000*3.14159/180;
+  x = ((double)pose.x - /*300*/529*cos(phi))/1000;
+  y = ((double)pose.y - /*300*/529*sin(phi))/1000;
+}
+
+#define NAV_CLOCK_NOMINAL_PERIOD 0.125 // s, one rotation at 8 Hz
+#define NAV_CLOCK_RESET_THRESHOLD 1.0 // s; a bigger jump means the device or host clock was reset
+#define NAV_CLOCK_LEAK 0.01 // per telegram; lets the offset rise again when the device clock runs slow
+#define NAV_CLOCK_DRIFT_WINDOW 10.0 // s of device time per drift estimate
+#define NAV_CLOCK_DRIFT_GAIN 0.5
+#define NAV_CLOCK_PERIOD_GAIN 0.1
+
+// maps a NAV350's millisecond clock onto ROS time. Transport and scheduling delays only ever
+// make a telegram arrive later, so the offset tracks the lower envelope of (receive time -
+// device time); a slow leak plus a drift estimate over NAV_CLOCK_DRIFT_WINDOW follow a device
+// clock that runs fast or slow. The rotation period is measured from the same timestamps.
+class NavClockSync
+{
+public:
+  NavClockSync() { Reset(); }
+
+  void Reset()
+  {
+    initialized_ = false;
+    offset_ = skew_ = 0;
+    scan_period_ = NAV_CLOCK_NOMINAL_PERIOD;
+  }
+
+  // feeds one scan: device_ms is when it started and scan_fraction the part of a rotation it
+  // covers (it cannot have been sent before that). Returns the ROS time of device_ms.
+  ros::Time Update(unsigned int device_ms, double scan_fraction, const ros::Time &receive_time)
+  {
+    const int delta_ms = (int)(device_ms - last_ms_); // wraps with the device's 32-bit clock
+    if (!initialized_ || delta_ms < -NAV_CLOCK_RESET_THRESHOLD*1000) {
+      Restart(device_ms, receive_time.toSec() - scan_fraction*scan_period_);
+      return ros::Time(device_s_ + offset_);
+    }
+
+    // rotation period from consecutive scans (a request may have skipped some)
+    if (delta_ms > 0) {
+      const double dt = delta_ms*1e-3;
+      const double rotations = std::max(1.0, floor(dt/scan_period_ + 0.5));
+      scan_period_ += NAV_CLOCK_PERIOD_GAIN*(dt/rotations - scan_period_);
+    }
+
+    last_ms_ = device_ms;
+    device_s_ += delta_ms*1e-3;
+    const double measured = receive_time.toSec() - scan_fraction*scan_period_ - device_s_;
+    const double predicted = offset_ + skew_*(device_s_ - ref_s_);
+    if (fabs(measured - predicted) > NAV_CLOCK_RESET_THRESHOLD) {
+      Restart(device_ms, receive_time.toSec() - scan_fraction*scan_period_);
+      return ros::Time(device_s_ + offset_);
+    }
+    offset_ = measured < predicted ? measured : predicted + NAV_CLOCK_LEAK*(measured - predicted);
+    ref_s_ = device_s_;
+
+    if (device_s_ - window_s_ >= NAV_CLOCK_DRIFT_WINDOW) {
+      skew_ += NAV_CLOCK_DRIFT_GAIN*((offset_ - window_offset_)/(device_s_ - window_s_) - skew_);
+      window_s_ = device_s_;
+      window_offset_ = offset_;
+    }
+    return ros::Time(device_s_ + offset_);
+  }
+
+  // converts another timestamp of the last scan's telegram (e.g. the pose's)
+  ros::Time ToRosTime(unsigned int device_ms) const
+  {
+    return ros::Time(device_s_ + (int)(device_ms - last_ms_)*1e-3 + offset_);
+  }
+
+  // measured time of one rotation (s)
+  double ScanPeriod() const { return scan_period_; }
+
+private:
+  void Restart(unsigned int device_ms, double sent_time)
+  {
+    initialized_ = true;
+    last_ms_ = device_ms;
+    device_s_ = ref_s_ = window_s_ = 0;
+    offset_ = window_offset_ = sent_time;
+    skew_ = 0;
+  }
+
+  bool initialized_;
+  unsigned int last_ms_;
+  double device_s_; // device time since the last restart, unwrapped
+  double offset_, skew_, ref_s_;
+  double window_s_, window_offset_;
+  double scan_period_;
+};
+
+// one navigation telegram, copied out of the driver by the acquisition thread. Only the ranges
+// the device sent are copied, and the queue hands range buffers on instead of copying them.
+struct NavFrame
+{
+  NavFrame() : sensor(0), angle_start(0), angle_step(0), timestamp_start(0), timestamp_stop(0) {}
+
+  // copies a leased sector (the lease can be released afterwards)
+  void SetSector(const SickScanView<uint32_t> &sector)
+  {
+    angle_start = sector.angle_start;
+    angle_step = sector.angle_step;
+    timestamp_start = sector.timestamp_start;
+    timestamp_stop = sector.timestamp_stop;
+    range_values.assign(sector.range_values, sector.range_values + sector.Size());
+  }
+
+  // the ranges as the driver lends them out; valid while the frame is unchanged
+  SickScanView<uint32_t> Sector() const
+  {
+    return SickScanView<uint32_t>(range_values.empty() ? NULL : &range_values[0], NULL, range_values.size(), 1.0,
+                                  angle_start, angle_step, timestamp_start, timestamp_stop);
+  }
+
+  // takes other's contents; other is left with this frame's range buffer to refill
+  void Take(NavFrame &other)
+  {
+    sensor = other.sensor;
+    receive_time = other.receive_time;
+    pose = other.pose;
+    angle_start = other.angle_start;
+    angle_step = other.angle_step;
+    timestamp_start = other.timestamp_start;
+    timestamp_stop = other.timestamp_stop;
+    range_values.swap(other.range_values);
+    reflectors = other.reflectors;
+  }
+
+  unsigned int sensor; // index of the sensor it came from
+  ros::Time receive_time; // when the telegram had been parsed
+  sick_nav350_pose_tag pose;
+  double angle_start, angle_step; // deg
+  unsigned int timestamp_start, timestamp_stop; // ms, device clock
+  std::vector<uint32_t> range_values; // mm, one per beam
+  sick_nav350_reflector_tag reflectors;
+};
+
+// bounded hand-off from the acquisition thread to the publish stage; when the publisher
+// falls behind the oldest frame is dropped so the newest pose always gets through
+class NavFrameQueue
+{
+public:
+  NavFrameQueue(size_t capacity) : frames_(std::max(capacity, (size_t)1)), head_(0), size_(0), closed_(false) {}
+
+  // moves frame in (frame gets a spare range buffer back); returns false if a frame had to
+  // be dropped to make room
+  bool Push(NavFrame &frame)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    bool dropped = false;
+    if (size_ == frames_.size()) {
+      head_ = (head_ + 1) % frames_.size();
+      size_--;
+      dropped = true;
+    }
+    frames_[(head_ + size_) % frames_.size()].Take(frame);
+    size_++;
+    not_empty_.notify_one();
+    return !dropped;
+  }
+
+  // waits up to timeout seconds; returns false if nothing arrived (or the queue was closed)
+  bool Pop(NavFrame &frame, double timeout)
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    const boost::system_time deadline = boost::get_system_time() + boost::posix_time::microseconds((long)(timeout*1e6));
+    while (size_ == 0 && !closed_) {
+      if (!not_empty_.timed_wait(lock, deadline))
+        return false;
+    }
+    if (size_ == 0)
+      return false;
+    frame.Take(frames_[head_]);
+    head_ = (head_ + 1) % frames_.size();
+    size_--;
+    return true;
+  }
+
+  void Close()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+  bool Closed()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return closed_;
+  }
+
+private:
+  std::vector<NavFrame> frames_;
+  size_t head_, size_;
+  bool closed_;
+  boost::mutex mutex_;
+  boost::condition_variable not_empty_;
+};
+
+// reports the driver's health counters; warns when drops, bad checksums, timeouts or
+// acquisition errors show up
+class DriverHealthTask
+{
+public:
+  DriverHealthTask(const SickNav350 &sick_nav350) : sick_nav350_(sick_nav350), acquisition_errors_(0), last_acquisition_errors_(0)
+  {
+    memset(&last_, 0, sizeof(last_));
+  }
+
+  // a request or reply failed and acquisition started over (safe from any thread)
+  void AcquisitionError() { __sync_fetch_and_add(&acquisition_errors_, 1); }
+
+  void run(diagnostic_updater::DiagnosticStatusWrapper &stat)
+  {
+    sick_health_counters_t counters;
+    sick_nav350_.GetHealthCounters(counters);
+    const uint64_t acquisition_errors = __sync_fetch_and_add(&acquisition_errors_, 0);
+
+    if (counters.frames_received == last_.frames_received)
+      stat.summary(diagnostic_msgs::DiagnosticStatus::ERROR, "No frames received since the last update");
+    else if (counters.frames_dropped > last_.frames_dropped ||
+             counters.checksum_failures > last_.checksum_failures ||
+             counters.frame_timeouts > last_.frame_timeouts ||
+             counters.reply_timeouts > last_.reply_timeouts ||
+             acquisition_errors > last_acquisition_errors_)
+      stat.summary(diagnostic_msgs::DiagnosticStatus::WARN, "Frames lost since the last update");
+    else
+      stat.summary(diagnostic_msgs::DiagnosticStatus::OK, "OK");
+
+    stat.add("Frames received", counters.frames_received);
+    stat.add("Frames dropped", counters.frames_dropped);
+    stat.add("Checksum failures", counters.checksum_failures);
+    stat.add("Resyncs", counters.resyncs);
+    stat.add("Frame timeouts", counters.frame_timeouts);
+    stat.add("Reply timeouts", counters.reply_timeouts);
+    stat.add("Bytes read", counters.bytes_read);
+    stat.add("Queue high water", counters.queue_high_water);
+    stat.add("Reconnects", counters.reconnects);
+    stat.add("Acquisition errors", acquisition_errors);
+    last_ = counters;
+    last_acquisition_errors_ = acquisition_errors;
+  }
+
+private:
+  const SickNav350 &sick_nav350_;
+  sick_health_counters_t last_;
+  uint64_t acquisition_errors_;
+  uint64_t last_acquisition_errors_;
+};
+
+#endif /* SICKNAV350_COMMON_H */
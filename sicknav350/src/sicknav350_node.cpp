@@ -12,13 +12,25 @@
 
 #include <iostream>
 #include <sicktoolbox/SickNAV350.hh>
+#include <sicktoolbox/SickScanFilter.hh>
+#include <sicktoolbox/SickScanConverter.hh>
+#include <sicktoolbox/SickScanArchive.hh>
 #include "ros/ros.h"
 #include "sensor_msgs/LaserScan.h"
+#include "sensor_msgs/PointCloud2.h"
+#include <limits>
 #include <deque>
+#include <cmath>
+#include <algorithm>
 #include <tf/transform_broadcaster.h>
 #include <nav_msgs/Odometry.h>
+#include <ros/callback_queue.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include "sicknav350_common.h"
 
 #define DEG2RAD M_PI/180.0
+#define NAV_RETRY_DELAY 1.0 // s before a sensor whose request or reply failed is asked again
 
 using namespace std;
 using namespace SickToolbox;
@@ -26,9 +38,10 @@ using namespace SickToolbox;
 void publish_scan(ros::Publisher *pub, double *range_values,
                   uint32_t n_range_values, unsigned int *intensity_values,
                    uint32_t n_intensity_values, ros::Time start,
-                  double scan_time, bool inverted, float angle_min,
+                  double scan_time, double time_increment, bool inverted, float angle_min,
                   float angle_max, std::string frame_id,
-		unsigned int sector_start_timestamp)
+		unsigned int sector_start_timestamp,
+		SickScanFilterChain *filters, float range_min, float range_max)
 {
   static int scan_count = 0;
   sensor_msgs::LaserScan scan_msg;
@@ -42,15 +55,18 @@ void publish_scan(ros::Publisher *pub, double *range_values,
     scan_msg.angle_max = angle_max*DEG2RAD;
   }
   scan_msg.angle_increment = (scan_msg.angle_max - scan_msg.angle_min) / (double)(n_range_values-1);
-  scan_msg.scan_time = 0.125;//scan_time 125ms;
-  scan_msg.time_increment = scan_msg.scan_time / n_range_values;
-  scan_msg.range_min = 0.1;
-  scan_msg.range_max = 250.;
+  scan_msg.scan_time = scan_time;
+  scan_msg.time_increment = time_increment;
+  scan_msg.range_min = range_min;
+  scan_msg.range_max = range_max;
   scan_msg.ranges.resize(n_range_values);
   scan_msg.header.stamp = start;
   for (size_t i = 0; i < n_range_values; i++) {
     scan_msg.ranges[i] = (float)range_values[i]/1000;
   }
+  if (!filters->Empty() && n_range_values > 0) {
+    filters->Apply(&scan_msg.ranges[0], NULL, n_range_values, angle_min, (angle_max - angle_min)/(double)(n_range_values-1));
+  }
   scan_msg.intensities.resize(n_intensity_values);
   for (size_t i = 0; i < n_intensity_values; i++) {
     scan_msg.intensities[i] = 0;//(float)intensity_values[i];
@@ -60,21 +76,19 @@ void publish_scan(ros::Publisher *pub, double *range_values,
 }
 
 
-void PublishLaserTransform(tf::TransformBroadcaster laser_broadcaster,std::string header_frame_id,std::string child_frame_id)
+void PublishLaserTransform(tf::TransformBroadcaster laser_broadcaster,std::string header_frame_id,std::string child_frame_id,ros::Time stamp)
 {
 
 	    laser_broadcaster.sendTransform(
 			    tf::StampedTransform(tf::Transform(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0.2374)),
-			          ros::Time::now(),header_frame_id, child_frame_id)); // distance from the focal point of the scanner to its base (199.4mm) + offset from the mount (38mm)
+			          stamp,header_frame_id, child_frame_id)); // distance from the focal point of the scanner to its base (199.4mm) + offset from the mount (38mm)
 
 } //you can also define a customized urdf model using the nav350 meshes given
 
 
 //necessary for sensor fusion using robot_localization package
-void PublishLaserOdometry(double x,double y,double th,ros::Publisher *pub,std::string frame_id)
+void PublishLaserOdometry(double x,double y,double th,ros::Publisher *pub,std::string frame_id,ros::Time current_time)
 {
-	ros::Time current_time;
-	current_time=ros::Time::now();
 	geometry_msgs::Quaternion odom_quat = tf::createQuaternionMsgFromYaw(th);
 	nav_msgs::Odometry odom;
 	    odom.header.stamp = current_time;
@@ -111,50 +125,412 @@ void PublishPositionTransform(double x,double y,double th,tf::TransformBroadcast
     odom_broadcaster.sendTransform(odom_trans);
 }
 
-// odometry call back from the robot 
-double vx,vy,vth;
+// point layout of the optional cloud; reflector is the GlobalID of the reflector a beam hit, -1 elsewhere
+struct NavCloudPoint
+{
+  float x, y, z;
+  float intensity;
+  int32_t reflector;
+};
+
+// writes navigation frames straight into a PointCloud2 (one point per beam, NaN where out of range).
+// The beam directions come from SickScanConverter's cached angle tables, so a frame costs one
+// pass over the ranges.
+class NavCloudBuilder
+{
+public:
+  NavCloudBuilder()
+  {
+    converter_.SetUnitScale(0.001); // mm -> m
+    converter_.SetMountingTransform(0, 0, -180); // beam angles follow the published LaserScan
+  }
+
+  void Build(const NavFrame &frame, bool inverted, float range_min, float range_max,
+             const ros::Time &stamp, const std::string &frame_id, sensor_msgs::PointCloud2 &cloud)
+  {
+    SickScanView<uint32_t> sector = frame.Sector();
+    const unsigned int n = sector.Size();
+
+    if (cloud.fields.empty()) {
+      static const char *names[] = {"x", "y", "z", "intensity", "reflector"};
+      cloud.fields.resize(5);
+      for (unsigned int i = 0; i < 5; i++) {
+        cloud.fields[i].name = names[i];
+        cloud.fields[i].offset = i*4;
+        cloud.fields[i].datatype = i < 4 ? sensor_msgs::PointField::FLOAT32 : sensor_msgs::PointField::INT32;
+        cloud.fields[i].count = 1;
+      }
+      cloud.height = 1;
+      cloud.is_bigendian = false;
+      cloud.is_dense = false;
+      cloud.point_step = sizeof(NavCloudPoint);
+    }
+    cloud.header.stamp = stamp;
+    cloud.header.frame_id = frame_id;
+    cloud.width = n;
+    cloud.row_step = n*cloud.point_step;
+    cloud.data.resize(cloud.row_step);
+    if (n == 0)
+      return;
+
+    // mirrored when inverted, like the LaserScan's angle_min/angle_increment
+    if (inverted) {
+      sector.angle_start = sector.AngleStop();
+      sector.angle_step = -sector.angle_step;
+    }
+    x_.resize(n);
+    y_.resize(n);
+    valid_.resize(n);
+    converter_.SetRangeLimits(range_min, range_max);
+    converter_.Convert(sector, &x_[0], &y_[0], &valid_[0]);
+
+    NavCloudPoint * const points = reinterpret_cast<NavCloudPoint *>(&cloud.data[0]);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (unsigned int i = 0; i < n; i++) {
+      points[i].x = x_[i];
+      points[i].y = y_[i];
+      points[i].z = valid_[i] ? 0.0f : nan;
+      points[i].intensity = 0; // the navigation telegram carries no echoes
+      points[i].reflector = -1;
+    }
+
+    // tag the beams each reflector was seen on
+    const sick_nav350_reflector_tag &reflectors = frame.reflectors;
+    const unsigned int num_reflectors = std::min(reflectors.num_reflector, (unsigned int)SICK_MAX_NUM_REFLECTORS);
+    for (unsigned int j = 0; j < num_reflectors; j++) {
+      if (!reflectors.optional[j])
+        continue;
+      const unsigned int last = std::min(reflectors.indexEnd[j], n - 1);
+      for (unsigned int i = reflectors.indexStart[j]; i <= last; i++)
+        points[i].reflector = (int32_t)reflectors.GlobalID[j];
+    }
+  }
+
+private:
+  SickScanConverter converter_;
+  std::vector<float> x_, y_;
+  std::vector<uint8_t> valid_;
+};
+
+// odometry call back from the robot (runs on its own spinner; the acquisition thread reads the latest velocity)
+NavVelocity robot_velocity;
 void OdometryCallback(const nav_msgs::Odometry::ConstPtr& msg)
 {
-	vx=msg->twist.twist.linear.x;
-	vy=msg->twist.twist.linear.y;
-	vth=msg->twist.twist.angular.z;
+	robot_velocity.Set(*msg);
+}
+
+// one NAV350 managed by the node: its driver and everything published for it
+struct NavSensor
+{
+  NavSensor() : port(DEFAULT_SICK_TCP_PORT), inverted(false), range_min(0.1), range_max(250.), publish_cloud(false),
+                device_stamps(false), time_offset(0),
+                scan_archive_writer(SICK_SCAN_ARCHIVE_KEYFRAME_INTERVAL, SickNav350::SICK_MAX_NUM_MEASUREMENTS),
+                last_time_stamp(0) {}
+
+  std::string name; // empty when the node runs a single sensor from its top-level parameters
+  std::string ipaddress;
+  int port;
+  bool inverted;
+  std::string frame_id, fixed_frame_id, laser_frame_id;
+  double range_min, range_max;
+  bool publish_cloud;
+  bool device_stamps; // stamp from the device clock (NavClockSync) instead of the arrival time
+  double time_offset; // s added to device stamps (latency the clock filter cannot see)
+
+  boost::scoped_ptr<SickNav350> sick_nav350;
+  SickScanFilterChain scan_filters;
+  SickTelegramRecorder telegram_recorder;
+  SickScanArchiveWriter scan_archive_writer;
+  ros::Publisher scan_pub, odom_pub, cloud_pub;
+  NavCloudBuilder cloud_builder;
+  sensor_msgs::PointCloud2 cloud_msg;
+  boost::scoped_ptr<DriverHealthTask> health_task;
+  NavClockSync clock_sync;
+  double last_time_stamp;
+};
+typedef boost::shared_ptr<NavSensor> NavSensorPtr;
+
+// a per-sensor parameter falls back to the node-level one, then to the default
+template <class T>
+void SensorParam(const ros::NodeHandle &sensor_nh, const ros::NodeHandle &nh_ns, const std::string &name, T &value, const T &default_value)
+{
+  if (!sensor_nh.getParam(name, value))
+    nh_ns.param(name, value, default_value);
+}
+
+// reads a sensor's parameters and sets up its driver, filters, recorders and publishers
+void SetupSensor(NavSensor &sensor, ros::NodeHandle &nh, const ros::NodeHandle &nh_ns, const ros::NodeHandle &sensor_nh,
+                 SickMonitorGroup *monitor_group)
+{
+  // topics and frames are per sensor; the defaults keep several sensors apart
+  const std::string prefix = sensor.name.empty() ? "" : sensor.name + "/";
+  std::string scan, cloud_topic, odom_topic, telegram_log, scan_archive;
+  sensor_nh.param<std::string>("scan", scan, prefix + "scan");
+  sensor_nh.param<std::string>("cloud", cloud_topic, prefix + "cloud");
+  sensor_nh.param<std::string>("odom", odom_topic, prefix + "nav350_laser/odom");
+  sensor_nh.param<std::string>("frame_id", sensor.frame_id, sensor.name.empty() ? "front_laser" : sensor.name + "_laser"); //laser frame for scan data
+  sensor_nh.param<std::string>("fixed_frame_id", sensor.fixed_frame_id, sensor.name.empty() ? "front_mount" : sensor.name + "_mount"); // nav350 mount position frame on the robot
+  sensor_nh.param("port", sensor.port, DEFAULT_SICK_TCP_PORT);
+  sensor_nh.param("ipaddress", sensor.ipaddress, (std::string)DEFAULT_SICK_IP_ADDRESS);
+  sensor_nh.param<std::string>("telegram_log", telegram_log, ""); // record all device traffic to this file (empty disables)
+  sensor_nh.param<std::string>("scan_archive", scan_archive, ""); // append compressed scans and reflectors to this file (empty disables)
+  SensorParam(sensor_nh, nh_ns, "inverted", sensor.inverted, false);
+  SensorParam<std::string>(sensor_nh, nh_ns, "laser_frame_id", sensor.laser_frame_id, "map"); //global cooridnate frame measurement for navigation and position based on reflectors
+  SensorParam(sensor_nh, nh_ns, "publish_cloud", sensor.publish_cloud, false); // x/y/z, intensity and reflector ID per beam
+
+  /* Time stamping: "receive" stamps scans when they arrive, "device" converts the NAV350's clock */
+  std::string stamp_mode;
+  SensorParam<std::string>(sensor_nh, nh_ns, "stamp_mode", stamp_mode, "receive");
+  SensorParam(sensor_nh, nh_ns, "time_offset", sensor.time_offset, 0.);
+  sensor.device_stamps = stamp_mode == "device";
+  if (!sensor.device_stamps && stamp_mode != "receive")
+    ROS_WARN("Unknown stamp_mode %s; stamping scans when they arrive", stamp_mode.c_str());
+
+  /* Scan filtering (every stage is off by default) */
+  bool filter_range_gate;
+  int filter_median_window, filter_temporal_depth;
+  double filter_shadow_angle;
+  SensorParam(sensor_nh, nh_ns, "range_min", sensor.range_min, 0.1);
+  SensorParam(sensor_nh, nh_ns, "range_max", sensor.range_max, 250.);
+  SensorParam(sensor_nh, nh_ns, "filter_range_gate", filter_range_gate, false); // NaN out ranges outside [range_min,range_max]
+  SensorParam(sensor_nh, nh_ns, "filter_median_window", filter_median_window, 0); // spatial median over this many beams
+  SensorParam(sensor_nh, nh_ns, "filter_temporal_depth", filter_temporal_depth, 0); // temporal median over this many scans
+  SensorParam(sensor_nh, nh_ns, "filter_shadow_angle", filter_shadow_angle, 0.); // drop veiling points below this angle (deg)
+  if (filter_range_gate) {
+    sensor.scan_filters.AddFilter(new SickRangeFilter((float)sensor.range_min, (float)sensor.range_max));
+  }
+  if (filter_median_window > 1) {
+    sensor.scan_filters.AddFilter(new SickMedianFilter(filter_median_window, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+  }
+  if (filter_temporal_depth > 1) {
+    sensor.scan_filters.AddFilter(new SickTemporalMedianFilter(filter_temporal_depth, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+  }
+  if (filter_shadow_angle > 0) {
+    sensor.scan_filters.AddFilter(new SickShadowFilter(filter_shadow_angle, 1, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+  }
+
+  sensor.scan_pub = nh.advertise<sensor_msgs::LaserScan>(scan, 100);
+  sensor.odom_pub = nh.advertise<nav_msgs::Odometry>(odom_topic, 10);
+  if (sensor.publish_cloud)
+    sensor.cloud_pub = nh.advertise<sensor_msgs::PointCloud2>(cloud_topic, 10);
+
+  /* Instantiate the driver; its telegrams are assembled on the shared I/O thread */
+  sensor.sick_nav350.reset(new SickNav350(sensor.ipaddress.c_str(), sensor.port));
+  sensor.sick_nav350->SetMonitorGroup(monitor_group);
+  if (!telegram_log.empty()) {
+    try {
+      sensor.telegram_recorder.Open(telegram_log);
+      sensor.sick_nav350->SetTelegramRecorder(&sensor.telegram_recorder);
+    } catch (...) {
+      ROS_ERROR("Unable to open telegram log %s", telegram_log.c_str());
+    }
+  }
+  if (!scan_archive.empty()) {
+    try {
+      sensor.scan_archive_writer.Open(scan_archive);
+    } catch (...) {
+      ROS_ERROR("Unable to open scan archive %s", scan_archive.c_str());
+    }
+  }
+  sensor.health_task.reset(new DriverHealthTask(*sensor.sick_nav350));
+}
+
+// keeps one navigation request in flight per sensor. With wait=1 a device answers once its
+// next scan is done, so the loop runs at the device rates; the replies are assembled on the
+// monitor group's I/O thread and this thread parses whichever is in and asks that sensor again.
+// Nothing here waits on a device: a failing sensor is logged, counted in its diagnostics and
+// asked again after NAV_RETRY_DELAY while the others carry on.
+void AcquisitionLoop(std::vector<NavSensorPtr> *sensors, NavFrameQueue *frame_queue)
+{
+  NavFrame frame;
+  SickScanLease<uint32_t> scan_lease;
+  std::vector<bool> requested(sensors->size(), false);
+  std::vector<ros::Time> retry_time(sensors->size());
+
+  try {
+    while (ros::ok() && !frame_queue->Closed()) {
+      bool received = false;
+      for (unsigned int i = 0; i < sensors->size(); i++) {
+        NavSensor &sensor = *(*sensors)[i];
+        SickNav350 *sick_nav350 = sensor.sick_nav350.get();
+        try {
+          if (!requested[i]) {
+            if (ros::Time::now() < retry_time[i])
+              continue;
+            sick_nav350->RequestDataNavigation(1,1);
+            requested[i] = true;
+            continue;
+          }
+          if (!sick_nav350->PollDataNavigation())
+            continue;
+          received = true;
+
+          frame.sensor = i;
+          frame.receive_time = ros::Time::now();
+          frame.pose = sick_nav350->PoseData_;
+          sick_nav350->GetSickMeasurements(scan_lease);
+          frame.SetSector(scan_lease.GetSector(0));
+          scan_lease.Release();
+          frame.reflectors = sick_nav350->ReflectorData_;
+          const unsigned int timestamp = frame.timestamp_start;
+          if (!frame_queue->Push(frame))
+            ROS_WARN_THROTTLE(10, "Publishing is falling behind the devices; dropped the oldest navigation frame");
+
+          // inject the latest odometry in the gap before the next telegram (the next poll skips the acknowledgement)
+          double x, y, th;
+          robot_velocity.Get(x, y, th);
+          sick_nav350->RequestSetSpeed(x,y,th,timestamp,0);
+          sick_nav350->RequestDataNavigation(1,1);
+        }
+        catch (SickException &e) {
+          ROS_ERROR("Navigation data acquisition failed (%s): %s; retrying", sensor.ipaddress.c_str(), e.what());
+          sensor.health_task->AcquisitionError();
+          scan_lease.Release();
+          requested[i] = false;
+          retry_time[i] = ros::Time::now() + ros::Duration(NAV_RETRY_DELAY);
+        }
+      }
+
+      // nothing in yet; poll at the rate the driver's own receive loop does
+      if (!received)
+        usleep(1000);
+    }
+    return;
+  }
+  catch(...) {
+    ROS_ERROR("Navigation data acquisition stopped");
+  }
+  frame_queue->Close();
+}
+
+// stops every driver's monitor before the group it is registered with goes away
+void UninitializeSensors(std::vector<NavSensorPtr> &sensors)
+{
+  for (unsigned int i = 0; i < sensors.size(); i++)
+    sensors[i]->sick_nav350->Uninitialize();
+}
+
+// archives and publishes one navigation frame for the sensor it came from
+void PublishFrame(NavSensor &sensor, const NavFrame &frame, tf::TransformBroadcaster &laser_broadcaster,
+                  bool publish_tf_, bool publish_odom_, bool publish_scan_)
+{
+    /* Define buffers for return values */
+    double range_values[SickNav350::SICK_MAX_NUM_MEASUREMENTS];
+    unsigned int intensity_values[SickNav350::SICK_MAX_NUM_MEASUREMENTS] = {0};
+    sick_archive_reflector_t archive_reflectors[SICK_SCAN_ARCHIVE_MAX_REFLECTORS];
+
+            const SickScanView<uint32_t> sector = frame.Sector();
+            const unsigned int num_measurements = sector.Size();
+            for (unsigned int i = 0; i < num_measurements; i++)
+              range_values[i] = sector.range_values[i];
+            double sector_start_angle = sector.angle_start;
+            double sector_stop_angle = sector.AngleStop();
+            const unsigned int sector_start_timestamp = sector.timestamp_start;
+
+            if (sensor.scan_archive_writer.IsOpen()) {
+              const sick_nav350_reflector_tag &reflectors = frame.reflectors;
+              sick_archive_scan_t archived_scan;
+              archived_scan.timestamp_usec = (uint64_t)(frame.receive_time.toNSec()/1000);
+              archived_scan.device_timestamp = sector.timestamp_start;
+              archived_scan.angle_start = (int32_t)lround(sector.angle_start*1000);
+              archived_scan.angle_step = (int32_t)lround(sector.angle_step*1000);
+              archived_scan.num_values = num_measurements;
+              archived_scan.range_values = sector.range_values;
+              archived_scan.echo_values = NULL; // the NAV350 parser does not fill echo_values
+              archived_scan.num_reflectors = std::min(reflectors.num_reflector, (unsigned int)SICK_SCAN_ARCHIVE_MAX_REFLECTORS);
+              for (unsigned int i = 0; i < archived_scan.num_reflectors; i++) {
+                archive_reflectors[i].global_id = reflectors.GlobalID[i];
+                archive_reflectors[i].x = (int32_t)lround(reflectors.x[i]);
+                archive_reflectors[i].y = (int32_t)lround(reflectors.y[i]);
+                archive_reflectors[i].dist = (int32_t)lround(reflectors.dist[i]);
+                archive_reflectors[i].phi = (int32_t)lround(reflectors.phi[i]);
+                archive_reflectors[i].quality = reflectors.quality[i];
+              }
+              archived_scan.reflectors = archive_reflectors;
+              try {
+                sensor.scan_archive_writer.Write(archived_scan);
+              } catch (SickIOException &e) {
+                ROS_ERROR("Scan archive write failed (%s); archiving stopped", e.what());
+                sensor.scan_archive_writer.Close();
+              }
+            }
+	/* When the first beam and the pose were measured, and how long a rotation takes */
+	ros::Time start_scan_time, pose_time;
+	double scan_duration, time_increment;
+	if (sensor.device_stamps)
+	{
+		const double scan_fraction = (sector.AngleStop() - sector.angle_start + sector.angle_step)/360;
+		start_scan_time = sensor.clock_sync.Update(sector_start_timestamp, scan_fraction, frame.receive_time) + ros::Duration(sensor.time_offset);
+		pose_time = frame.pose.optionalPoseData == 1 ? sensor.clock_sync.ToRosTime(frame.pose.timeStamp) + ros::Duration(sensor.time_offset) : start_scan_time;
+		scan_duration = sensor.clock_sync.ScanPeriod();
+		time_increment = scan_duration*sector.angle_step/360;
+	}
+	else
+	{
+		// stamped when the telegram arrived, not when this stage got to it
+		scan_duration = 0.125;
+		start_scan_time = frame.receive_time - ros::Duration(scan_duration);
+		pose_time = ros::Time::now();
+		time_increment = num_measurements ? scan_duration/num_measurements : 0;
+	}
+
+	double x2,y2,phi2;
+	NavPoseToLaserPose(frame.pose,x2,y2,phi2);
+
+	if(publish_tf_)
+	{
+//        	PublishPositionTransform(x2,y2,phi2,odom_broadcaster,laser_frame_id,laser_child_frame_id); //publish position data as transform in map frame 
+		PublishLaserTransform(laser_broadcaster,sensor.fixed_frame_id,sensor.frame_id,sensor.device_stamps ? start_scan_time : ros::Time::now()); // publish laser transform with respect to base frame (scan data)
+	}
+	if(publish_odom_)
+		{
+	PublishLaserOdometry(x2,y2,phi2,&sensor.odom_pub,sensor.laser_frame_id,pose_time); // publish odometry data from nav350 for sensor fusion
+		}
+	if (sector_start_timestamp<sensor.last_time_stamp)
+	{
+		return;
+	}
+	sensor.last_time_stamp=sector_start_timestamp;
+
+            sector_start_angle-=180;
+		sector_stop_angle-=180;
+		if(publish_scan_)
+				{
+            publish_scan(&sensor.scan_pub, range_values, num_measurements, intensity_values,
+                   num_measurements, start_scan_time, scan_duration, time_increment, sensor.inverted,
+                   (float)sector_start_angle, (float)sector_stop_angle, sensor.frame_id,sector_start_timestamp,
+                   &sensor.scan_filters, (float)sensor.range_min, (float)sensor.range_max);
+				}
+		if(sensor.publish_cloud)
+		{
+			sensor.cloud_builder.Build(frame, sensor.inverted, (float)sensor.range_min, (float)sensor.range_max, start_scan_time, sensor.frame_id, sensor.cloud_msg);
+			sensor.cloud_pub.publish(sensor.cloud_msg);
+		}
 }
 
 int main(int argc, char *argv[]) {
     ros::init(argc, argv, "sicknav350");
-    int port;
-    std::string ipaddress;
-    std::string frame_id, fixed_frame_id;
-    std::string odometry;
-    std::string scan;
-    bool inverted;
     bool publish_tf_,publish_odom_,publish_scan_;
     int sick_motor_speed = 8;//10; // Hz
     double sick_step_angle = 1.5;//0.5;//0.25; 
     double active_sector_start_angle = 0;
     double active_sector_stop_angle = 360;//269.75;
-    std::string laser_frame_id,laser_child_frame_id,odom_frame_id;
+    std::string laser_child_frame_id;
     ros::NodeHandle nh;
 	ros::NodeHandle nh_ns("~");
-	nh_ns.param<std::string>("scan", scan, "scan");
-	ros::Publisher scan_pub = nh.advertise<sensor_msgs::LaserScan>(scan, 100);
-
-	ros::Publisher odom_pub = nh.advertise<nav_msgs::Odometry>("nav350_laser/odom", 10);
 
 	nh_ns.param<bool>("publish_tf", publish_tf_, true);
 	nh_ns.param<bool>("publish_odom_", publish_odom_, true);
 	nh_ns.param<bool>("publish_scan", publish_scan_, true);
-
-	nh_ns.param("port", port, DEFAULT_SICK_TCP_PORT);
-	nh_ns.param("ipaddress", ipaddress, (std::string)DEFAULT_SICK_IP_ADDRESS);
-	nh_ns.param("inverted", inverted, false);
-	nh_ns.param<std::string>("frame_id", frame_id, "front_laser"); //laser frame for scan data
-	nh_ns.param<std::string>("fixed_frame_id", fixed_frame_id, "front_mount"); // nav350 mount position frame on the robot 
-
-	nh_ns.param<std::string>("laser_frame_id", laser_frame_id, "map"); //global cooridnate frame measurement for navigation and position based on reflectors
 	nh_ns.param<std::string>("laser_child_frame_id", laser_child_frame_id, "reflector");// a fixed frame eg: odom or base or reflector
 
-	ros::Subscriber sub = nh.subscribe("odometry/filtered", 10, OdometryCallback); // data from sensor fusion or wheel odometry of jackal robot
+	// odometry is handled on its own queue so velocity updates never wait behind publishing
+	ros::NodeHandle nh_odom;
+	ros::CallbackQueue odom_queue;
+	nh_odom.setCallbackQueue(&odom_queue);
+	ros::Subscriber sub = nh_odom.subscribe("odometry/filtered", 10, OdometryCallback); // data from sensor fusion or wheel odometry of jackal robot
+	ros::AsyncSpinner odom_spinner(1, &odom_queue);
+	odom_spinner.start();
 
 
 
@@ -162,105 +538,83 @@ int main(int argc, char *argv[]) {
     nh_ns.param("start_angle", active_sector_start_angle, 0.);
     nh_ns.param("stop_angle", active_sector_stop_angle, 360.);
     nh_ns.param("scan_rate", sick_motor_speed, 5);
-
-    /* Define buffers for return values */
-    double range_values[SickNav350::SICK_MAX_NUM_MEASUREMENTS] = {0};
-    unsigned int intensity_values[SickNav350::SICK_MAX_NUM_MEASUREMENTS] = {0};
-    /* Define buffers to hold sector specific data */
-    unsigned int num_measurements = {0};
-    unsigned int sector_start_timestamp = {0};
-	unsigned int sector_stop_timestamp = {0};
-    double sector_step_angle = {0};
-    double sector_start_angle = {0};
-    double sector_stop_angle = {0};
-    /* Instantiate the object */
-    SickNav350 sick_nav350(ipaddress.c_str(),port);
+    int publish_queue_size;
+    nh_ns.param("publish_queue_size", publish_queue_size, 4); // navigation frames buffered between acquisition and publishing
+
+    // ~sensors lists the NAV350s this node runs, each configured under ~<name>/. Without it
+    // the node runs one sensor from its top-level parameters.
+    std::vector<std::string> sensor_names;
+    nh_ns.getParam("sensors", sensor_names);
+    if (sensor_names.empty())
+      sensor_names.push_back("");
+
+    // all sensors share one I/O thread; it must outlive their drivers
+    SickMonitorGroup monitor_group;
+    std::vector<NavSensorPtr> sensors;
+    for (unsigned int i = 0; i < sensor_names.size(); i++) {
+      NavSensorPtr sensor(new NavSensor);
+      sensor->name = sensor_names[i];
+      const ros::NodeHandle sensor_nh = sensor->name.empty() ? nh_ns : ros::NodeHandle(nh_ns, sensor->name);
+      SetupSensor(*sensor, nh, nh_ns, sensor_nh, &monitor_group);
+      sensors.push_back(sensor);
+    }
+#ifdef SICK_LATENCY_TRACING
+    SickLatencyHistograms::DumpOnSignal(SIGUSR1); // kill -USR1 prints where scans spend their time
+#endif
   //  ros::Duration(50).sleep(); //timedelay for jackal robot startup jobs
-double last_time_stamp=0;
     try {
-        /* Initialize the device */
-        sick_nav350.Initialize();
+        /* Initialize the devices */
+        for (unsigned int i = 0; i < sensors.size(); i++) {
+          sensors[i]->sick_nav350->Initialize();
 
-        try {
-		sick_nav350.SetOperatingMode(4);
+          try {
+		sensors[i]->sick_nav350->SetOperatingMode(4);
 
-        } catch (...) {
-            ROS_ERROR("Configuration error");
+          } catch (...) {
+            ROS_ERROR("Configuration error (%s)", sensors[i]->ipaddress.c_str());
+            UninitializeSensors(sensors);
             return -1;
+          }
         }
 
-        ros::Time last_start_scan_time;
-        unsigned int last_sector_stop_timestamp = 0;
-	ros::Rate loop_rate(8);
-	tf::TransformBroadcaster odom_broadcaster;
 	tf::TransformBroadcaster laser_broadcaster;
-
-        while (ros::ok()) {
-            /* Get the scan and landmark measurements */
-            sick_nav350.GetDataNavigation(1,1);
-            sick_nav350.GetSickMeasurements(range_values,
-                                        &num_measurements,
-                                        &sector_step_angle,
-                                        &sector_start_angle,
-                                        &sector_stop_angle,
-                                        &sector_start_timestamp,
-                                        &sector_stop_timestamp
-                                        );
-	double x1=(double) sick_nav350.PoseData_.x;
-	double y1=(double) sick_nav350.PoseData_.y;
-	double phi1=sick_nav350.PoseData_.phi;
-	double x2,y2;
-	double phi2=phi1-180000-1250-300;
-	phi2=phi2/1000*3.14159/180;
-	x2=x1-/*300*/529*cos(phi2);
-	y2=y1-/*300*/529*sin(phi2);
-	x2=x2/1000;
-	y2=y2/1000;
-
-	if(publish_tf_)
-	{
-//        	PublishPositionTransform(x2,y2,phi2,odom_broadcaster,laser_frame_id,laser_child_frame_id); //publish position data as transform in map frame 
-		PublishLaserTransform(laser_broadcaster,fixed_frame_id,frame_id); // publish laser transform with respect to base frame (scan data)
+	diagnostic_updater::Updater updater;
+	std::string hardware_id;
+	for (unsigned int i = 0; i < sensors.size(); i++) {
+	  NavSensor &sensor = *sensors[i];
+	  hardware_id += (i ? "," : "") + sensor.ipaddress;
+	  updater.add(sensor.name.empty() ? "Driver health" : sensor.name + " driver health",
+	              sensor.health_task.get(), &DriverHealthTask::run);
 	}
-	if(publish_odom_)
-		{
-	PublishLaserOdometry(x2,y2,phi2,&odom_pub,laser_frame_id); // publish odometry data from nav350 for sensor fusion
-		}
-	if (sector_start_timestamp<last_time_stamp)
-	{
-		loop_rate.sleep();
-		ros::spinOnce();
-		continue;
-	}
-	last_time_stamp=sector_start_timestamp;
-            ros::Time end_scan_time = ros::Time::now();
-
-            double scan_duration = 0.125;
-
-            ros::Time start_scan_time = end_scan_time - ros::Duration(scan_duration);
-            sector_start_angle-=180;
-		sector_stop_angle-=180;
-		if(publish_scan_)
-				{
-            publish_scan(&scan_pub, range_values, num_measurements, intensity_values,
-                   num_measurements, start_scan_time, scan_duration, inverted,
-                   (float)sector_start_angle, (float)sector_stop_angle, frame_id,sector_start_timestamp);
-				}
+	updater.setHardwareID(hardware_id);
 
-            last_start_scan_time = start_scan_time;
-           last_sector_stop_timestamp = sector_stop_timestamp;
+	/* The devices pace acquisition; this thread only publishes what it hands over */
+	NavFrameQueue frame_queue(publish_queue_size*sensors.size());
+	boost::thread acquisition_thread(AcquisitionLoop, &sensors, &frame_queue);
+	NavFrame frame;
 
-           sick_nav350.SetSpeed(vx,vy,vth,sector_start_timestamp,0);
+        while (ros::ok()) {
+            if (frame_queue.Pop(frame, 0.1))
+              PublishFrame(*sensors[frame.sensor], frame, laser_broadcaster, publish_tf_, publish_odom_, publish_scan_);
+            else if (frame_queue.Closed())
+              break;
 
-		loop_rate.sleep();
+		updater.update();
 			ros::spinOnce();
 
         }
-        /* Uninitialize the device */
-       sick_nav350.Uninitialize();
+        const bool acquisition_failed = frame_queue.Closed();
+        frame_queue.Close();
+        acquisition_thread.join();
+        odom_spinner.stop();
+        /* Uninitialize the devices */
+       UninitializeSensors(sensors);
+       if (acquisition_failed)
+         return -1;
     }
     catch(...) {
         ROS_ERROR("Error");
+        UninitializeSensors(sensors);
         return -1;
     }
     return 0;
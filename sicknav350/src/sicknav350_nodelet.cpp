@@ -0,0 +1,262 @@
+/*
+ * sicknav350_nodelet.cpp
+ *
+ * Nodelet version of sicknav350_node. Scans and odometry are written straight from the
+ * driver's buffers into pooled messages and published by shared pointer, so nodelets in
+ * the same manager (localization, costmaps) get them without serialization or copies.
+ *
+ * Released under BSD license.
+ */
+
+#include <nodelet/nodelet.h>
+#include <pluginlib/class_list_macros.h>
+#include <sicktoolbox/SickNAV350.hh>
+#include <sicktoolbox/SickScanFilter.hh>
+#include "sensor_msgs/LaserScan.h"
+#include <tf/transform_broadcaster.h>
+#include <boost/make_shared.hpp>
+#include <boost/scoped_ptr.hpp>
+#include "sicknav350_common.h"
+
+#define DEG2RAD M_PI/180.0
+#define SCAN_DURATION 0.125 // s
+#define MAX_POOLED_MESSAGES 16 // per topic; subscribers holding more than this get fresh messages
+
+namespace sicknav350
+{
+
+// returns a pooled message nobody else holds any more. Intra-process subscribers keep the
+// very object that was published, so a message is only refilled once all of them let go.
+template <class M>
+boost::shared_ptr<M> TakeFromPool(std::vector<boost::shared_ptr<M> > &pool)
+{
+  for (size_t i = 0; i < pool.size(); i++)
+    if (pool[i].unique())
+      return pool[i];
+  if (pool.size() >= MAX_POOLED_MESSAGES)
+    return boost::make_shared<M>();
+  pool.push_back(boost::make_shared<M>());
+  return pool.back();
+}
+
+class SickNav350Nodelet : public nodelet::Nodelet
+{
+public:
+  SickNav350Nodelet() : running_(false) {}
+
+  ~SickNav350Nodelet()
+  {
+    running_ = false;
+    acquisition_thread_.join();
+  }
+
+private:
+  virtual void onInit();
+
+  // connects, then receives, publishes and injects odometry at the device rate
+  void Acquire();
+
+  void PublishScan(const SickScanView<uint32_t> &sector, const ros::Time &stamp,
+                   double scan_time, double time_increment);
+  void PublishOdometry(const sick_nav350_pose_tag &pose, const ros::Time &stamp);
+
+  void OdometryCallback(const nav_msgs::Odometry::ConstPtr &msg) { velocity_.Set(*msg); }
+
+  /* Parameters */
+  std::string ipaddress_;
+  int port_;
+  bool inverted_;
+  bool publish_tf_, publish_odom_, publish_scan_;
+  std::string frame_id_, fixed_frame_id_, laser_frame_id_;
+  double range_min_, range_max_;
+  bool device_stamps_;
+  double time_offset_;
+
+  ros::Publisher scan_pub_, odom_pub_;
+  ros::Subscriber odom_sub_;
+  boost::scoped_ptr<tf::TransformBroadcaster> laser_broadcaster_;
+  SickScanFilterChain scan_filters_;
+  NavVelocity velocity_;
+  NavClockSync clock_sync_;
+
+  std::vector<sensor_msgs::LaserScanPtr> scan_pool_;
+  std::vector<nav_msgs::OdometryPtr> odom_pool_;
+
+  volatile bool running_;
+  boost::thread acquisition_thread_;
+};
+
+void SickNav350Nodelet::onInit()
+{
+  ros::NodeHandle &nh = getNodeHandle();
+  ros::NodeHandle &nh_ns = getPrivateNodeHandle();
+
+  std::string scan;
+  nh_ns.param<std::string>("scan", scan, "scan");
+  nh_ns.param<bool>("publish_tf", publish_tf_, true);
+  nh_ns.param<bool>("publish_odom_", publish_odom_, true);
+  nh_ns.param<bool>("publish_scan", publish_scan_, true);
+  nh_ns.param("port", port_, DEFAULT_SICK_TCP_PORT);
+  nh_ns.param("ipaddress", ipaddress_, (std::string)DEFAULT_SICK_IP_ADDRESS);
+  nh_ns.param("inverted", inverted_, false);
+  nh_ns.param<std::string>("frame_id", frame_id_, "front_laser");
+  nh_ns.param<std::string>("fixed_frame_id", fixed_frame_id_, "front_mount");
+  nh_ns.param<std::string>("laser_frame_id", laser_frame_id_, "map");
+
+  /* Time stamping (same parameters as sicknav350_node) */
+  std::string stamp_mode;
+  nh_ns.param<std::string>("stamp_mode", stamp_mode, "receive");
+  nh_ns.param("time_offset", time_offset_, 0.);
+  device_stamps_ = stamp_mode == "device";
+  if (!device_stamps_ && stamp_mode != "receive")
+    NODELET_WARN("Unknown stamp_mode %s; stamping scans when they arrive", stamp_mode.c_str());
+
+  /* Scan filtering (same parameters as sicknav350_node) */
+  bool filter_range_gate;
+  int filter_median_window, filter_temporal_depth;
+  double filter_shadow_angle;
+  nh_ns.param("range_min", range_min_, 0.1);
+  nh_ns.param("range_max", range_max_, 250.);
+  nh_ns.param("filter_range_gate", filter_range_gate, false);
+  nh_ns.param("filter_median_window", filter_median_window, 0);
+  nh_ns.param("filter_temporal_depth", filter_temporal_depth, 0);
+  nh_ns.param("filter_shadow_angle", filter_shadow_angle, 0.);
+  if (filter_range_gate)
+    scan_filters_.AddFilter(new SickRangeFilter((float)range_min_, (float)range_max_));
+  if (filter_median_window > 1)
+    scan_filters_.AddFilter(new SickMedianFilter(filter_median_window, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+  if (filter_temporal_depth > 1)
+    scan_filters_.AddFilter(new SickTemporalMedianFilter(filter_temporal_depth, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+  if (filter_shadow_angle > 0)
+    scan_filters_.AddFilter(new SickShadowFilter(filter_shadow_angle, 1, SickNav350::SICK_MAX_NUM_MEASUREMENTS));
+
+  scan_pub_ = nh.advertise<sensor_msgs::LaserScan>(scan, 100);
+  odom_pub_ = nh.advertise<nav_msgs::Odometry>("nav350_laser/odom", 10);
+  laser_broadcaster_.reset(new tf::TransformBroadcaster);
+
+  // the multi-threaded handle keeps velocity updates off the acquisition path
+  odom_sub_ = getMTNodeHandle().subscribe("odometry/filtered", 10, &SickNav350Nodelet::OdometryCallback, this);
+
+  // connecting takes a while; onInit must not hold up the manager
+  running_ = true;
+  acquisition_thread_ = boost::thread(&SickNav350Nodelet::Acquire, this);
+}
+
+void SickNav350Nodelet::Acquire()
+{
+  SickNav350 sick_nav350(ipaddress_.c_str(), port_);
+  SickScanLease<uint32_t> scan_lease; // the driver's ranges, read in place until the next request
+
+  diagnostic_updater::Updater updater(getNodeHandle(), getPrivateNodeHandle(), getName());
+  updater.setHardwareID(ipaddress_);
+  DriverHealthTask health_task(sick_nav350);
+  updater.add("Driver health", &health_task, &DriverHealthTask::run);
+
+  try {
+    sick_nav350.Initialize();
+    sick_nav350.SetOperatingMode(4);
+  }
+  catch(...) {
+    NODELET_ERROR("Unable to initialize the NAV350 at %s:%d", ipaddress_.c_str(), port_);
+    return;
+  }
+
+  unsigned int last_time_stamp = 0;
+  try {
+    while (running_ && ros::ok()) {
+      // with wait=1 the device answers once its next scan is done
+      sick_nav350.GetDataNavigation(1,1);
+      const ros::Time stamp = ros::Time::now();
+      sick_nav350.GetSickMeasurements(scan_lease);
+      const SickScanView<uint32_t> &sector = scan_lease.GetSector(0);
+      const sick_nav350_pose_tag &pose = sick_nav350.PoseData_;
+
+      // when the first beam and the pose were measured, and how long a rotation takes
+      ros::Time scan_stamp = stamp - ros::Duration(SCAN_DURATION), pose_stamp = stamp;
+      double scan_time = SCAN_DURATION;
+      double time_increment = sector.Size() ? SCAN_DURATION / sector.Size() : 0;
+      if (device_stamps_) {
+        const double scan_fraction = (sector.AngleStop() - sector.angle_start + sector.angle_step)/360;
+        scan_stamp = clock_sync_.Update(sector.timestamp_start, scan_fraction, stamp) + ros::Duration(time_offset_);
+        pose_stamp = pose.optionalPoseData == 1 ? clock_sync_.ToRosTime(pose.timeStamp) + ros::Duration(time_offset_) : scan_stamp;
+        scan_time = clock_sync_.ScanPeriod();
+        time_increment = scan_time*sector.angle_step/360;
+      }
+
+      if (publish_tf_)
+        laser_broadcaster_->sendTransform(tf::StampedTransform(tf::Transform(tf::Quaternion(0, 0, 0, 1), tf::Vector3(0, 0, 0.2374)),
+                                                               device_stamps_ ? scan_stamp : stamp, fixed_frame_id_, frame_id_));
+      if (publish_odom_)
+        PublishOdometry(pose, pose_stamp);
+      if (publish_scan_ && sector.timestamp_start >= last_time_stamp)
+        PublishScan(sector, scan_stamp, scan_time, time_increment);
+      last_time_stamp = std::max(last_time_stamp, sector.timestamp_start);
+      const unsigned int timestamp = sector.timestamp_start;
+      scan_lease.Release();
+
+      // inject the latest odometry in the gap before the next telegram
+      double vx, vy, vth;
+      velocity_.Get(vx, vy, vth);
+      sick_nav350.SetSpeed(vx, vy, vth, timestamp, 0);
+
+      updater.update();
+    }
+  }
+  catch(...) {
+    NODELET_ERROR("Navigation data acquisition failed");
+  }
+
+  sick_nav350.Uninitialize();
+}
+
+void SickNav350Nodelet::PublishScan(const SickScanView<uint32_t> &sector, const ros::Time &stamp,
+                                    double scan_time, double time_increment)
+{
+  const unsigned int n = sector.Size();
+  sensor_msgs::LaserScanPtr scan = TakeFromPool(scan_pool_);
+
+  // a reused message already has its arrays sized and intensities zeroed
+  if (scan->ranges.size() != n) {
+    scan->ranges.resize(n);
+    scan->intensities.assign(n, 0);
+  }
+
+  const double angle_min = sector.angle_start - 180;
+  const double angle_max = sector.AngleStop() - 180;
+  scan->header.frame_id = frame_id_;
+  scan->header.stamp = stamp;
+  scan->angle_min = (inverted_ ? angle_max : angle_min)*DEG2RAD;
+  scan->angle_max = (inverted_ ? angle_min : angle_max)*DEG2RAD;
+  scan->angle_increment = (scan->angle_max - scan->angle_min) / (double)(n-1);
+  scan->scan_time = scan_time;
+  scan->time_increment = time_increment;
+  scan->range_min = range_min_;
+  scan->range_max = range_max_;
+
+  // mm straight from the driver's buffer to m in the message
+  for (unsigned int i = 0; i < n; i++)
+    scan->ranges[i] = sector.range_values[i] * 0.001f;
+  if (!scan_filters_.Empty() && n > 0)
+    scan_filters_.Apply(&scan->ranges[0], NULL, n, angle_min, (angle_max - angle_min)/(double)(n-1));
+
+  scan_pub_.publish(scan);
+}
+
+void SickNav350Nodelet::PublishOdometry(const sick_nav350_pose_tag &pose, const ros::Time &stamp)
+{
+  double x, y, phi;
+  NavPoseToLaserPose(pose, x, y, phi);
+
+  nav_msgs::OdometryPtr odom = TakeFromPool(odom_pool_);
+  odom->header.stamp = stamp;
+  odom->header.frame_id = laser_frame_id_;
+  odom->pose.pose.position.x = x;
+  odom->pose.pose.position.y = y;
+  odom->pose.pose.position.z = 0;
+  odom->pose.pose.orientation = tf::createQuaternionMsgFromYaw(phi);
+  odom_pub_.publish(odom);
+}
+
+} // namespace sicknav350
+
+PLUGINLIB_EXPORT_CLASS(sicknav350::SickNav350Nodelet, nodelet::Nodelet)
@@ -55,7 +55,8 @@ namespace SickToolbox {
     _sick_sensor_mode(SICK_SENSOR_MODE_UNKNOWN),
     _sick_motor_mode(SICK_MOTOR_MODE_UNKNOWN),
     _sick_streaming_range_data(false),
-    _sick_streaming_range_and_echo_data(false)
+    _sick_streaming_range_and_echo_data(false),
+    _sick_scan_leased(false)
   {
     /* Initialize the sick identity */
     _sick_identity.sick_part_number =
@@ -70,6 +71,8 @@ namespace SickToolbox {
       _sick_identity.sick_application_software_name =
       _sick_identity.sick_application_software_version = "UNKNOWN";
 
+    SICK_LATENCY_LABEL(_sick_latency,"SickLD " + sick_ip_address);
+
     /* Initialize the global configuration structure */
     memset(&_sick_global_config,0,sizeof(sick_ld_config_global_t));
 
@@ -749,191 +752,25 @@ namespace SickToolbox {
 				    unsigned int * const sector_stop_timestamps )
     throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException ){
 
-    /* Ensure the device has been initialized */
-    if(!_sick_initialized) {
-      throw SickIOException("SickLD::GetSickMeasurements: Device NOT Initialized!!!");
-    }
-  
-    /* The following conditional holds true if the user wants a RANGE+ECHO data
-     * stream but already has an active RANGE-ONLY stream.
-     */
-    if (_sick_streaming_range_data && echo_measurements != NULL) {
-
-      try {
-	
-        /* Cancel the current RANGE-ONLY data stream */
-        _cancelSickScanProfiles();
-
-        /* Request a RANGE+ECHO data stream */
-        _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE_AND_ECHO);
-
-      }
-
-      /* Handle a timeout! */
-      catch (SickTimeoutException &sick_timeout_exception) {
-	std::cerr << sick_timeout_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle I/O exceptions */
-      catch (SickIOException &sick_io_exception) {
-	std::cerr << sick_io_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle a returned error code */
-      catch (SickErrorException &sick_error_exception) {
-	std::cerr << sick_error_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* A safety net */
-      catch (...) {
-	std::cerr << "SickLMS::GetSickMeasurements: Unknown exception!!!" << std::endl;
-	throw;
-      }  
-      
-    }
-
-    /* The following conditional holds true if the user wants a RANGE-ONLY data
-     * stream but already has an active RANGE+ECHO stream.
-     */
-    if (_sick_streaming_range_and_echo_data && echo_measurements == NULL) {
-
-      try {
-
-	/* Cancel the current RANGE+ECHO data stream */
-        _cancelSickScanProfiles();
-
-        /* Request a RANGE-ONLY data stream */
-        _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE);
-	
-      }
-      
-      /* Handle a timeout! */
-      catch (SickTimeoutException &sick_timeout_exception) {
-	std::cerr << sick_timeout_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle I/O exceptions */
-      catch (SickIOException &sick_io_exception) {
-	std::cerr << sick_io_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle a returned error code */
-      catch (SickErrorException &sick_error_exception) {
-	std::cerr << sick_error_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* A safety net */
-      catch (...) {
-	std::cerr << "SickLMS::GetSickMeasurements: Unknown exception!!!" << std::endl;
-	throw;
-      }  
-      
-    }
-
-    /* If there aren't any active data streams, setup a new one */
-    if (!_sick_streaming_range_data && !_sick_streaming_range_and_echo_data) {
-
-      try {
-      
-	/* Determine the target data stream by checking the value of echo_measurements */
-	if (echo_measurements != NULL) {
-	  
-	  /* Request a RANGE+ECHO data stream */
-	  _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE_AND_ECHO);	  
-	  
-	}
-	else {
-	  
-	  /* Request a RANGE+ONLY data stream */
-	  _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE);
-	  
-	}
+    /* Acquire a new scan profile into the driver's buffer */
+    _acquireSickScanProfile(echo_measurements != NULL);
 
-      }
-
-      /* Handle a timeout! */
-      catch (SickTimeoutException &sick_timeout_exception) {
-	std::cerr << sick_timeout_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle I/O exceptions */
-      catch (SickIOException &sick_io_exception) {
-	std::cerr << sick_io_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* Handle a returned error code */
-      catch (SickErrorException &sick_error_exception) {
-	std::cerr << sick_error_exception.what() << std::endl;
-	throw;
-      }
-      
-      /* A safety net */
-      catch (...) {
-	std::cerr << "SickLMS::_setSickSensorMode: Unknown exception!!!" << std::endl;
-	throw;
-      }  
-      
-    }
-
-    /* Declare the receive message object */
-    SickLDMessage recv_message;
-  
-    /* Acquire the most recently buffered message */
-    try {
-      _recvMessage(recv_message,(unsigned int)1e6);
-    }
-    
-    catch(SickTimeoutException &sick_timeout_exception) {
-      std::cerr << sick_timeout_exception.what() << std::endl;
-      throw;
-    }  
-
-    catch(...) {
-      std::cerr << "SickLD::GetSickMeasurements - Unknown exception!" << std::endl;
-      throw;
-    }
-    
-    /* A single buffer for payload contents */
-    uint8_t payload_buffer[SickLDMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-
-    /* Get the message payload */
-    recv_message.GetPayload(payload_buffer);
-
-    /* Define the destination Sick LD scan profile struct */
-    sick_ld_scan_profile_t profile_data;
-  
-    /* Extract the scan profile */
-    _parseScanProfile(&payload_buffer[2],profile_data);
-
-    /* Update and check the returned sensor status */
-    if ((_sick_sensor_mode = profile_data.sensor_status) != SICK_SENSOR_MODE_MEASURE) {
-      throw SickConfigException("SickLD::GetSickMeasurements: Unexpected sensor mode! " + _sickSensorModeToString(_sick_sensor_mode));
-    }
-
-    /* Update and check the returned motor status */
-    if ((_sick_motor_mode = profile_data.motor_status) != SICK_MOTOR_MODE_OK) {
-      throw SickConfigException("SickLD::GetSickMeasurements: Unexpected motor mode! (Are you using a valid motor speed!)");
-    }
+    const sick_ld_scan_profile_t &profile_data = _sick_scan_profile;
 
     /* Everything is OK, so now populate the relevant return buffers */
     for (unsigned int i = 0, total_measurements = 0; i < _sick_sector_config.sick_num_active_sectors; i++) {
 
-      /* Copy over the returned range values */
-      memcpy(&range_measurements[total_measurements],profile_data.sector_data[_sick_sector_config.sick_active_sector_ids[i]].range_values,
-	     profile_data.sector_data[_sick_sector_config.sick_active_sector_ids[i]].num_data_points*sizeof(double));
+      const sick_ld_sector_data_t &sector_data = profile_data.sector_data[_sick_sector_config.sick_active_sector_ids[i]];
+      SickScanView< uint16_t > sector_view(sector_data.range_values,sector_data.echo_values,sector_data.num_data_points,
+					   SICK_RANGE_SCALE,sector_data.angle_start,sector_data.angle_step,
+					   sector_data.timestamp_start,sector_data.timestamp_stop);
+
+      /* Expand the returned range values (meters) */
+      sector_view.GetRanges(&range_measurements[total_measurements]);
     
-      /* Copy the returned echo values  if requested */
+      /* Expand the returned echo values if requested */
       if (echo_measurements != NULL) {
-	memcpy(&echo_measurements[total_measurements],profile_data.sector_data[_sick_sector_config.sick_active_sector_ids[i]].echo_values,
-	       profile_data.sector_data[_sick_sector_config.sick_active_sector_ids[i]].num_data_points*sizeof(unsigned int));
+	sector_view.GetEchoes(&echo_measurements[total_measurements]);
       }
     
       /* Set the number of measurements */
@@ -984,6 +821,41 @@ namespace SickToolbox {
   
   }
 
+  /**
+   * \brief Acquires measurements for all active sectors and lends the driver's buffer to the caller
+   * \param &scan_lease Receives one view per active sector. Ranges are raw (see SICK_RANGE_SCALE)
+   *                    and the views remain valid until the lease is released.
+   * \param get_echoes  Requests a RANGE+ECHO stream (otherwise the views carry no echo values)
+   *
+   * NOTE: Unlike the array version this performs no copy. Acquiring another scan (through either
+   *       version) while a different lease is still held throws a SickConfigException.
+   */
+  void SickLD::GetSickMeasurements( SickScanLease< uint16_t > &scan_lease, const bool get_echoes )
+    throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException ){
+
+    /* Return the caller's previous lease (if any) before overwriting the buffer */
+    scan_lease.Release();
+
+    /* Acquire a new scan profile into the driver's buffer */
+    _acquireSickScanProfile(get_echoes);
+
+    /* Lend out a view of each active sector */
+    scan_lease.Grant(&_sick_scan_leased);
+    for (unsigned int i = 0; i < _sick_sector_config.sick_num_active_sectors; i++) {
+
+      const sick_ld_sector_data_t &sector_data = _sick_scan_profile.sector_data[_sick_sector_config.sick_active_sector_ids[i]];
+      scan_lease.AddSector(SickScanView< uint16_t >(sector_data.range_values,(get_echoes ? sector_data.echo_values : NULL),
+						    sector_data.num_data_points,SICK_RANGE_SCALE,
+						    sector_data.angle_start,sector_data.angle_step,
+						    sector_data.timestamp_start,sector_data.timestamp_stop),
+			   sector_data.sector_num);
+
+    }
+
+    /* Success */
+
+  }
+
   /**
    * \brief Attempts to set a new sensor ID for the device (in flash)
    * \param sick_sensor_id The desired sensor ID
@@ -1653,6 +1525,20 @@ namespace SickToolbox {
     std::cout << GetSickSectorConfigAsString() << std::flush;
   }
 
+  /**
+   * \brief Enables the persistent device-profile cache
+   * \param cache_dir Directory in which to keep the profile (empty disables the cache)
+   *
+   * NOTE: With the cache enabled, Initialize only queries the serial number and
+   *       firmware version. If both match the stored profile, the identity, Ethernet,
+   *       global and sector configs are taken from the cache instead of the device.
+   *       Changes made to the flash config with another tool will not be noticed
+   *       until the profile file is removed.
+   */
+  void SickLD::SetProfileCacheDirectory( const std::string cache_dir ) {
+    _sick_profile_cache.SetDirectory(cache_dir);
+  }
+
   /**
    * \brief Tear down the connection between the host and the Sick LD
    */
@@ -1844,10 +1730,15 @@ namespace SickToolbox {
       
       /* Acquire current configuration */
       _getSickStatus();
-      _getSickIdentity();
-      _getSickEthernetConfig();
-      _getSickGlobalConfig();
-      _getSickSectorConfig();
+
+      /* Skip the full sync if the cached profile still matches */
+      if (!_loadProfileCache()) {
+	_getSickIdentity();
+	_getSickEthernetConfig();
+	_getSickGlobalConfig();
+	_getSickSectorConfig();
+	_storeProfileCache();
+      }
 
       /* Reset Sick signals */
       _setSickSignals();
@@ -1881,6 +1772,146 @@ namespace SickToolbox {
     /* Success */
   }
 
+  /**
+   * \brief Restores the driver's identity/config from the profile cache.
+   * \return True if the cached profile matches the connected device
+   *
+   * NOTE: Only the serial number and firmware version are queried as a fingerprint.
+   */
+  bool SickLD::_loadProfileCache( ) throw( SickTimeoutException, SickIOException ) {
+
+    /* Nothing to do if the cache is disabled or empty */
+    if (!_sick_profile_cache.Load(_sick_ip_address)) {
+      return false;
+    }
+
+    std::string cached_serial_number, cached_firmware_version;
+    if (!_sick_profile_cache.GetString("serial_number",cached_serial_number) ||
+	!_sick_profile_cache.GetString("firmware_version",cached_firmware_version)) {
+      return false;
+    }
+
+    try {
+
+      /* Acquire the fingerprint */
+      _getSensorSerialNumber();
+      _getFirmwareVersion();
+
+    }
+
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle I/O exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLD::_loadProfileCache: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    /* A different unit (or new firmware) at this address */
+    if (cached_serial_number != _sick_identity.sick_serial_number ||
+	cached_firmware_version != _sick_identity.sick_firmware_version) {
+      std::cout << "\t\tCached profile does not match device, doing full sync..." << std::endl;
+      return false;
+    }
+
+    /* Restore into temporaries so a partial profile leaves the driver untouched */
+    sick_ld_identity_t sick_identity = _sick_identity;
+    sick_ld_config_ethernet_t sick_ethernet_config;
+    sick_ld_config_global_t sick_global_config;
+    sick_ld_config_sector_t sick_sector_config;
+
+    if (!_sick_profile_cache.GetString("part_number",sick_identity.sick_part_number) ||
+	!_sick_profile_cache.GetString("name",sick_identity.sick_name) ||
+	!_sick_profile_cache.GetString("version",sick_identity.sick_version) ||
+	!_sick_profile_cache.GetString("edm_serial_number",sick_identity.sick_edm_serial_number) ||
+	!_sick_profile_cache.GetString("firmware_part_number",sick_identity.sick_firmware_part_number) ||
+	!_sick_profile_cache.GetString("firmware_name",sick_identity.sick_firmware_name) ||
+	!_sick_profile_cache.GetString("application_software_part_number",sick_identity.sick_application_software_part_number) ||
+	!_sick_profile_cache.GetString("application_software_name",sick_identity.sick_application_software_name) ||
+	!_sick_profile_cache.GetString("application_software_version",sick_identity.sick_application_software_version) ||
+	!_sick_profile_cache.GetValues("ip_address",sick_ethernet_config.sick_ip_address,4) ||
+	!_sick_profile_cache.GetValues("subnet_mask",sick_ethernet_config.sick_subnet_mask,4) ||
+	!_sick_profile_cache.GetValues("gateway_ip_address",sick_ethernet_config.sick_gateway_ip_address,4) ||
+	!_sick_profile_cache.GetValue("node_id",sick_ethernet_config.sick_node_id) ||
+	!_sick_profile_cache.GetValue("transparent_tcp_port",sick_ethernet_config.sick_transparent_tcp_port) ||
+	!_sick_profile_cache.GetValue("sensor_id",sick_global_config.sick_sensor_id) ||
+	!_sick_profile_cache.GetValue("motor_speed",sick_global_config.sick_motor_speed) ||
+	!_sick_profile_cache.GetValue("angle_step",sick_global_config.sick_angle_step) ||
+	!_sick_profile_cache.GetValue("num_active_sectors",sick_sector_config.sick_num_active_sectors) ||
+	!_sick_profile_cache.GetValue("num_initialized_sectors",sick_sector_config.sick_num_initialized_sectors) ||
+	!_sick_profile_cache.GetValues("active_sector_ids",sick_sector_config.sick_active_sector_ids,SICK_MAX_NUM_SECTORS) ||
+	!_sick_profile_cache.GetValues("sector_functions",sick_sector_config.sick_sector_functions,SICK_MAX_NUM_SECTORS) ||
+	!_sick_profile_cache.GetValues("sector_start_angles",sick_sector_config.sick_sector_start_angles,SICK_MAX_NUM_SECTORS) ||
+	!_sick_profile_cache.GetValues("sector_stop_angles",sick_sector_config.sick_sector_stop_angles,SICK_MAX_NUM_SECTORS)) {
+      return false;
+    }
+
+    /* Sanity check the sector config before trusting it */
+    if (sick_sector_config.sick_num_active_sectors > SICK_MAX_NUM_SECTORS ||
+	sick_sector_config.sick_num_initialized_sectors > SICK_MAX_NUM_SECTORS) {
+      return false;
+    }
+
+    _sick_identity = sick_identity;
+    _sick_ethernet_config = sick_ethernet_config;
+    _sick_global_config = sick_global_config;
+    _sick_sector_config = sick_sector_config;
+
+    std::cout << "\t\tRestored cached profile for S/N " << _sick_identity.sick_serial_number << std::endl;
+
+    /* Success */
+    return true;
+  }
+
+  /**
+   * \brief Writes the driver's identity/config to the profile cache (if enabled)
+   */
+  void SickLD::_storeProfileCache( ) {
+
+    if (!_sick_profile_cache.IsEnabled()) {
+      return;
+    }
+
+    _sick_profile_cache.Clear();
+    _sick_profile_cache.SetString("part_number",_sick_identity.sick_part_number);
+    _sick_profile_cache.SetString("name",_sick_identity.sick_name);
+    _sick_profile_cache.SetString("version",_sick_identity.sick_version);
+    _sick_profile_cache.SetString("serial_number",_sick_identity.sick_serial_number);
+    _sick_profile_cache.SetString("edm_serial_number",_sick_identity.sick_edm_serial_number);
+    _sick_profile_cache.SetString("firmware_part_number",_sick_identity.sick_firmware_part_number);
+    _sick_profile_cache.SetString("firmware_name",_sick_identity.sick_firmware_name);
+    _sick_profile_cache.SetString("firmware_version",_sick_identity.sick_firmware_version);
+    _sick_profile_cache.SetString("application_software_part_number",_sick_identity.sick_application_software_part_number);
+    _sick_profile_cache.SetString("application_software_name",_sick_identity.sick_application_software_name);
+    _sick_profile_cache.SetString("application_software_version",_sick_identity.sick_application_software_version);
+    _sick_profile_cache.SetValues("ip_address",_sick_ethernet_config.sick_ip_address,4);
+    _sick_profile_cache.SetValues("subnet_mask",_sick_ethernet_config.sick_subnet_mask,4);
+    _sick_profile_cache.SetValues("gateway_ip_address",_sick_ethernet_config.sick_gateway_ip_address,4);
+    _sick_profile_cache.SetValue("node_id",_sick_ethernet_config.sick_node_id);
+    _sick_profile_cache.SetValue("transparent_tcp_port",_sick_ethernet_config.sick_transparent_tcp_port);
+    _sick_profile_cache.SetValue("sensor_id",_sick_global_config.sick_sensor_id);
+    _sick_profile_cache.SetValue("motor_speed",_sick_global_config.sick_motor_speed);
+    _sick_profile_cache.SetValue("angle_step",_sick_global_config.sick_angle_step);
+    _sick_profile_cache.SetValue("num_active_sectors",_sick_sector_config.sick_num_active_sectors);
+    _sick_profile_cache.SetValue("num_initialized_sectors",_sick_sector_config.sick_num_initialized_sectors);
+    _sick_profile_cache.SetValues("active_sector_ids",_sick_sector_config.sick_active_sector_ids,SICK_MAX_NUM_SECTORS);
+    _sick_profile_cache.SetValues("sector_functions",_sick_sector_config.sick_sector_functions,SICK_MAX_NUM_SECTORS);
+    _sick_profile_cache.SetValues("sector_start_angles",_sick_sector_config.sick_sector_start_angles,SICK_MAX_NUM_SECTORS);
+    _sick_profile_cache.SetValues("sector_stop_angles",_sick_sector_config.sick_sector_stop_angles,SICK_MAX_NUM_SECTORS);
+    _sick_profile_cache.Store(_sick_ip_address);
+
+  }
+
   /** \brief Sets the function for a particular scan sector.
    *  \param sector_number The number of the sector (should be in [0,7])
    *  \param sector_function The function of the sector (e.g. no measurement, reserved, normal measurement, ...)
@@ -2512,6 +2543,196 @@ namespace SickToolbox {
     /* Success */
   }
 
+  /**
+   * \brief Receives the next scan profile into _sick_scan_profile (setting up the stream if needed)
+   * \param get_echoes Indicates whether a RANGE+ECHO stream (as opposed to RANGE-ONLY) is wanted
+   */
+  void SickLD::_acquireSickScanProfile( const bool get_echoes )
+    throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException ){
+
+    /* Ensure the device has been initialized */
+    if(!_sick_initialized) {
+      throw SickIOException("SickLD::_acquireSickScanProfile: Device NOT Initialized!!!");
+    }
+
+    /* Ensure the buffer isn't still lent out */
+    if (_sick_scan_leased) {
+      throw SickConfigException("SickLD::_acquireSickScanProfile: Scan buffer is still leased!");
+    }
+  
+    /* The following conditional holds true if the user wants a RANGE+ECHO data
+     * stream but already has an active RANGE-ONLY stream.
+     */
+    if (_sick_streaming_range_data && get_echoes) {
+
+      try {
+	
+        /* Cancel the current RANGE-ONLY data stream */
+        _cancelSickScanProfiles();
+
+        /* Request a RANGE+ECHO data stream */
+        _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE_AND_ECHO);
+
+      }
+
+      /* Handle a timeout! */
+      catch (SickTimeoutException &sick_timeout_exception) {
+	std::cerr << sick_timeout_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle I/O exceptions */
+      catch (SickIOException &sick_io_exception) {
+	std::cerr << sick_io_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle a returned error code */
+      catch (SickErrorException &sick_error_exception) {
+	std::cerr << sick_error_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* A safety net */
+      catch (...) {
+	std::cerr << "SickLMS::GetSickMeasurements: Unknown exception!!!" << std::endl;
+	throw;
+      }  
+      
+    }
+
+    /* The following conditional holds true if the user wants a RANGE-ONLY data
+     * stream but already has an active RANGE+ECHO stream.
+     */
+    if (_sick_streaming_range_and_echo_data && !get_echoes) {
+
+      try {
+
+	/* Cancel the current RANGE+ECHO data stream */
+        _cancelSickScanProfiles();
+
+        /* Request a RANGE-ONLY data stream */
+        _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE);
+	
+      }
+      
+      /* Handle a timeout! */
+      catch (SickTimeoutException &sick_timeout_exception) {
+	std::cerr << sick_timeout_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle I/O exceptions */
+      catch (SickIOException &sick_io_exception) {
+	std::cerr << sick_io_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle a returned error code */
+      catch (SickErrorException &sick_error_exception) {
+	std::cerr << sick_error_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* A safety net */
+      catch (...) {
+	std::cerr << "SickLMS::GetSickMeasurements: Unknown exception!!!" << std::endl;
+	throw;
+      }  
+      
+    }
+
+    /* If there aren't any active data streams, setup a new one */
+    if (!_sick_streaming_range_data && !_sick_streaming_range_and_echo_data) {
+
+      try {
+      
+	/* Determine the target data stream by checking the value of get_echoes */
+	if (get_echoes) {
+	  
+	  /* Request a RANGE+ECHO data stream */
+	  _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE_AND_ECHO);	  
+	  
+	}
+	else {
+	  
+	  /* Request a RANGE+ONLY data stream */
+	  _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE);
+	  
+	}
+
+      }
+
+      /* Handle a timeout! */
+      catch (SickTimeoutException &sick_timeout_exception) {
+	std::cerr << sick_timeout_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle I/O exceptions */
+      catch (SickIOException &sick_io_exception) {
+	std::cerr << sick_io_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* Handle a returned error code */
+      catch (SickErrorException &sick_error_exception) {
+	std::cerr << sick_error_exception.what() << std::endl;
+	throw;
+      }
+      
+      /* A safety net */
+      catch (...) {
+	std::cerr << "SickLMS::_setSickSensorMode: Unknown exception!!!" << std::endl;
+	throw;
+      }  
+      
+    }
+
+    /* Declare the receive message object */
+    SickLDMessage recv_message;
+  
+    /* Acquire the most recently buffered message */
+    try {
+      _recvMessage(recv_message,(unsigned int)1e6);
+    }
+    
+    catch(SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }  
+
+    catch(...) {
+      std::cerr << "SickLD::_acquireSickScanProfile - Unknown exception!" << std::endl;
+      throw;
+    }
+    
+    /* A single buffer for payload contents */
+    uint8_t payload_buffer[SickLDMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+
+    /* Get the message payload */
+    recv_message.GetPayload(payload_buffer);
+
+    /* Extract the scan profile (into the driver's own buffer) */
+    sick_ld_scan_profile_t &profile_data = _sick_scan_profile;
+    _parseScanProfile(&payload_buffer[2],profile_data);
+    SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+
+    /* Update and check the returned sensor status */
+    if ((_sick_sensor_mode = profile_data.sensor_status) != SICK_SENSOR_MODE_MEASURE) {
+      throw SickConfigException("SickLD::_acquireSickScanProfile: Unexpected sensor mode! " + _sickSensorModeToString(_sick_sensor_mode));
+    }
+
+    /* Update and check the returned motor status */
+    if ((_sick_motor_mode = profile_data.motor_status) != SICK_MOTOR_MODE_OK) {
+      throw SickConfigException("SickLD::_acquireSickScanProfile: Unexpected motor mode! (Are you using a valid motor speed!)");
+    }
+
+    /* Success */
+    SICK_LATENCY_RECORD(_sick_latency,recv_message);
+
+  }
+
   /**
    * \brief Parses a well-formed sequence of bytes into a corresponding scan profile
    * \param *src_buffer The source data buffer
@@ -2615,25 +2836,20 @@ namespace SickToolbox {
       /* Acquire the range and echo values for the sector */
       for (unsigned int j=0; j < profile_data.sector_data[i].num_data_points; j++) {
 
-	/* Check if DISTANCE-n is included */
+	/* Check if DISTANCE-n is included (kept raw, see SICK_RANGE_SCALE) */
 	if (profile_format & 0x0100) {
 	  memcpy(&temp_buffer,&src_buffer[data_offset],2);
-	  profile_data.sector_data[i].range_values[j] = ((double)sick_ld_to_host_byte_order(temp_buffer))/256;
+	  profile_data.sector_data[i].range_values[j] = sick_ld_to_host_byte_order(temp_buffer);
 	  data_offset += 2;
 	}
 	else {
 	  profile_data.sector_data[i].range_values[j] = 0;
 	}
       
-	/* Check if DIRECTION-n is included */
+	/* Skip DIRECTION-n if included (angles are derived from STARTDIR/DIRSTEP) */
 	if (profile_format & 0x0200) {
-	  memcpy(&temp_buffer,&src_buffer[data_offset],2);
-	  profile_data.sector_data[i].scan_angles[j] = ((double)sick_ld_to_host_byte_order(temp_buffer))/16;
 	  data_offset += 2;
 	}
-	else {
-	  profile_data.sector_data[i].scan_angles[j] = 0;
-	}
       
 	/* Check if ECHO-n is included */
 	if (profile_format & 0x0400) {
@@ -3078,6 +3294,9 @@ namespace SickToolbox {
     _sick_global_config.sick_sensor_id = sick_sensor_id;
     _sick_global_config.sick_motor_speed = sick_motor_speed;
     _sick_global_config.sick_angle_step = sick_angle_step;  
+
+    /* The flash config changed, so refresh the cached profile */
+    _storeProfileCache();
     
     /* Success! */
   }
@@ -3949,6 +4168,9 @@ namespace SickToolbox {
       std::cerr << "SickLMS::_setSickTemporaryScanAreas: Unknown exception!!!" << std::endl;
       throw;
     }  
+
+    /* The active sectors no longer match flash, so don't trust the cached profile */
+    _sick_profile_cache.Invalidate(_sick_ip_address);
     
     /* Success! */ 
   }
@@ -4573,7 +4795,7 @@ namespace SickToolbox {
    * \param print_sector_data Indicates whether to print the sector data fields associated
    *                          with the given profile.
    */
-  void SickLD::_printSickScanProfile( const sick_ld_scan_profile_t profile_data, const bool print_sector_data ) const {
+  void SickLD::_printSickScanProfile( const sick_ld_scan_profile_t &profile_data, const bool print_sector_data ) const {
   
     std::cout << "\t========= Sick Scan Prof. =========" << std::endl;
     std::cout << "\tProfile Num.: " << profile_data.profile_number << std::endl;
@@ -49,6 +49,7 @@ namespace SickToolbox {
     uint8_t checksum = 0;  
     uint8_t message_buffer[SickLDMessage::MESSAGE_MAX_LENGTH] = {0};
     uint32_t payload_length = 0;
+    bool resynced = false, frame_started = false;
 
     try {
 
@@ -64,9 +65,14 @@ namespace SickToolbox {
 	}
 	else {
 	  i = 0;
+	  if (!resynced) {
+	    _sick_health.Resync();
+	    resynced = true;
+	  }
 	}
 	
       }  
+      frame_started = true;
       
       /* Populate message buffer w/ response header */
       memcpy(message_buffer,sick_response_header,4);
@@ -105,11 +111,17 @@ namespace SickToolbox {
 
     }
 
-    catch(SickTimeoutException &sick_timeout) { /* This is ok! */ }
+    catch(SickTimeoutException &sick_timeout) {
+      /* This is ok! (unless a frame was cut short) */
+      if (frame_started) {
+	_sick_health.FrameTimeout();
+      }
+    }
     
     /* Catch a bad checksum! */
     catch(SickBadChecksumException &sick_checksum_exception) {
       sick_message.Clear(); // Clear the message container
+      _sick_health.ChecksumFailure();
     }
     
     /* Catch any serious IO buffer exceptions */
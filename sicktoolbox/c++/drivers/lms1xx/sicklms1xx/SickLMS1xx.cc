@@ -59,6 +59,7 @@ namespace SickToolbox {
     _sick_streaming(false)
   {
     memset(&_sick_scan_config,0,sizeof(sick_lms_1xx_scan_config_t));
+    SICK_LATENCY_LABEL(_sick_latency,"SickLMS1xx " + sick_ip_address);
   }
 
   /**
@@ -378,6 +379,33 @@ namespace SickToolbox {
       throw;
     }
     
+    /* Extract the requested channels */
+    _parseSickScanData(recv_message,range_1_vals,range_2_vals,reflect_1_vals,reflect_2_vals,num_measurements,dev_status);
+    SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+
+    /* Success! */
+    SICK_LATENCY_RECORD(_sick_latency,recv_message);
+    
+  }
+
+  /**
+   * \brief Parses an LMDscandata telegram into the given buffers
+   * \param &recv_message The received scan telegram
+   * \param range_1_vals A buffer to hold the range measurements
+   * \param range_2_vals A buffer to hold the second pulse range measurements
+   * \param reflect_1_vals A buffer to hold the first pulse reflectivity
+   * \param reflect_2_vals A buffer to hold the second pulse reflectivity
+   * \param num_measurements The number of range measurements extracted
+   * \param dev_status The device status (if not NULL)
+   */
+  void SickLMS1xx::_parseSickScanData( const SickLMS1xxMessage &recv_message,
+				       unsigned int * const range_1_vals,
+				       unsigned int * const range_2_vals,
+				       unsigned int * const reflect_1_vals,
+				       unsigned int * const reflect_2_vals,
+				       unsigned int & num_measurements,
+				       unsigned int * const dev_status ) const throw ( SickIOException ) {
+
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH+1] = {0};
     
@@ -415,7 +443,7 @@ namespace SickToolbox {
       const char * substr_dist_1 = "DIST1";
       unsigned int substr_dist_1_pos = 0;
       if (!_findSubString((char *)payload_buffer,substr_dist_1,recv_message.GetPayloadLength()+1,5,substr_dist_1_pos)) {
-	throw SickIOException("SickLMS1xx::GetSickMeasurements: _findSubString() failed!");
+	throw SickIOException("SickLMS1xx::_parseSickScanData: _findSubString() failed!");
       }
       
       /* Extract Num DIST1 Values */
@@ -458,7 +486,7 @@ namespace SickToolbox {
 	}
       }
       else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse range values, which are not being streamed! ";
+	std::cerr << "SickLMS1xx::_parseSickScanData: WARNING! It seems you are expecting double-pulse range values, which are not being streamed! ";
 	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
       }
 	
@@ -489,7 +517,7 @@ namespace SickToolbox {
 	}
       }
       else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting single-pulse reflectivity values, which are not being streamed! ";
+	std::cerr << "SickLMS1xx::_parseSickScanData: WARNING! It seems you are expecting single-pulse reflectivity values, which are not being streamed! ";
 	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
       }
 	  
@@ -520,7 +548,7 @@ namespace SickToolbox {
 	}
       }
       else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse reflectivity values, which are not being streamed! ";
+	std::cerr << "SickLMS1xx::_parseSickScanData: WARNING! It seems you are expecting double-pulse reflectivity values, which are not being streamed! ";
 	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
       }
 
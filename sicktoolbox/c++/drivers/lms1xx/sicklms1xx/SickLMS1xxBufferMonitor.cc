@@ -43,20 +43,30 @@ namespace SickToolbox {
     /* Flush the input buffer */
     uint8_t byte_buffer = 0;
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    bool resynced = false, frame_started = false;
     
     try {
 
       /* Flush the TCP receive buffer */
-      _flushTCPRecvBuffer();
+      if (_flushTCPRecvBuffer() > 0) {
+	_sick_health.Resync();
+	resynced = true;
+      }
 
       /* Search for STX in the byte stream */
       do {
 	
  	/* Grab the next byte from the stream */
  	_readBytes(&byte_buffer,1,DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT);
+
+	if (byte_buffer != 0x02 && !resynced) {
+	  _sick_health.Resync();
+	  resynced = true;
+	}
 	
       }
       while (byte_buffer != 0x02);
+      frame_started = true;
       
       /* Ok, now acquire the payload! (until ETX) */
       int payload_length = 0;
@@ -80,7 +90,12 @@ namespace SickToolbox {
       
     }
     
-    catch(SickTimeoutException &sick_timeout) { /* This is ok! */ }
+    catch(SickTimeoutException &sick_timeout) {
+      /* This is ok! (unless a frame was cut short) */
+      if (frame_started) {
+	_sick_health.FrameTimeout();
+      }
+    }
     
     /* Catch any serious IO buffer exceptions */
     catch(SickIOException &sick_io_exception) {
@@ -96,8 +111,9 @@ namespace SickToolbox {
 
   /**
    * \brief Flushes TCP receive buffer contents
+   * \return The number of bytes discarded
    */
-  void SickLMS1xxBufferMonitor::_flushTCPRecvBuffer( ) const throw (SickIOException) {
+  unsigned int SickLMS1xxBufferMonitor::_flushTCPRecvBuffer( ) const throw (SickIOException) {
     
     char null_byte;
     int num_bytes_waiting = 0;    
@@ -116,6 +132,10 @@ namespace SickToolbox {
       }	  
       
     }
+
+    /* Flushed bytes were still read off the wire */
+    _sick_health.BytesRead(num_bytes_waiting);
+    return num_bytes_waiting;
     
   }
   
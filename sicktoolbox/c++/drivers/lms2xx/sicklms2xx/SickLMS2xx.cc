@@ -17,7 +17,9 @@
 #include <sicktoolbox/SickConfig.hh>
 
 /* Implementation dependencies */
+#include <vector>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 #include <termios.h>
 #include <sys/ioctl.h>
@@ -47,9 +49,11 @@ namespace SickToolbox {
 								_curr_session_baud(SICK_BAUD_UNKNOWN),
 								_desired_session_baud(SICK_BAUD_UNKNOWN),
 								_sick_type(SICK_LMS_TYPE_UNKNOWN),
+								_sick_scan_leased(false),
 								_sick_mean_value_sample_size(0),
 								_sick_values_subrange_start_index(0),
-								_sick_values_subrange_stop_index(0)
+								_sick_values_subrange_stop_index(0),
+								_sick_low_latency(false)
   {
     
     /* Initialize the protected/private structs */
@@ -61,7 +65,10 @@ namespace SickToolbox {
     memset(&_sick_field_status,0,sizeof(sick_lms_2xx_field_status_t));
     memset(&_sick_baud_status,0,sizeof(sick_lms_2xx_baud_status_t));
     memset(&_sick_device_config,0,sizeof(sick_lms_2xx_device_config_t));
+    memset(&_sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_b0_t));
     memset(&_old_term,0,sizeof(struct termios));
+
+    SICK_LATENCY_LABEL(_sick_latency,"SickLMS2xx " + sick_device_path);
     
   }
 
@@ -100,6 +107,9 @@ namespace SickToolbox {
 
     /* Buffer the desired baud rate in case we have to reset */
     _desired_session_baud = desired_baud_rate;
+
+    /* Where the LMS was last seen (earlier in this run, else in a previous one) */
+    const sick_lms_2xx_baud_t hint_baud = _curr_session_baud != SICK_BAUD_UNKNOWN ? _curr_session_baud : _loadBaudHint();
     
     try {
     
@@ -122,46 +132,17 @@ namespace SickToolbox {
 	std::cout << "\t\tBuffer monitor reset!" << std::endl;       
       }
 
-      try {
-
-	std::cout << "\tAttempting to set requested baud rate..." << std::endl;
-	_setSessionBaud(_desired_session_baud);
-	
+      /* Find the LMS before talking to it at any particular rate */
+      std::cout << "\tAttempting to detect LMS baud rate..." << std::endl << std::flush;
+      if (_detectSickBaud(hint_baud) == SICK_BAUD_UNKNOWN) {
+	_stopListening();
+	throw SickIOException("SickLMS2xx::Initialize: failed to detect baud rate!");
       }
 
-      /* Assume a timeout is due to a misconfigured terminal baud */
-      catch(SickTimeoutException &sick_timeout) {
-      
-	/* Check whether to do an autodetect */
-	sick_lms_2xx_baud_t default_baud = _baudToSickBaud(DEFAULT_SICK_LMS_2XX_SICK_BAUD);
-	std::cout << "\tFailed to set requested baud rate..." << std::endl << std::flush;
-	std::cout << "\tAttempting to detect LMS baud rate..." << std::endl << std::flush;
-	if((default_baud != SICK_BAUD_9600) && _testSickBaud(SICK_BAUD_9600)) {
-	  std::cout << "\t\tDetected LMS baud @ " << SickBaudToString(SICK_BAUD_9600) << "!" << std::endl;
-	} else if((default_baud != SICK_BAUD_19200) && _testSickBaud(SICK_BAUD_19200)) {
-	  std::cout << "\t\tDetected LMS baud @ " << SickBaudToString(SICK_BAUD_19200) << "!" << std::endl;
-	} else if((default_baud != SICK_BAUD_38400) && _testSickBaud(SICK_BAUD_38400)) {
-	  std::cout << "\t\tDetected LMS baud @ " << SickBaudToString(SICK_BAUD_38400) << "!" << std::endl;
-	} else if((default_baud) != SICK_BAUD_500K && _testSickBaud(SICK_BAUD_500K)) {
-	  std::cout << "\t\tDetected LMS baud @ " << SickBaudToString(SICK_BAUD_500K) << "!" << std::endl;
-	} else {
-          _stopListening();
-	  throw SickIOException("SickLMS2xx::Initialize: failed to detect baud rate!");	
-	}
-	std::cout << std::flush;
-	
-	/* Try again! */
-	if (_curr_session_baud != _desired_session_baud) {
-	  std::cout << "\tAttempting to setup desired baud (again)..." << std::endl << std::flush;
-	  _setSessionBaud(_desired_session_baud);	  
-	}
-	
-      }
-
-      /* Catch anything else */
-      catch(...) {
-	std::cerr << "SickLMS2xx::Initialize: Unknown exception!" << std::endl;
-	throw;
+      /* Only switch if it isn't there already */
+      if (_curr_session_baud != _desired_session_baud) {
+	std::cout << "\tAttempting to set requested baud rate..." << std::endl << std::flush;
+	_setSessionBaud(_desired_session_baud);
       }
 
       std::cout << "\t\tOperating @ " << SickBaudToString(_curr_session_baud) << std::endl;     
@@ -171,9 +152,14 @@ namespace SickToolbox {
       
       /* Acquire the type of device that we are working with */
       std::cout << "\tAttempting to sync driver..." << std::endl << std::flush;
-      _getSickType();     // Get the Sick device type string
       _getSickStatus();   // Get the Sick device status
-      _getSickConfig();   // Get the Sick current config
+
+      /* The status reply doubles as the cache fingerprint */
+      if (!_loadProfileCache()) {
+	_getSickType();   // Get the Sick device type string
+	_storeProfileCache();
+      }
+      _getSickConfig();   // Get the Sick current config (always, another tool may have changed it)
       std::cout << "\t\tDriver synchronized!" << std::endl << std::flush;
 
       /* Set the flag */
@@ -1017,6 +1003,7 @@ namespace SickToolbox {
 
       /* Parse the message payload */
       _parseSickScanProfileB0(&payload_buffer[1],sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
 
       /* Return the request values! */
       num_measurement_values = sick_scan_profile.sick_num_measurements;
@@ -1053,6 +1040,9 @@ namespace SickToolbox {
 	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
       }
 
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
     }
 
     /* Handle any config exceptions */
@@ -1087,6 +1077,113 @@ namespace SickToolbox {
 
   }
 
+  /**
+   * \brief Returns the most recent measured values by lending out the driver's scan buffer
+   * \param &scan_lease Receives a single view of the raw measurements (in the current measuring units).
+   *                    The view remains valid until the lease is released.
+   * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
+   * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   *
+   * NOTE: Unlike the array version this performs no copy. Angles are given in the device
+   *       frame (0 deg at the right-hand end of a 180 deg scan). Acquiring another scan
+   *       through this function while a different lease is still held throws a SickConfigException.
+   */
+  void SickLMS2xx::GetSickScan( SickScanLease< uint16_t > &scan_lease,
+			     unsigned int * const sick_telegram_index,
+			     unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+
+    /* Ensure the device is initialized */
+    if (!_sick_initialized) {
+      throw SickConfigException("SickLMS2xx::GetSickScan: Sick LMS is not initialized!");
+    }
+
+    /* Return the caller's previous lease (if any) and ensure no other lease is held */
+    scan_lease.Release();
+    if (_sick_scan_leased) {
+      throw SickConfigException("SickLMS2xx::GetSickScan: Scan buffer is still leased!");
+    }
+
+    /* Declare message objects */
+    SickLMS2xxMessage response;
+
+    /* Declare some useful variables and a buffer */
+    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+
+    try {
+
+      /* Restore original operating mode */
+      _setSickOpModeMonitorStreamValues();
+
+      /* Receive a data frame from the stream. */
+      _recvMessage(response,DEFAULT_SICK_LMS_2XX_SICK_MESSAGE_TIMEOUT);
+
+      /* Check that our payload has the proper command byte of 0xB0 */
+      if(response.GetCommandCode() != 0xB0) {
+	throw SickIOException("SickLMS2xx::GetSickScan: Unexpected message!");
+      }
+
+      /* Acquire the payload buffer and length*/
+      response.GetPayload(payload_buffer);
+
+      /* Parse the message payload straight into the driver's buffer */
+      _sick_scan_profile.sick_num_measurements = 0;
+      _parseSickScanProfileB0(&payload_buffer[1],_sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
+
+      /* Lend out the measurements */
+      const double scan_angle = GetSickScanAngle();
+      scan_lease.Grant(&_sick_scan_leased);
+      scan_lease.AddSector(SickScanView< uint16_t >(_sick_scan_profile.sick_measurements,NULL,
+						    _sick_scan_profile.sick_num_measurements,1.0,
+						    (180.0 - scan_angle)/2,GetSickScanResolution(),0,0));
+
+      /* If requested, copy the real time scan index */
+      if(sick_real_time_scan_index) {
+	*sick_real_time_scan_index = _sick_scan_profile.sick_real_time_scan_index;
+      }
+
+      /* If requested, copy the telegram index */
+      if(sick_telegram_index) {
+	*sick_telegram_index = _sick_scan_profile.sick_telegram_index;
+      }
+
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
+    }
+
+    /* Handle any config exceptions */
+    catch(SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle a timeout exception */
+    catch(SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle any I/O exceptions */
+    catch(SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle any thread exceptions */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle anything else */
+    catch(...) {
+      std::cerr << "SickLMS2xx::GetSickScan: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+  }
+
   /**
    * \brief Acquires both range and reflectivity values from the Sick LMS 211/221/291-S14 (LMS-FAST)
    * \param *range_values The buffer in which range measurements will be stored
@@ -1149,6 +1246,7 @@ namespace SickToolbox {
 
       /* Parse the message payload */
       _parseSickScanProfileC4(&payload_buffer[1],sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
 
       /* Return the requested values! */
       num_range_measurements = sick_scan_profile.sick_num_range_measurements;
@@ -1190,7 +1288,10 @@ namespace SickToolbox {
       if(sick_real_time_scan_index) {
 	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
       }
-      
+
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
     }
 
     /* Handle any config exceptions */
@@ -1292,6 +1393,7 @@ namespace SickToolbox {
 
       /* Parse the message payload */
       _parseSickScanProfileB7(&payload_buffer[1],sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
 
       /* Return the request values! */
       num_measurement_values = sick_scan_profile.sick_num_measurements;
@@ -1328,6 +1430,9 @@ namespace SickToolbox {
 	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
       }
 
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
     }
 
     /* Handle any config exceptions */
@@ -1429,6 +1534,7 @@ namespace SickToolbox {
 
       /* Parse the message payload */
       _parseSickScanProfileB0(&payload_buffer[1],sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
 
       /* Return the request values! */
       num_measurement_values = sick_scan_profile.sick_num_measurements;
@@ -1468,6 +1574,9 @@ namespace SickToolbox {
 	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
       }
 
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
     }
 
     /* Handle any config exceptions */
@@ -1557,6 +1666,7 @@ namespace SickToolbox {
 
       /* Parse the message payload */
       _parseSickScanProfileB6(&payload_buffer[1],sick_scan_profile);
+      SICK_LATENCY_STAMP(response,SICK_LATENCY_PARSE_COMPLETE);
 
       /* Return the request values! */
       num_measurement_values = sick_scan_profile.sick_num_measurements;
@@ -1576,6 +1686,9 @@ namespace SickToolbox {
 	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
       }
 
+      /* Account for the scan latency */
+      SICK_LATENCY_RECORD(_sick_latency,response);
+
     }
 
     /* Handle any config exceptions */
@@ -2000,6 +2113,33 @@ namespace SickToolbox {
   void SickLMS2xx::PrintSickConfig() const {
     std::cout << GetSickConfigAsString() << std::endl;
   }
+
+  /**
+   * \brief Enables the persistent device-profile cache
+   * \param cache_dir Directory in which to keep the profile (empty disables the cache)
+   *
+   * NOTE: Only the device type is cached. The LMS 2xx has no serial number
+   *       telegram, so the profile is keyed by device path and fingerprinted by
+   *       the software versions in the status reply (which is always requested).
+   *       The config is read from the device on every start.
+   */
+  void SickLMS2xx::SetProfileCacheDirectory( const std::string cache_dir ) {
+    _sick_profile_cache.SetDirectory(cache_dir);
+  }
+
+  /**
+   * \brief Enables the low-latency serial mode
+   * \param low_latency Whether to use it
+   *
+   * Frames are then read w/ blocking reads that each ask for all the bytes
+   * still missing (VMIN permitting), instead of waking for every byte, and under Linux
+   * the port is flagged ASYNC_LOW_LATENCY (which also takes USB-serial
+   * adapters' receive latency timer down to 1 ms).
+   */
+  void SickLMS2xx::SetLowLatencySerial( const bool low_latency ) {
+    _sick_low_latency = low_latency;
+    _sick_buffer_monitor->SetLowLatency(low_latency);
+  }
   
   /**
    * \brief Converts the Sick LMS type to a corresponding string
@@ -2335,6 +2475,11 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::_setupConnection: - Unable to open serial port");
       }
 
+      /* Low latency: blocking reads, so VMIN and VTIME take effect */
+      if (_sick_low_latency && fcntl(_sick_fd,F_SETFL,fcntl(_sick_fd,F_GETFL) & ~O_NONBLOCK) < 0) {
+	throw SickIOException("SickLMS2xx::_setupConnection: fcntl() failed!");
+      }
+
       // Sleep to allow the SICK to power on for some applications
       sleep(delay);
       
@@ -2551,6 +2696,7 @@ namespace SickToolbox {
 
       /* Set the host terminal baud rate to the new speed */
       _setTerminalBaud(baud_rate);
+      _storeBaudHint();
 
       /* Sick likes a sleep here */
       usleep(250000);
@@ -2586,8 +2732,11 @@ namespace SickToolbox {
   /**
    * \brief Attempts to detect whether the LMS is operating at the given baud rate
    * \param baud_rate The baud rate to use when "pinging" the Sick LMS 2xx
+   * \param timeout_value How long to wait for each reply (in usecs)
+   * \param num_tries The number of times to send the ping
    */
-  bool SickLMS2xx::_testSickBaud(const sick_lms_2xx_baud_t baud_rate) throw( SickIOException, SickThreadException ) {
+  bool SickLMS2xx::_testSickBaud( const sick_lms_2xx_baud_t baud_rate, const unsigned int timeout_value,
+				  const unsigned int num_tries ) throw( SickIOException, SickThreadException ) {
 
     try {
     
@@ -2604,8 +2753,11 @@ namespace SickToolbox {
       
       try {
 
-	/* Check to see if the Sick replies! */
-	_getSickErrors();
+	/* Check to see if the Sick replies to an error status request! */
+	SickLMS2xxMessage message, response;
+	uint8_t payload = 0x32;
+	message.BuildMessage(DEFAULT_SICK_LMS_2XX_SICK_ADDRESS,&payload,1);
+	_sendMessageAndGetReply(message,response,timeout_value,num_tries);
 
       }
 
@@ -2646,6 +2798,53 @@ namespace SickToolbox {
 
   }
 
+  /**
+   * \brief Finds the baud rate the LMS is operating at
+   * \param hint_baud Where the LMS was last seen (SICK_BAUD_UNKNOWN if nowhere)
+   * \return The detected rate (also the terminal's), or SICK_BAUD_UNKNOWN
+   *
+   * Rates are pinged likeliest first: the hint, the power-on rate, the
+   * desired rate, then the rest.  The first pass waits only briefly for
+   * each reply and every further pass waits twice as long (up to the
+   * usual message timeout), so a responsive LMS is found in a fraction of
+   * a second and a slow one still is eventually.
+   */
+  sick_lms_2xx_baud_t SickLMS2xx::_detectSickBaud( const sick_lms_2xx_baud_t hint_baud ) throw( SickIOException, SickThreadException ) {
+
+    const sick_lms_2xx_baud_t likely_bauds[] = { hint_baud, _baudToSickBaud(DEFAULT_SICK_LMS_2XX_SICK_BAUD), _desired_session_baud,
+						 SICK_BAUD_9600, SICK_BAUD_19200, SICK_BAUD_38400, SICK_BAUD_500K };
+    const unsigned int num_likely_bauds = sizeof(likely_bauds)/sizeof(sick_lms_2xx_baud_t);
+
+    /* Drop the unknowns and repeats */
+    std::vector< sick_lms_2xx_baud_t > probe_bauds;
+    for (unsigned int i = 0; i < num_likely_bauds; i++) {
+      if (likely_bauds[i] != SICK_BAUD_UNKNOWN && std::find(probe_bauds.begin(),probe_bauds.end(),likely_bauds[i]) == probe_bauds.end()) {
+	probe_bauds.push_back(likely_bauds[i]);
+      }
+    }
+
+    for (unsigned int timeout_value = DEFAULT_SICK_LMS_2XX_BAUD_PROBE_TIMEOUT; ; timeout_value *= 2) {
+
+      timeout_value = std::min(timeout_value,(unsigned int)DEFAULT_SICK_LMS_2XX_SICK_MESSAGE_TIMEOUT);
+      for (unsigned int i = 0; i < probe_bauds.size(); i++) {
+	if (_testSickBaud(probe_bauds[i],timeout_value,1)) {
+	  std::cout << "\t\tDetected LMS baud @ " << SickBaudToString(probe_bauds[i]) << "!" << std::endl << std::flush;
+	  _storeBaudHint();
+	  return probe_bauds[i];
+	}
+      }
+
+      /* The last pass waited as long as any request does */
+      if (timeout_value == DEFAULT_SICK_LMS_2XX_SICK_MESSAGE_TIMEOUT) {
+	break;
+      }
+
+    }
+
+    return SICK_BAUD_UNKNOWN;
+
+  }
+
   /**
    * \brief Sets the local terminal baud rate
    * \param baud_rate The desired terminal baud rate
@@ -2673,6 +2872,9 @@ namespace SickToolbox {
 	/* Set the custom devisor */
 	serial.flags |= ASYNC_SPD_CUST;
 	serial.custom_divisor = 48; // for FTDI USB/serial converter divisor is 240/5
+	if (_sick_low_latency) {
+	  serial.flags |= ASYNC_LOW_LATENCY;
+	}
 	
 	/* Set the new attibute values */
 	if(ioctl(_sick_fd,TIOCSSERIAL,&serial) < 0) {
@@ -2697,6 +2899,9 @@ namespace SickToolbox {
 	
 	serial.custom_divisor = 0;
         serial.flags &= ~ASYNC_SPD_CUST;
+	if (_sick_low_latency) {
+	  serial.flags |= ASYNC_LOW_LATENCY;
+	}
 	
 	if(ioctl(_sick_fd,TIOCSSERIAL,&serial) < 0) {
 	  std::cerr << "SickLMS2xx::_setTerminalBaud: ioctl() failed while trying to set serial port info!" << std::endl;
@@ -2749,6 +2954,11 @@ namespace SickToolbox {
       
       /* Buffer the rate locally */
       _curr_session_baud = baud_rate;
+
+      /* The attributes were rewritten, so the monitor has to set VMIN again */
+      if (_sick_low_latency) {
+	_sick_buffer_monitor->SetLowLatency(true);
+      }
       
       /* Attempt to flush the I/O buffers */
       _flushTerminalBuffer();
@@ -2950,6 +3160,106 @@ namespace SickToolbox {
      
   }
 
+  /**
+   * \brief Restores the device type from the profile cache
+   * \return True if the cached profile matches the connected device
+   *
+   * NOTE: Expects _getSickStatus() to have been called beforehand.
+   */
+  bool SickLMS2xx::_loadProfileCache( ) {
+
+    /* Nothing to do if the cache is disabled or empty */
+    if (!_sick_profile_cache.Load(_sick_device_path)) {
+      return false;
+    }
+
+    sick_lms_2xx_software_status_t cached_software_status;
+    int cached_type;
+    
+    if (!_sick_profile_cache.GetValues("system_software_version",cached_software_status.sick_system_software_version,
+				       sizeof(cached_software_status.sick_system_software_version)) ||
+	!_sick_profile_cache.GetValues("prom_software_version",cached_software_status.sick_prom_software_version,
+				       sizeof(cached_software_status.sick_prom_software_version)) ||
+	!_sick_profile_cache.GetValue("type",cached_type)) {
+      return false;
+    }
+
+    /* Compare the fingerprint against the status we just read */
+    if (memcmp(cached_software_status.sick_system_software_version,_sick_software_status.sick_system_software_version,
+	       sizeof(cached_software_status.sick_system_software_version)) != 0 ||
+	memcmp(cached_software_status.sick_prom_software_version,_sick_software_status.sick_prom_software_version,
+	       sizeof(cached_software_status.sick_prom_software_version)) != 0) {
+      std::cout << "\t\tCached profile does not match device, doing full sync..." << std::endl;
+      return false;
+    }
+
+    _sick_type = (sick_lms_2xx_type_t)cached_type;
+
+    std::cout << "\t\tRestored cached profile for " << _sick_device_path << std::endl;
+
+    /* Success */
+    return true;
+  }
+
+  /**
+   * \brief Writes the device type to the profile cache (if enabled)
+   */
+  void SickLMS2xx::_storeProfileCache( ) {
+
+    if (!_sick_profile_cache.IsEnabled()) {
+      return;
+    }
+
+    _sick_profile_cache.Clear();
+    _sick_profile_cache.SetValue("type",(int)_sick_type);
+    _sick_profile_cache.SetValues("system_software_version",_sick_software_status.sick_system_software_version,
+				  sizeof(_sick_software_status.sick_system_software_version));
+    _sick_profile_cache.SetValues("prom_software_version",_sick_software_status.sick_prom_software_version,
+				  sizeof(_sick_software_status.sick_prom_software_version));
+    _sick_profile_cache.SetString("baud",SickBaudToString(_curr_session_baud));
+    _sick_profile_cache.Store(_sick_device_path);
+
+  }
+
+  /**
+   * \brief Reads where the LMS was last seen from the profile cache
+   * \return The rate of the last session, or SICK_BAUD_UNKNOWN if none was recorded
+   */
+  sick_lms_2xx_baud_t SickLMS2xx::_loadBaudHint( ) {
+
+    std::string cached_baud;
+    if (!_sick_profile_cache.Load(_sick_device_path) || !_sick_profile_cache.GetString("baud",cached_baud)) {
+      return SICK_BAUD_UNKNOWN;
+    }
+
+    const sick_lms_2xx_baud_t sick_bauds[] = { SICK_BAUD_9600, SICK_BAUD_19200, SICK_BAUD_38400, SICK_BAUD_500K };
+    for (unsigned int i = 0; i < sizeof(sick_bauds)/sizeof(sick_lms_2xx_baud_t); i++) {
+      if (cached_baud == SickBaudToString(sick_bauds[i])) {
+	return sick_bauds[i];
+      }
+    }
+
+    return SICK_BAUD_UNKNOWN;
+  }
+
+  /**
+   * \brief Records the current session baud in the profile cache (if enabled)
+   *
+   * NOTE: The rest of the stored profile is kept, so this is safe to call
+   *       whenever the rate changes.
+   */
+  void SickLMS2xx::_storeBaudHint( ) {
+
+    if (!_sick_profile_cache.IsEnabled()) {
+      return;
+    }
+
+    _sick_profile_cache.Load(_sick_device_path);
+    _sick_profile_cache.SetString("baud",SickBaudToString(_curr_session_baud));
+    _sick_profile_cache.Store(_sick_device_path);
+
+  }
+
   /**
    * \brief Sets the current configuration in flash
    * \param &sick_device_config The desired Sick LMS configuration
@@ -3097,7 +3407,7 @@ namespace SickToolbox {
 
       /* Refresh the status info! */
       _getSickStatus();
-      
+
     }
     
     /* Catch any timeout exceptions */
@@ -19,7 +19,10 @@
 
 /* Implementation dependencies */
 #include <iostream>
+#include <algorithm>
 #include <termios.h>
+#include <unistd.h>
+#include <sys/select.h>
 
 #include <sicktoolbox/SickLMS2xx.hh>
 #include <sicktoolbox/SickLMS2xxBufferMonitor.hh>
@@ -33,7 +36,23 @@ namespace SickToolbox {
   /**
    * \brief A standard constructor
    */
-  SickLMS2xxBufferMonitor::SickLMS2xxBufferMonitor( ) : SickBufferMonitor<SickLMS2xxBufferMonitor,SickLMS2xxMessage>(this) { }
+  SickLMS2xxBufferMonitor::SickLMS2xxBufferMonitor( ) : SickBufferMonitor<SickLMS2xxBufferMonitor,SickLMS2xxMessage>(this),
+							_low_latency(false), _read_minimum(0) { }
+
+  /**
+   * \brief Switches the low-latency serial mode (whole-frame blocking reads) on or off
+   * \param low_latency Whether the data stream is blocking and frames are read w/ reads of all the bytes still missing
+   *
+   * NOTE: Also call this after the terminal settings were rewritten, so the next frame sets VMIN again.
+   */
+  void SickLMS2xxBufferMonitor::SetLowLatency( const bool low_latency ) throw( SickThreadException ) {
+
+    AcquireDataStream();
+    _low_latency = low_latency;
+    _read_minimum = 0;
+    ReleaseDataStream();
+
+  }
 
   /**
    * \brief Acquires the next message from the SickLMS2xx byte stream
@@ -41,11 +60,10 @@ namespace SickToolbox {
    */
   void SickLMS2xxBufferMonitor::GetNextMessageFromDataStream( SickLMS2xxMessage &sick_message ) throw( SickIOException ) {
     
-    uint8_t search_buffer[2] = {0};
-    uint8_t payload_length_buffer[2] = {0};
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    uint8_t checksum_buffer[2] = {0};  
+    uint8_t frame_buffer[SickLMS2xxMessage::MESSAGE_MAX_LENGTH] = {0};
     uint16_t payload_length, checksum;
+    sick_lms_2xx_crc_t sick_crc;
+    bool frame_started = false;
     
     try {
 
@@ -54,18 +72,26 @@ namespace SickToolbox {
      	throw SickIOException("SickLMS2xxBufferMonitor::GetNextMessageFromDataStream: tcdrain failed!");
       }
 
-      /* Read until we get a valid message header */
-      unsigned int bytes_searched = 0;
-      while(search_buffer[0] != 0x02 || search_buffer[1] != DEFAULT_SICK_LMS_2XX_HOST_ADDRESS) {
+      /* Read a whole header (stx, address, payload length), then slide a byte at a time until it is valid */
+      if (_low_latency) {
+	_readBytes(frame_buffer,1,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+	_readBlocking(&frame_buffer[1],SickLMS2xxMessage::MESSAGE_HEADER_LENGTH-1);
+      }
+      else {
+	_readBytes(frame_buffer,SickLMS2xxMessage::MESSAGE_HEADER_LENGTH,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+      }
+      unsigned int bytes_searched = SickLMS2xxMessage::MESSAGE_HEADER_LENGTH;
+      while(frame_buffer[0] != 0x02 || frame_buffer[1] != DEFAULT_SICK_LMS_2XX_HOST_ADDRESS) {
 	
  	/* Slide the search window */
- 	search_buffer[0] = search_buffer[1];
+	memmove(frame_buffer,&frame_buffer[1],SickLMS2xxMessage::MESSAGE_HEADER_LENGTH-1);
 	
  	/* Attempt to read in another byte */
- 	_readBytes(&search_buffer[1],1,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+ 	_readBytes(&frame_buffer[SickLMS2xxMessage::MESSAGE_HEADER_LENGTH-1],1,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
 
 	/* Header should be no more than max message length + header length bytes away */
 	if (bytes_searched > SickLMS2xxMessage::MESSAGE_MAX_LENGTH + SickLMS2xxMessage::MESSAGE_HEADER_LENGTH) {
+	  _sick_health.Resync();
 	  throw SickTimeoutException("SickLMS2xxBufferMonitor::GetNextMessageFromDataStream: header timeout!");
 	}
 	
@@ -73,44 +99,76 @@ namespace SickToolbox {
 	bytes_searched++;
 	
       }
-      
-      /* Read until we receive the payload length or we timeout */
-      _readBytes(payload_length_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+
+      /* Anything before the header was stray */
+      if (bytes_searched > SickLMS2xxMessage::MESSAGE_HEADER_LENGTH) {
+	_sick_health.Resync();
+      }
+      frame_started = true;
 
       /* Extract the payload length */
-      memcpy(&payload_length,payload_length_buffer,2);
+      memcpy(&payload_length,&frame_buffer[2],2);
       payload_length = sick_lms_2xx_to_host_byte_order(payload_length);
 
       /* Make sure the payload length is legitimate, otherwise disregard */
-      if (payload_length <= SickLMS2xxMessage::MESSAGE_MAX_LENGTH) {
+      if (payload_length <= SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
 
-	/* Read until we receive the payload or we timeout */
-	_readBytes(payload_buffer,payload_length,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
-	
-	/* Read until we receive the checksum or we timeout */
-	_readBytes(checksum_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+	/* The CRC is kept up to date as the frame arrives, so it is done w/ the last byte */
+	sick_lms_2xx_crc_init(sick_crc);
+	sick_lms_2xx_crc_update(sick_crc,frame_buffer,SickLMS2xxMessage::MESSAGE_HEADER_LENGTH);
+
+	/* The rest of the frame (payload and checksum) */
+	uint8_t * const payload_buffer = &frame_buffer[SickLMS2xxMessage::MESSAGE_HEADER_LENGTH];
+	const unsigned int num_bytes_left = payload_length + SickLMS2xxMessage::MESSAGE_TRAILER_LENGTH;
+
+	/* Low latency: the whole rest of the frame in as few blocking reads as VMIN allows */
+	if (_low_latency) {
+	  _readBlocking(payload_buffer,num_bytes_left);
+	  sick_lms_2xx_crc_update(sick_crc,payload_buffer,payload_length);
+	}
+
+	/* Otherwise read a segment at a time or until we timeout */
+	else {
+	  for (unsigned int num_bytes_read = 0; num_bytes_read < num_bytes_left; ) {
+	    const unsigned int num_bytes_to_read = std::min(num_bytes_left - num_bytes_read,(unsigned int)SICK_LMS_2XX_CRC_SEGMENT_LENGTH);
+	    _readBytes(&payload_buffer[num_bytes_read],num_bytes_to_read,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+	    if (num_bytes_read < payload_length) {
+	      sick_lms_2xx_crc_update(sick_crc,&payload_buffer[num_bytes_read],std::min(num_bytes_to_read,payload_length - num_bytes_read));
+	    }
+	    num_bytes_read += num_bytes_to_read;
+	  }
+	}
 	
 	/* Copy into uint16_t so it can be used */
-	memcpy(&checksum,checksum_buffer,2);
+	memcpy(&checksum,&payload_buffer[payload_length],2);
 	checksum = sick_lms_2xx_to_host_byte_order(checksum);
 	
-	/* Build a frame and compute the crc */
-	sick_message.BuildMessage(DEFAULT_SICK_LMS_2XX_HOST_ADDRESS,payload_buffer,payload_length);
-	
 	/* See if the checksums match */
-	if(sick_message.GetChecksum() != checksum) {
+	if(sick_crc.crc != checksum) {
 	  throw SickBadChecksumException("SickLMS2xx::GetNextMessageFromDataStream: CRC16 failed!");
 	}
 
+	/* Take the checked frame as is */
+	sick_message.ParseMessage(frame_buffer);
+
+      }
+      else {
+	_sick_health.FrameDropped();
       }
       
     }
     
-    catch(SickTimeoutException &sick_timeout_exception) { /* This is ok! */ }
+    catch(SickTimeoutException &sick_timeout_exception) {
+      /* This is ok! (unless a frame was cut short) */
+      if (frame_started) {
+	_sick_health.FrameTimeout();
+      }
+    }
     
     /* Handle a bad checksum! */
     catch(SickBadChecksumException &sick_checksum_exception) {
       sick_message.Clear(); // Clear the message container
+      _sick_health.ChecksumFailure();
     }
     
     /* Handle any serious IO exceptions */
@@ -125,6 +183,80 @@ namespace SickToolbox {
     
   }
   
+  /**
+   * \brief Reads a certain number of bytes from the (blocking) data stream, as many per read() as VMIN allows
+   * \param *dest_buffer A pointer to the destination buffer
+   * \param num_bytes_to_read The number of bytes to read into the buffer
+   *
+   * NOTE: Each read() asks for every byte still missing (at most VMIN), so it returns once they are
+   *       all in or after a gap of VTIME. VTIME only runs once a byte is in, so select() still
+   *       waits for the first byte of each read, which keeps a frame cut short from blocking forever.
+   */
+  void SickLMS2xxBufferMonitor::_readBlocking( uint8_t * const dest_buffer, const unsigned int num_bytes_to_read )
+    throw( SickTimeoutException, SickIOException ) {
+
+    _setReadMinimum(SICK_LMS_2XX_MAX_READ_MINIMUM);
+
+    unsigned int total_num_bytes_read = 0;
+    while (total_num_bytes_read < num_bytes_to_read) {
+
+      /* Wait for the next byte */
+      fd_set file_desc_set;
+      FD_ZERO(&file_desc_set);
+      FD_SET(_sick_fd,&file_desc_set);
+
+      struct timeval timeout_val;
+      memset(&timeout_val,0,sizeof(timeout_val));
+      timeout_val.tv_usec = DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT;
+
+      const int num_active_files = select(_sick_fd+1,&file_desc_set,0,0,&timeout_val);
+      if (num_active_files == 0) {
+	throw SickTimeoutException("SickLMS2xxBufferMonitor::_readBlocking: select() timeout!");
+      }
+      else if (num_active_files < 0) {
+	throw SickIOException("SickLMS2xxBufferMonitor::_readBlocking: select() failed!");
+      }
+
+      /* Then take everything still missing in one go */
+      const unsigned int num_bytes_missing = std::min(num_bytes_to_read - total_num_bytes_read,(unsigned int)SICK_LMS_2XX_MAX_READ_MINIMUM);
+      const int num_bytes_read = read(_sick_fd,&dest_buffer[total_num_bytes_read],num_bytes_missing);
+      if (num_bytes_read <= 0) {
+	throw SickIOException("SickLMS2xxBufferMonitor::_readBlocking: read() failed!");
+      }
+
+      total_num_bytes_read += num_bytes_read;
+      _sick_health.BytesRead(num_bytes_read);
+
+    }
+
+  }
+
+  /**
+   * \brief Makes a blocking read of the data stream wait for the given number of bytes
+   * \param read_minimum The number of bytes (VMIN), or fewer if a read asks for fewer
+   */
+  void SickLMS2xxBufferMonitor::_setReadMinimum( const unsigned int read_minimum ) throw( SickIOException ) {
+
+    /* Frames of one kind share a length, so this is mostly a no-op */
+    if (read_minimum == _read_minimum) {
+      return;
+    }
+
+    struct termios term;
+    if (tcgetattr(_sick_fd,&term) < 0) {
+      throw SickIOException("SickLMS2xxBufferMonitor::_setReadMinimum: tcgetattr() failed!");
+    }
+
+    /* The inter-byte timer gives up on a frame that stops short */
+    term.c_cc[VMIN] = read_minimum;
+    term.c_cc[VTIME] = SICK_LMS_2XX_READ_GAP_TIMEOUT;
+    if (tcsetattr(_sick_fd,TCSANOW,&term) < 0) {
+      throw SickIOException("SickLMS2xxBufferMonitor::_setReadMinimum: tcsetattr() failed!");
+    }
+
+    _read_minimum = read_minimum;
+  }
+
   /**
    * \brief A standard destructor
    */
@@ -26,6 +26,257 @@
 /* Associate the namespace */
 namespace SickToolbox {
 
+  /*
+   * NOTE: Every step of the Sick CRC16 shifts the register once (reducing
+   *       by CRC16_GEN_POL) and XORs in the current and previous bytes, so
+   *       it is linear in the register and the data.  Four steps therefore
+   *       collapse into one XOR of table entries for the register, the last
+   *       byte and the first three new bytes (the fourth goes in as is).
+   *       The tables were generated from CRC16_GEN_POL.
+   */
+  static const uint16_t sick_lms_2xx_crc_table[6][256] = {
+    /* Register high byte */
+    {
+      0x0000, 0x1000, 0x2000, 0x3000, 0x4000, 0x5000, 0x6000, 0x7000,
+      0x8000, 0x9000, 0xA000, 0xB000, 0xC000, 0xD000, 0xE000, 0xF000,
+      0x8005, 0x9005, 0xA005, 0xB005, 0xC005, 0xD005, 0xE005, 0xF005,
+      0x0005, 0x1005, 0x2005, 0x3005, 0x4005, 0x5005, 0x6005, 0x7005,
+      0x800F, 0x900F, 0xA00F, 0xB00F, 0xC00F, 0xD00F, 0xE00F, 0xF00F,
+      0x000F, 0x100F, 0x200F, 0x300F, 0x400F, 0x500F, 0x600F, 0x700F,
+      0x000A, 0x100A, 0x200A, 0x300A, 0x400A, 0x500A, 0x600A, 0x700A,
+      0x800A, 0x900A, 0xA00A, 0xB00A, 0xC00A, 0xD00A, 0xE00A, 0xF00A,
+      0x801B, 0x901B, 0xA01B, 0xB01B, 0xC01B, 0xD01B, 0xE01B, 0xF01B,
+      0x001B, 0x101B, 0x201B, 0x301B, 0x401B, 0x501B, 0x601B, 0x701B,
+      0x001E, 0x101E, 0x201E, 0x301E, 0x401E, 0x501E, 0x601E, 0x701E,
+      0x801E, 0x901E, 0xA01E, 0xB01E, 0xC01E, 0xD01E, 0xE01E, 0xF01E,
+      0x0014, 0x1014, 0x2014, 0x3014, 0x4014, 0x5014, 0x6014, 0x7014,
+      0x8014, 0x9014, 0xA014, 0xB014, 0xC014, 0xD014, 0xE014, 0xF014,
+      0x8011, 0x9011, 0xA011, 0xB011, 0xC011, 0xD011, 0xE011, 0xF011,
+      0x0011, 0x1011, 0x2011, 0x3011, 0x4011, 0x5011, 0x6011, 0x7011,
+      0x8033, 0x9033, 0xA033, 0xB033, 0xC033, 0xD033, 0xE033, 0xF033,
+      0x0033, 0x1033, 0x2033, 0x3033, 0x4033, 0x5033, 0x6033, 0x7033,
+      0x0036, 0x1036, 0x2036, 0x3036, 0x4036, 0x5036, 0x6036, 0x7036,
+      0x8036, 0x9036, 0xA036, 0xB036, 0xC036, 0xD036, 0xE036, 0xF036,
+      0x003C, 0x103C, 0x203C, 0x303C, 0x403C, 0x503C, 0x603C, 0x703C,
+      0x803C, 0x903C, 0xA03C, 0xB03C, 0xC03C, 0xD03C, 0xE03C, 0xF03C,
+      0x8039, 0x9039, 0xA039, 0xB039, 0xC039, 0xD039, 0xE039, 0xF039,
+      0x0039, 0x1039, 0x2039, 0x3039, 0x4039, 0x5039, 0x6039, 0x7039,
+      0x0028, 0x1028, 0x2028, 0x3028, 0x4028, 0x5028, 0x6028, 0x7028,
+      0x8028, 0x9028, 0xA028, 0xB028, 0xC028, 0xD028, 0xE028, 0xF028,
+      0x802D, 0x902D, 0xA02D, 0xB02D, 0xC02D, 0xD02D, 0xE02D, 0xF02D,
+      0x002D, 0x102D, 0x202D, 0x302D, 0x402D, 0x502D, 0x602D, 0x702D,
+      0x8027, 0x9027, 0xA027, 0xB027, 0xC027, 0xD027, 0xE027, 0xF027,
+      0x0027, 0x1027, 0x2027, 0x3027, 0x4027, 0x5027, 0x6027, 0x7027,
+      0x0022, 0x1022, 0x2022, 0x3022, 0x4022, 0x5022, 0x6022, 0x7022,
+      0x8022, 0x9022, 0xA022, 0xB022, 0xC022, 0xD022, 0xE022, 0xF022
+    },
+    /* Register low byte */
+    {
+      0x0000, 0x0010, 0x0020, 0x0030, 0x0040, 0x0050, 0x0060, 0x0070,
+      0x0080, 0x0090, 0x00A0, 0x00B0, 0x00C0, 0x00D0, 0x00E0, 0x00F0,
+      0x0100, 0x0110, 0x0120, 0x0130, 0x0140, 0x0150, 0x0160, 0x0170,
+      0x0180, 0x0190, 0x01A0, 0x01B0, 0x01C0, 0x01D0, 0x01E0, 0x01F0,
+      0x0200, 0x0210, 0x0220, 0x0230, 0x0240, 0x0250, 0x0260, 0x0270,
+      0x0280, 0x0290, 0x02A0, 0x02B0, 0x02C0, 0x02D0, 0x02E0, 0x02F0,
+      0x0300, 0x0310, 0x0320, 0x0330, 0x0340, 0x0350, 0x0360, 0x0370,
+      0x0380, 0x0390, 0x03A0, 0x03B0, 0x03C0, 0x03D0, 0x03E0, 0x03F0,
+      0x0400, 0x0410, 0x0420, 0x0430, 0x0440, 0x0450, 0x0460, 0x0470,
+      0x0480, 0x0490, 0x04A0, 0x04B0, 0x04C0, 0x04D0, 0x04E0, 0x04F0,
+      0x0500, 0x0510, 0x0520, 0x0530, 0x0540, 0x0550, 0x0560, 0x0570,
+      0x0580, 0x0590, 0x05A0, 0x05B0, 0x05C0, 0x05D0, 0x05E0, 0x05F0,
+      0x0600, 0x0610, 0x0620, 0x0630, 0x0640, 0x0650, 0x0660, 0x0670,
+      0x0680, 0x0690, 0x06A0, 0x06B0, 0x06C0, 0x06D0, 0x06E0, 0x06F0,
+      0x0700, 0x0710, 0x0720, 0x0730, 0x0740, 0x0750, 0x0760, 0x0770,
+      0x0780, 0x0790, 0x07A0, 0x07B0, 0x07C0, 0x07D0, 0x07E0, 0x07F0,
+      0x0800, 0x0810, 0x0820, 0x0830, 0x0840, 0x0850, 0x0860, 0x0870,
+      0x0880, 0x0890, 0x08A0, 0x08B0, 0x08C0, 0x08D0, 0x08E0, 0x08F0,
+      0x0900, 0x0910, 0x0920, 0x0930, 0x0940, 0x0950, 0x0960, 0x0970,
+      0x0980, 0x0990, 0x09A0, 0x09B0, 0x09C0, 0x09D0, 0x09E0, 0x09F0,
+      0x0A00, 0x0A10, 0x0A20, 0x0A30, 0x0A40, 0x0A50, 0x0A60, 0x0A70,
+      0x0A80, 0x0A90, 0x0AA0, 0x0AB0, 0x0AC0, 0x0AD0, 0x0AE0, 0x0AF0,
+      0x0B00, 0x0B10, 0x0B20, 0x0B30, 0x0B40, 0x0B50, 0x0B60, 0x0B70,
+      0x0B80, 0x0B90, 0x0BA0, 0x0BB0, 0x0BC0, 0x0BD0, 0x0BE0, 0x0BF0,
+      0x0C00, 0x0C10, 0x0C20, 0x0C30, 0x0C40, 0x0C50, 0x0C60, 0x0C70,
+      0x0C80, 0x0C90, 0x0CA0, 0x0CB0, 0x0CC0, 0x0CD0, 0x0CE0, 0x0CF0,
+      0x0D00, 0x0D10, 0x0D20, 0x0D30, 0x0D40, 0x0D50, 0x0D60, 0x0D70,
+      0x0D80, 0x0D90, 0x0DA0, 0x0DB0, 0x0DC0, 0x0DD0, 0x0DE0, 0x0DF0,
+      0x0E00, 0x0E10, 0x0E20, 0x0E30, 0x0E40, 0x0E50, 0x0E60, 0x0E70,
+      0x0E80, 0x0E90, 0x0EA0, 0x0EB0, 0x0EC0, 0x0ED0, 0x0EE0, 0x0EF0,
+      0x0F00, 0x0F10, 0x0F20, 0x0F30, 0x0F40, 0x0F50, 0x0F60, 0x0F70,
+      0x0F80, 0x0F90, 0x0FA0, 0x0FB0, 0x0FC0, 0x0FD0, 0x0FE0, 0x0FF0
+    },
+    /* The byte before the four */
+    {
+      0x0000, 0x0800, 0x1000, 0x1800, 0x2000, 0x2800, 0x3000, 0x3800,
+      0x4000, 0x4800, 0x5000, 0x5800, 0x6000, 0x6800, 0x7000, 0x7800,
+      0x8000, 0x8800, 0x9000, 0x9800, 0xA000, 0xA800, 0xB000, 0xB800,
+      0xC000, 0xC800, 0xD000, 0xD800, 0xE000, 0xE800, 0xF000, 0xF800,
+      0x8005, 0x8805, 0x9005, 0x9805, 0xA005, 0xA805, 0xB005, 0xB805,
+      0xC005, 0xC805, 0xD005, 0xD805, 0xE005, 0xE805, 0xF005, 0xF805,
+      0x0005, 0x0805, 0x1005, 0x1805, 0x2005, 0x2805, 0x3005, 0x3805,
+      0x4005, 0x4805, 0x5005, 0x5805, 0x6005, 0x6805, 0x7005, 0x7805,
+      0x800F, 0x880F, 0x900F, 0x980F, 0xA00F, 0xA80F, 0xB00F, 0xB80F,
+      0xC00F, 0xC80F, 0xD00F, 0xD80F, 0xE00F, 0xE80F, 0xF00F, 0xF80F,
+      0x000F, 0x080F, 0x100F, 0x180F, 0x200F, 0x280F, 0x300F, 0x380F,
+      0x400F, 0x480F, 0x500F, 0x580F, 0x600F, 0x680F, 0x700F, 0x780F,
+      0x000A, 0x080A, 0x100A, 0x180A, 0x200A, 0x280A, 0x300A, 0x380A,
+      0x400A, 0x480A, 0x500A, 0x580A, 0x600A, 0x680A, 0x700A, 0x780A,
+      0x800A, 0x880A, 0x900A, 0x980A, 0xA00A, 0xA80A, 0xB00A, 0xB80A,
+      0xC00A, 0xC80A, 0xD00A, 0xD80A, 0xE00A, 0xE80A, 0xF00A, 0xF80A,
+      0x801B, 0x881B, 0x901B, 0x981B, 0xA01B, 0xA81B, 0xB01B, 0xB81B,
+      0xC01B, 0xC81B, 0xD01B, 0xD81B, 0xE01B, 0xE81B, 0xF01B, 0xF81B,
+      0x001B, 0x081B, 0x101B, 0x181B, 0x201B, 0x281B, 0x301B, 0x381B,
+      0x401B, 0x481B, 0x501B, 0x581B, 0x601B, 0x681B, 0x701B, 0x781B,
+      0x001E, 0x081E, 0x101E, 0x181E, 0x201E, 0x281E, 0x301E, 0x381E,
+      0x401E, 0x481E, 0x501E, 0x581E, 0x601E, 0x681E, 0x701E, 0x781E,
+      0x801E, 0x881E, 0x901E, 0x981E, 0xA01E, 0xA81E, 0xB01E, 0xB81E,
+      0xC01E, 0xC81E, 0xD01E, 0xD81E, 0xE01E, 0xE81E, 0xF01E, 0xF81E,
+      0x0014, 0x0814, 0x1014, 0x1814, 0x2014, 0x2814, 0x3014, 0x3814,
+      0x4014, 0x4814, 0x5014, 0x5814, 0x6014, 0x6814, 0x7014, 0x7814,
+      0x8014, 0x8814, 0x9014, 0x9814, 0xA014, 0xA814, 0xB014, 0xB814,
+      0xC014, 0xC814, 0xD014, 0xD814, 0xE014, 0xE814, 0xF014, 0xF814,
+      0x8011, 0x8811, 0x9011, 0x9811, 0xA011, 0xA811, 0xB011, 0xB811,
+      0xC011, 0xC811, 0xD011, 0xD811, 0xE011, 0xE811, 0xF011, 0xF811,
+      0x0011, 0x0811, 0x1011, 0x1811, 0x2011, 0x2811, 0x3011, 0x3811,
+      0x4011, 0x4811, 0x5011, 0x5811, 0x6011, 0x6811, 0x7011, 0x7811
+    },
+    /* First of the four */
+    {
+      0x0000, 0x0408, 0x0810, 0x0C18, 0x1020, 0x1428, 0x1830, 0x1C38,
+      0x2040, 0x2448, 0x2850, 0x2C58, 0x3060, 0x3468, 0x3870, 0x3C78,
+      0x4080, 0x4488, 0x4890, 0x4C98, 0x50A0, 0x54A8, 0x58B0, 0x5CB8,
+      0x60C0, 0x64C8, 0x68D0, 0x6CD8, 0x70E0, 0x74E8, 0x78F0, 0x7CF8,
+      0x8100, 0x8508, 0x8910, 0x8D18, 0x9120, 0x9528, 0x9930, 0x9D38,
+      0xA140, 0xA548, 0xA950, 0xAD58, 0xB160, 0xB568, 0xB970, 0xBD78,
+      0xC180, 0xC588, 0xC990, 0xCD98, 0xD1A0, 0xD5A8, 0xD9B0, 0xDDB8,
+      0xE1C0, 0xE5C8, 0xE9D0, 0xEDD8, 0xF1E0, 0xF5E8, 0xF9F0, 0xFDF8,
+      0x8205, 0x860D, 0x8A15, 0x8E1D, 0x9225, 0x962D, 0x9A35, 0x9E3D,
+      0xA245, 0xA64D, 0xAA55, 0xAE5D, 0xB265, 0xB66D, 0xBA75, 0xBE7D,
+      0xC285, 0xC68D, 0xCA95, 0xCE9D, 0xD2A5, 0xD6AD, 0xDAB5, 0xDEBD,
+      0xE2C5, 0xE6CD, 0xEAD5, 0xEEDD, 0xF2E5, 0xF6ED, 0xFAF5, 0xFEFD,
+      0x0305, 0x070D, 0x0B15, 0x0F1D, 0x1325, 0x172D, 0x1B35, 0x1F3D,
+      0x2345, 0x274D, 0x2B55, 0x2F5D, 0x3365, 0x376D, 0x3B75, 0x3F7D,
+      0x4385, 0x478D, 0x4B95, 0x4F9D, 0x53A5, 0x57AD, 0x5BB5, 0x5FBD,
+      0x63C5, 0x67CD, 0x6BD5, 0x6FDD, 0x73E5, 0x77ED, 0x7BF5, 0x7FFD,
+      0x840F, 0x8007, 0x8C1F, 0x8817, 0x942F, 0x9027, 0x9C3F, 0x9837,
+      0xA44F, 0xA047, 0xAC5F, 0xA857, 0xB46F, 0xB067, 0xBC7F, 0xB877,
+      0xC48F, 0xC087, 0xCC9F, 0xC897, 0xD4AF, 0xD0A7, 0xDCBF, 0xD8B7,
+      0xE4CF, 0xE0C7, 0xECDF, 0xE8D7, 0xF4EF, 0xF0E7, 0xFCFF, 0xF8F7,
+      0x050F, 0x0107, 0x0D1F, 0x0917, 0x152F, 0x1127, 0x1D3F, 0x1937,
+      0x254F, 0x2147, 0x2D5F, 0x2957, 0x356F, 0x3167, 0x3D7F, 0x3977,
+      0x458F, 0x4187, 0x4D9F, 0x4997, 0x55AF, 0x51A7, 0x5DBF, 0x59B7,
+      0x65CF, 0x61C7, 0x6DDF, 0x69D7, 0x75EF, 0x71E7, 0x7DFF, 0x79F7,
+      0x060A, 0x0202, 0x0E1A, 0x0A12, 0x162A, 0x1222, 0x1E3A, 0x1A32,
+      0x264A, 0x2242, 0x2E5A, 0x2A52, 0x366A, 0x3262, 0x3E7A, 0x3A72,
+      0x468A, 0x4282, 0x4E9A, 0x4A92, 0x56AA, 0x52A2, 0x5EBA, 0x5AB2,
+      0x66CA, 0x62C2, 0x6EDA, 0x6AD2, 0x76EA, 0x72E2, 0x7EFA, 0x7AF2,
+      0x870A, 0x8302, 0x8F1A, 0x8B12, 0x972A, 0x9322, 0x9F3A, 0x9B32,
+      0xA74A, 0xA342, 0xAF5A, 0xAB52, 0xB76A, 0xB362, 0xBF7A, 0xBB72,
+      0xC78A, 0xC382, 0xCF9A, 0xCB92, 0xD7AA, 0xD3A2, 0xDFBA, 0xDBB2,
+      0xE7CA, 0xE3C2, 0xEFDA, 0xEBD2, 0xF7EA, 0xF3E2, 0xFFFA, 0xFBF2
+    },
+    /* Second of the four */
+    {
+      0x0000, 0x0204, 0x0408, 0x060C, 0x0810, 0x0A14, 0x0C18, 0x0E1C,
+      0x1020, 0x1224, 0x1428, 0x162C, 0x1830, 0x1A34, 0x1C38, 0x1E3C,
+      0x2040, 0x2244, 0x2448, 0x264C, 0x2850, 0x2A54, 0x2C58, 0x2E5C,
+      0x3060, 0x3264, 0x3468, 0x366C, 0x3870, 0x3A74, 0x3C78, 0x3E7C,
+      0x4080, 0x4284, 0x4488, 0x468C, 0x4890, 0x4A94, 0x4C98, 0x4E9C,
+      0x50A0, 0x52A4, 0x54A8, 0x56AC, 0x58B0, 0x5AB4, 0x5CB8, 0x5EBC,
+      0x60C0, 0x62C4, 0x64C8, 0x66CC, 0x68D0, 0x6AD4, 0x6CD8, 0x6EDC,
+      0x70E0, 0x72E4, 0x74E8, 0x76EC, 0x78F0, 0x7AF4, 0x7CF8, 0x7EFC,
+      0x8100, 0x8304, 0x8508, 0x870C, 0x8910, 0x8B14, 0x8D18, 0x8F1C,
+      0x9120, 0x9324, 0x9528, 0x972C, 0x9930, 0x9B34, 0x9D38, 0x9F3C,
+      0xA140, 0xA344, 0xA548, 0xA74C, 0xA950, 0xAB54, 0xAD58, 0xAF5C,
+      0xB160, 0xB364, 0xB568, 0xB76C, 0xB970, 0xBB74, 0xBD78, 0xBF7C,
+      0xC180, 0xC384, 0xC588, 0xC78C, 0xC990, 0xCB94, 0xCD98, 0xCF9C,
+      0xD1A0, 0xD3A4, 0xD5A8, 0xD7AC, 0xD9B0, 0xDBB4, 0xDDB8, 0xDFBC,
+      0xE1C0, 0xE3C4, 0xE5C8, 0xE7CC, 0xE9D0, 0xEBD4, 0xEDD8, 0xEFDC,
+      0xF1E0, 0xF3E4, 0xF5E8, 0xF7EC, 0xF9F0, 0xFBF4, 0xFDF8, 0xFFFC,
+      0x8205, 0x8001, 0x860D, 0x8409, 0x8A15, 0x8811, 0x8E1D, 0x8C19,
+      0x9225, 0x9021, 0x962D, 0x9429, 0x9A35, 0x9831, 0x9E3D, 0x9C39,
+      0xA245, 0xA041, 0xA64D, 0xA449, 0xAA55, 0xA851, 0xAE5D, 0xAC59,
+      0xB265, 0xB061, 0xB66D, 0xB469, 0xBA75, 0xB871, 0xBE7D, 0xBC79,
+      0xC285, 0xC081, 0xC68D, 0xC489, 0xCA95, 0xC891, 0xCE9D, 0xCC99,
+      0xD2A5, 0xD0A1, 0xD6AD, 0xD4A9, 0xDAB5, 0xD8B1, 0xDEBD, 0xDCB9,
+      0xE2C5, 0xE0C1, 0xE6CD, 0xE4C9, 0xEAD5, 0xE8D1, 0xEEDD, 0xECD9,
+      0xF2E5, 0xF0E1, 0xF6ED, 0xF4E9, 0xFAF5, 0xF8F1, 0xFEFD, 0xFCF9,
+      0x0305, 0x0101, 0x070D, 0x0509, 0x0B15, 0x0911, 0x0F1D, 0x0D19,
+      0x1325, 0x1121, 0x172D, 0x1529, 0x1B35, 0x1931, 0x1F3D, 0x1D39,
+      0x2345, 0x2141, 0x274D, 0x2549, 0x2B55, 0x2951, 0x2F5D, 0x2D59,
+      0x3365, 0x3161, 0x376D, 0x3569, 0x3B75, 0x3971, 0x3F7D, 0x3D79,
+      0x4385, 0x4181, 0x478D, 0x4589, 0x4B95, 0x4991, 0x4F9D, 0x4D99,
+      0x53A5, 0x51A1, 0x57AD, 0x55A9, 0x5BB5, 0x59B1, 0x5FBD, 0x5DB9,
+      0x63C5, 0x61C1, 0x67CD, 0x65C9, 0x6BD5, 0x69D1, 0x6FDD, 0x6DD9,
+      0x73E5, 0x71E1, 0x77ED, 0x75E9, 0x7BF5, 0x79F1, 0x7FFD, 0x7DF9
+    },
+    /* Third of the four */
+    {
+      0x0000, 0x0102, 0x0204, 0x0306, 0x0408, 0x050A, 0x060C, 0x070E,
+      0x0810, 0x0912, 0x0A14, 0x0B16, 0x0C18, 0x0D1A, 0x0E1C, 0x0F1E,
+      0x1020, 0x1122, 0x1224, 0x1326, 0x1428, 0x152A, 0x162C, 0x172E,
+      0x1830, 0x1932, 0x1A34, 0x1B36, 0x1C38, 0x1D3A, 0x1E3C, 0x1F3E,
+      0x2040, 0x2142, 0x2244, 0x2346, 0x2448, 0x254A, 0x264C, 0x274E,
+      0x2850, 0x2952, 0x2A54, 0x2B56, 0x2C58, 0x2D5A, 0x2E5C, 0x2F5E,
+      0x3060, 0x3162, 0x3264, 0x3366, 0x3468, 0x356A, 0x366C, 0x376E,
+      0x3870, 0x3972, 0x3A74, 0x3B76, 0x3C78, 0x3D7A, 0x3E7C, 0x3F7E,
+      0x4080, 0x4182, 0x4284, 0x4386, 0x4488, 0x458A, 0x468C, 0x478E,
+      0x4890, 0x4992, 0x4A94, 0x4B96, 0x4C98, 0x4D9A, 0x4E9C, 0x4F9E,
+      0x50A0, 0x51A2, 0x52A4, 0x53A6, 0x54A8, 0x55AA, 0x56AC, 0x57AE,
+      0x58B0, 0x59B2, 0x5AB4, 0x5BB6, 0x5CB8, 0x5DBA, 0x5EBC, 0x5FBE,
+      0x60C0, 0x61C2, 0x62C4, 0x63C6, 0x64C8, 0x65CA, 0x66CC, 0x67CE,
+      0x68D0, 0x69D2, 0x6AD4, 0x6BD6, 0x6CD8, 0x6DDA, 0x6EDC, 0x6FDE,
+      0x70E0, 0x71E2, 0x72E4, 0x73E6, 0x74E8, 0x75EA, 0x76EC, 0x77EE,
+      0x78F0, 0x79F2, 0x7AF4, 0x7BF6, 0x7CF8, 0x7DFA, 0x7EFC, 0x7FFE,
+      0x8100, 0x8002, 0x8304, 0x8206, 0x8508, 0x840A, 0x870C, 0x860E,
+      0x8910, 0x8812, 0x8B14, 0x8A16, 0x8D18, 0x8C1A, 0x8F1C, 0x8E1E,
+      0x9120, 0x9022, 0x9324, 0x9226, 0x9528, 0x942A, 0x972C, 0x962E,
+      0x9930, 0x9832, 0x9B34, 0x9A36, 0x9D38, 0x9C3A, 0x9F3C, 0x9E3E,
+      0xA140, 0xA042, 0xA344, 0xA246, 0xA548, 0xA44A, 0xA74C, 0xA64E,
+      0xA950, 0xA852, 0xAB54, 0xAA56, 0xAD58, 0xAC5A, 0xAF5C, 0xAE5E,
+      0xB160, 0xB062, 0xB364, 0xB266, 0xB568, 0xB46A, 0xB76C, 0xB66E,
+      0xB970, 0xB872, 0xBB74, 0xBA76, 0xBD78, 0xBC7A, 0xBF7C, 0xBE7E,
+      0xC180, 0xC082, 0xC384, 0xC286, 0xC588, 0xC48A, 0xC78C, 0xC68E,
+      0xC990, 0xC892, 0xCB94, 0xCA96, 0xCD98, 0xCC9A, 0xCF9C, 0xCE9E,
+      0xD1A0, 0xD0A2, 0xD3A4, 0xD2A6, 0xD5A8, 0xD4AA, 0xD7AC, 0xD6AE,
+      0xD9B0, 0xD8B2, 0xDBB4, 0xDAB6, 0xDDB8, 0xDCBA, 0xDFBC, 0xDEBE,
+      0xE1C0, 0xE0C2, 0xE3C4, 0xE2C6, 0xE5C8, 0xE4CA, 0xE7CC, 0xE6CE,
+      0xE9D0, 0xE8D2, 0xEBD4, 0xEAD6, 0xEDD8, 0xECDA, 0xEFDC, 0xEEDE,
+      0xF1E0, 0xF0E2, 0xF3E4, 0xF2E6, 0xF5E8, 0xF4EA, 0xF7EC, 0xF6EE,
+      0xF9F0, 0xF8F2, 0xFBF4, 0xFAF6, 0xFDF8, 0xFCFA, 0xFFFC, 0xFEFE
+    }
+  };
+
+  /**
+   * \brief Feeds the next bytes of a frame to a running CRC16
+   * \param &sick_crc The running CRC (sick_lms_2xx_crc_init() at the frame's first byte)
+   * \param data The bytes
+   * \param data_length Number of bytes
+   */
+  void sick_lms_2xx_crc_update( sick_lms_2xx_crc_t &sick_crc, const uint8_t * data, unsigned int data_length ) {
+
+    uint16_t crc = sick_crc.crc;
+    uint8_t last_byte = sick_crc.last_byte;
+
+    /* Four bytes per step */
+    while (data_length >= 4) {
+      crc = sick_lms_2xx_crc_table[0][crc >> 8] ^ sick_lms_2xx_crc_table[1][crc & 0xFF] ^ sick_lms_2xx_crc_table[2][last_byte] ^
+	sick_lms_2xx_crc_table[3][data[0]] ^ sick_lms_2xx_crc_table[4][data[1]] ^ sick_lms_2xx_crc_table[5][data[2]] ^ data[3];
+      last_byte = data[3];
+      data += 4;
+      data_length -= 4;
+    }
+
+    /* The rest a byte at a time (w/o a branch on the register's top bit) */
+    while (data_length--) {
+      crc = (uint16_t)((crc << 1) ^ (CRC16_GEN_POL & -(crc >> 15))) ^ MKSHORT(*data,last_byte);
+      last_byte = *data++;
+    }
+
+    sick_crc.crc = crc;
+    sick_crc.last_byte = last_byte;
+  }
+
   /*!
    * \brief A default constructor
    */
@@ -156,24 +407,12 @@ namespace SickToolbox {
    * \param len The length of the data array
    * \return CRC16 computed over given data buffer
    */
-  uint16_t SickLMS2xxMessage::_computeCRC( uint8_t * data, unsigned int data_length ) const {
-  
-    uint16_t uCrc16;
-    uint8_t abData[2];
-    uCrc16 = abData[0] = 0;
-    while (data_length-- ) {
-      abData[1] = abData[0];
-      abData[0] = *data++;
-      if(uCrc16 & 0x8000) {
-	uCrc16 = (uCrc16 & 0x7fff) << 1;
-	uCrc16 ^= CRC16_GEN_POL;
-      }
-      else {
-	uCrc16 <<= 1;
-      }
-      uCrc16 ^= MKSHORT(abData[0],abData[1]);
-    }
-    return uCrc16;
+  uint16_t SickLMS2xxMessage::_computeCRC( const uint8_t * data, unsigned int data_length ) const {
+
+    sick_lms_2xx_crc_t sick_crc;
+    sick_lms_2xx_crc_init(sick_crc);
+    sick_lms_2xx_crc_update(sick_crc,data,data_length);
+    return sick_crc.crc;
   }
 
   SickLMS2xxMessage::~SickLMS2xxMessage( ) { }
@@ -40,6 +40,7 @@
 #include "sicktoolbox/SickNAV350BufferMonitor.hh"
 #include "sicktoolbox/SickNAV350Utility.hh"   
  #include "sicktoolbox/SickException.hh"
+#include "sicktoolbox/SickColaFormat.hh"
 using namespace std;
 /* Associate the namespace */
 namespace SickToolbox {
@@ -90,11 +91,14 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
     _sick_ip_address(sick_ip_address),
     _sick_tcp_port(sick_tcp_port),
     _sick_streaming_range_data(false),
-    _sick_streaming_range_and_echo_data(false)
+    _sick_streaming_range_and_echo_data(false),
+    _sick_scan_leased(false),
+    _navigation_request_pending(false)
   {
 	  arg=new std::string[5000];
 	  argumentcount_=0;
-	  MeasuredData_=new sick_nav350_sector_data_tag;
+	  MeasuredData_=new sick_nav350_sector_data_tag();
+	  SICK_LATENCY_LABEL(_sick_latency,"SickNav350 " + sick_ip_address);
 	  /* Initialize the global configuration structure */
   }
 
@@ -157,6 +161,12 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   
   void SickNav350::Uninitialize( )
   {
+	  /* Stop the buffer monitor before its driver goes away */
+	  if (_sick_initialized) {
+		  _stopListening();
+		  _sick_initialized = false;
+	  }
+	  _navigation_request_pending = false;
 	  delete []arg;
 	  delete MeasuredData_;
   }
@@ -810,92 +820,10 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
  void SickNav350::SetSpeed(double x,double y,double phi,int timestamp,int coordbase)
  {
 //	  std::cout<<"set speed"<<std::endl;
-	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-	    int count=0;
-	    std::string command_type=this->SETVELOCITY_COMMAND_TYPE;
-	    std::string command=this->SETVELOCITY_COMMAND;
-	    for (int i=0;i<command_type.length();i++)
-	    {
-	    	payload_buffer[count]=command_type[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-	    for (int i=0;i<command.length();i++)
-	    {
-	    	payload_buffer[count]=command[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-	    char c[100];
-	    sprintf(c,"%d",(int)(x*1000));
-	    if (c[0]!='-')
-	    {
-		    payload_buffer[count]='+';
-		    count++;
-	    }
-	    for (int i=0;i<strlen(c);i++)
-	    {
-	    	payload_buffer[count]=c[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-
-	    sprintf(c,"%d",(int)(y*1000));
-	    if (c[0]!='-')
-	    {
-		    payload_buffer[count]='+';
-		    count++;
-	    }
-	    for (int i=0;i<strlen(c);i++)
-	    {
-	    	payload_buffer[count]=c[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-
-	    sprintf(c,"%d",(int)(phi/3.14159*180*1000));
-	    if (c[0]!='-')
-	    {
-		    payload_buffer[count]='+';
-		    count++;
-	    }
-	    for (int i=0;i<strlen(c);i++)
-	    {
-	    	payload_buffer[count]=c[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-
-	    sprintf(c,"%d",timestamp);
-	    if (c[0]!='-')
-	    {
-		    payload_buffer[count]='+';
-		    count++;
-	    }
-	    for (int i=0;i<strlen(c);i++)
-	    {
-	    	payload_buffer[count]=c[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-
-	    payload_buffer[count]=48+coordbase;
-	    count++;
-
-/*		for (int i=0;i<count;i++)
-		{
-			printf("%c",payload_buffer[i]);
-		}
-		printf("\n");*/
 	    /* Create the Sick messages */
-	    SickNav350Message send_message(payload_buffer,count);
+	    SickNav350Message send_message;
 	    SickNav350Message recv_message;
+	    _buildSetSpeedRequest(x,y,phi,timestamp,coordbase,send_message);
 
 
 	    uint8_t byte_sequence[] = {'s','A','N',' ','m','N','P','O','S','S','e','t','S','p','e','e','d',0};
@@ -937,8 +865,64 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	    }
 
  }
+
+  /**
+   * \brief Sends the velocity without waiting for the acknowledgement, so it can be
+   *        injected between navigation requests (PollDataNavigation skips the reply)
+   */
+  void SickNav350::RequestSetSpeed(double x,double y,double phi,int timestamp,int coordbase)
+  {
+	    SickNav350Message send_message;
+	    _buildSetSpeedRequest(x,y,phi,timestamp,coordbase,send_message);
+	    _sendMessage(send_message,0);
+  }
+
+  void SickNav350::_buildSetSpeedRequest(double x,double y,double phi,int timestamp,int coordbase,SickNav350Message &send_message) const
+  {
+	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+	    int count=0;
+	    std::string command_type=this->SETVELOCITY_COMMAND_TYPE;
+	    std::string command=this->SETVELOCITY_COMMAND;
+	    for (int i=0;i<command_type.length();i++)
+	    {
+	    	payload_buffer[count]=command_type[i];
+	    	count++;
+	    }
+	    payload_buffer[count]=' ';
+	    count++;
+	    for (int i=0;i<command.length();i++)
+	    {
+	    	payload_buffer[count]=command[i];
+	    	count++;
+	    }
+	    payload_buffer[count]=' ';
+	    count++;
+	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(x*1000));
+	    payload_buffer[count]=' ';
+	    count++;
+
+	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(y*1000));
+	    payload_buffer[count]=' ';
+	    count++;
+
+	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(phi/3.14159*180*1000));
+	    payload_buffer[count]=' ';
+	    count++;
+
+	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,timestamp);
+	    payload_buffer[count]=' ';
+	    count++;
+
+	    payload_buffer[count]=48+coordbase;
+	    count++;
+
+	    send_message.BuildMessage(payload_buffer,count);
+  }
+
   void SickNav350::GetData(int wait,int dataset)
   {
+	    _checkScanLease("SickNav350::GetData");
+
 	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
 	    int count=0;
 	    std::string command_type=this->GETDATA_COMMAND_TYPE;
@@ -981,6 +965,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	      _SplitReceivedMessage(recv_message);
 //	      std::cout<<"argument count="<<argumentcount_<<std::endl;
 	      _ParseScanData();
+	      SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+	      SICK_LATENCY_RECORD(_sick_latency,recv_message);
 //	      std::cout<<"Get data"<<std::endl;
 	    }
 
@@ -1002,6 +988,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   }
   void SickNav350::GetDataLandMark(int wait,int dataset)
   {
+	    _checkScanLease("SickNav350::GetDataLandMark");
+
 	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
 	    int count=0;
 	    std::string command_type=this->GETDATALANDMARK_COMMAND_TYPE;
@@ -1044,6 +1032,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	      _SplitReceivedMessage(recv_message);
 //	      std::cout<<"argument count="<<argumentcount_<<std::endl;
 	      _ParseScanDataLandMark();
+	      SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+	      SICK_LATENCY_RECORD(_sick_latency,recv_message);
 //	      std::cout<<"Get data"<<std::endl;
 	    }
 
@@ -1186,7 +1176,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 //		  std::cout<<"Landmark data follow"<<std::endl;
 		  //std::cout<<"Landmark filter "<<
 				 arg[count++];//<<std::endl;
-		  int refcount=atoi(arg[count++].c_str());
+		  int refcount=_ConvertHexToDec(arg[count++]);
 		  //std::cout<<"reflector count: "<<refcount<<std::endl;
 		  for (int i=0;i<refcount;i++)
 		  {
@@ -1283,6 +1273,37 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	  return suma;
 
   }
+
+  int SickNav350::_ParseReflectorCount(const std::string &num, int &num_reported)
+  {
+	  num_reported=_ConvertHexToDec(num);
+	  if (num_reported<0)
+	  {
+		  num_reported=0;
+	  }
+	  if (num_reported>SICK_MAX_NUM_REFLECTORS)
+	  {
+		  std::cerr<<"SickNav350::_ParseReflectorCount - "<<num_reported<<" reflectors reported, keeping "<<SICK_MAX_NUM_REFLECTORS<<std::endl;
+		  return SICK_MAX_NUM_REFLECTORS;
+	  }
+	  return num_reported;
+  }
+
+  void SickNav350::_SkipReflectorData(int &count)
+  {
+	  if (arg[count++]!="0")
+	  {
+		  count+=2; //x,y
+	  }
+	  if (arg[count++]!="0")
+	  {
+		  count+=2; //dist,phi
+	  }
+	  if (arg[count++]=="1")
+	  {
+		  count+=11; //LocalID..indexEnd
+	  }
+  }
   void SickNav350::GetSickMeasurements(double* range_values,unsigned int *num_measurements,
   		double *sector_step_angle,
   		double *sector_start_angle,
@@ -1290,10 +1311,10 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   		unsigned int *sector_start_timestamp,
   		unsigned int *sector_stop_timestamp)
   {
-	  for (int i=0;i<MeasuredData_->num_data_points;i++)
-	  {
-		  range_values[i]=MeasuredData_->range_values[i];
-	  }
+	  SickScanView< uint32_t > scan_view(MeasuredData_->range_values,NULL,MeasuredData_->num_data_points,1.0,
+					     MeasuredData_->angle_start,MeasuredData_->angle_step,
+					     MeasuredData_->timestamp_start,MeasuredData_->timestamp_stop);
+	  scan_view.GetRanges(range_values);
 	  *num_measurements=MeasuredData_->num_data_points;
 	  *sector_step_angle=MeasuredData_->angle_step;
 	  *sector_start_angle=MeasuredData_->angle_start;
@@ -1302,6 +1323,36 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	  *sector_stop_timestamp=MeasuredData_->timestamp_start;
 
   }
+  /**
+   * \brief Lends out the scan from the most recent GetData* call without copying it
+   * \param &scan_lease Receives a single view of the ranges (mm). The view remains valid until
+   *                    the lease is released; GetData* throws a SickConfigException until then.
+   *
+   * NOTE: Throws a SickConfigException if a different lease still holds the buffer.
+   */
+  void SickNav350::GetSickMeasurements( SickScanLease< uint32_t > &scan_lease ) throw( SickConfigException )
+  {
+	  /* Return the caller's previous lease (if any); any other one must be returned first */
+	  scan_lease.Release();
+	  _checkScanLease("SickNav350::GetSickMeasurements");
+
+	  scan_lease.Grant(&_sick_scan_leased);
+	  scan_lease.AddSector(SickScanView< uint32_t >(MeasuredData_->range_values,NULL,MeasuredData_->num_data_points,1.0,
+							MeasuredData_->angle_start,MeasuredData_->angle_step,
+							MeasuredData_->timestamp_start,MeasuredData_->timestamp_stop));
+  }
+
+  /**
+   * \brief Throws if the scan buffer is still lent out through a SickScanLease
+   * \param &caller Name of the calling method (for the error message)
+   */
+  void SickNav350::_checkScanLease( const std::string &caller ) const throw( SickConfigException )
+  {
+	  if (_sick_scan_leased) {
+		  throw SickConfigException(caller + ": Scan buffer is still leased!");
+	  }
+  }
+
   void SickNav350::GetResponseFromCustomMessage(uint8_t *req,int req_size,uint8_t *res,int* res_size)
   {
 	    SickNav350Message send_message(req,req_size);
@@ -1338,35 +1389,12 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   }
   void SickNav350::GetDataNavigation(int wait,int dataset)
   {
-	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-	    int count=0;
-	    std::string command_type=this->GETDATANAVIGATION_COMMAND_TYPE;
-	    std::string command=this->GETDATANAVIGATION_COMMAND;
-	    for (int i=0;i<command_type.length();i++)
-	    {
-	    	payload_buffer[count]=command_type[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-	    for (int i=0;i<command.length();i++)
-	    {
-	    	payload_buffer[count]=command[i];
-	    	count++;
-	    }
-	    payload_buffer[count]=' ';
-	    count++;
-	    payload_buffer[count]=48+wait;
-	    count++;
-	    payload_buffer[count]=' ';
-	    count++;
-	    payload_buffer[count]=48+dataset;
-	    count++;
+	    _checkScanLease("SickNav350::GetDataNavigation");
 
 	    /* Create the Sick messages */
-	    SickNav350Message send_message(payload_buffer,count);
+	    SickNav350Message send_message;
 	    SickNav350Message recv_message;
-
+	    _buildDataNavigationRequest(wait,dataset,send_message);
 
 	    uint8_t byte_sequence[] = {115,65,78,32,109,78,80,79,83,71,101,116,68,97,116,97};
 	    int byte_sequence_length=5;
@@ -1382,11 +1410,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	      _recvMessage(recv_message,byte_sequence,byte_sequence_length,DEFAULT_SICK_MESSAGE_TIMEOUT);
 //	      std::cout<<"second message"<<std::endl;
 
-	      //sick_nav350_sector_data_t.=0;
-	      _SplitReceivedMessage(recv_message);
-	    //  recv_message.Print();
-//	       std::cout<<"argument count="<<argumentcount_<<std::endl;
-	      _ParseScanDataNavigation();
+	      _parseDataNavigationReply(recv_message);
 //	      std::cout<<"Get data"<<std::endl;
 	    }
 
@@ -1406,6 +1430,112 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	      throw;
 	    }
   }
+
+  /**
+   * \brief Sends a navigation data request without waiting for the reply, so one
+   *        thread can keep requests to several devices in flight
+   */
+  void SickNav350::RequestDataNavigation(int wait,int dataset)
+  {
+	    _checkScanLease("SickNav350::RequestDataNavigation");
+
+	    SickNav350Message send_message;
+	    _buildDataNavigationRequest(wait,dataset,send_message);
+
+	    _navigation_request_pending = true;
+	    gettimeofday(&_navigation_request_time,NULL);
+	    _sendMessage(send_message,0);
+  }
+
+  /**
+   * \brief Picks up the reply to RequestDataNavigation (the acknowledgement and
+   *        anything else in front of it is skipped)
+   * \return True once the reply has been parsed into PoseData_, MeasuredData_ and ReflectorData_
+   *
+   * NOTE: Throws a SickConfigException while MeasuredData_ is lent out; the reply
+   *       is left waiting and is picked up by the first poll after the release.
+   */
+  bool SickNav350::PollDataNavigation( ) throw( SickTimeoutException, SickConfigException )
+  {
+	    if (!_navigation_request_pending) {
+	      return false;
+	    }
+
+	    /* A lease may have been granted since the request went out */
+	    _checkScanLease("SickNav350::PollDataNavigation");
+
+	    /* "sAN mNPOSGetData"; acknowledgements such as "sAN mNPOSSetSpeed" share the prefix */
+	    uint8_t byte_sequence[] = {115,65,78,32,109,78,80,79,83,71,101,116,68,97,116,97};
+	    uint8_t payload_buffer[sizeof(byte_sequence)] = {0};
+
+	    SickNav350Message recv_message;
+	    while (_sick_buffer_monitor->GetNextMessageFromMonitor(recv_message)) {
+
+	      if (recv_message.GetPayloadLength() < sizeof(byte_sequence)) {
+		continue;
+	      }
+
+	      recv_message.GetPayloadSubregion(payload_buffer,0,sizeof(byte_sequence)-1);
+	      if (memcmp(payload_buffer,byte_sequence,sizeof(byte_sequence)) == 0) {
+		_navigation_request_pending = false;
+		_parseDataNavigationReply(recv_message);
+		return true;
+	      }
+
+	    }
+
+	    struct timeval now;
+	    gettimeofday(&now,NULL);
+	    if (_computeElapsedTime(_navigation_request_time,now) > DEFAULT_SICK_MESSAGE_TIMEOUT) {
+	      _navigation_request_pending = false;
+	      _sick_buffer_monitor->GetHealthCounters().ReplyTimeout();
+	      throw SickTimeoutException("SickNav350::PollDataNavigation: Timeout occurred!");
+	    }
+
+	    return false;
+  }
+
+  void SickNav350::_buildDataNavigationRequest(int wait,int dataset,SickNav350Message &send_message) const
+  {
+	    uint8_t payload_buffer[SickNav350Message::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+	    int count=0;
+	    std::string command_type=this->GETDATANAVIGATION_COMMAND_TYPE;
+	    std::string command=this->GETDATANAVIGATION_COMMAND;
+	    for (int i=0;i<command_type.length();i++)
+	    {
+	    	payload_buffer[count]=command_type[i];
+	    	count++;
+	    }
+	    payload_buffer[count]=' ';
+	    count++;
+	    for (int i=0;i<command.length();i++)
+	    {
+	    	payload_buffer[count]=command[i];
+	    	count++;
+	    }
+	    payload_buffer[count]=' ';
+	    count++;
+	    payload_buffer[count]=48+wait;
+	    count++;
+	    payload_buffer[count]=' ';
+	    count++;
+	    payload_buffer[count]=48+dataset;
+	    count++;
+
+	    send_message.BuildMessage(payload_buffer,count);
+  }
+
+  void SickNav350::_parseDataNavigationReply(SickNav350Message &recv_message)
+  {
+	      //sick_nav350_sector_data_t.=0;
+	      _SplitReceivedMessage(recv_message);
+	    //  recv_message.Print();
+//	       std::cout<<"argument count="<<argumentcount_<<std::endl;
+	      _ParseScanDataNavigation();
+	      SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+	      SICK_LATENCY_RECORD(_sick_latency,recv_message);
+  }
+
   void SickNav350::_ParseScanDataNavigation()
   {
 /*	  for (int i=0;i<this->argumentcount_;i++)
@@ -1460,7 +1590,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	//	  std::cout<<"Landmark data follow"<<std::endl;
 		  ReflectorData_.filter=_ConvertHexToDec(arg[count++]);
 		//  std::cout<<"Landmark filter "<<std::endl;
-		  int refcount=atoi(arg[count++].c_str());
+		  int num_reported=0;
+		  int refcount=_ParseReflectorCount(arg[count++],num_reported);
 		  ReflectorData_.num_reflector=refcount;
 //		  std::cout<<"reflector count: "<<refcount<<std::endl;
 		  for (int i=0;i<refcount;i++)
@@ -1516,6 +1647,10 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 			  }
 
 		  }
+		  for (int i=refcount;i<num_reported;i++)
+		  {
+			  _SkipReflectorData(count);
+		  }
 //		  for ()
 	  }
 
@@ -1602,6 +1737,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   	      _SplitReceivedMessage(recv_message);
   //	       std::cout<<"argument count="<<argumentcount_<<std::endl;
   	      _ParseScanDataMapping();
+  	      SICK_LATENCY_STAMP(recv_message,SICK_LATENCY_PARSE_COMPLETE);
+  	      SICK_LATENCY_RECORD(_sick_latency,recv_message);
   	//      std::cout<<"Mapping Successful"<<std::endl;
   	    }
 
@@ -1654,7 +1791,8 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	  		//std::cout<<"Landmark data follow"<<std::endl;
 	  				  ReflectorData_.filter=_ConvertHexToDec(arg[count++]);
 	  				//  std::cout<<"Landmark filter "<<std::endl;
-	  				  int refcount=atoi(arg[count++].c_str());
+	  				  int num_reported=0;
+	  				  int refcount=_ParseReflectorCount(arg[count++],num_reported);
 	  				  ReflectorData_.num_reflector=refcount;
 	  		//		  std::cout<<"reflector count: "<<refcount<<std::endl;
 	  				  for (int i=0;i<refcount;i++)
@@ -1709,6 +1847,10 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	  						  std::cout<<"no optional reflector data"<<std::endl;
 	  					  }
 	  				  }
+	  				  for (int i=refcount;i<num_reported;i++)
+	  				  {
+	  					  _SkipReflectorData(count);
+	  				  }
 	  //		  for ()
 	  	  }
 
@@ -1736,58 +1878,22 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   	    payload_buffer[count]=' ';
   	    count++;
 
-  	    char c[100];
-   	    sprintf(c,"%d",(int)mean);
-    	    for (int i=0;i<strlen(c);i++)
-	    	  	{
-	    	    	payload_buffer[count]=c[i];
-                    count++;
-   	  	        }
+   	    count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)mean);
   	    payload_buffer[count]=' ';
   	   	count++;
   	   	payload_buffer[count]=48+neg;
   	   	count++;
 
   	    
-  	  	    sprintf(c,"%d",(int)(x*1000));
-  	  	    if (c[0]!='-')
-  	  	    {
-  	  		    payload_buffer[count]='+';
-  	  		    count++;
-  	  	    }
-  	  	    for (int i=0;i<strlen(c);i++)
-  	  	    {
-  	  	    	payload_buffer[count]=c[i];
-  	  	    	count++;
-  	  	    }
+  	  	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(x*1000));
   	  	    payload_buffer[count]=' ';
   	  	    count++;
 
-  	  	    sprintf(c,"%d",(int)(y*1000));
-  	  	    if (c[0]!='-')
-  	  	    {
-  	  		    payload_buffer[count]='+';
-  	  		    count++;
-  	  	    }
-  	  	    for (int i=0;i<strlen(c);i++)
-  	  	    {
-  	  	    	payload_buffer[count]=c[i];
-  	  	    	count++;
-  	  	    }
+  	  	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(y*1000));
   	  	    payload_buffer[count]=' ';
   	  	    count++;
 
-  	  	    sprintf(c,"%d",(int)(phi/3.14159*180*1000));
-  	  	    if (c[0]!='-')
-  	  	    {
-  	  		    payload_buffer[count]='+';
-  	  		    count++;
-  	  	    }
-  	  	    for (int i=0;i<strlen(c);i++)
-  	  	    {
-  	  	    	payload_buffer[count]=c[i];
-  	  	    	count++;
-  	  	    }
+  	  	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(phi/3.14159*180*1000));
   	    /* Create the Sick messages */
   	    SickNav350Message send_message(payload_buffer,count);
   	    SickNav350Message recv_message;
@@ -1847,13 +1953,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
   	    payload_buffer[count]=' ';
   	    count++;
 
-   	    char c[100];
-   	    sprintf(c,"%d",(int)currLayer);
-    	    for (int i=0;i<strlen(c);i++)
-	    	  	{
-	    	    	payload_buffer[count]=c[i];
-                    count++;
-   	  	        }
+   	    count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)currLayer);
 
   	    /* Create the Sick messages */
   	    SickNav350Message send_message(payload_buffer,count);
@@ -1975,13 +2075,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
    	    payload_buffer[count]=' ';
    	    count++;
 
-   	    char c[100];
-   	    sprintf(c,"%d",(int)size);
-    	    for (int i=0;i<strlen(c);i++)
-	    	  	{
-	    	    	payload_buffer[count]=c[i];
-                    count++;
-   	  	        }
+   	    count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)size);
 
    	    /* Create the Sick messages */
    	    SickNav350Message send_message(payload_buffer,count);
@@ -2041,41 +2135,15 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	    	    }
 	    	    payload_buffer[count]=' ';
 	    	    count++;
-	    	    char c[100];
-	    	    sprintf(c,"%d",(int)landmarkData);
-	    	    for (int i=0;i<strlen(c);i++)
-	    	  	{
-	    	    	payload_buffer[count]=c[i];
-                    count++;
- 	  	        }
+	    	    count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)landmarkData);
 	    	    payload_buffer[count]=' ';
 	    	    count++;
 
-	    	    sprintf(c,"%d",(int)(x*1000));
-	    	  	    if (c[0]!='-')
-	    	  	    {
-	    	  		    payload_buffer[count]='+';
-	    	  		    count++;
-	    	  	    }
-	    	  	    for (int i=0;i<strlen(c);i++)
-	    	  	    {
-	    	  	    	payload_buffer[count]=c[i];
-	    	  	    	count++;
-	    	  	    }
+	    	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(x*1000));
 	    	  	    payload_buffer[count]=' ';
 	    	  	    count++;
 
-	    	  	    sprintf(c,"%d",(int)(y*1000));
-	    	  	    if (c[0]!='-')
-	    	  	    {
-	    	  		    payload_buffer[count]='+';
-	    	  		    count++;
-	    	  	    }
-	    	  	    for (int i=0;i<strlen(c);i++)
-	    	  	    {
-	    	  	    	payload_buffer[count]=c[i];
-	    	  	    	count++;
-	    	  	    }
+	    	  	    count+=sick_cola_write_signed_decimal((char *)payload_buffer+count,(int)(y*1000));
 	    	  	    payload_buffer[count]=' ';
 	    	  	    count++;
 
@@ -2087,12 +2155,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	                count++;
 	                payload_buffer[count] = ' ';
 	                count++;
-		    	    sprintf(c,"%d",(int)size);
-		    	    for (int i=0;i<strlen(c);i++)
-		    	  	{
-		    	    	payload_buffer[count]=c[i];
-	                    count++;
-	 	  	        }
+		    	    count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)size);
 		    	    payload_buffer[count]=' ';
 		    	    count++;
 	                payload_buffer[count]=48+layerID;
@@ -2100,12 +2163,7 @@ const std::string SickNav350::ADDLANDMARK_COMMAND="mNLAYAddLandmark";
 	                payload_buffer[count] = ' ';
 	                count++;
 
-	                sprintf(c,"%d",(int)ID);
-	                for (int i=0;i<strlen(c);i++)
-	                   {
-	                    	payload_buffer[count]=c[i];
-	                    	count++;
-	                   }
+	                count+=sick_cola_write_decimal((char *)payload_buffer+count,(int)ID);
 
 
 	    	    /* Create the Sick messages */
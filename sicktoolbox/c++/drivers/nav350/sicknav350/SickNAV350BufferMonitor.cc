@@ -51,6 +51,7 @@ namespace SickToolbox {
     uint8_t message_buffer[SICK_NAV350_MSG_PAYLOAD_MAX_LEN /*SickNav350Message::MESSAGE_MAX_LENGTH*/] = {0};
     uint32_t payload_length = 0;
 	int8_t succ=0;
+    bool resynced = false, frame_started = false;
 
     try {
 
@@ -67,9 +68,14 @@ namespace SickToolbox {
     	  }
     	  else {
     		  i = 0;
+    		  if (!resynced) {
+    			  _sick_health.Resync();
+    			  resynced = true;
+    		  }
     	  }
 	
       }  
+      frame_started = true;
       /* Populate message buffer w/ response header */
       memcpy(message_buffer,sick_response_header,1);
 
@@ -94,6 +100,7 @@ namespace SickToolbox {
       if (succ==0)
       {
     	  std::cout<<"Incorrect message"<<std::endl;
+    	  _sick_health.FrameDropped();
     	  return;
       }
       
@@ -114,11 +121,17 @@ namespace SickToolbox {
 
     }
 
-    catch(SickTimeoutException &sick_timeout) { /* This is ok! */ }
+    catch(SickTimeoutException &sick_timeout) {
+      /* This is ok! (unless a frame was cut short) */
+      if (frame_started) {
+	_sick_health.FrameTimeout();
+      }
+    }
     
     /* Catch a bad checksum! */
     catch(SickBadChecksumException &sick_checksum_exception) {
       sick_message.Clear(); // Clear the message container
+      _sick_health.ChecksumFailure();
     }
     
     /* Catch any serious IO buffer exceptions */
@@ -0,0 +1,186 @@
+/*!
+ * \file ld_benchmark.cc
+ * \brief Replays GET_PROFILE replies through the LD receive path.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "parser_benchmark.h"
+
+#include <cstdlib>
+#include <sicktoolbox/SickLD.hh>
+
+/* Macros */
+#define LD_BENCHMARK_NUM_VALUES                      (720)  ///< 0.5 deg over a single full sector
+#define LD_BENCHMARK_ANGLE_STEP                        (8)  ///< 0.5 deg (1/16 deg)
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \brief Parses a profile as SickLD::_acquireSickScanProfile() does
+   * \param &sick_ld The driver (receives the profile)
+   * \param &recv_message The profile
+   */
+  void SickParserBenchmark::_parseLDProfile( SickLD &sick_ld, const SickLDMessage &recv_message ) {
+    uint8_t payload_buffer[SickLDMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    recv_message.GetPayload(payload_buffer);
+    sick_ld._parseScanProfile(&payload_buffer[2],sick_ld._sick_scan_profile);
+  }
+
+  /**
+   * \class LDProfileBenchmark
+   * \brief GET_PROFILE replies w/ one sector in the given profile format
+   */
+  class LDProfileBenchmark : public SickParserBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    LDProfileBenchmark( const std::string &name, const uint16_t profile_format ) :
+      SickParserBenchmark(name), _profile_format(profile_format) { }
+
+    /** Synthesizes profiles w/ LD_BENCHMARK_NUM_VALUES points */
+    void Synthesize( const unsigned int num_payloads );
+
+    /** Keeps recorded profiles of the same format */
+    bool AddRecordedTelegram( const uint8_t * const message, const unsigned int length );
+
+    /** Runs one profile through the receive path */
+    void Parse( const std::vector< uint8_t > &payload ) {
+      _monitor_message.BuildMessage(&payload[0],payload.size());
+      _handOff(_monitor_message,_container,_recv_message);
+      _parseLDProfile(_sick_ld,_recv_message);
+    }
+
+  private:
+
+    /** The profile format (see SickLD::SICK_SCAN_PROFILE_RANGE) */
+    uint16_t _profile_format;
+
+    /** The driver (never initialized) */
+    SickLD _sick_ld;
+
+    /** The message built by the buffer monitor */
+    SickLDMessage _monitor_message;
+
+    /** The buffer monitor's container */
+    SickLDMessage _container;
+
+    /** The driver's receive message */
+    SickLDMessage _recv_message;
+
+    /** Appends a big-endian 16-bit value to the payload */
+    static void _append16( std::vector< uint8_t > &payload, const uint16_t value ) {
+      payload.push_back((uint8_t)(value >> 8));
+      payload.push_back((uint8_t)(value & 0xFF));
+    }
+
+  };
+
+  /**
+   * \brief Synthesizes profiles w/ LD_BENCHMARK_NUM_VALUES points
+   * \param num_payloads The number of distinct profiles
+   */
+  void LDProfileBenchmark::Synthesize( const unsigned int num_payloads ) {
+
+    unsigned int seed = _profile_format;
+    for (unsigned int n = 0; n < num_payloads; n++) {
+
+      std::vector< uint8_t > payload;
+      payload.push_back(SickLD::SICK_MEAS_SERV_CODE | 0x80);
+      payload.push_back((uint8_t)SickLD::SICK_MEAS_SERV_GET_PROFILE);
+      _append16(payload,_profile_format);
+      _append16(payload,1);                                   // One sector
+
+      if (_profile_format & 0x0001) {
+	_append16(payload,n);                                 // PROFILESENT
+      }
+      if (_profile_format & 0x0002) {
+	_append16(payload,n);                                 // PROFILECOUNT
+      }
+      if (_profile_format & 0x0004) {
+	_append16(payload,0);                                 // LAYERNUM
+      }
+      if (_profile_format & 0x0008) {
+	_append16(payload,0);                                 // SECTORNUM
+      }
+      if (_profile_format & 0x0010) {
+	_append16(payload,LD_BENCHMARK_ANGLE_STEP);           // DIRSTEP
+      }
+      if (_profile_format & 0x0020) {
+	_append16(payload,LD_BENCHMARK_NUM_VALUES);           // POINTNUM
+      }
+      if (_profile_format & 0x0040) {
+	_append16(payload,n*100);                             // TSTART
+      }
+      if (_profile_format & 0x0080) {
+	_append16(payload,0);                                 // STARTDIR
+      }
+
+      for (unsigned int i = 0; i < LD_BENCHMARK_NUM_VALUES; i++) {
+	if (_profile_format & 0x0100) {
+	  _append16(payload,(uint16_t)(128 + rand_r(&seed) % 5000));
+	}
+	if (_profile_format & 0x0200) {
+	  _append16(payload,i*LD_BENCHMARK_ANGLE_STEP);
+	}
+	if (_profile_format & 0x0400) {
+	  _append16(payload,(uint16_t)(100 + rand_r(&seed) % 900));
+	}
+      }
+
+      if (_profile_format & 0x0800) {
+	_append16(payload,n*100 + 99);                        // TEND
+      }
+      if (_profile_format & 0x1000) {
+	_append16(payload,(LD_BENCHMARK_NUM_VALUES - 1)*LD_BENCHMARK_ANGLE_STEP);
+      }
+      if (_profile_format & 0x2000) {
+	_append16(payload,0);                                 // SENSTAT (measuring, motor ok)
+	_append16(payload,SickLD::SICK_SENSOR_MODE_MEASURE | (SickLD::SICK_MOTOR_MODE_OK << 4));
+      }
+
+      _payloads.push_back(payload);
+    }
+
+  }
+
+  /**
+   * \brief Keeps recorded profiles of the same format
+   * \param message The recorded frame ("\x02USP", length, payload, checksum)
+   * \param length The frame length
+   * \return True if the frame was kept
+   */
+  bool LDProfileBenchmark::AddRecordedTelegram( const uint8_t * const message, const unsigned int length ) {
+
+    const unsigned int payload_offset = SickLDMessage::MESSAGE_HEADER_LENGTH;
+    if (length < payload_offset + 4 + SickLDMessage::MESSAGE_TRAILER_LENGTH ||
+	message[1] != 'U' || message[2] != 'S' || message[3] != 'P' ||
+	message[payload_offset] != (SickLD::SICK_MEAS_SERV_CODE | 0x80) ||
+	message[payload_offset+1] != SickLD::SICK_MEAS_SERV_GET_PROFILE ||
+	(message[payload_offset+2] << 8 | message[payload_offset+3]) != _profile_format) {
+      return false;
+    }
+
+    _payloads.push_back(std::vector< uint8_t >(&message[payload_offset],&message[length - SickLDMessage::MESSAGE_TRAILER_LENGTH]));
+    return true;
+  }
+
+  /**
+   * \brief Appends the LD cases
+   * \param &benchmarks The case list
+   */
+  void AddLDBenchmarks( std::vector< SickParserBenchmark * > &benchmarks ) {
+    benchmarks.push_back(new LDProfileBenchmark("ld GET_PROFILE range (720)",SickLD::SICK_SCAN_PROFILE_RANGE));
+    benchmarks.push_back(new LDProfileBenchmark("ld GET_PROFILE range+echo (720)",SickLD::SICK_SCAN_PROFILE_RANGE_AND_ECHO));
+  }
+
+} //namespace SickToolbox
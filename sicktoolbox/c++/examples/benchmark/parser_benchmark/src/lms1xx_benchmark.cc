@@ -0,0 +1,199 @@
+/*!
+ * \file lms1xx_benchmark.cc
+ * \brief Replays LMDscandata telegrams through the LMS 1xx receive path.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "parser_benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sicktoolbox/SickLMS1xx.hh>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \brief Parses a scan telegram as SickLMS1xx::GetSickMeasurements() does
+   * \param &sick_lms_1xx The driver
+   * \param &recv_message The telegram
+   * \param range_vals Receives the first pulse ranges
+   * \param reflect_vals Receives the first pulse reflectivity (NULL if not streamed)
+   * \param &num_measurements Receives the number of ranges
+   */
+  void SickParserBenchmark::_parseLMS1xxScanData( const SickLMS1xx &sick_lms_1xx, const SickLMS1xxMessage &recv_message,
+						  unsigned int * const range_vals, unsigned int * const reflect_vals,
+						  unsigned int &num_measurements ) {
+    sick_lms_1xx._parseSickScanData(recv_message,range_vals,NULL,reflect_vals,NULL,num_measurements,NULL);
+  }
+
+  /**
+   * \class LMS1xxScanDataBenchmark
+   * \brief LMDscandata telegrams w/ DIST1 and optionally 8-bit RSSI1
+   */
+  class LMS1xxScanDataBenchmark : public SickParserBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    LMS1xxScanDataBenchmark( const std::string &name, const unsigned int num_values, const bool rssi ) :
+      SickParserBenchmark(name), _num_values(num_values), _rssi(rssi) { }
+
+    /** Synthesizes telegrams w/ _num_values beams */
+    void Synthesize( const unsigned int num_payloads );
+
+    /** Keeps recorded LMDscandata telegrams of the matching format */
+    bool AddRecordedTelegram( const uint8_t * const message, const unsigned int length );
+
+    /** Runs one telegram through the receive path */
+    void Parse( const std::vector< uint8_t > &payload ) {
+      unsigned int num_measurements = 0;
+      _monitor_message.BuildMessage(&payload[0],payload.size());
+      _handOff(_monitor_message,_container,_recv_message);
+      _parseLMS1xxScanData(_sick_lms_1xx,_recv_message,_range_vals,_rssi ? _reflect_vals : NULL,num_measurements);
+    }
+
+  private:
+
+    /** Number of beams in a synthetic telegram */
+    unsigned int _num_values;
+
+    /** Whether the telegrams carry RSSI1 */
+    bool _rssi;
+
+    /** The driver (never initialized) */
+    SickLMS1xx _sick_lms_1xx;
+
+    /** The message built by the buffer monitor */
+    SickLMS1xxMessage _monitor_message;
+
+    /** The buffer monitor's container */
+    SickLMS1xxMessage _container;
+
+    /** The driver's receive message */
+    SickLMS1xxMessage _recv_message;
+
+    /** Parsed ranges */
+    unsigned int _range_vals[SickLMS1xx::SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];
+
+    /** Parsed reflectivity */
+    unsigned int _reflect_vals[SickLMS1xx::SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];
+
+    /** Appends " <value in hex>" to the payload */
+    static void _appendHex( std::string &payload, const unsigned int value );
+
+  };
+
+  /**
+   * \brief Synthesizes telegrams w/ _num_values beams
+   * \param num_payloads The number of distinct telegrams
+   */
+  void LMS1xxScanDataBenchmark::Synthesize( const unsigned int num_payloads ) {
+
+    /* 1081 beams need 0.25 deg at 25 Hz, otherwise 0.5 deg at 50 Hz */
+    const unsigned int scan_freq = (_num_values > 541) ? 2500 : 5000;
+    const unsigned int scan_res = (_num_values > 541) ? 2500 : 5000;
+    unsigned int seed = 100 + _num_values;
+
+    for (unsigned int n = 0; n < num_payloads; n++) {
+
+      /* Device, status and timing blocks */
+      std::string payload = "sSN LMDscandata 1 1 EE5A1A 0 0";
+      _appendHex(payload,n + 1);
+      _appendHex(payload,n + 1);
+      _appendHex(payload,n*20000);
+      _appendHex(payload,n*20000 + 100);
+      payload += " 0 0 0 0 0";
+      _appendHex(payload,scan_freq);
+      _appendHex(payload,scan_freq/100*_num_values/100);
+      payload += " 0";
+
+      /* DIST1 (and RSSI1) */
+      std::vector< unsigned int > ranges(_num_values);
+      for (unsigned int i = 0; i < _num_values; i++) {
+	ranges[i] = 500 + rand_r(&seed) % 19500;
+      }
+
+      payload += " 1 DIST1 3F800000 00000000 FFF92230";
+      _appendHex(payload,scan_res);
+      _appendHex(payload,_num_values);
+      for (unsigned int i = 0; i < _num_values; i++) {
+	_appendHex(payload,ranges[i]);
+      }
+
+      if (_rssi) {
+	payload += " 1 RSSI1 3F800000 00000000 FFF92230";
+	_appendHex(payload,scan_res);
+	_appendHex(payload,_num_values);
+	for (unsigned int i = 0; i < _num_values; i++) {
+	  _appendHex(payload,255 - ranges[i]/100);
+	}
+      }
+      else {
+	payload += " 0";
+      }
+
+      /* No position, name, comment, time or event */
+      payload += " 0 0 0 0 0";
+
+      _payloads.push_back(std::vector< uint8_t >(payload.begin(),payload.end()));
+    }
+
+  }
+
+  /**
+   * \brief Keeps recorded LMDscandata telegrams of the matching format
+   * \param message The recorded frame (STX ... ETX)
+   * \param length The frame length
+   * \return True if the frame was kept
+   */
+  bool LMS1xxScanDataBenchmark::AddRecordedTelegram( const uint8_t * const message, const unsigned int length ) {
+
+    const unsigned int framing_length = SickLMS1xxMessage::MESSAGE_HEADER_LENGTH + SickLMS1xxMessage::MESSAGE_TRAILER_LENGTH;
+    const char * const command = "sSN LMDscandata ";
+    if (length < framing_length + strlen(command) ||
+	strncmp((const char *)&message[SickLMS1xxMessage::MESSAGE_HEADER_LENGTH],command,strlen(command)) != 0) {
+      return false;
+    }
+
+    /* The RSSI case only takes telegrams that carry RSSI1 (and vice versa) */
+    const std::string telegram((const char *)message,length);
+    if ((telegram.find("RSSI1") != std::string::npos) != _rssi) {
+      return false;
+    }
+
+    _payloads.push_back(std::vector< uint8_t >(&message[SickLMS1xxMessage::MESSAGE_HEADER_LENGTH],
+					       &message[length - SickLMS1xxMessage::MESSAGE_TRAILER_LENGTH]));
+    return true;
+  }
+
+  /**
+   * \brief Appends " <value in hex>" to the payload
+   * \param &payload The payload being built
+   * \param value The value
+   */
+  void LMS1xxScanDataBenchmark::_appendHex( std::string &payload, const unsigned int value ) {
+    char hex_buffer[16];
+    snprintf(hex_buffer,sizeof(hex_buffer)," %X",value);
+    payload += hex_buffer;
+  }
+
+  /**
+   * \brief Appends the LMS 1xx cases
+   * \param &benchmarks The case list
+   */
+  void AddLMS1xxBenchmarks( std::vector< SickParserBenchmark * > &benchmarks ) {
+    benchmarks.push_back(new LMS1xxScanDataBenchmark("lms1xx LMDscandata DIST1 (541)",541,false));
+    benchmarks.push_back(new LMS1xxScanDataBenchmark("lms1xx LMDscandata DIST1+RSSI1 (1081)",1081,true));
+  }
+
+} //namespace SickToolbox
@@ -0,0 +1,191 @@
+/*!
+ * \file lms2xx_benchmark.cc
+ * \brief Replays B0 and C4 replies through the LMS 2xx receive path.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "parser_benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sicktoolbox/SickLMS2xx.hh>
+
+/* Macros */
+#define LMS2XX_BENCHMARK_NUM_VALUES_B0               (361)  ///< 0.5 deg over 180 deg
+#define LMS2XX_BENCHMARK_NUM_VALUES_C4               (181)  ///< 1 deg over 180 deg (C4 must fit w/ reflectivity)
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \brief Parses a B0 reply as SickLMS2xx::GetSickScan() (range only) does
+   * \param &sick_lms_2xx The driver (receives the profile)
+   * \param &recv_message The reply
+   */
+  void SickParserBenchmark::_parseLMS2xxB0( SickLMS2xx &sick_lms_2xx, const SickLMS2xxMessage &recv_message ) {
+    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    recv_message.GetPayload(payload_buffer);
+    sick_lms_2xx._sick_scan_profile.sick_num_measurements = 0;
+    sick_lms_2xx._parseSickScanProfileB0(&payload_buffer[1],sick_lms_2xx._sick_scan_profile);
+  }
+
+  /**
+   * \brief Parses a C4 reply as SickLMS2xx::GetSickScan() (range and reflectivity) does
+   * \param &sick_lms_2xx The driver
+   * \param &recv_message The reply
+   */
+  void SickParserBenchmark::_parseLMS2xxC4( const SickLMS2xx &sick_lms_2xx, const SickLMS2xxMessage &recv_message ) {
+    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    recv_message.GetPayload(payload_buffer);
+    SickLMS2xx::sick_lms_2xx_scan_profile_c4_t sick_scan_profile;
+    memset(&sick_scan_profile,0,sizeof(SickLMS2xx::sick_lms_2xx_scan_profile_c4_t));
+    sick_lms_2xx._parseSickScanProfileC4(&payload_buffer[1],sick_scan_profile);
+  }
+
+  /**
+   * \class LMS2xxScanBenchmark
+   * \brief B0 (range) or C4 (range and reflectivity) replies
+   */
+  class LMS2xxScanBenchmark : public SickParserBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    LMS2xxScanBenchmark( const std::string &name, const uint8_t command_code ) :
+      SickParserBenchmark(name), _command_code(command_code), _sick_lms_2xx("/dev/null") { }
+
+    /** Synthesizes replies */
+    void Synthesize( const unsigned int num_payloads );
+
+    /** Keeps recorded replies w/ the same command code */
+    bool AddRecordedTelegram( const uint8_t * const message, const unsigned int length );
+
+    /** Runs one reply through the receive path */
+    void Parse( const std::vector< uint8_t > &payload ) {
+      _monitor_message.BuildMessage(DEFAULT_SICK_LMS_2XX_HOST_ADDRESS,&payload[0],payload.size());
+      _handOff(_monitor_message,_container,_recv_message);
+      if (_command_code == 0xB0) {
+	_parseLMS2xxB0(_sick_lms_2xx,_recv_message);
+      }
+      else {
+	_parseLMS2xxC4(_sick_lms_2xx,_recv_message);
+      }
+    }
+
+  private:
+
+    /** The reply's command code (0xB0 or 0xC4) */
+    uint8_t _command_code;
+
+    /** The driver (never initialized) */
+    SickLMS2xx _sick_lms_2xx;
+
+    /** The message built by the buffer monitor */
+    SickLMS2xxMessage _monitor_message;
+
+    /** The buffer monitor's container */
+    SickLMS2xxMessage _container;
+
+    /** The driver's receive message */
+    SickLMS2xxMessage _recv_message;
+
+    /** Appends measurements (little-endian, 13-bit range plus field bits) */
+    static void _appendMeasurements( std::vector< uint8_t > &payload, const unsigned int num_values, unsigned int &seed );
+
+  };
+
+  /**
+   * \brief Synthesizes replies
+   * \param num_payloads The number of distinct replies
+   */
+  void LMS2xxScanBenchmark::Synthesize( const unsigned int num_payloads ) {
+
+    unsigned int seed = _command_code;
+    for (unsigned int n = 0; n < num_payloads; n++) {
+
+      std::vector< uint8_t > payload;
+      payload.push_back(_command_code);
+
+      if (_command_code == 0xB0) {
+	_appendMeasurements(payload,LMS2XX_BENCHMARK_NUM_VALUES_B0,seed);
+      }
+      else {
+
+	_appendMeasurements(payload,LMS2XX_BENCHMARK_NUM_VALUES_C4,seed);
+
+	/* Reflectivity over the whole range */
+	payload.push_back(LMS2XX_BENCHMARK_NUM_VALUES_C4 & 0xFF);
+	payload.push_back(LMS2XX_BENCHMARK_NUM_VALUES_C4 >> 8);
+	payload.push_back(1);
+	payload.push_back(0);
+	payload.push_back(LMS2XX_BENCHMARK_NUM_VALUES_C4 & 0xFF);
+	payload.push_back(LMS2XX_BENCHMARK_NUM_VALUES_C4 >> 8);
+	for (unsigned int i = 0; i < LMS2XX_BENCHMARK_NUM_VALUES_C4; i++) {
+	  payload.push_back((uint8_t)(rand_r(&seed) & 0xFF));
+	}
+
+      }
+
+      payload.push_back((uint8_t)n);                        // Telegram index
+      payload.push_back(0x10);                              // Status
+
+      _payloads.push_back(payload);
+    }
+
+  }
+
+  /**
+   * \brief Keeps recorded replies w/ the same command code
+   * \param message The recorded frame (STX, address, length, payload, CRC)
+   * \param length The frame length
+   * \return True if the frame was kept
+   */
+  bool LMS2xxScanBenchmark::AddRecordedTelegram( const uint8_t * const message, const unsigned int length ) {
+
+    const unsigned int payload_offset = SickLMS2xxMessage::MESSAGE_HEADER_LENGTH;
+    if (length < payload_offset + 1 + SickLMS2xxMessage::MESSAGE_TRAILER_LENGTH ||
+	message[0] != 0x02 || message[1] != DEFAULT_SICK_LMS_2XX_HOST_ADDRESS ||
+	message[payload_offset] != _command_code) {
+      return false;
+    }
+
+    _payloads.push_back(std::vector< uint8_t >(&message[payload_offset],&message[length - SickLMS2xxMessage::MESSAGE_TRAILER_LENGTH]));
+    return true;
+  }
+
+  /**
+   * \brief Appends measurements (little-endian, 13-bit range plus field bits)
+   * \param &payload The payload being built
+   * \param num_values The number of measurements
+   * \param &seed The generator state
+   */
+  void LMS2xxScanBenchmark::_appendMeasurements( std::vector< uint8_t > &payload, const unsigned int num_values, unsigned int &seed ) {
+
+    payload.push_back(num_values & 0xFF);
+    payload.push_back(num_values >> 8);
+    for (unsigned int i = 0; i < num_values; i++) {
+      const uint16_t value = (uint16_t)(100 + rand_r(&seed) % 8000);
+      payload.push_back(value & 0xFF);
+      payload.push_back((value >> 8) & 0x1F);
+    }
+
+  }
+
+  /**
+   * \brief Appends the LMS 2xx cases
+   * \param &benchmarks The case list
+   */
+  void AddLMS2xxBenchmarks( std::vector< SickParserBenchmark * > &benchmarks ) {
+    benchmarks.push_back(new LMS2xxScanBenchmark("lms2xx B0 range (361)",0xB0));
+    benchmarks.push_back(new LMS2xxScanBenchmark("lms2xx C4 range+reflect (181)",0xC4));
+  }
+
+} //namespace SickToolbox
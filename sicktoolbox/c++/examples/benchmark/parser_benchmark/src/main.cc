@@ -0,0 +1,254 @@
+/*!
+ * \file main.cc
+ * \brief Micro-benchmarks the telegram parsers of the NAV350, LMS 1xx,
+ *        LD and LMS 2xx drivers (and the scan conversion after them)
+ *        on synthetic or recorded telegrams.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <sicktoolbox/SickTelegramLog.hh>
+#include "parser_benchmark.h"
+
+using namespace std;
+using namespace SickToolbox;
+
+/*
+ * Allocation and copy accounting.  malloc() and memcpy() are interposed
+ * for the whole process (operator new and std::string land in them too).
+ * Copies the compiler inlines (small fixed-size memcpy, element-wise
+ * struct copies) are not seen; the message hand-off adds its own.
+ */
+namespace SickToolbox {
+  parser_benchmark_counters_t parser_benchmark_counters = {false,0,0};
+}
+
+static parser_benchmark_counters_t &counters = parser_benchmark_counters;
+
+#ifdef __GLIBC__
+
+extern "C" void *__libc_malloc( size_t size );
+extern "C" void *__libc_calloc( size_t num_elements, size_t size );
+extern "C" void *__libc_realloc( void *ptr, size_t size );
+
+extern "C" void *malloc( size_t size ) __THROW {
+  counters.num_allocations += counters.counting;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc( size_t num_elements, size_t size ) __THROW {
+  counters.num_allocations += counters.counting;
+  return __libc_calloc(num_elements,size);
+}
+
+extern "C" void *realloc( void *ptr, size_t size ) __THROW {
+  counters.num_allocations += counters.counting;
+  return __libc_realloc(ptr,size);
+}
+
+extern "C" void *memcpy( void *destination, const void *source, size_t size ) __THROW {
+  counters.num_bytes_copied += counters.counting ? size : 0;
+  return memmove(destination,source,size);
+}
+
+#define PARSER_BENCHMARK_ACCOUNTING (true)
+#else
+#define PARSER_BENCHMARK_ACCOUNTING (false)
+#endif
+
+/** Returns a monotonic time stamp (nsec) */
+static double now_nsec( ) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  return now.tv_sec*1e9 + now.tv_nsec;
+}
+
+/** Loads the telegrams a device sent from a log into the cases that parse them */
+static unsigned int load_log( const string &log_path, vector< SickParserBenchmark * > &benchmarks ) {
+
+  SickTelegramLog telegram_log;
+  telegram_log.Open(log_path);
+
+  unsigned int num_kept = 0;
+  sick_telegram_t telegram;
+  while (telegram_log.Next(telegram)) {
+
+    if (telegram.direction != SICK_TELEGRAM_FROM_DEVICE) {
+      continue;
+    }
+
+    /* Every case that parses a telegram gets it (e.g. w/ and w/o conversion) */
+    bool kept = false;
+    for (unsigned int i = 0; i < benchmarks.size(); i++) {
+      kept = benchmarks[i]->AddRecordedTelegram(telegram.data,telegram.length) || kept;
+    }
+    num_kept += kept;
+
+  }
+
+  return num_kept;
+}
+
+static void print_usage( ) {
+  cout << "Usage: parser_benchmark [OPTIONS]" << endl
+       << "  --log FILE             replay the scan telegrams of a telegram log instead of synthetic ones" << endl
+       << "  --filter TEXT          only run cases whose name contains TEXT" << endl
+       << "  --min-time SEC         minimum duration of a timed repeat (default 0.2)" << endl
+       << "  --repeats N            timed repeats per case (default 5)" << endl
+       << "Reports the best and median time per telegram, the heap allocations per" << endl
+       << "telegram and the bytes copied per telegram (memcpy() plus the message" << endl
+       << "hand-off; copies the compiler inlines are not seen).  A telegram starts" << endl
+       << "as a framed payload and goes through the same message hand-off and parser" << endl
+       << "calls as in the driver." << endl
+       << "Ex: parser_benchmark --filter nav350" << endl
+       << "    parser_benchmark --log nav350.tlg --repeats 9" << endl;
+}
+
+int main( int argc, char *argv[] ) {
+
+  string log_path, name_filter;
+  double min_time = 0.2;
+  unsigned int num_repeats = 5;
+
+  static struct option long_options[] = {
+    {"log",          required_argument, 0, 'f'},
+    {"filter",       required_argument, 0, 'F'},
+    {"min-time",     required_argument, 0, 't'},
+    {"repeats",      required_argument, 0, 'r'},
+    {"help",         no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int option;
+  while ((option = getopt_long(argc,argv,"h",long_options,NULL)) != -1) {
+    switch (option) {
+    case 'f': log_path = optarg; break;
+    case 'F': name_filter = optarg; break;
+    case 't': min_time = atof(optarg); break;
+    case 'r': num_repeats = max(1,atoi(optarg)); break;
+    default:
+      print_usage();
+      return option == 'h' ? 0 : -1;
+    }
+  }
+
+  vector< SickParserBenchmark * > benchmarks;
+  AddNav350Benchmarks(benchmarks);
+  AddLMS1xxBenchmarks(benchmarks);
+  AddLDBenchmarks(benchmarks);
+  AddLMS2xxBenchmarks(benchmarks);
+
+  /* Fill the cases */
+  if (!log_path.empty()) {
+    try {
+      cout << "Loaded " << load_log(log_path,benchmarks) << " scan telegrams from " << log_path << endl;
+    }
+    catch (SickIOException &sick_io_exception) {
+      cerr << sick_io_exception.what() << endl;
+      return -1;
+    }
+  }
+  else {
+    for (unsigned int i = 0; i < benchmarks.size(); i++) {
+      benchmarks[i]->Synthesize(PARSER_BENCHMARK_NUM_SYNTHETIC);
+    }
+  }
+
+  cout << left << setw(40) << "case" << right
+       << setw(7) << "tlgs" << setw(10) << "bytes/tlg"
+       << setw(12) << "best ns" << setw(12) << "median ns" << setw(10) << "MB/s"
+       << setw(12) << "allocs/tlg" << setw(12) << "copied/tlg" << endl;
+
+  for (unsigned int i = 0; i < benchmarks.size(); i++) {
+
+    SickParserBenchmark &benchmark = *benchmarks[i];
+    const vector< vector< uint8_t > > &payloads = benchmark.GetPayloads();
+    if (payloads.empty() || benchmark.GetName().find(name_filter) == string::npos) {
+      continue;
+    }
+
+    unsigned long num_payload_bytes = 0;
+    for (unsigned int j = 0; j < payloads.size(); j++) {
+      num_payload_bytes += payloads[j].size();
+    }
+
+    try {
+
+      /* Warm up, then count one pass over the set */
+      for (unsigned int j = 0; j < payloads.size(); j++) {
+	benchmark.Parse(payloads[j]);
+      }
+
+      counters.num_allocations = counters.num_bytes_copied = 0;
+      counters.counting = true;
+      for (unsigned int j = 0; j < payloads.size(); j++) {
+	benchmark.Parse(payloads[j]);
+      }
+      counters.counting = false;
+
+      /* Time whole passes until each repeat lasts at least min_time */
+      vector< double > nsec_per_telegram;
+      for (unsigned int repeat = 0; repeat < num_repeats; repeat++) {
+
+	unsigned long num_parsed = 0;
+	const double start_nsec = now_nsec();
+	double elapsed_nsec = 0;
+	do {
+	  for (unsigned int j = 0; j < payloads.size(); j++) {
+	    benchmark.Parse(payloads[j]);
+	  }
+	  num_parsed += payloads.size();
+	  elapsed_nsec = now_nsec() - start_nsec;
+	} while (elapsed_nsec < min_time*1e9);
+
+	nsec_per_telegram.push_back(elapsed_nsec/num_parsed);
+      }
+
+      sort(nsec_per_telegram.begin(),nsec_per_telegram.end());
+      const double best_nsec = nsec_per_telegram.front();
+      const double median_nsec = nsec_per_telegram[nsec_per_telegram.size()/2];
+      const double bytes_per_telegram = (double)num_payload_bytes/payloads.size();
+
+      cout << left << setw(40) << benchmark.GetName() << right << fixed
+	   << setw(7) << payloads.size() << setprecision(0) << setw(10) << bytes_per_telegram
+	   << setprecision(0) << setw(12) << best_nsec << setw(12) << median_nsec
+	   << setprecision(1) << setw(10) << bytes_per_telegram*1e3/best_nsec;
+
+      if (PARSER_BENCHMARK_ACCOUNTING) {
+	cout << setprecision(1) << setw(12) << (double)counters.num_allocations/payloads.size()
+	     << setprecision(0) << setw(12) << (double)counters.num_bytes_copied/payloads.size() << endl;
+      }
+      else {
+	cout << setw(12) << "n/a" << setw(12) << "n/a" << endl;
+      }
+
+    }
+
+    catch (SickException &sick_exception) {
+      counters.counting = false;
+      cerr << benchmark.GetName() << ": " << sick_exception.what() << endl;
+    }
+
+  }
+
+  for (unsigned int i = 0; i < benchmarks.size(); i++) {
+    delete benchmarks[i];
+  }
+
+  return 0;
+}
@@ -0,0 +1,282 @@
+/*!
+ * \file nav350_benchmark.cc
+ * \brief Replays mNPOSGetData replies through the NAV350 receive path.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "parser_benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sicktoolbox/SickNAV350.hh>
+#include <sicktoolbox/SickScanConverter.hh>
+
+/* Macros */
+#define NAV350_BENCHMARK_NUM_VALUES                 (1440)  ///< 0.25 deg over a full revolution
+#define NAV350_BENCHMARK_NUM_REFLECTORS                (8)  ///< Reflectors reported per reply
+#define NAV350_BENCHMARK_MIN_RANGE                   (1.0)  ///< Converter range limits (m; the synthetic ranges are 0.5-20 m)
+#define NAV350_BENCHMARK_MAX_RANGE                  (15.0)
+#define NAV350_BENCHMARK_OFFSET_X                   (0.25)  ///< Converter mounting pose (m, m, deg)
+#define NAV350_BENCHMARK_OFFSET_Y                  (-0.10)
+#define NAV350_BENCHMARK_OFFSET_YAW                 (90.0)
+#define NAV350_BENCHMARK_POINT_TOLERANCE            (1e-4)  ///< Largest difference from the double-precision reference (m)
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \brief Parses a navigation reply as SickNav350::GetDataNavigation() does
+   * \param &sick_nav350 The driver (receives the pose, reflectors and scan)
+   * \param &recv_message The reply
+   */
+  void SickParserBenchmark::_parseNav350Navigation( SickNav350 &sick_nav350, const SickNav350Message &recv_message ) {
+    sick_nav350._SplitReceivedMessage(recv_message);
+    sick_nav350._ParseScanDataNavigation();
+  }
+
+  /**
+   * \class Nav350NavigationBenchmark
+   * \brief mNPOSGetData replies carrying pose, reflectors and a full scan
+   */
+  class Nav350NavigationBenchmark : public SickParserBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    Nav350NavigationBenchmark( const std::string &name = "nav350 mNPOSGetData" ) : SickParserBenchmark(name) { }
+
+    /** Synthesizes replies with NAV350_BENCHMARK_NUM_VALUES ranges */
+    void Synthesize( const unsigned int num_payloads );
+
+    /** Keeps recorded mNPOSGetData replies */
+    bool AddRecordedTelegram( const uint8_t * const message, const unsigned int length );
+
+    /** Runs one reply through the receive path */
+    void Parse( const std::vector< uint8_t > &payload ) {
+      _monitor_message.BuildMessage(&payload[0],payload.size());
+      _handOff(_monitor_message,_container,_recv_message);
+      _parseNav350Navigation(_sick_nav350,_recv_message);
+    }
+
+  protected:
+
+    /** The driver (never initialized) */
+    SickNav350 _sick_nav350;
+
+  private:
+
+    /** The message built by the buffer monitor */
+    SickNav350Message _monitor_message;
+
+    /** The buffer monitor's container */
+    SickNav350Message _container;
+
+    /** The driver's receive message */
+    SickNav350Message _recv_message;
+
+    /** Appends " <value in hex>" to the payload */
+    static void _appendHex( std::string &payload, const unsigned int value );
+
+  };
+
+  /**
+   * \class Nav350ConverterBenchmark
+   * \brief mNPOSGetData replies parsed, then leased and converted to x/y
+   *        (range gate and mounting yaw included) by SickScanConverter
+   *
+   * The first scan converted is checked point by point against a
+   * double-precision reference, so the vector kernel the build targets
+   * (AVX, NEON or none) is checked against the scalar math as well.
+   */
+  class Nav350ConverterBenchmark : public Nav350NavigationBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    Nav350ConverterBenchmark( ) : Nav350NavigationBenchmark("nav350 mNPOSGetData + SickScanConverter"), _checked(false) {
+      _scan_converter.SetUnitScale(0.001);
+      _scan_converter.SetRangeLimits(NAV350_BENCHMARK_MIN_RANGE,NAV350_BENCHMARK_MAX_RANGE);
+      _scan_converter.SetMountingTransform(NAV350_BENCHMARK_OFFSET_X,NAV350_BENCHMARK_OFFSET_Y,NAV350_BENCHMARK_OFFSET_YAW);
+    }
+
+    /** Runs one reply through the receive path and converts its scan */
+    void Parse( const std::vector< uint8_t > &payload );
+
+  private:
+
+    /** The conversion stage under test */
+    SickScanConverter _scan_converter;
+
+    /** Lends the parsed scan to the converter */
+    SickScanLease< uint32_t > _scan_lease;
+
+    /** Converted points (capacity is kept across scans) */
+    std::vector< float > _x_values, _y_values;
+
+    /** Whether a scan was checked against the reference yet */
+    bool _checked;
+
+    /** Throws if a converted point differs from the double-precision reference */
+    void _checkAgainstReference( ) const;
+
+  };
+
+  /**
+   * \brief Runs one reply through the receive path and converts its scan
+   * \param &payload The reply
+   */
+  void Nav350ConverterBenchmark::Parse( const std::vector< uint8_t > &payload ) {
+
+    Nav350NavigationBenchmark::Parse(payload);
+
+    _sick_nav350.GetSickMeasurements(_scan_lease);
+    if (_scan_lease.GetNumValues() > 0) {
+
+      _x_values.resize(_scan_lease.GetNumValues());
+      _y_values.resize(_scan_lease.GetNumValues());
+      _scan_converter.Convert(_scan_lease,&_x_values[0],&_y_values[0]);
+
+      if (!_checked) {
+	_checkAgainstReference();
+	_checked = true;
+      }
+
+    }
+    _scan_lease.Release();
+
+  }
+
+  /**
+   * \brief Throws if a converted point differs from the double-precision reference
+   */
+  void Nav350ConverterBenchmark::_checkAgainstReference( ) const {
+
+    const SickScanView< uint32_t > &scan_view = _scan_lease.GetSector(0);
+    for (unsigned int i = 0; i < scan_view.Size(); i++) {
+
+      const double range = scan_view.Range(i)*0.001;
+      const double angle = (scan_view.Angle(i) + NAV350_BENCHMARK_OFFSET_YAW)*M_PI/180;
+      const bool valid = range >= NAV350_BENCHMARK_MIN_RANGE && range <= NAV350_BENCHMARK_MAX_RANGE;
+
+      bool matches = std::isnan(_x_values[i]) && std::isnan(_y_values[i]);
+      if (valid) {
+	matches = fabs(_x_values[i] - (range*cos(angle) + NAV350_BENCHMARK_OFFSET_X)) <= NAV350_BENCHMARK_POINT_TOLERANCE &&
+		  fabs(_y_values[i] - (range*sin(angle) + NAV350_BENCHMARK_OFFSET_Y)) <= NAV350_BENCHMARK_POINT_TOLERANCE;
+      }
+
+      if (!matches) {
+	char point_buffer[64];
+	snprintf(point_buffer,sizeof(point_buffer),"point %u differs from the reference",i);
+	throw SickException("Nav350ConverterBenchmark::_checkAgainstReference:",point_buffer);
+      }
+
+    }
+
+  }
+
+  /**
+   * \brief Synthesizes replies with NAV350_BENCHMARK_NUM_VALUES ranges
+   * \param num_payloads The number of distinct replies
+   */
+  void Nav350NavigationBenchmark::Synthesize( const unsigned int num_payloads ) {
+
+    unsigned int seed = 350;
+    for (unsigned int n = 0; n < num_payloads; n++) {
+
+      /* Header, wait flag, mask and the pose (with optional data) */
+      std::string payload = "sAN mNPOSGetData 1 0 1 2 1";
+      _appendHex(payload,8000 + rand_r(&seed) % 1000);
+      _appendHex(payload,6000 + rand_r(&seed) % 1000);
+      _appendHex(payload,rand_r(&seed) % 360000);
+      payload += " 1 0";
+      _appendHex(payload,n*125);
+      payload += " A 0 0";
+      _appendHex(payload,NAV350_BENCHMARK_NUM_REFLECTORS);
+
+      /* Reflectors in Cartesian and polar form w/ optional data */
+      payload += " 1 0";
+      _appendHex(payload,NAV350_BENCHMARK_NUM_REFLECTORS);
+      for (unsigned int i = 0; i < NAV350_BENCHMARK_NUM_REFLECTORS; i++) {
+	payload += " 1";
+	_appendHex(payload,rand_r(&seed) % 20000);
+	_appendHex(payload,rand_r(&seed) % 15000);
+	payload += " 1";
+	_appendHex(payload,1000 + rand_r(&seed) % 15000);
+	_appendHex(payload,rand_r(&seed) % 360000);
+	payload += " 1";
+	_appendHex(payload,i);
+	_appendHex(payload,i + 1);
+	payload += " 1 1 64";
+	_appendHex(payload,n*125);
+	payload += " 50";
+	_appendHex(payload,5 + rand_r(&seed) % 10);
+	payload += " C8";
+	_appendHex(payload,i*180);
+	_appendHex(payload,i*180 + 8);
+      }
+
+      /* One DIST1 channel (the trailing fields end the last token) */
+      payload += " 1 DIST1 3F800000 00000000 0 FA";
+      _appendHex(payload,n*125);
+      _appendHex(payload,NAV350_BENCHMARK_NUM_VALUES);
+      for (unsigned int i = 0; i < NAV350_BENCHMARK_NUM_VALUES; i++) {
+	_appendHex(payload,500 + rand_r(&seed) % 19500);
+      }
+      payload += " 0 0";
+
+      _payloads.push_back(std::vector< uint8_t >(payload.begin(),payload.end()));
+    }
+
+  }
+
+  /**
+   * \brief Keeps recorded mNPOSGetData replies
+   * \param message The recorded frame (STX ... ETX)
+   * \param length The frame length
+   * \return True if the frame was kept
+   */
+  bool Nav350NavigationBenchmark::AddRecordedTelegram( const uint8_t * const message, const unsigned int length ) {
+
+    const unsigned int framing_length = SickNav350Message::MESSAGE_HEADER_LENGTH + SickNav350Message::MESSAGE_TRAILER_LENGTH;
+    const char * const command = "sAN mNPOSGetData ";
+    if (length < framing_length + strlen(command) ||
+	strncmp((const char *)&message[SickNav350Message::MESSAGE_HEADER_LENGTH],command,strlen(command)) != 0) {
+      return false;
+    }
+
+    _payloads.push_back(std::vector< uint8_t >(&message[SickNav350Message::MESSAGE_HEADER_LENGTH],
+					       &message[length - SickNav350Message::MESSAGE_TRAILER_LENGTH]));
+    return true;
+  }
+
+  /**
+   * \brief Appends " <value in hex>" to the payload
+   * \param &payload The payload being built
+   * \param value The value
+   */
+  void Nav350NavigationBenchmark::_appendHex( std::string &payload, const unsigned int value ) {
+    char hex_buffer[16];
+    snprintf(hex_buffer,sizeof(hex_buffer)," %X",value);
+    payload += hex_buffer;
+  }
+
+  /**
+   * \brief Appends the NAV350 cases
+   * \param &benchmarks The case list
+   */
+  void AddNav350Benchmarks( std::vector< SickParserBenchmark * > &benchmarks ) {
+    benchmarks.push_back(new Nav350NavigationBenchmark());
+    benchmarks.push_back(new Nav350ConverterBenchmark());
+  }
+
+} //namespace SickToolbox
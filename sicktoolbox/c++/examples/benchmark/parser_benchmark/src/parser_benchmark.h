@@ -0,0 +1,154 @@
+/*!
+ * \file parser_benchmark.h
+ * \brief Defines the benchmark cases that replay telegrams through the
+ *        drivers' receive paths.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef PARSER_BENCHMARK_H
+#define PARSER_BENCHMARK_H
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+/* Macros */
+#define PARSER_BENCHMARK_NUM_SYNTHETIC                (32)  ///< Distinct synthetic telegrams per case
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \struct parser_benchmark_counters_tag
+   * \brief Heap allocations and copied bytes (advanced only while counting)
+   */
+  /**
+   * \typedef parser_benchmark_counters_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct parser_benchmark_counters_tag {
+    bool counting;                                          ///< Whether the counters advance
+    unsigned long num_allocations;                          ///< malloc()/calloc()/realloc() calls
+    unsigned long num_bytes_copied;                         ///< Bytes passed to memcpy() plus message hand-offs
+  } parser_benchmark_counters_t;
+
+  /** The process-wide counters (see main.cc) */
+  extern parser_benchmark_counters_t parser_benchmark_counters;
+
+  /* Drivers under test */
+  class SickNav350;
+  class SickNav350Message;
+  class SickLMS1xx;
+  class SickLMS1xxMessage;
+  class SickLD;
+  class SickLDMessage;
+  class SickLMS2xx;
+  class SickLMS2xxMessage;
+
+  /**
+   * \class SickParserBenchmark
+   * \brief A named set of telegram payloads and the receive path they
+   *        are replayed through
+   *
+   * Parse() starts from a payload the way a buffer monitor does: it
+   * builds the message, hands it through the monitor's container to
+   * the driver's receive message and then calls the parser the
+   * driver's public API would call.  The drivers befriend this class
+   * so the protected helpers below can reach their private parsers.
+   */
+  class SickParserBenchmark {
+
+  public:
+
+    /** A standard constructor */
+    SickParserBenchmark( const std::string &name ) : _name(name) { }
+
+    /** Returns the case name */
+    const std::string & GetName( ) const { return _name; }
+
+    /** Returns the payloads that are replayed */
+    const std::vector< std::vector< uint8_t > > & GetPayloads( ) const { return _payloads; }
+
+    /** Fills the case with synthetic payloads */
+    virtual void Synthesize( const unsigned int num_payloads ) = 0;
+
+    /** Keeps a recorded telegram (a full frame) if this case parses it */
+    virtual bool AddRecordedTelegram( const uint8_t * const message, const unsigned int length ) = 0;
+
+    /** Runs one payload through the receive path */
+    virtual void Parse( const std::vector< uint8_t > &payload ) = 0;
+
+    /** A virtual destructor */
+    virtual ~SickParserBenchmark( ) { }
+
+  protected:
+
+    /** The payloads (message frames stripped) */
+    std::vector< std::vector< uint8_t > > _payloads;
+
+    /** Hands a framed message through the monitor's container (see SickBufferMonitor) */
+    template < class SICK_MSG_CLASS >
+    static void _handOff( const SICK_MSG_CLASS &monitor_message, SICK_MSG_CLASS &container, SICK_MSG_CLASS &recv_message ) {
+
+      container = monitor_message;
+      recv_message = container;
+      container.Clear();
+
+      /* The implicit copies go element by element and never reach memcpy() */
+      if (parser_benchmark_counters.counting) {
+	parser_benchmark_counters.num_bytes_copied += 2*SICK_MSG_CLASS::MESSAGE_MAX_LENGTH;
+      }
+
+    }
+
+    /** SickNav350::GetDataNavigation() once the reply has arrived */
+    static void _parseNav350Navigation( SickNav350 &sick_nav350, const SickNav350Message &recv_message );
+
+    /** SickLMS1xx::GetSickMeasurements() once the telegram has arrived */
+    static void _parseLMS1xxScanData( const SickLMS1xx &sick_lms_1xx, const SickLMS1xxMessage &recv_message,
+				      unsigned int * const range_vals, unsigned int * const reflect_vals,
+				      unsigned int &num_measurements );
+
+    /** SickLD::_acquireSickScanProfile() once the profile has arrived */
+    static void _parseLDProfile( SickLD &sick_ld, const SickLDMessage &recv_message );
+
+    /** SickLMS2xx::GetSickScan() (range only) once the B0 reply has arrived */
+    static void _parseLMS2xxB0( SickLMS2xx &sick_lms_2xx, const SickLMS2xxMessage &recv_message );
+
+    /** SickLMS2xx::GetSickScan() (range and reflectivity) once the C4 reply has arrived */
+    static void _parseLMS2xxC4( const SickLMS2xx &sick_lms_2xx, const SickLMS2xxMessage &recv_message );
+
+  private:
+
+    /** The case name */
+    std::string _name;
+
+    /** Cases are not copyable */
+    SickParserBenchmark( const SickParserBenchmark & );
+    SickParserBenchmark & operator=( const SickParserBenchmark & );
+
+  };
+
+  /** Appends the NAV350 cases */
+  void AddNav350Benchmarks( std::vector< SickParserBenchmark * > &benchmarks );
+
+  /** Appends the LMS 1xx cases */
+  void AddLMS1xxBenchmarks( std::vector< SickParserBenchmark * > &benchmarks );
+
+  /** Appends the LD cases */
+  void AddLDBenchmarks( std::vector< SickParserBenchmark * > &benchmarks );
+
+  /** Appends the LMS 2xx cases */
+  void AddLMS2xxBenchmarks( std::vector< SickParserBenchmark * > &benchmarks );
+
+} //namespace SickToolbox
+
+#endif /* PARSER_BENCHMARK_H */
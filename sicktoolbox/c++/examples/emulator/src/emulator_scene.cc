@@ -0,0 +1,125 @@
+/*!
+ * \file emulator_scene.cc
+ * \brief Implements the emulator scene and CoLa-A framing helpers.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "emulator_scene.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+/**
+ * \brief Returns the default scene
+ */
+emulator_scene_t EmulatorDefaultScene( ) {
+
+  emulator_scene_t scene;
+  scene.room_width = 20000;
+  scene.room_height = 15000;
+  scene.x = 8000;
+  scene.y = 6000;
+  scene.heading = 30;
+  scene.max_range = 20000;
+  scene.range_noise = 10;
+  scene.seed = 1;
+  return scene;
+}
+
+/**
+ * \brief Distance to the room walls
+ * \param room_width Room extent in x (mm)
+ * \param room_height Room extent in y (mm)
+ * \param x Ray origin x (mm)
+ * \param y Ray origin y (mm)
+ * \param theta Ray heading (rad)
+ * \param max_range Cap on the returned distance (mm)
+ * \return Distance to the first wall
+ */
+double EmulatorWallRange( const double room_width, const double room_height, const double x, const double y,
+			  const double theta, const double max_range ) {
+
+  const double c = cos(theta), s = sin(theta);
+  double range = max_range;
+
+  if (c > 1e-9) {
+    range = std::min(range,(room_width - x)/c);
+  }
+  else if (c < -1e-9) {
+    range = std::min(range,-x/c);
+  }
+
+  if (s > 1e-9) {
+    range = std::min(range,(room_height - y)/s);
+  }
+  else if (s < -1e-9) {
+    range = std::min(range,-y/s);
+  }
+
+  return range > 0 ? range : 0;
+}
+
+/**
+ * \brief Returns a uniform number in [-1,1)
+ * \param state The xorshift32 state (never zero)
+ */
+double EmulatorNoise( uint32_t &state ) {
+
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state/4294967296.0*2 - 1;
+}
+
+/**
+ * \brief Seeds a noise generator for one frame
+ * \param seed The scene/world seed
+ * \param frame The scan or profile index
+ *
+ * Frames can be synthesized in any order and still come out the same.
+ */
+uint32_t EmulatorNoiseSeed( const unsigned int seed, const unsigned long frame ) {
+
+  const uint32_t state = (seed*2654435761u) ^ ((uint32_t)frame*40503u + 0x9E3779B9u);
+  return state ? state : 1;
+}
+
+/**
+ * \brief Frames an STX...ETX telegram
+ * \param buffer The received bytes
+ * \param length Number of received bytes
+ * \param request_start Set to the offset of the STX (anything before it is noise)
+ * \return Length of the telegram including STX and ETX (0 if incomplete)
+ */
+unsigned int EmulatorFrameColaA( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) {
+
+  const uint8_t *stx = (const uint8_t *)memchr(buffer,0x02,length);
+  if (stx == NULL) {
+    request_start = length;
+    return 0;
+  }
+
+  request_start = stx - buffer;
+  const uint8_t *etx = (const uint8_t *)memchr(stx,0x03,length - request_start);
+  return etx ? (etx - stx) + 1 : 0;
+}
+
+/**
+ * \brief Sends a framed reply
+ * \param connection The client
+ * \param payload The reply payload
+ */
+void EmulatorSendColaA( EmulatorConnection &connection, const std::string &payload ) {
+
+  const std::string telegram = '\x02' + payload + '\x03';
+  connection.Send((const uint8_t *)telegram.data(),telegram.length());
+}
@@ -0,0 +1,61 @@
+/*!
+ * \file emulator_scene.h
+ * \brief A static room that the emulated range finders measure, plus
+ *        the framing helpers shared by the CoLa-A devices.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef EMULATOR_SCENE_H
+#define EMULATOR_SCENE_H
+
+/* Definition dependencies */
+#include <string>
+#include <stdint.h>
+#include "emulator_server.h"
+
+/**
+ * \struct emulator_scene_tag
+ * \brief A fixed sensor in a rectangular room
+ */
+/**
+ * \typedef emulator_scene_t
+ * \brief Adopt c-style convention
+ */
+typedef struct emulator_scene_tag {
+  double room_width;                                        ///< The room spans [0,room_width] in x (mm)
+  double room_height;                                       ///< The room spans [0,room_height] in y (mm)
+  double x;                                                 ///< Sensor position x (mm)
+  double y;                                                 ///< Sensor position y (mm)
+  double heading;                                           ///< Sensor heading (deg)
+  double max_range;                                         ///< Longest synthesized range (mm)
+  double range_noise;                                       ///< Peak range noise (mm)
+  unsigned int seed;                                        ///< Seed for the range noise
+} emulator_scene_t;
+
+/** Returns a 20 x 15 m room with the sensor off its centre */
+emulator_scene_t EmulatorDefaultScene( );
+
+/** Distance from (x,y) to the walls of a [0,width] x [0,height] room along heading theta (rad), capped at max_range */
+double EmulatorWallRange( const double room_width, const double room_height, const double x, const double y,
+			  const double theta, const double max_range );
+
+/** Advances an xorshift32 generator and returns a uniform number in [-1,1) */
+double EmulatorNoise( uint32_t &state );
+
+/** Seeds a noise generator so that each (seed,frame) pair yields its own reproducible sequence */
+uint32_t EmulatorNoiseSeed( const unsigned int seed, const unsigned long frame );
+
+/** Frames an STX...ETX (CoLa-A) telegram; see EmulatorDevice::FrameRequest */
+unsigned int EmulatorFrameColaA( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start );
+
+/** Sends a payload wrapped in STX...ETX */
+void EmulatorSendColaA( EmulatorConnection &connection, const std::string &payload );
+
+#endif /* EMULATOR_SCENE_H */
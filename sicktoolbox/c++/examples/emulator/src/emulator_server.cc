@@ -0,0 +1,419 @@
+/*!
+ * \file emulator_server.cc
+ * \brief Implements the event-driven emulator server core.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "emulator_server.h"
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/**
+ * \brief Returns a fault configuration that injects nothing
+ */
+emulator_fault_config_t EmulatorNoFaults( ) {
+
+  emulator_fault_config_t faults;
+  memset(&faults,0,sizeof(emulator_fault_config_t));
+  faults.garbage_max = EMULATOR_MAX_GARBAGE_BYTES;
+  faults.seed = 1;
+  return faults;
+}
+
+/**
+ * \brief Builds a connection (server use only)
+ * \param socket_fd The accepted client socket
+ * \param id The connection id
+ * \param faults The faults to inject into replies
+ */
+EmulatorConnection::EmulatorConnection( const int socket_fd, const unsigned int id, const emulator_fault_config_t &faults ) :
+  _socket_fd(socket_fd), _id(id), _num_replies(0), _faults(faults),
+  _random_state(faults.seed*2654435761u + id*40503u + 1) {
+
+  _recv_buffer.reserve(EMULATOR_RECV_BUFFER_SIZE);
+}
+
+/**
+ * \brief Queues a reply, applying the configured faults
+ * \param bytes The reply
+ * \param length Number of bytes in the reply
+ *
+ * Every random draw happens in the same order for every reply, so a given
+ * seed and request sequence always produce the same faults.
+ */
+void EmulatorConnection::Send( const uint8_t * const bytes, const unsigned int length ) {
+
+  _num_replies++;
+
+  const double drop_draw = _random();
+  const double garbage_draw = _random();
+  const double jitter_draw = _random();
+
+  if (drop_draw < _faults.drop_probability) {
+    return;
+  }
+
+  uint64_t due_usec = EmulatorServer::Now() + (uint64_t)_faults.delay_ms*1000 + (uint64_t)(jitter_draw*_faults.jitter_ms*1000);
+
+  /* Line noise between telegrams (never an STX, so the framing can resynchronize) */
+  if (garbage_draw < _faults.garbage_probability && _faults.garbage_max > 0) {
+
+    std::string garbage(1 + (unsigned int)(_random()*_faults.garbage_max),'\0');
+    for (unsigned int i = 0; i < garbage.size(); i++) {
+      do {
+	garbage[i] = (char)(_random()*256);
+      } while (garbage[i] == 0x02);
+    }
+
+    _queue(due_usec,garbage);
+  }
+
+  if (_faults.fragment_max == 0) {
+    _queue(due_usec,std::string((const char *)bytes,length));
+    return;
+  }
+
+  for (unsigned int offset = 0; offset < length; ) {
+
+    unsigned int fragment_length = 1 + (unsigned int)(_random()*_faults.fragment_max);
+    if (fragment_length > length - offset) {
+      fragment_length = length - offset;
+    }
+
+    _queue(due_usec,std::string((const char *)bytes + offset,fragment_length));
+    offset += fragment_length;
+    due_usec += (uint64_t)_faults.fragment_gap_ms*1000;
+  }
+
+}
+
+/**
+ * \brief Returns a uniform random number in [0,1)
+ */
+double EmulatorConnection::_random( ) {
+
+  /* xorshift32 */
+  _random_state ^= _random_state << 13;
+  _random_state ^= _random_state >> 17;
+  _random_state ^= _random_state << 5;
+  return _random_state/4294967296.0;
+}
+
+/**
+ * \brief Appends a chunk, keeping the queue ordered
+ * \param due_usec Earliest time to write the chunk
+ * \param bytes The chunk
+ */
+void EmulatorConnection::_queue( const uint64_t due_usec, const std::string &bytes ) {
+
+  emulator_chunk_t chunk;
+  chunk.due_usec = (!_send_queue.empty() && _send_queue.back().due_usec > due_usec) ? _send_queue.back().due_usec : due_usec;
+  chunk.bytes = bytes;
+  _send_queue.push_back(chunk);
+}
+
+/**
+ * \brief A standard constructor
+ */
+EmulatorServer::EmulatorServer( ) : _next_connection_id(0), _running(0) { }
+
+/**
+ * \brief A standard destructor
+ */
+EmulatorServer::~EmulatorServer( ) {
+
+  for (unsigned int i = 0; i < _listeners.size(); i++) {
+
+    while (!_listeners[i].connections.empty()) {
+      _close(_listeners[i],_listeners[i].connections.size()-1);
+    }
+
+    close(_listeners[i].socket_fd);
+    delete _listeners[i].device;
+  }
+
+}
+
+/**
+ * \brief Adds a device and starts listening for it
+ * \param device The device (the server takes ownership)
+ * \param port TCP port (0 picks a free port)
+ * \param faults Faults to inject into the device's replies
+ * \return The port the device listens on (0 on failure, in which case the device is deleted)
+ */
+unsigned short EmulatorServer::AddDevice( EmulatorDevice * const device, const unsigned short port, const emulator_fault_config_t &faults ) {
+
+  int socket_fd = -1;
+  if ((socket_fd = socket(AF_INET,SOCK_STREAM,0)) < 0) {
+    std::cerr << "EmulatorServer::AddDevice: socket() failed!" << std::endl;
+    delete device;
+    return 0;
+  }
+
+  int reuse_address = 1;
+  setsockopt(socket_fd,SOL_SOCKET,SO_REUSEADDR,&reuse_address,sizeof(reuse_address));
+
+  struct sockaddr_in address;
+  socklen_t address_length = sizeof(address);
+  memset(&address,0,sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = INADDR_ANY;
+
+  if (bind(socket_fd,(struct sockaddr *)&address,sizeof(address)) != 0 || listen(socket_fd,16) != 0 ||
+      getsockname(socket_fd,(struct sockaddr *)&address,&address_length) != 0) {
+    std::cerr << "EmulatorServer::AddDevice: Unable to listen on port " << port << " (" << strerror(errno) << ")" << std::endl;
+    close(socket_fd);
+    delete device;
+    return 0;
+  }
+
+  fcntl(socket_fd,F_SETFL,fcntl(socket_fd,F_GETFL) | O_NONBLOCK);
+
+  emulator_listener_t listener;
+  listener.socket_fd = socket_fd;
+  listener.device = device;
+  listener.faults = faults;
+  listener.next_tick_usec = device->GetTickPeriod() ? Now() + device->GetTickPeriod() : 0;
+  _listeners.push_back(listener);
+
+  std::cout << "\t" << device->GetName() << " listening on port " << ntohs(address.sin_port) << std::endl;
+  return ntohs(address.sin_port);
+}
+
+/**
+ * \brief Runs the event loop until Stop() is called
+ */
+void EmulatorServer::Run( ) {
+
+  std::vector< struct pollfd > poll_fds;
+  std::vector< std::pair< unsigned int, int > > poll_owners;  // (listener, connection index or -1 for the listener)
+
+  _running = 1;
+  while (_running) {
+
+    uint64_t now_usec = Now();
+    uint64_t wake_usec = now_usec + 100000;
+
+    /* Device ticks */
+    for (unsigned int i = 0; i < _listeners.size(); i++) {
+
+      emulator_listener_t &listener = _listeners[i];
+      if (listener.next_tick_usec == 0) {
+	continue;
+      }
+
+      if (listener.next_tick_usec <= now_usec) {
+	listener.device->HandleTick(now_usec);
+	listener.next_tick_usec += listener.device->GetTickPeriod();
+	if (listener.next_tick_usec <= now_usec) {
+	  /* Fell behind; skip the missed ticks rather than bursting them */
+	  listener.next_tick_usec = now_usec + listener.device->GetTickPeriod();
+	}
+      }
+
+      if (listener.next_tick_usec < wake_usec) {
+	wake_usec = listener.next_tick_usec;
+      }
+    }
+
+    /* Build the poll set */
+    poll_fds.clear();
+    poll_owners.clear();
+    for (unsigned int i = 0; i < _listeners.size(); i++) {
+
+      struct pollfd listen_fd = { _listeners[i].socket_fd, POLLIN, 0 };
+      poll_fds.push_back(listen_fd);
+      poll_owners.push_back(std::make_pair(i,-1));
+
+      for (unsigned int j = 0; j < _listeners[i].connections.size(); j++) {
+
+	EmulatorConnection &connection = *_listeners[i].connections[j];
+	struct pollfd client_fd = { connection._socket_fd, POLLIN, 0 };
+
+	if (!connection._send_queue.empty()) {
+	  if (connection._send_queue.front().due_usec <= now_usec) {
+	    client_fd.events |= POLLOUT;
+	  }
+	  else if (connection._send_queue.front().due_usec < wake_usec) {
+	    wake_usec = connection._send_queue.front().due_usec;
+	  }
+	}
+
+	poll_fds.push_back(client_fd);
+	poll_owners.push_back(std::make_pair(i,(int)j));
+      }
+    }
+
+    int timeout_ms = (wake_usec > now_usec) ? (int)((wake_usec - now_usec + 999)/1000) : 0;
+    if (poll(&poll_fds[0],poll_fds.size(),timeout_ms) < 0 && errno != EINTR) {
+      std::cerr << "EmulatorServer::Run: poll() failed - " << strerror(errno) << std::endl;
+      break;
+    }
+
+    /* Service in reverse so closing a connection does not disturb the indices still to visit */
+    now_usec = Now();
+    for (int k = (int)poll_fds.size() - 1; k >= 0; k--) {
+
+      emulator_listener_t &listener = _listeners[poll_owners[k].first];
+      if (poll_owners[k].second < 0) {
+	if (poll_fds[k].revents & POLLIN) {
+	  _accept(listener);
+	}
+	continue;
+      }
+
+      const unsigned int j = poll_owners[k].second;
+      EmulatorConnection &connection = *listener.connections[j];
+      bool open = true;
+
+      if (poll_fds[k].revents & (POLLIN | POLLHUP | POLLERR)) {
+	open = _receive(listener,connection);
+      }
+
+      if (open) {
+	open = _flush(connection,now_usec);
+      }
+
+      if (!open) {
+	_close(listener,j);
+      }
+    }
+
+  }
+
+}
+
+/**
+ * \brief Returns the monotonic time in usec
+ */
+uint64_t EmulatorServer::Now( ) {
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC,&now);
+  return (uint64_t)now.tv_sec*1000000 + now.tv_nsec/1000;
+}
+
+/**
+ * \brief Accepts a pending client
+ * \param listener The listener with the pending client
+ */
+void EmulatorServer::_accept( emulator_listener_t &listener ) {
+
+  int client_fd = -1;
+  if ((client_fd = accept(listener.socket_fd,NULL,NULL)) < 0) {
+    return;
+  }
+
+  fcntl(client_fd,F_SETFL,fcntl(client_fd,F_GETFL) | O_NONBLOCK);
+
+  /* Replies are timed by the fault injector, not by Nagle */
+  int no_delay = 1;
+  setsockopt(client_fd,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+
+  listener.connections.push_back(new EmulatorConnection(client_fd,_next_connection_id++,listener.faults));
+}
+
+/**
+ * \brief Reads a client's bytes and dispatches every complete request
+ * \param listener The client's listener
+ * \param connection The client
+ * \return False once the client has disconnected
+ */
+bool EmulatorServer::_receive( emulator_listener_t &listener, EmulatorConnection &connection ) {
+
+  uint8_t recv_buffer[4096];
+  ssize_t num_bytes = recv(connection._socket_fd,recv_buffer,sizeof(recv_buffer),0);
+
+  if (num_bytes == 0 || (num_bytes < 0 && errno != EAGAIN && errno != EINTR)) {
+    return false;
+  }
+
+  if (num_bytes < 0) {
+    return true;
+  }
+
+  std::vector< uint8_t > &buffer = connection._recv_buffer;
+  buffer.insert(buffer.end(),recv_buffer,recv_buffer + num_bytes);
+
+  /* Frame and dispatch */
+  unsigned int consumed = 0;
+  while (consumed < buffer.size()) {
+
+    unsigned int request_start = 0;
+    const unsigned int request_length = listener.device->FrameRequest(&buffer[consumed],buffer.size() - consumed,request_start);
+
+    consumed += request_start;
+    if (request_length == 0) {
+      break;
+    }
+
+    listener.device->HandleRequest(connection,&buffer[consumed],request_length);
+    consumed += request_length;
+  }
+
+  buffer.erase(buffer.begin(),buffer.begin() + consumed);
+
+  /* A client that never completes a request is dropped rather than buffered forever */
+  return buffer.size() < EMULATOR_RECV_BUFFER_SIZE;
+}
+
+/**
+ * \brief Writes a client's chunks that are due
+ * \param connection The client
+ * \param now_usec The current time
+ * \return False once the client has disconnected
+ */
+bool EmulatorServer::_flush( EmulatorConnection &connection, const uint64_t now_usec ) {
+
+  while (!connection._send_queue.empty() && connection._send_queue.front().due_usec <= now_usec) {
+
+    std::string &bytes = connection._send_queue.front().bytes;
+    ssize_t num_bytes = send(connection._socket_fd,bytes.data(),bytes.size(),MSG_NOSIGNAL);
+
+    if (num_bytes < 0) {
+      return (errno == EAGAIN || errno == EINTR);
+    }
+
+    if ((size_t)num_bytes < bytes.size()) {
+      bytes.erase(0,num_bytes);
+      return true;
+    }
+
+    connection._send_queue.pop_front();
+  }
+
+  return true;
+}
+
+/**
+ * \brief Closes a connection
+ * \param listener The connection's listener
+ * \param i Index of the connection
+ */
+void EmulatorServer::_close( emulator_listener_t &listener, const unsigned int i ) {
+
+  EmulatorConnection *connection = listener.connections[i];
+  listener.device->HandleDisconnect(*connection);
+  close(connection->_socket_fd);
+  delete connection;
+  listener.connections.erase(listener.connections.begin() + i);
+}
@@ -0,0 +1,229 @@
+/*!
+ * \file emulator_server.h
+ * \brief An event-driven TCP server core for emulating Sick devices,
+ *        with deterministic fault injection (delays, fragmentation,
+ *        garbage bytes and dropped replies).
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef EMULATOR_SERVER_H
+#define EMULATOR_SERVER_H
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdint.h>
+
+/* Macros */
+#define EMULATOR_RECV_BUFFER_SIZE                  (65536)  ///< Largest request backlog kept per connection
+#define EMULATOR_MAX_GARBAGE_BYTES                    (16)  ///< Default cap on injected garbage bytes
+
+/**
+ * \struct emulator_fault_config_tag
+ * \brief The faults injected into every reply a device sends
+ */
+/**
+ * \typedef emulator_fault_config_t
+ * \brief Adopt c-style convention
+ */
+typedef struct emulator_fault_config_tag {
+  unsigned int delay_ms;                                    ///< Fixed delay added to every reply
+  unsigned int jitter_ms;                                   ///< Uniform random delay in [0,jitter_ms] added to every reply
+  unsigned int fragment_max;                                ///< Split replies into writes of 1..fragment_max bytes (0 disables)
+  unsigned int fragment_gap_ms;                             ///< Gap between the writes of a fragmented reply
+  double garbage_probability;                               ///< Probability of sending garbage bytes ahead of a reply
+  unsigned int garbage_max;                                 ///< Largest garbage burst (bytes)
+  double drop_probability;                                  ///< Probability of silently dropping a reply
+  unsigned int seed;                                        ///< Seed for the fault generator (same seed, same faults)
+} emulator_fault_config_t;
+
+/** Returns a fault configuration that injects nothing */
+emulator_fault_config_t EmulatorNoFaults( );
+
+class EmulatorServer;
+
+/**
+ * \class EmulatorConnection
+ * \brief One client connection to an emulated device
+ *
+ * Replies are queued with their due times and written by the server
+ * loop, so a delayed or fragmented reply never blocks other clients.
+ */
+class EmulatorConnection {
+
+public:
+
+  /** Queues a reply (faults are applied here) */
+  void Send( const uint8_t * const bytes, const unsigned int length );
+
+  /** Returns the id of the connection (unique within the server) */
+  unsigned int GetID( ) const { return _id; }
+
+  /** Returns the number of replies queued since the connection opened */
+  unsigned int GetNumReplies( ) const { return _num_replies; }
+
+private:
+
+  /** A chunk waiting to be written */
+  typedef struct emulator_chunk_tag {
+    uint64_t due_usec;                                      ///< Earliest time to write the chunk
+    std::string bytes;                                      ///< The bytes to write
+  } emulator_chunk_t;
+
+  /** Built by the server only */
+  EmulatorConnection( const int socket_fd, const unsigned int id, const emulator_fault_config_t &faults );
+
+  /** Returns a uniform random number in [0,1) from the fault generator */
+  double _random( );
+
+  /** Appends a chunk no earlier than the one before it */
+  void _queue( const uint64_t due_usec, const std::string &bytes );
+
+  /** The client socket */
+  int _socket_fd;
+
+  /** The connection id */
+  unsigned int _id;
+
+  /** Replies queued so far */
+  unsigned int _num_replies;
+
+  /** The faults to inject */
+  emulator_fault_config_t _faults;
+
+  /** State of the fault generator */
+  uint32_t _random_state;
+
+  /** Bytes received but not yet framed into a request */
+  std::vector< uint8_t > _recv_buffer;
+
+  /** Chunks waiting to be written (ordered by due time) */
+  std::deque< emulator_chunk_t > _send_queue;
+
+  friend class EmulatorServer;
+
+};
+
+/**
+ * \class EmulatorDevice
+ * \brief The protocol side of an emulated device
+ *
+ * A device frames requests out of the byte stream, answers them through
+ * EmulatorConnection::Send and may stream data on a periodic tick.
+ */
+class EmulatorDevice {
+
+public:
+
+  /** A standard destructor */
+  virtual ~EmulatorDevice( ) { }
+
+  /** Returns a short name for log output */
+  virtual std::string GetName( ) const = 0;
+
+  /**
+   * \brief Locates the first complete request in a receive buffer
+   * \param buffer The received bytes
+   * \param length Number of received bytes
+   * \param request_start Set to the offset of the request (bytes before it are discarded)
+   * \return Length of the request (0 if no complete request is buffered yet)
+   */
+  virtual unsigned int FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const = 0;
+
+  /** Answers one framed request */
+  virtual void HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length ) = 0;
+
+  /** Returns the tick period in usec (0 if the device does not stream) */
+  virtual uint64_t GetTickPeriod( ) const { return 0; }
+
+  /** Called once per tick period */
+  virtual void HandleTick( const uint64_t /* now_usec */ ) { }
+
+  /** Called before a connection is destroyed */
+  virtual void HandleDisconnect( EmulatorConnection & /* connection */ ) { }
+
+};
+
+/**
+ * \class EmulatorServer
+ * \brief Serves any number of emulated devices from a single thread
+ *
+ * Each device listens on its own port.  One poll() loop accepts clients,
+ * frames and dispatches requests, drives device ticks and writes queued
+ * reply chunks when they fall due.
+ */
+class EmulatorServer {
+
+public:
+
+  /** A standard constructor */
+  EmulatorServer( );
+
+  /** A standard destructor (closes every socket and deletes the devices) */
+  ~EmulatorServer( );
+
+  /**
+   * \brief Adds a device (the server takes ownership)
+   * \param device The device
+   * \param port TCP port to listen on (0 picks a free port)
+   * \param faults Faults to inject into the device's replies
+   * \return The port the device listens on
+   */
+  unsigned short AddDevice( EmulatorDevice * const device, const unsigned short port, const emulator_fault_config_t &faults );
+
+  /** Runs the event loop until Stop() is called */
+  void Run( );
+
+  /** Asks the event loop to return (safe from a signal handler or another thread) */
+  void Stop( ) { _running = 0; }
+
+  /** Returns the monotonic time in usec */
+  static uint64_t Now( );
+
+private:
+
+  /** A listening device */
+  typedef struct emulator_listener_tag {
+    int socket_fd;                                          ///< The listening socket
+    EmulatorDevice *device;                                 ///< The device answering on it
+    emulator_fault_config_t faults;                         ///< Faults for its connections
+    uint64_t next_tick_usec;                                ///< When the device ticks next (0 if never)
+    std::vector< EmulatorConnection * > connections;        ///< Its open connections
+  } emulator_listener_t;
+
+  /** The listening devices */
+  std::vector< emulator_listener_t > _listeners;
+
+  /** Next connection id */
+  unsigned int _next_connection_id;
+
+  /** Cleared by Stop() */
+  volatile int _running;
+
+  /** Accepts a client on a listener */
+  void _accept( emulator_listener_t &listener );
+
+  /** Reads and dispatches a client's requests (false once the client is gone) */
+  bool _receive( emulator_listener_t &listener, EmulatorConnection &connection );
+
+  /** Writes the client's due chunks (false once the client is gone) */
+  bool _flush( EmulatorConnection &connection, const uint64_t now_usec );
+
+  /** Closes and deletes a listener's ith connection */
+  void _close( emulator_listener_t &listener, const unsigned int i );
+
+  /** Servers are not copyable */
+  EmulatorServer( const EmulatorServer & );
+  EmulatorServer & operator=( const EmulatorServer & );
+
+};
+
+#endif /* EMULATOR_SERVER_H */
@@ -0,0 +1,555 @@
+/*!
+ * \file ld_emulator.cc
+ * \brief Implements the Sick LD emulator.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "ld_emulator.h"
+#include <sicktoolbox/SickLD.hh>
+#include <sicktoolbox/SickLDUtility.hh>
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace SickToolbox;
+
+/**
+ * \brief A standard constructor
+ * \param scene The room to measure
+ * \param motor_speed Motor speed at power up (Hz)
+ *
+ * The device powers up idle with a single measuring sector covering the
+ * full revolution.
+ */
+LdEmulator::LdEmulator( const emulator_scene_t &scene, const unsigned int motor_speed ) :
+  _scene(scene), _sensor_id(1), _motor_speed(LD_EMULATOR_DEFAULT_MOTOR_SPEED), _angle_step(LD_EMULATOR_DEFAULT_ANGLE_STEP),
+  _sensor_mode(SickLD::SICK_SENSOR_MODE_IDLE), _signals(0), _profile_counter(0), _start_usec(EmulatorServer::Now()) {
+
+  if (motor_speed >= SickLD::SICK_MIN_MOTOR_SPEED && motor_speed <= SickLD::SICK_MAX_MOTOR_SPEED) {
+    _motor_speed = motor_speed;
+  }
+
+  memset(_sector_functions,0,sizeof(_sector_functions));
+  memset(_sector_stops,0,sizeof(_sector_stops));
+  _sector_functions[0] = SickLD::SICK_CONF_SECTOR_NORMAL_MEASUREMENT;
+  _sector_stops[0] = LD_EMULATOR_TICKS_PER_REV - _angle_step;
+
+  _payload.reserve(SICK_LD_MSG_PAYLOAD_MAX_LEN);
+}
+
+/**
+ * \brief Frames a message (0x02 'U' 'S' 'P', 32-bit length, payload, checksum)
+ * \param buffer The received bytes
+ * \param length Number of received bytes
+ * \param request_start Set to the offset of the header (anything before it is noise)
+ * \return Length of the message (0 if incomplete)
+ */
+unsigned int LdEmulator::FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const {
+
+  for (unsigned int i = 0; i + 4 <= length; i++) {
+
+    if (memcmp(&buffer[i],"\x02USP",4) != 0) {
+      continue;
+    }
+
+    request_start = i;
+    if (length - i < SICK_LD_MSG_HEADER_LEN) {
+      return 0;
+    }
+
+    uint32_t payload_length = 0;
+    memcpy(&payload_length,&buffer[i+4],4);
+    payload_length = sick_ld_to_host_byte_order(payload_length);
+
+    /* A bogus length means a false header, so keep looking */
+    if (payload_length > SICK_LD_MSG_PAYLOAD_MAX_LEN) {
+      continue;
+    }
+
+    const unsigned int message_length = SICK_LD_MSG_HEADER_LEN + payload_length + SICK_LD_MSG_TRAILER_LEN;
+    return (length - i >= message_length) ? message_length : 0;
+  }
+
+  /* Keep a partial header */
+  request_start = (length > 3) ? length - 3 : 0;
+  return 0;
+}
+
+/**
+ * \brief Answers one request
+ * \param connection The requesting client
+ * \param request The message (header and checksum included)
+ * \param length Length of the message
+ */
+void LdEmulator::HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length ) {
+
+  const uint8_t * const payload = &request[SICK_LD_MSG_HEADER_LEN];
+  const unsigned int payload_length = length - SICK_LD_MSG_HEADER_LEN - SICK_LD_MSG_TRAILER_LEN;
+
+  uint8_t checksum = 0;
+  for (unsigned int i = 0; i < payload_length; i++) {
+    checksum ^= payload[i];
+  }
+
+  /* The device ignores corrupt and truncated requests */
+  if (checksum != request[length-1] || payload_length < 2) {
+    return;
+  }
+
+  /* Arguments past the end of the request read as zero */
+  uint8_t arguments[16] = {0};
+  memcpy(arguments,payload,std::min(payload_length,(unsigned int)sizeof(arguments)));
+
+  const uint8_t service_code = arguments[0];
+  const uint8_t service_subcode = arguments[1];
+  const uint16_t argument_word = (arguments[2] << 8) | arguments[3];
+
+  _payload.clear();
+  _payload.push_back(service_code | 0x80);
+  _payload.push_back(service_subcode);
+
+  bool accepted = true;
+
+  switch (service_code) {
+
+  case SickLD::SICK_STAT_SERV_CODE:
+
+    if (service_subcode == SickLD::SICK_STAT_SERV_GET_ID) {
+      _appendIdentification(arguments[3]);
+    }
+    else if (service_subcode == SickLD::SICK_STAT_SERV_GET_STATUS) {
+      _append16(0);
+      _append16(_statusByte());
+    }
+    else if (service_subcode == SickLD::SICK_STAT_SERV_GET_SIGNAL) {
+      _append16(_signals);
+    }
+    else if (service_subcode == SickLD::SICK_STAT_SERV_SET_SIGNAL) {
+      _signals = arguments[3];
+      _append16(0);
+    }
+    else {
+      accepted = false;
+    }
+    break;
+
+  case SickLD::SICK_CONF_SERV_CODE:
+
+    if (service_subcode == SickLD::SICK_CONF_SERV_SET_CONFIGURATION) {
+
+      const uint16_t angle_step = (arguments[8] << 8) | arguments[9];
+      if (argument_word == SickLD::SICK_CONF_KEY_GLOBAL) {
+
+	if (arguments[7] < SickLD::SICK_MIN_MOTOR_SPEED || arguments[7] > SickLD::SICK_MAX_MOTOR_SPEED ||
+	    angle_step == 0 || LD_EMULATOR_TICKS_PER_REV % angle_step != 0) {
+	  accepted = false;
+	  break;
+	}
+
+	_sensor_id = arguments[5];
+	_motor_speed = arguments[7];
+	_angle_step = angle_step;
+      }
+      _append16(0);
+    }
+    else if (service_subcode == SickLD::SICK_CONF_SERV_GET_CONFIGURATION) {
+
+      _append16(argument_word);
+      if (argument_word == SickLD::SICK_CONF_KEY_GLOBAL) {
+	_append16(_sensor_id);
+	_append16(_motor_speed);
+	_append16(_angle_step);
+      }
+      else if (argument_word == SickLD::SICK_CONF_KEY_ETHERNET) {
+
+	const uint16_t ethernet_config[] = {127,0,0,1, 255,0,0,0, 0,0,0,0, 1, DEFAULT_SICK_TCP_PORT};
+	for (unsigned int i = 0; i < sizeof(ethernet_config)/sizeof(uint16_t); i++) {
+	  _append16(ethernet_config[i]);
+	}
+      }
+      else {
+	accepted = false;
+      }
+    }
+    else if (service_subcode == SickLD::SICK_CONF_SERV_SET_TIME_ABSOLUTE ||
+	     service_subcode == SickLD::SICK_CONF_SERV_SET_TIME_RELATIVE ||
+	     service_subcode == SickLD::SICK_CONF_SERV_GET_SYNC_CLOCK) {
+      _append16((uint16_t)((EmulatorServer::Now() - _start_usec)/1000));
+    }
+    else if (service_subcode == SickLD::SICK_CONF_SERV_SET_FILTER) {
+      _append16(argument_word);
+    }
+    else if (service_subcode == SickLD::SICK_CONF_SERV_SET_FUNCTION) {
+
+      if (argument_word >= LD_EMULATOR_MAX_NUM_SECTORS) {
+	accepted = false;
+	break;
+      }
+
+      _sector_functions[argument_word] = (arguments[4] << 8) | arguments[5];
+      _sector_stops[argument_word] = (arguments[6] << 8) | arguments[7];
+      _append16(argument_word);
+    }
+    else if (service_subcode == SickLD::SICK_CONF_SERV_GET_FUNCTION) {
+
+      if (argument_word >= LD_EMULATOR_MAX_NUM_SECTORS) {
+	accepted = false;
+	break;
+      }
+
+      _append16(argument_word);
+      _append16(_sector_functions[argument_word]);
+      _append16(_sector_stops[argument_word]);
+    }
+    else {
+      accepted = false;
+    }
+    break;
+
+  case SickLD::SICK_MEAS_SERV_CODE:
+
+    if (service_subcode == SickLD::SICK_MEAS_SERV_GET_PROFILE) {
+
+      const uint16_t profile_format = (arguments[4] << 8) | arguments[5];
+
+      _cancelStreams(&connection);
+
+      ld_emulator_stream_t stream;
+      stream.connection = &connection;
+      stream.profile_format = profile_format;
+      stream.num_remaining = argument_word;
+      stream.num_sent = 0;
+      _streams.push_back(stream);
+
+      _append16(profile_format);
+    }
+    else if (service_subcode == SickLD::SICK_MEAS_SERV_CANCEL_PROFILE) {
+      _cancelStreams(&connection);
+      _append16(0);
+      _append16(_statusByte());
+    }
+    else {
+      accepted = false;
+    }
+    break;
+
+  case SickLD::SICK_WORK_SERV_CODE:
+
+    if (service_subcode == SickLD::SICK_WORK_SERV_RESET) {
+      _sensor_mode = SickLD::SICK_SENSOR_MODE_IDLE;
+      _cancelStreams(NULL);
+      _append16(argument_word);
+    }
+    else if (service_subcode == SickLD::SICK_WORK_SERV_TRANS_IDLE ||
+	     service_subcode == SickLD::SICK_WORK_SERV_TRANS_ROTATE ||
+	     service_subcode == SickLD::SICK_WORK_SERV_TRANS_MEASURE) {
+
+      /* The subcodes follow the sensor modes (TRANS_IDLE = IDLE + 1, ...) */
+      _sensor_mode = service_subcode - 1;
+      if (_sensor_mode != SickLD::SICK_SENSOR_MODE_MEASURE) {
+	_cancelStreams(NULL);
+      }
+
+      _append16(0);
+      _append16(_statusByte());
+      _append16(SickLD::SICK_WORK_SERV_TRANS_MEASURE_RET_OK);
+    }
+    else {
+      accepted = false;
+    }
+    break;
+
+  default:
+    accepted = false;
+  }
+
+  /* Rejected requests come back with an error word */
+  if (!accepted) {
+    _payload.resize(2);
+    _append16(0xFFFF);
+  }
+
+  _sendPayload(connection);
+}
+
+/**
+ * \brief Streams the current revolution to every subscriber
+ * \param now_usec The current time
+ */
+void LdEmulator::HandleTick( const uint64_t now_usec ) {
+
+  if (_streams.empty() || _sensor_mode != SickLD::SICK_SENSOR_MODE_MEASURE) {
+    return;
+  }
+
+  _profile_counter++;
+
+  /* Encode the revolution once per format */
+  std::vector< uint16_t > formats;
+  _profiles.clear();
+
+  for (unsigned int i = 0; i < _streams.size(); ) {
+
+    ld_emulator_stream_t &stream = _streams[i];
+
+    unsigned int f = std::find(formats.begin(),formats.end(),stream.profile_format) - formats.begin();
+    if (f == formats.size()) {
+      formats.push_back(stream.profile_format);
+      _profiles.push_back(std::vector< uint8_t >());
+      _synthesizeProfile(stream.profile_format,now_usec,_profiles.back());
+    }
+
+    std::vector< uint8_t > &message = _profiles[f];
+    if (message.empty()) {
+      i++;
+      continue;
+    }
+
+    /* Patch PROFILESENT (and the checksum) for this subscriber */
+    stream.num_sent++;
+    if (stream.profile_format & 0x0001) {
+      uint8_t &checksum = message[message.size()-1];
+      checksum ^= message[14] ^ message[15] ^ (uint8_t)(stream.num_sent >> 8) ^ (uint8_t)stream.num_sent;
+      message[14] = stream.num_sent >> 8;
+      message[15] = stream.num_sent & 0xFF;
+    }
+
+    stream.connection->Send(&message[0],message.size());
+
+    if (stream.num_remaining > 0 && --stream.num_remaining == 0) {
+      _streams.erase(_streams.begin() + i);
+    }
+    else {
+      i++;
+    }
+
+  }
+
+}
+
+/**
+ * \brief Drops the connection's stream
+ * \param connection The departing client
+ */
+void LdEmulator::HandleDisconnect( EmulatorConnection &connection ) {
+  _cancelStreams(&connection);
+}
+
+/**
+ * \brief Appends a big-endian 16-bit value to the reply
+ * \param value The value
+ */
+void LdEmulator::_append16( const uint16_t value ) {
+  _payload.push_back(value >> 8);
+  _payload.push_back(value & 0xFF);
+}
+
+/**
+ * \brief Wraps the reply payload in a message and sends it
+ * \param connection The client
+ */
+void LdEmulator::_sendPayload( EmulatorConnection &connection ) {
+
+  _framePayload(_message);
+  connection.Send(&_message[0],_message.size());
+}
+
+/**
+ * \brief Wraps the payload being built in a message
+ * \param message Receives the header, payload and checksum
+ */
+void LdEmulator::_framePayload( std::vector< uint8_t > &message ) const {
+
+  const uint32_t payload_length = host_to_sick_ld_byte_order((uint32_t)_payload.size());
+
+  message.clear();
+  message.insert(message.end(),(const uint8_t *)"\x02USP",(const uint8_t *)"\x02USP" + 4);
+  message.insert(message.end(),(const uint8_t *)&payload_length,(const uint8_t *)&payload_length + 4);
+  message.insert(message.end(),_payload.begin(),_payload.end());
+
+  uint8_t checksum = 0;
+  for (unsigned int i = 0; i < _payload.size(); i++) {
+    checksum ^= _payload[i];
+  }
+  message.push_back(checksum);
+}
+
+/**
+ * \brief Encodes the current revolution
+ * \param profile_format The requested fields (see the SickLD profile format masks)
+ * \param now_usec The current time
+ * \param message Receives the message (left empty if the profile does not fit in a message)
+ *
+ * Only the sectors configured for normal measurement carry data.  Ranges
+ * are the distances to the room walls plus bounded noise seeded by the
+ * revolution, in the device's 1/256 m units.
+ */
+void LdEmulator::_synthesizeProfile( const uint16_t profile_format, const uint64_t now_usec, std::vector< uint8_t > &message ) {
+
+  /* Locate the sector boundaries as the driver does */
+  unsigned int num_initialized_sectors = 0;
+  while (num_initialized_sectors < LD_EMULATOR_MAX_NUM_SECTORS &&
+	 _sector_functions[num_initialized_sectors] != SickLD::SICK_CONF_SECTOR_NOT_INITIALIZED) {
+    num_initialized_sectors++;
+  }
+
+  uint16_t sector_starts[LD_EMULATOR_MAX_NUM_SECTORS] = {0};
+  for (unsigned int i = 1; i < num_initialized_sectors; i++) {
+    sector_starts[i] = (_sector_stops[i-1] + _angle_step) % LD_EMULATOR_TICKS_PER_REV;
+  }
+  if (num_initialized_sectors > 1) {
+    sector_starts[0] = (_sector_stops[num_initialized_sectors-1] + _angle_step) % LD_EMULATOR_TICKS_PER_REV;
+  }
+
+  unsigned int num_measuring_sectors = 0;
+  for (unsigned int i = 0; i < num_initialized_sectors; i++) {
+    if (_sector_functions[i] == SickLD::SICK_CONF_SECTOR_NORMAL_MEASUREMENT) {
+      num_measuring_sectors++;
+    }
+  }
+
+  const double revolution_ms = (now_usec - _start_usec)/1000.0;
+  const double ms_per_tick = 1000.0/_motor_speed/LD_EMULATOR_TICKS_PER_REV;
+  uint32_t random_state = EmulatorNoiseSeed(_scene.seed,_profile_counter);
+
+  _payload.clear();
+  _payload.push_back(SickLD::SICK_MEAS_SERV_CODE | 0x80);
+  _payload.push_back((uint8_t)SickLD::SICK_MEAS_SERV_GET_PROFILE);
+  _append16(profile_format);
+  _append16(num_measuring_sectors);
+
+  if (profile_format & 0x0001) {
+    _append16(0);                                           // PROFILESENT (patched per subscriber)
+  }
+  if (profile_format & 0x0002) {
+    _append16(_profile_counter);                            // PROFILECOUNT
+  }
+  if (profile_format & 0x0004) {
+    _append16(0);                                           // LAYERNUM
+  }
+
+  for (unsigned int i = 0; i < num_initialized_sectors; i++) {
+
+    if (_sector_functions[i] != SickLD::SICK_CONF_SECTOR_NORMAL_MEASUREMENT) {
+      continue;
+    }
+
+    const unsigned int span = (_sector_stops[i] + LD_EMULATOR_TICKS_PER_REV - sector_starts[i]) % LD_EMULATOR_TICKS_PER_REV;
+    const unsigned int num_points = std::min(span/_angle_step + 1,(unsigned int)SickLD::SICK_MAX_NUM_MEASUREMENTS);
+
+    if (profile_format & 0x0008) {
+      _append16(i);                                         // SECTORNUM
+    }
+    if (profile_format & 0x0010) {
+      _append16(_angle_step);                               // DIRSTEP
+    }
+    if (profile_format & 0x0020) {
+      _append16(num_points);                                // POINTNUM
+    }
+    if (profile_format & 0x0040) {
+      _append16((uint16_t)(revolution_ms + sector_starts[i]*ms_per_tick));
+    }
+    if (profile_format & 0x0080) {
+      _append16(sector_starts[i]);                          // STARTDIR
+    }
+
+    for (unsigned int j = 0; j < num_points; j++) {
+
+      const uint16_t direction = (sector_starts[i] + j*_angle_step) % LD_EMULATOR_TICKS_PER_REV;
+      const double theta = (direction/16.0 + _scene.heading)*M_PI/180;
+
+      double range = EmulatorWallRange(_scene.room_width,_scene.room_height,_scene.x,_scene.y,theta,_scene.max_range);
+      range += EmulatorNoise(random_state)*_scene.range_noise;
+      range = (range > 0 && range < _scene.max_range) ? range : 0;
+
+      if (profile_format & 0x0100) {
+	_append16((uint16_t)std::min(floor(range*256/1000 + 0.5),65535.0));
+      }
+      if (profile_format & 0x0200) {
+	_append16(direction);
+      }
+      if (profile_format & 0x0400) {
+	_append16(range > 0 ? (uint16_t)(1000 - std::min(range/20,900.0)) : 0);
+      }
+
+    }
+
+    if (profile_format & 0x0800) {
+      _append16((uint16_t)(revolution_ms + (sector_starts[i] + span)*ms_per_tick));
+    }
+    if (profile_format & 0x1000) {
+      _append16((sector_starts[i] + (num_points - 1)*_angle_step) % LD_EMULATOR_TICKS_PER_REV);
+    }
+
+  }
+
+  if (profile_format & 0x2000) {
+    _append16(0);                                           // SENSTAT
+    _append16(_statusByte());
+  }
+
+  /* A real device cannot be configured into an oversized profile either */
+  if (_payload.size() > SICK_LD_MSG_PAYLOAD_MAX_LEN) {
+    message.clear();
+    return;
+  }
+
+  _framePayload(message);
+}
+
+/**
+ * \brief Appends an identification string (NUL terminated)
+ * \param id_code The requested SICK_STAT_SERV_GET_ID_* item
+ */
+void LdEmulator::_appendIdentification( const uint8_t id_code ) {
+
+  const char *id_string = "";
+  switch (id_code) {
+  case SickLD::SICK_STAT_SERV_GET_ID_SENSOR_PART_NUM:       id_string = "1026543"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_SENSOR_NAME:           id_string = "LD-OEM EMULATOR"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_SENSOR_VERSION:        id_string = "V1.00"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_SENSOR_SERIAL_NUM:     id_string = "EMU00001"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_SENSOR_EDM_SERIAL_NUM: id_string = "EMU00001E"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_FIRMWARE_PART_NUM:     id_string = "2034567"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_FIRMWARE_NAME:         id_string = "LD-OEM"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_FIRMWARE_VERSION:      id_string = "V1.10"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_APP_PART_NUM:          id_string = "2045678"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_APP_NAME:              id_string = "EMULATOR"; break;
+  case SickLD::SICK_STAT_SERV_GET_ID_APP_VERSION:           id_string = "V1.00"; break;
+  }
+
+  _payload.insert(_payload.end(),id_string,id_string + strlen(id_string) + 1);
+}
+
+/**
+ * \brief Returns the status byte (motor mode in the high nibble, sensor mode in the low)
+ */
+uint8_t LdEmulator::_statusByte( ) const {
+  return (SickLD::SICK_MOTOR_MODE_OK << 4) | _sensor_mode;
+}
+
+/**
+ * \brief Cancels profile streams
+ * \param connection The subscriber to cancel (NULL cancels every stream)
+ */
+void LdEmulator::_cancelStreams( const EmulatorConnection * const connection ) {
+
+  for (unsigned int i = 0; i < _streams.size(); ) {
+    if (connection == NULL || _streams[i].connection == connection) {
+      _streams.erase(_streams.begin() + i);
+    }
+    else {
+      i++;
+    }
+  }
+
+}
@@ -0,0 +1,147 @@
+/*!
+ * \file ld_emulator.h
+ * \brief Emulates a Sick LD over its binary TCP protocol, streaming
+ *        scan profiles while the device is measuring.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef LD_EMULATOR_H
+#define LD_EMULATOR_H
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include "emulator_server.h"
+#include "emulator_scene.h"
+
+/* Macros */
+#define LD_EMULATOR_TICKS_PER_REV                   (5760)  ///< Angular ticks per revolution (1/16 deg)
+#define LD_EMULATOR_DEFAULT_MOTOR_SPEED               (10)  ///< Motor speed at power up (Hz)
+#define LD_EMULATOR_DEFAULT_ANGLE_STEP                 (8)  ///< Angular step at power up (ticks, i.e. 0.5 deg)
+#define LD_EMULATOR_MAX_NUM_SECTORS                    (8)  ///< Sectors per revolution (SickLD::SICK_MAX_NUM_SECTORS)
+
+/**
+ * \class LdEmulator
+ * \brief A Sick LD that answers the requests issued by SickLD
+ *
+ * Sector functions, the global configuration and the sensor mode are
+ * held as device state, so the driver's configuration round trips.
+ * GET_PROFILE subscribes the requesting connection to one profile per
+ * motor revolution (or a fixed number of them); each revolution is
+ * encoded once per profile format and shared by its subscribers.
+ */
+class LdEmulator : public EmulatorDevice {
+
+public:
+
+  /** A standard constructor */
+  LdEmulator( const emulator_scene_t &scene, const unsigned int motor_speed = LD_EMULATOR_DEFAULT_MOTOR_SPEED );
+
+  /** Returns a short name for log output */
+  std::string GetName( ) const { return "LD"; }
+
+  /** Frames a 0x02 'USP' message */
+  unsigned int FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const;
+
+  /** Answers one request */
+  void HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length );
+
+  /** Returns the revolution period */
+  uint64_t GetTickPeriod( ) const { return (uint64_t)1000000/_motor_speed; }
+
+  /** Streams a profile to the subscribers */
+  void HandleTick( const uint64_t now_usec );
+
+  /** Drops the connection's stream */
+  void HandleDisconnect( EmulatorConnection &connection );
+
+  /** Returns the number of revolutions streamed so far */
+  unsigned int GetNumProfiles( ) const { return _profile_counter; }
+
+private:
+
+  /** A connection receiving profiles */
+  typedef struct ld_emulator_stream_tag {
+    EmulatorConnection *connection;                         ///< The subscriber
+    uint16_t profile_format;                                ///< Requested profile format
+    uint16_t num_remaining;                                 ///< Profiles left to send (0 streams until cancelled)
+    uint16_t num_sent;                                      ///< Profiles sent so far (PROFILESENT)
+  } ld_emulator_stream_t;
+
+  /** The scene */
+  emulator_scene_t _scene;
+
+  /** Sensor id */
+  uint16_t _sensor_id;
+
+  /** Motor speed (Hz) */
+  uint16_t _motor_speed;
+
+  /** Angular step (ticks) */
+  uint16_t _angle_step;
+
+  /** Sensor mode (SickLD::SICK_SENSOR_MODE_*) */
+  uint8_t _sensor_mode;
+
+  /** Switch and LED port */
+  uint8_t _signals;
+
+  /** Sector functions */
+  uint16_t _sector_functions[LD_EMULATOR_MAX_NUM_SECTORS];
+
+  /** Sector stop angles (ticks) */
+  uint16_t _sector_stops[LD_EMULATOR_MAX_NUM_SECTORS];
+
+  /** Revolutions synthesized so far (PROFILECOUNT) */
+  uint16_t _profile_counter;
+
+  /** Wall time at power up (usec) */
+  uint64_t _start_usec;
+
+  /** The active streams */
+  std::vector< ld_emulator_stream_t > _streams;
+
+  /** The payload of the reply being built */
+  std::vector< uint8_t > _payload;
+
+  /** The reply being sent */
+  std::vector< uint8_t > _message;
+
+  /** Encoded messages, one per profile format seen in the current tick */
+  std::vector< std::vector< uint8_t > > _profiles;
+
+  /** Appends a big-endian 16-bit value to _payload */
+  void _append16( const uint16_t value );
+
+  /** Wraps _payload in a message and sends it */
+  void _sendPayload( EmulatorConnection &connection );
+
+  /** Wraps _payload in a message */
+  void _framePayload( std::vector< uint8_t > &message ) const;
+
+  /** Encodes the current revolution in the given format */
+  void _synthesizeProfile( const uint16_t profile_format, const uint64_t now_usec, std::vector< uint8_t > &message );
+
+  /** Appends an identification string */
+  void _appendIdentification( const uint8_t id_code );
+
+  /** Returns the SENSTAT/status byte */
+  uint8_t _statusByte( ) const;
+
+  /** Cancels the connection's stream (all streams if connection is NULL) */
+  void _cancelStreams( const EmulatorConnection * const connection );
+
+  /** Emulators are not copyable */
+  LdEmulator( const LdEmulator & );
+  LdEmulator & operator=( const LdEmulator & );
+
+};
+
+#endif /* LD_EMULATOR_H */
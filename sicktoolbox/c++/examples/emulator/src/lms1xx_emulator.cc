@@ -0,0 +1,325 @@
+/*!
+ * \file lms1xx_emulator.cc
+ * \brief Implements the LMS 1xx emulator.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "lms1xx_emulator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+#include <sicktoolbox/SickColaFormat.hh>
+
+/**
+ * \brief A standard constructor
+ * \param scene The room to measure
+ * \param scan_freq Scan frequency at power up (1/100 Hz)
+ */
+Lms1xxEmulator::Lms1xxEmulator( const emulator_scene_t &scene, const unsigned int scan_freq ) :
+  _scene(scene), _scan_freq(LMS1XX_EMULATOR_SCAN_FREQ_50), _scan_res(LMS1XX_EMULATOR_SCAN_RES_50),
+  _start_angle(LMS1XX_EMULATOR_MIN_ANGLE), _stop_angle(LMS1XX_EMULATOR_MAX_ANGLE),
+  _channels(1), _rssi(false), _rssi_16bit(false), _status(LMS1XX_EMULATOR_STATUS_MEASURING),
+  _scan_counter(0), _telegram_counter(0), _start_usec(EmulatorServer::Now()) {
+
+  if (scan_freq == LMS1XX_EMULATOR_SCAN_FREQ_25) {
+    _scan_freq = LMS1XX_EMULATOR_SCAN_FREQ_25;
+    _scan_res = LMS1XX_EMULATOR_SCAN_RES_25;
+  }
+
+  _telegram.reserve(16384);
+}
+
+/**
+ * \brief Frames an STX...ETX telegram
+ */
+unsigned int Lms1xxEmulator::FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const {
+  return EmulatorFrameColaA(buffer,length,request_start);
+}
+
+/**
+ * \brief Answers one CoLa-A request
+ * \param connection The requesting client
+ * \param request The telegram (STX and ETX included)
+ * \param length Length of the telegram
+ */
+void Lms1xxEmulator::HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length ) {
+
+  const std::string payload((const char *)request + 1,length - 2);
+
+  std::istringstream payload_stream(payload);
+  std::string command_type, command, arguments;
+  payload_stream >> command_type >> command;
+  std::getline(payload_stream,arguments);
+
+  if (command == "LMPscancfg") {
+
+    /* Angles are signed, but the device (and driver) carry them as 32-bit hex */
+    char reply[128];
+    snprintf(reply,sizeof(reply),"sRA LMPscancfg %X 1 %X %X %X",_scan_freq,_scan_res,(uint32_t)_start_angle,(uint32_t)_stop_angle);
+    EmulatorSendColaA(connection,reply);
+  }
+  else if (command == "mLMPsetscancfg") {
+
+    char reply[128];
+    snprintf(reply,sizeof(reply),"sAN mLMPsetscancfg %u %X 1 %X %X %X",_setScanConfig(arguments),_scan_freq,_scan_res,(uint32_t)_start_angle,(uint32_t)_stop_angle);
+    EmulatorSendColaA(connection,reply);
+  }
+  else if (command == "LMDscandatacfg") {
+    _setScanDataConfig(arguments);
+    EmulatorSendColaA(connection,"sWA LMDscandatacfg");
+  }
+  else if (command == "LMDscandata" && command_type == "sEN") {
+
+    std::vector< EmulatorConnection * >::iterator subscriber = std::find(_subscribers.begin(),_subscribers.end(),&connection);
+    const bool subscribe = arguments.find('1') != std::string::npos;
+
+    if (subscribe && subscriber == _subscribers.end()) {
+      _subscribers.push_back(&connection);
+    }
+    else if (!subscribe && subscriber != _subscribers.end()) {
+      _subscribers.erase(subscriber);
+    }
+
+    EmulatorSendColaA(connection,subscribe ? "sEA LMDscandata 1" : "sEA LMDscandata 0");
+  }
+  else if (command == "STlms") {
+
+    char reply[128];
+    snprintf(reply,sizeof(reply),"sRA STlms %u 1 8 16:00:00 8 01.01.2000 0 0 0",_status);
+    EmulatorSendColaA(connection,reply);
+  }
+  else if (command == "LMCstartmeas") {
+    _status = LMS1XX_EMULATOR_STATUS_MEASURING;
+    EmulatorSendColaA(connection,"sAN LMCstartmeas 0");
+  }
+  else if (command == "LMCstopmeas") {
+    _status = LMS1XX_EMULATOR_STATUS_READY;
+    EmulatorSendColaA(connection,"sAN LMCstopmeas 0");
+  }
+  else if (command == "SetAccessMode") {
+    EmulatorSendColaA(connection,"sAN SetAccessMode 1");
+  }
+  else if (command == "mEEwriteall") {
+    EmulatorSendColaA(connection,"sAN mEEwriteall 1");
+  }
+  else if (command == "Run") {
+    EmulatorSendColaA(connection,"sAN Run 1");
+  }
+  else if (command_type == "sWN") {
+    EmulatorSendColaA(connection,"sWA " + command);
+  }
+  else if (command_type == "sMN") {
+    EmulatorSendColaA(connection,"sAN " + command + " 0");
+  }
+  else {
+    EmulatorSendColaA(connection,"sFA 1");
+  }
+
+}
+
+/**
+ * \brief Streams one scan to every subscriber
+ * \param now_usec The current time
+ */
+void Lms1xxEmulator::HandleTick( const uint64_t now_usec ) {
+
+  if (_subscribers.empty() || _status != LMS1XX_EMULATOR_STATUS_MEASURING) {
+    return;
+  }
+
+  _synthesizeScan(now_usec);
+  for (unsigned int i = 0; i < _subscribers.size(); i++) {
+    _subscribers[i]->Send((const uint8_t *)_telegram.data(),_telegram.length());
+  }
+
+}
+
+/**
+ * \brief Drops the connection's subscription
+ * \param connection The departing client
+ */
+void Lms1xxEmulator::HandleDisconnect( EmulatorConnection &connection ) {
+  _subscribers.erase(std::remove(_subscribers.begin(),_subscribers.end(),&connection),_subscribers.end());
+}
+
+/**
+ * \brief Applies "+freq +1 +res start stop"
+ * \param arguments The mLMPsetscancfg arguments
+ * \return The device's status code (0 on success, 1-4 for an invalid frequency, resolution, both or area)
+ *
+ * The LMS 1xx scans at 25 Hz with 0.25 or 0.5 deg, or at 50 Hz with 0.5 deg.
+ */
+unsigned int Lms1xxEmulator::_setScanConfig( const std::string &arguments ) {
+
+  std::istringstream argument_stream(arguments);
+  int scan_freq = 0, num_sectors = 0, scan_res = 0, start_angle = 0, stop_angle = 0;
+  if (!(argument_stream >> scan_freq >> num_sectors >> scan_res >> start_angle >> stop_angle)) {
+    return 5;
+  }
+
+  const bool valid_freq = scan_freq == LMS1XX_EMULATOR_SCAN_FREQ_25 || scan_freq == LMS1XX_EMULATOR_SCAN_FREQ_50;
+  const bool valid_res = scan_res == LMS1XX_EMULATOR_SCAN_RES_50 ||
+                         (scan_res == LMS1XX_EMULATOR_SCAN_RES_25 && scan_freq != LMS1XX_EMULATOR_SCAN_FREQ_50);
+
+  if (!valid_freq || !valid_res) {
+    return (valid_freq ? 0 : 1) + (valid_res ? 0 : 2);
+  }
+
+  if (start_angle < LMS1XX_EMULATOR_MIN_ANGLE || stop_angle > LMS1XX_EMULATOR_MAX_ANGLE || start_angle >= stop_angle) {
+    return 4;
+  }
+
+  _scan_freq = scan_freq;
+  _scan_res = scan_res;
+  _start_angle = start_angle;
+  _stop_angle = stop_angle;
+  return 0;
+}
+
+/**
+ * \brief Applies "0X 00 R B ..." (X: channels, R: RSSI on/off, B: 8/16 bit RSSI)
+ * \param arguments The LMDscandatacfg arguments
+ */
+void Lms1xxEmulator::_setScanDataConfig( const std::string &arguments ) {
+
+  std::istringstream argument_stream(arguments);
+  std::string channels, reserved;
+  unsigned int rssi = 0, rssi_16bit = 0;
+
+  if (argument_stream >> channels >> reserved >> rssi >> rssi_16bit) {
+    _channels = (unsigned int)strtoul(channels.c_str(),NULL,16) & 0x3;
+    _rssi = rssi != 0;
+    _rssi_16bit = rssi_16bit != 0;
+  }
+
+}
+
+/**
+ * \brief Builds the next LMDscandata telegram
+ * \param now_usec The current time
+ *
+ * DIST1 holds the distance to the room walls plus bounded noise seeded
+ * by the scan counter; DIST2 (the second echo) is always empty.
+ */
+void Lms1xxEmulator::_synthesizeScan( const uint64_t now_usec ) {
+
+  const unsigned int num_values = (unsigned int)(_stop_angle - _start_angle)/_scan_res + 1;
+  const uint32_t time_since_startup = (uint32_t)(now_usec - _start_usec);
+
+  _scan_counter++;
+  _telegram_counter++;
+
+  _telegram.assign("\x02sSN LMDscandata 1 1 EE5A1A");
+  _appendHex(0);                                            // Device status
+  _appendHex(0);
+  _appendHex(_telegram_counter);
+  _appendHex(_scan_counter);
+  _appendHex(time_since_startup);                           // Time since startup (usec)
+  _appendHex(time_since_startup + 100);                     // Time of transmission (usec)
+  _telegram.append(" 0 0 0 0 0");                           // Inputs, outputs, reserved
+  _appendHex(_scan_freq);
+  _appendHex(_scan_freq/100*num_values/100);                // Measurement frequency (100 Hz)
+  _telegram.append(" 0");                                   // No encoders
+
+  /* The ranges are synthesized once and reused by each channel */
+  std::vector< unsigned int > ranges(num_values);
+  uint32_t random_state = EmulatorNoiseSeed(_scene.seed,_scan_counter);
+  for (unsigned int i = 0; i < num_values; i++) {
+
+    const double angle = (_start_angle + (double)i*_scan_res)/10000.0 + _scene.heading;
+    double range = EmulatorWallRange(_scene.room_width,_scene.room_height,_scene.x,_scene.y,angle*M_PI/180,_scene.max_range);
+    range = floor(range + EmulatorNoise(random_state)*_scene.range_noise + 0.5);
+    ranges[i] = (range > 0 && range < _scene.max_range) ? (unsigned int)range : 0;
+  }
+
+  /* Remission falls off with range (second echoes are empty) */
+  std::vector< unsigned int > empty(num_values,0), rssi(num_values,0);
+  for (unsigned int i = 0; i < num_values; i++) {
+    if (ranges[i]) {
+      rssi[i] = 255 - std::min(ranges[i]/100,200u);
+      rssi[i] = _rssi_16bit ? rssi[i]*256 : rssi[i];
+    }
+  }
+
+  const unsigned int num_channels = ((_channels & 0x1) ? 1 : 0) + ((_channels & 0x2) ? 1 : 0);
+
+  /* 16-bit channels */
+  _appendHex(num_channels + ((_rssi && _rssi_16bit) ? num_channels : 0));
+  if (_channels & 0x1) {
+    _appendChannel("DIST1",ranges);
+  }
+  if (_channels & 0x2) {
+    _appendChannel("DIST2",empty);
+  }
+  if (_rssi && _rssi_16bit) {
+    _appendRemission(rssi,empty);
+  }
+
+  /* 8-bit channels */
+  _appendHex((_rssi && !_rssi_16bit) ? num_channels : 0);
+  if (_rssi && !_rssi_16bit) {
+    _appendRemission(rssi,empty);
+  }
+
+  _telegram.append(" 0 0 0 0 0\x03");                       // No position, name, comment, time or event
+}
+
+/**
+ * \brief Appends an output channel
+ * \param name The channel name (e.g. "DIST1")
+ * \param values One value per beam
+ */
+void Lms1xxEmulator::_appendChannel( const char * const name, const std::vector< unsigned int > &values ) {
+
+  _telegram.append(" ");
+  _telegram.append(name);
+  _telegram.append(" 3F800000 00000000");                   // Scale factor 1.0, offset 0
+  _appendHex((uint32_t)_start_angle);
+  _appendHex(_scan_res);
+  _appendHex(values.size());
+
+  /* The whole channel in one pass */
+  if (!values.empty()) {
+    const unsigned int length = _telegram.size();
+    _telegram.resize(length + values.size()*(1 + SICK_COLA_MAX_HEX_LENGTH) + SICK_COLA_WRITE_SLACK);
+    _telegram.resize(length + SickToolbox::sick_cola_write_hex_fields(&_telegram[length],&values[0],values.size()));
+  }
+
+}
+
+/**
+ * \brief Appends the RSSI channels matching the enabled distance channels
+ * \param first The first-echo remission
+ * \param second The second-echo remission
+ */
+void Lms1xxEmulator::_appendRemission( const std::vector< unsigned int > &first, const std::vector< unsigned int > &second ) {
+
+  if (_channels & 0x1) {
+    _appendChannel("RSSI1",first);
+  }
+  if (_channels & 0x2) {
+    _appendChannel("RSSI2",second);
+  }
+
+}
+
+/**
+ * \brief Appends a space and the value in upper-case hex
+ * \param value The value
+ */
+void Lms1xxEmulator::_appendHex( const uint32_t value ) {
+
+  char field[1 + SICK_COLA_MAX_HEX_LENGTH + SICK_COLA_WRITE_SLACK] = {' '};
+  _telegram.append(field,1 + SickToolbox::sick_cola_write_hex(field + 1,value));
+}
@@ -0,0 +1,138 @@
+/*!
+ * \file lms1xx_emulator.h
+ * \brief Emulates a Sick LMS 1xx over CoLa-A, streaming LMDscandata
+ *        telegrams at the configured scan frequency.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef LMS1XX_EMULATOR_H
+#define LMS1XX_EMULATOR_H
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include "emulator_server.h"
+#include "emulator_scene.h"
+
+/* Macros */
+#define LMS1XX_EMULATOR_SCAN_FREQ_25                (2500)  ///< 25 Hz (1/100 Hz)
+#define LMS1XX_EMULATOR_SCAN_FREQ_50                (5000)  ///< 50 Hz (1/100 Hz)
+#define LMS1XX_EMULATOR_SCAN_RES_25                 (2500)  ///< 0.25 deg (1/10000 deg)
+#define LMS1XX_EMULATOR_SCAN_RES_50                 (5000)  ///< 0.50 deg (1/10000 deg)
+#define LMS1XX_EMULATOR_MIN_ANGLE                (-450000)  ///< -45 deg (1/10000 deg)
+#define LMS1XX_EMULATOR_MAX_ANGLE                (2250000)  ///< 225 deg (1/10000 deg)
+#define LMS1XX_EMULATOR_STATUS_READY                   (6)  ///< STlms: ready
+#define LMS1XX_EMULATOR_STATUS_MEASURING               (7)  ///< STlms: ready for measurement
+
+/**
+ * \class Lms1xxEmulator
+ * \brief An LMS 1xx that answers the requests issued by SickLMS1xx
+ *
+ * Clients that send "sEN LMDscandata 1" receive one scan telegram per
+ * tick until they unsubscribe or disconnect.  A tick synthesizes the
+ * telegram once and sends the same bytes to every subscriber.
+ */
+class Lms1xxEmulator : public EmulatorDevice {
+
+public:
+
+  /** A standard constructor */
+  Lms1xxEmulator( const emulator_scene_t &scene, const unsigned int scan_freq = LMS1XX_EMULATOR_SCAN_FREQ_50 );
+
+  /** Returns a short name for log output */
+  std::string GetName( ) const { return "LMS1xx"; }
+
+  /** Frames an STX...ETX telegram */
+  unsigned int FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const;
+
+  /** Answers one CoLa-A request */
+  void HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length );
+
+  /** Returns the scan period */
+  uint64_t GetTickPeriod( ) const { return (uint64_t)100000000/_scan_freq; }
+
+  /** Streams a scan to the subscribers */
+  void HandleTick( const uint64_t now_usec );
+
+  /** Drops the connection's subscription */
+  void HandleDisconnect( EmulatorConnection &connection );
+
+  /** Returns the number of scans streamed so far */
+  unsigned int GetNumScans( ) const { return _scan_counter; }
+
+private:
+
+  /** The scene */
+  emulator_scene_t _scene;
+
+  /** Scan frequency (1/100 Hz) */
+  unsigned int _scan_freq;
+
+  /** Angular resolution (1/10000 deg) */
+  unsigned int _scan_res;
+
+  /** First beam (1/10000 deg) */
+  int _start_angle;
+
+  /** Last beam (1/10000 deg) */
+  int _stop_angle;
+
+  /** Output channels (bit 0: first pulse, bit 1: second pulse) */
+  unsigned int _channels;
+
+  /** Whether RSSI channels are output */
+  bool _rssi;
+
+  /** Whether RSSI values are 16 bit (otherwise 8 bit) */
+  bool _rssi_16bit;
+
+  /** STlms device status */
+  unsigned int _status;
+
+  /** Scans synthesized so far */
+  unsigned int _scan_counter;
+
+  /** Telegrams sent so far */
+  unsigned int _telegram_counter;
+
+  /** Wall time at power up (usec) */
+  uint64_t _start_usec;
+
+  /** Connections subscribed to LMDscandata */
+  std::vector< EmulatorConnection * > _subscribers;
+
+  /** The telegram being built */
+  std::string _telegram;
+
+  /** Updates the scan config from an mLMPsetscancfg request */
+  unsigned int _setScanConfig( const std::string &arguments );
+
+  /** Updates the output format from an LMDscandatacfg request */
+  void _setScanDataConfig( const std::string &arguments );
+
+  /** Builds the next LMDscandata telegram into _telegram */
+  void _synthesizeScan( const uint64_t now_usec );
+
+  /** Appends a named channel to _telegram */
+  void _appendChannel( const char * const name, const std::vector< unsigned int > &values );
+
+  /** Appends RSSI1/RSSI2 for the enabled distance channels */
+  void _appendRemission( const std::vector< unsigned int > &first, const std::vector< unsigned int > &second );
+
+  /** Appends " <value in hex>" to _telegram */
+  void _appendHex( const uint32_t value );
+
+  /** Emulators are not copyable */
+  Lms1xxEmulator( const Lms1xxEmulator & );
+  Lms1xxEmulator & operator=( const Lms1xxEmulator & );
+
+};
+
+#endif /* LMS1XX_EMULATOR_H */
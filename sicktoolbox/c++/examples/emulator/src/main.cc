@@ -0,0 +1,162 @@
+/*!
+ * \file main.cc
+ * \brief Serves emulated Sick devices for driver load and latency
+ *        testing without hardware.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <stdlib.h>
+#include <signal.h>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "emulator_server.h"
+#include "nav350_emulator.h"
+#include "lms1xx_emulator.h"
+#include "ld_emulator.h"
+
+using namespace std;
+
+/* The server (stopped by SIGINT/SIGTERM) */
+static EmulatorServer *emulator_server = NULL;
+
+static void stop_server( int /* signal_number */ ) {
+  if (emulator_server) {
+    emulator_server->Stop();
+  }
+}
+
+static void print_usage( ) {
+  cout << "Usage: sick_emulator [OPTIONS]" << endl
+       << "  --nav350 PORT          serve a NAV350 on PORT (repeatable; 0 picks a free port)" << endl
+       << "  --lms1xx PORT          serve an LMS 1xx on PORT (repeatable)" << endl
+       << "  --ld PORT              serve an LD on PORT (repeatable)" << endl
+       << "  --rate HZ              NAV350 scan rate (default 8)" << endl
+       << "  --lms1xx-freq HZ       LMS 1xx scan frequency at power up, 25 or 50 (default 50)" << endl
+       << "  --ld-speed HZ          LD motor speed at power up, 5-20 (default 10)" << endl
+       << "  --deterministic        advance one scan per data request instead of the wall clock" << endl
+       << "  --trajectory FILE      \"time_ms x y phi_mdeg\" waypoints (looped)" << endl
+       << "  --landmarks FILE       \"global_id x y\" reflector map" << endl
+       << "  --noise MM             peak range noise (default 10)" << endl
+       << "  --delay MS             delay every reply" << endl
+       << "  --jitter MS            add a random delay of up to MS to every reply" << endl
+       << "  --fragment BYTES       split replies into writes of up to BYTES" << endl
+       << "  --fragment-gap MS      gap between the writes of a split reply" << endl
+       << "  --garbage P            send garbage ahead of a reply with probability P" << endl
+       << "  --drop P               drop a reply with probability P" << endl
+       << "  --seed N               seed for noise and faults (default 1)" << endl
+       << "Ex: sick_emulator --nav350 2111 --deterministic --fragment 64 --garbage 0.01" << endl
+       << "    sick_emulator --lms1xx 0 --lms1xx 0 --ld 49152" << endl;
+}
+
+int main( int argc, char *argv[] ) {
+
+  nav350_world_t world = Nav350DefaultWorld();
+  emulator_fault_config_t faults = EmulatorNoFaults();
+  emulator_scene_t scene = EmulatorDefaultScene();
+  unsigned int lms1xx_freq = LMS1XX_EMULATOR_SCAN_FREQ_50;
+  unsigned int ld_motor_speed = LD_EMULATOR_DEFAULT_MOTOR_SPEED;
+  vector< unsigned short > nav350_ports, lms1xx_ports, ld_ports;
+
+  static struct option long_options[] = {
+    {"nav350",       required_argument, 0, 'n'},
+    {"lms1xx",       required_argument, 0, 'm'},
+    {"ld",           required_argument, 0, 'L'},
+    {"rate",         required_argument, 0, 'r'},
+    {"lms1xx-freq",  required_argument, 0, 'q'},
+    {"ld-speed",     required_argument, 0, 'S'},
+    {"deterministic",no_argument,       0, 'd'},
+    {"trajectory",   required_argument, 0, 't'},
+    {"landmarks",    required_argument, 0, 'l'},
+    {"noise",        required_argument, 0, 'N'},
+    {"delay",        required_argument, 0, 'D'},
+    {"jitter",       required_argument, 0, 'j'},
+    {"fragment",     required_argument, 0, 'f'},
+    {"fragment-gap", required_argument, 0, 'F'},
+    {"garbage",      required_argument, 0, 'g'},
+    {"drop",         required_argument, 0, 'x'},
+    {"seed",         required_argument, 0, 's'},
+    {"help",         no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int option = 0;
+  while ((option = getopt_long(argc,argv,"",long_options,NULL)) != -1) {
+
+    switch (option) {
+    case 'n': nav350_ports.push_back((unsigned short)atoi(optarg)); break;
+    case 'm': lms1xx_ports.push_back((unsigned short)atoi(optarg)); break;
+    case 'L': ld_ports.push_back((unsigned short)atoi(optarg)); break;
+    case 'r': world.scan_rate = atof(optarg); break;
+    case 'q': lms1xx_freq = atoi(optarg)*100; break;
+    case 'S': ld_motor_speed = atoi(optarg); break;
+    case 'd': world.deterministic = true; break;
+    case 't':
+      if (!Nav350LoadTrajectory(optarg,world)) {
+	cerr << "Unable to load a trajectory from " << optarg << endl;
+	return -1;
+      }
+      break;
+    case 'l':
+      if (!Nav350LoadLandmarks(optarg,world)) {
+	cerr << "Unable to load landmarks from " << optarg << endl;
+	return -1;
+      }
+      break;
+    case 'N': world.range_noise = scene.range_noise = atof(optarg); break;
+    case 'D': faults.delay_ms = atoi(optarg); break;
+    case 'j': faults.jitter_ms = atoi(optarg); break;
+    case 'f': faults.fragment_max = atoi(optarg); break;
+    case 'F': faults.fragment_gap_ms = atoi(optarg); break;
+    case 'g': faults.garbage_probability = atof(optarg); break;
+    case 'x': faults.drop_probability = atof(optarg); break;
+    case 's': world.seed = scene.seed = faults.seed = atoi(optarg); break;
+    default:
+      print_usage();
+      return (option == 'h') ? 0 : -1;
+    }
+
+  }
+
+  if (nav350_ports.empty() && lms1xx_ports.empty() && ld_ports.empty()) {
+    nav350_ports.push_back(2111);
+  }
+
+  EmulatorServer server;
+  for (unsigned int i = 0; i < nav350_ports.size(); i++) {
+    if (server.AddDevice(new Nav350Emulator(world),nav350_ports[i],faults) == 0) {
+      return -1;
+    }
+  }
+
+  /* Each scanner gets its own noise so that no two streams are identical */
+  for (unsigned int i = 0; i < lms1xx_ports.size(); i++, scene.seed++) {
+    if (server.AddDevice(new Lms1xxEmulator(scene,lms1xx_freq),lms1xx_ports[i],faults) == 0) {
+      return -1;
+    }
+  }
+
+  for (unsigned int i = 0; i < ld_ports.size(); i++, scene.seed++) {
+    if (server.AddDevice(new LdEmulator(scene,ld_motor_speed),ld_ports[i],faults) == 0) {
+      return -1;
+    }
+  }
+
+  emulator_server = &server;
+  signal(SIGINT,stop_server);
+  signal(SIGTERM,stop_server);
+  signal(SIGPIPE,SIG_IGN);
+
+  server.Run();
+
+  emulator_server = NULL;
+  return 0;
+}
@@ -0,0 +1,381 @@
+/*!
+ * \file nav350_emulator.cc
+ * \brief Implements the NAV350 emulator.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+/* Implementation dependencies */
+#include "nav350_emulator.h"
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+/**
+ * \brief Returns the default world
+ *
+ * A 20 x 15 m room with twelve reflectors on a 6 m ring around its
+ * centre; the sensor drives a 3 m circle every 20 s, facing along the
+ * direction of travel.
+ */
+nav350_world_t Nav350DefaultWorld( ) {
+
+  nav350_world_t world;
+  world.room_width = 20000;
+  world.room_height = 15000;
+  world.reflector_radius = 40;
+  world.range_noise = 10;
+  world.scan_rate = 8;
+  world.deterministic = false;
+  world.seed = 1;
+
+  for (unsigned int i = 0; i <= 40; i++) {
+    const double theta = 2*M_PI*i/40;
+    nav350_waypoint_t waypoint;
+    waypoint.time_ms = 500.0*i;
+    waypoint.x = world.room_width/2 + 3000*cos(theta);
+    waypoint.y = world.room_height/2 + 3000*sin(theta);
+    waypoint.phi = fmod(theta*180/M_PI + 90,360)*1000;
+    world.trajectory.push_back(waypoint);
+  }
+
+  for (unsigned int i = 0; i < 12; i++) {
+    const double theta = 2*M_PI*i/12;
+    nav350_landmark_t landmark;
+    landmark.global_id = i + 1;
+    landmark.x = world.room_width/2 + 6000*cos(theta);
+    landmark.y = world.room_height/2 + 6000*sin(theta);
+    world.landmarks.push_back(landmark);
+  }
+
+  return world;
+}
+
+/**
+ * \brief Loads a trajectory ("time_ms x y phi" per line, '#' starts a comment)
+ * \param path The trajectory file
+ * \param world Receives the trajectory
+ * \return False if the file cannot be read or holds no waypoints
+ */
+bool Nav350LoadTrajectory( const std::string &path, nav350_world_t &world ) {
+
+  std::ifstream trajectory_file(path.c_str());
+  std::vector< nav350_waypoint_t > trajectory;
+  std::string line;
+
+  while (std::getline(trajectory_file,line)) {
+
+    std::istringstream line_stream(line.substr(0,line.find('#')));
+    nav350_waypoint_t waypoint;
+    if (line_stream >> waypoint.time_ms >> waypoint.x >> waypoint.y >> waypoint.phi) {
+      trajectory.push_back(waypoint);
+    }
+  }
+
+  if (trajectory.empty()) {
+    return false;
+  }
+
+  world.trajectory = trajectory;
+  return true;
+}
+
+/**
+ * \brief Loads a landmark map ("global_id x y" per line, '#' starts a comment)
+ * \param path The landmark file
+ * \param world Receives the landmarks
+ * \return False if the file cannot be read
+ */
+bool Nav350LoadLandmarks( const std::string &path, nav350_world_t &world ) {
+
+  std::ifstream landmark_file(path.c_str());
+  if (!landmark_file) {
+    return false;
+  }
+
+  std::vector< nav350_landmark_t > landmarks;
+  std::string line;
+
+  while (std::getline(landmark_file,line)) {
+
+    std::istringstream line_stream(line.substr(0,line.find('#')));
+    nav350_landmark_t landmark;
+    if (line_stream >> landmark.global_id >> landmark.x >> landmark.y) {
+      landmarks.push_back(landmark);
+    }
+  }
+
+  world.landmarks = landmarks;
+  return true;
+}
+
+/**
+ * \brief A standard constructor
+ * \param world The world to synthesize data from
+ */
+Nav350Emulator::Nav350Emulator( const nav350_world_t &world ) :
+  _world(world), _reply(NAV350_EMULATOR_REPLY_SIZE), _start_usec(EmulatorServer::Now()),
+  _scan_index(-1), _num_scans(0), _operating_mode('1') {
+
+  if (_world.trajectory.empty()) {
+    _world.trajectory = Nav350DefaultWorld().trajectory;
+  }
+
+  if (_world.scan_rate <= 0) {
+    _world.scan_rate = 8;
+  }
+
+  memset(&_measurements.ReflectorData_,0,sizeof(_measurements.ReflectorData_));
+  memset(&_measurements.PoseData_,0,sizeof(_measurements.PoseData_));
+  _measurements.meas_num = 0;
+}
+
+/**
+ * \brief Frames an STX...ETX telegram
+ * \param buffer The received bytes
+ * \param length Number of received bytes
+ * \param request_start Set to the offset of the STX (anything before it is noise)
+ * \return Length of the telegram including STX and ETX (0 if incomplete)
+ */
+unsigned int Nav350Emulator::FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const {
+  return EmulatorFrameColaA(buffer,length,request_start);
+}
+
+/**
+ * \brief Answers one CoLa-A request
+ * \param connection The requesting client
+ * \param request The telegram (STX and ETX included)
+ * \param length Length of the telegram
+ */
+void Nav350Emulator::HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length ) {
+
+  const std::string payload((const char *)request + 1,length - 2);
+
+  std::istringstream payload_stream(payload);
+  std::string command_type, command;
+  payload_stream >> command_type >> command;
+
+  char * const reply = &_reply[0];
+  const char last_argument = payload.empty() ? '0' : payload[payload.length()-1];
+
+  if (command == "mNPOSGetData") {
+    _updateScan();
+    connection.Send((const uint8_t *)reply,GetPoseData(&_measurements,reply,last_argument));
+  }
+  else if (command == "mNLMDGetData") {
+    _updateScan();
+    connection.Send((const uint8_t *)reply,GetLandmarkData(&_measurements,reply));
+  }
+  else if (command == "mNPOSGetPose") {
+    _updateScan();
+    connection.Send((const uint8_t *)reply,GetPose(&_measurements,reply));
+  }
+  else if (command == "mNMAPDoMapping") {
+    _updateScan();
+    connection.Send((const uint8_t *)reply,DoMapping(&_measurements,reply));
+  }
+  else if (command == "mNEVAChangeState") {
+    _operating_mode = last_argument;
+    connection.Send((const uint8_t *)reply,ChangeState(reply,_operating_mode));
+  }
+  else if (command == "SetAccessMode") {
+    EmulatorSendColaA(connection,"sAN SetAccessMode 1");
+  }
+  else if (command == "SerialNumber") {
+    EmulatorSendColaA(connection,"sRA SerialNumber 8 EMU00350");
+  }
+  else if (command == "DeviceIdent") {
+    EmulatorSendColaA(connection,"sRA DeviceIdent 6 NAV350 8 EMULATOR");
+  }
+  else if (command == "NLMDReflSize") {
+    EmulatorSendColaA(connection,"sRA NLMDReflSize 50");
+  }
+  else if (command_type == "sWN") {
+    EmulatorSendColaA(connection,"sWA " + command);
+  }
+  else if (command_type == "sMN") {
+    EmulatorSendColaA(connection,"sAN " + command + " 0");
+  }
+  else {
+    EmulatorSendColaA(connection,"sFA 1");
+  }
+
+}
+
+/**
+ * \brief Brings the packet up to date for a data request
+ */
+void Nav350Emulator::_updateScan( ) {
+
+  long scan_index = _scan_index + 1;
+  if (!_world.deterministic) {
+    scan_index = (long)((EmulatorServer::Now() - _start_usec)*_world.scan_rate/1e6);
+  }
+
+  if (scan_index != _scan_index) {
+    _synthesizeScan(scan_index);
+    _scan_index = scan_index;
+  }
+
+}
+
+/**
+ * \brief Synthesizes a scan, its pose and the visible reflectors
+ * \param scan_index The scan to synthesize (its time is scan_index/scan_rate)
+ *
+ * Ranges come from the room walls and the reflector cylinders plus a
+ * bounded noise term drawn from a generator seeded by the scan index, so
+ * a scan depends only on its index and the world.
+ */
+void Nav350Emulator::_synthesizeScan( const long scan_index ) {
+
+  const double time_ms = scan_index*1000.0/_world.scan_rate;
+  const nav350_waypoint_t pose = _poseAt(time_ms);
+  const double step_angle = 360.0/NAV350_EMULATOR_NUM_VALUES;
+  const double heading = pose.phi/1000.0*M_PI/180;
+  const unsigned int timestamp = (unsigned int)time_ms;
+
+  Measurements &m = _measurements;
+  m.meas_num = NAV350_EMULATOR_NUM_VALUES;
+  m.start_angle = 0;
+  m.step_angle = step_angle;
+  m.stop_angle = 360 - step_angle;
+  m.timestamp = timestamp;
+
+  for (unsigned int i = 0; i < NAV350_EMULATOR_NUM_VALUES; i++) {
+    m.distance[i] = EmulatorWallRange(_world.room_width,_world.room_height,pose.x,pose.y,
+				      heading + i*step_angle*M_PI/180,NAV350_EMULATOR_MAX_RANGE);
+  }
+
+  /* Reflectors */
+  sick_nav350_reflector_tag &reflectors = m.ReflectorData_;
+  reflectors.filter = 0;
+  reflectors.num_reflector = 0;
+
+  for (unsigned int j = 0; j < _world.landmarks.size() && reflectors.num_reflector < SICK_MAX_NUM_REFLECTORS; j++) {
+
+    const nav350_landmark_t &landmark = _world.landmarks[j];
+    const double dx = landmark.x - pose.x, dy = landmark.y - pose.y;
+    const double dist = sqrt(dx*dx + dy*dy);
+    if (dist <= _world.reflector_radius || dist > NAV350_EMULATOR_MAX_RANGE) {
+      continue;
+    }
+
+    double bearing = fmod(atan2(dy,dx) - heading,2*M_PI);
+    if (bearing < 0) {
+      bearing += 2*M_PI;
+    }
+
+    const double half_width = asin(_world.reflector_radius/dist);
+    const int center = (int)floor(bearing*180/M_PI/step_angle + 0.5);
+    const int half_beams = (int)ceil(half_width*180/M_PI/step_angle);
+
+    /* Hidden behind a wall (the room is convex, so only from outside it) */
+    if (dist - _world.reflector_radius > m.distance[(center + NAV350_EMULATOR_NUM_VALUES) % NAV350_EMULATOR_NUM_VALUES]) {
+      continue;
+    }
+
+    for (int k = center - half_beams; k <= center + half_beams; k++) {
+      const unsigned int beam = (k + NAV350_EMULATOR_NUM_VALUES) % NAV350_EMULATOR_NUM_VALUES;
+      if (dist - _world.reflector_radius < m.distance[beam]) {
+	m.distance[beam] = dist - _world.reflector_radius;
+      }
+    }
+
+    const unsigned int r = reflectors.num_reflector++;
+    reflectors.cart[r] = 1;
+    reflectors.x[r] = (int)floor(landmark.x + 0.5);
+    reflectors.y[r] = (int)floor(landmark.y + 0.5);
+    reflectors.polar[r] = 1;
+    reflectors.dist[r] = (int)floor(dist + 0.5);
+    reflectors.phi[r] = (int)floor(bearing*180/M_PI*1000 + 0.5);
+    reflectors.optional[r] = 1;
+    reflectors.LocalID[r] = r;
+    reflectors.GlobalID[r] = landmark.global_id;
+    reflectors.type[r] = 1;
+    reflectors.subtype[r] = 1;
+    reflectors.quality[r] = 100;
+    reflectors.timestamp[r] = timestamp;
+    reflectors.size[r] = (unsigned int)(2*_world.reflector_radius);
+    reflectors.hitCount[r] = 2*half_beams + 1;
+    reflectors.meanEchoAmplitude[r] = 200;
+    reflectors.indexStart[r] = (center - half_beams + NAV350_EMULATOR_NUM_VALUES) % NAV350_EMULATOR_NUM_VALUES;
+    reflectors.indexEnd[r] = (center + half_beams) % NAV350_EMULATOR_NUM_VALUES;
+  }
+
+  /* Bounded noise (seeded by the scan, so scans are reproducible in any order) */
+  uint32_t random_state = EmulatorNoiseSeed(_world.seed,scan_index);
+  for (unsigned int i = 0; i < NAV350_EMULATOR_NUM_VALUES; i++) {
+
+    const double noise = EmulatorNoise(random_state)*_world.range_noise;
+    m.distance[i] = floor(m.distance[i] + noise + 0.5);
+    if (m.distance[i] < 0 || m.distance[i] > NAV350_EMULATOR_MAX_RANGE) {
+      m.distance[i] = 0;
+    }
+  }
+
+  /* Pose */
+  sick_nav350_pose_tag &pose_data = m.PoseData_;
+  pose_data.x = (int)floor(pose.x + 0.5);
+  pose_data.y = (int)floor(pose.y + 0.5);
+  pose_data.phi = (unsigned int)floor(pose.phi + 0.5) % 360000;
+  pose_data.optionalPoseData = 1;
+  pose_data.outputMode = 0;
+  pose_data.timeStamp = timestamp;
+  pose_data.meanDeviation = (int)_world.range_noise;
+  pose_data.positionMode = 0;
+  pose_data.infoState = 0;
+  pose_data.numUsedReflectors = reflectors.num_reflector;
+
+  _num_scans++;
+}
+
+/**
+ * \brief Interpolates the (looped) trajectory
+ * \param time_ms Time since the start
+ * \return The interpolated pose
+ */
+nav350_waypoint_t Nav350Emulator::_poseAt( const double time_ms ) const {
+
+  const std::vector< nav350_waypoint_t > &trajectory = _world.trajectory;
+  const double duration = trajectory.back().time_ms - trajectory.front().time_ms;
+
+  if (trajectory.size() == 1 || duration <= 0) {
+    return trajectory.front();
+  }
+
+  const double t = trajectory.front().time_ms + fmod(time_ms,duration);
+
+  unsigned int i = 1;
+  while (i < trajectory.size() - 1 && trajectory[i].time_ms < t) {
+    i++;
+  }
+
+  const nav350_waypoint_t &a = trajectory[i-1], &b = trajectory[i];
+  const double s = (b.time_ms > a.time_ms) ? (t - a.time_ms)/(b.time_ms - a.time_ms) : 0;
+
+  /* Interpolate the heading the short way round */
+  double phi_delta = fmod(b.phi - a.phi,360000);
+  if (phi_delta > 180000) {
+    phi_delta -= 360000;
+  }
+  else if (phi_delta < -180000) {
+    phi_delta += 360000;
+  }
+
+  nav350_waypoint_t pose;
+  pose.time_ms = time_ms;
+  pose.x = a.x + s*(b.x - a.x);
+  pose.y = a.y + s*(b.y - a.y);
+  pose.phi = fmod(a.phi + s*phi_delta + 360000,360000);
+  return pose;
+}
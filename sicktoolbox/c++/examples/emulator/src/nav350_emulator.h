@@ -0,0 +1,154 @@
+/*!
+ * \file nav350_emulator.h
+ * \brief Emulates a Sick NAV350 over CoLa-A, synthesizing poses,
+ *        reflectors and scans from a scripted trajectory and map.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef NAV350_EMULATOR_H
+#define NAV350_EMULATOR_H
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include "emulator_server.h"
+#include "emulator_scene.h"
+#include "../../nav350/nav350_server/src/server.h"
+
+/* Macros */
+#define NAV350_EMULATOR_NUM_VALUES                  (1440)  ///< Values per synthesized scan (0.25 deg over 360 deg)
+#define NAV350_EMULATOR_REPLY_SIZE                 (65536)  ///< Largest encoded reply
+#define NAV350_EMULATOR_MAX_RANGE                  (30000)  ///< Longest synthesized range (mm)
+
+/**
+ * \struct nav350_waypoint_tag
+ * \brief A trajectory waypoint
+ */
+/**
+ * \typedef nav350_waypoint_t
+ * \brief Adopt c-style convention
+ */
+typedef struct nav350_waypoint_tag {
+  double time_ms;                                           ///< Time since the start of the trajectory (ms)
+  double x;                                                 ///< Position x (mm)
+  double y;                                                 ///< Position y (mm)
+  double phi;                                               ///< Heading (mdeg)
+} nav350_waypoint_t;
+
+/**
+ * \struct nav350_landmark_tag
+ * \brief A reflector in the landmark map
+ */
+/**
+ * \typedef nav350_landmark_t
+ * \brief Adopt c-style convention
+ */
+typedef struct nav350_landmark_tag {
+  unsigned int global_id;                                   ///< Global landmark id
+  double x;                                                 ///< Position x (mm)
+  double y;                                                 ///< Position y (mm)
+} nav350_landmark_t;
+
+/**
+ * \struct nav350_world_tag
+ * \brief Everything the emulator synthesizes its data from
+ */
+/**
+ * \typedef nav350_world_t
+ * \brief Adopt c-style convention
+ */
+typedef struct nav350_world_tag {
+  double room_width;                                        ///< The room spans [0,room_width] in x (mm)
+  double room_height;                                       ///< The room spans [0,room_height] in y (mm)
+  double reflector_radius;                                  ///< Radius of the cylindrical reflectors (mm)
+  double range_noise;                                       ///< Peak range noise (mm)
+  double scan_rate;                                         ///< Scans per second
+  bool deterministic;                                       ///< Advance one scan per data request instead of following the wall clock
+  unsigned int seed;                                        ///< Seed for the range noise
+  std::vector< nav350_waypoint_t > trajectory;              ///< Looped trajectory (at least one waypoint)
+  std::vector< nav350_landmark_t > landmarks;               ///< The landmark map
+} nav350_world_t;
+
+/** Returns a 20 x 15 m room with a ring of reflectors and a circular trajectory */
+nav350_world_t Nav350DefaultWorld( );
+
+/** Replaces the world's trajectory with "time_ms x y phi" lines from a file */
+bool Nav350LoadTrajectory( const std::string &path, nav350_world_t &world );
+
+/** Replaces the world's landmarks with "global_id x y" lines from a file */
+bool Nav350LoadLandmarks( const std::string &path, nav350_world_t &world );
+
+/**
+ * \class Nav350Emulator
+ * \brief A NAV350 that answers the requests issued by SickNav350
+ *
+ * Replies are encoded by the nav350_server encoders.  The device clock
+ * advances with the configured scan rate (or one scan per data request
+ * in deterministic mode) and each new scan is synthesized once, on the
+ * first request that needs it.
+ */
+class Nav350Emulator : public EmulatorDevice {
+
+public:
+
+  /** A standard constructor */
+  Nav350Emulator( const nav350_world_t &world );
+
+  /** Returns a short name for log output */
+  std::string GetName( ) const { return "NAV350"; }
+
+  /** Frames an STX...ETX telegram */
+  unsigned int FrameRequest( const uint8_t * const buffer, const unsigned int length, unsigned int &request_start ) const;
+
+  /** Answers one CoLa-A request */
+  void HandleRequest( EmulatorConnection &connection, const uint8_t * const request, const unsigned int length );
+
+  /** Returns the number of scans synthesized so far */
+  unsigned int GetNumScans( ) const { return _num_scans; }
+
+private:
+
+  /** The world */
+  nav350_world_t _world;
+
+  /** Holds the current pose, reflectors and scan in the encoders' layout */
+  Measurements _measurements;
+
+  /** Reply buffer */
+  std::vector< char > _reply;
+
+  /** Wall time of the first scan (usec) */
+  uint64_t _start_usec;
+
+  /** Index of the scan held in _measurements (-1 before the first) */
+  long _scan_index;
+
+  /** Scans synthesized so far */
+  unsigned int _num_scans;
+
+  /** Current operating mode */
+  char _operating_mode;
+
+  /** Brings _measurements up to date for a data request */
+  void _updateScan( );
+
+  /** Synthesizes the scan with the given index into _measurements */
+  void _synthesizeScan( const long scan_index );
+
+  /** Interpolates the trajectory */
+  nav350_waypoint_t _poseAt( const double time_ms ) const;
+
+  /** Emulators are not copyable */
+  Nav350Emulator( const Nav350Emulator & );
+  Nav350Emulator & operator=( const Nav350Emulator & );
+
+};
+
+#endif /* NAV350_EMULATOR_H */
@@ -31,34 +31,26 @@ using namespace SickToolbox;
 	sem_t sem=(sem_t) arg;
 
 }*/
+// fills the back snapshot straight from the driver and hands it to the server
 void GetMeasurements(ServerPacket *sp,SickNav350 *sn)
 {
-    double range_values[SickNav350::SICK_MAX_NUM_MEASUREMENTS] = {0};
+	Measurements *m=sp->snapshots.Back();
     unsigned int num_measurements = {0};
     unsigned int sector_start_timestamp = {0};
 	unsigned int sector_stop_timestamp = {0};
-    double sector_step_angle = {0};
-    double sector_start_angle = {0};
-    double sector_stop_angle = {0};
-	int i;
-	sn->GetSickMeasurements(range_values,
+	sn->GetSickMeasurements(m->distance,
                                         &num_measurements,
-                                        &sector_step_angle,
-                                        &sector_start_angle,
-                                        &sector_stop_angle,
+                                        &m->step_angle,
+                                        &m->start_angle,
+                                        &m->stop_angle,
                                         &sector_start_timestamp,
                                         &sector_stop_timestamp);
-	sp->m_.meas_num=num_measurements;
-	sp->m_.step_angle=sector_step_angle;
-	sp->m_.start_angle=sector_start_angle;
-	sp->m_.stop_angle=sector_stop_angle;
-	sp->m_.timestamp=sector_start_timestamp;
-	for (i=0;i<num_measurements;i++)
-	{
-		sp->m_.distance[i]=range_values[i];
-	}	
-	sp->m_.ReflectorData_=sn->ReflectorData_;
-	sp->m_.PoseData_=sn->PoseData_;
+	m->meas_num=num_measurements;
+	m->timestamp=sector_start_timestamp;
+	m->ReflectorData_=sn->ReflectorData_;
+	m->PoseData_=sn->PoseData_;
+	sp->snapshots.Publish();
+	sp->Wake();
 }
 void OpenPort(ServerPacket *sp/*,ServerPacket *sp1*/)
 {	
@@ -101,60 +93,87 @@ void OpenPort(ServerPacket *sp/*,ServerPacket *sp1*/)
 	}
 	sp->sockfd=sockfd;
 //	sp1->sockfd=sockfd;
+
+	/*---Wakes the server when a forwarded request is answered---*/
+	if ( (sp->wakefd = eventfd(0, EFD_NONBLOCK)) < 0 )
+	{
+		perror("eventfd");
+		exit(errno);
+	}
+}
+// pass-through mode: the relay's own connection to the sensor, shared by every client
+int ConnectSensor(const char *address,int port)
+{
+	struct sockaddr_in sensor;
+
+	int sensorfd;
+	if ( (sensorfd = socket(AF_INET, SOCK_STREAM, 0)) < 0 )
+	{
+		perror("Socket");
+		exit(errno);
+	}
+
+	bzero(&sensor, sizeof(sensor));
+	sensor.sin_family = AF_INET;
+	sensor.sin_port = htons(port);
+	if ( inet_aton(address, &sensor.sin_addr) == 0 )
+	{
+		printf("invalid sensor address %s\n",address);
+		exit(1);
+	}
+
+	/*---Requests are small and pipelined; do not hold them back---*/
+	int optval = 1;
+	setsockopt(sensorfd, IPPROTO_TCP, TCP_NODELAY, &optval, sizeof optval);
+
+	if ( connect(sensorfd, (struct sockaddr*)&sensor, sizeof(sensor)) != 0 )
+	{
+		perror("socket--connect");
+		exit(errno);
+	}
+	return sensorfd;
 }
+// runs the requests the server forwarded, oldest first, and hands the answers back
 void ProcessCustomRequest(ServerPacket *sp,SickNav350 *sick_nav350)
 {
 	static uint8_t res[6000];
 	int resp_size;
-	static uint8_t req[1000];
-	int req_size;
-
-	int i;
-		sem_wait(&(sp->sem2_));
-		if (sp->request==1)
- 		{
-			for (i=0;i<sp->req_size;i++)
-			{
-				req[i]=sp->req[i];
-			}
-			req_size=sp->req_size;
-			sem_post(&(sp->sem2_));	
-//printf("ja\n");		
-			sick_nav350->GetResponseFromCustomMessage(req,req_size,res,&resp_size);
-			sem_wait(&(sp->sem3_));
-			for (i=0;i<resp_size;i++)
-			{
-//				printf("%c",res[i]);
-				sp->resp[i]=res[i];
-			}
-//			printf("\n");
-			sp->resp_size=resp_size;
-			sp->request=0;
-			sem_post(&(sp->sem3_));
-		}
-		else
-		{
-			sem_post(&(sp->sem2_));
-		}
-
+	ServerCommand *command;
+	bool answered=false;
+	while ((command=sp->commands.Pop())!=NULL)
+	{
+		sick_nav350->GetResponseFromCustomMessage((uint8_t *) &command->request[0],command->request.size(),res,&resp_size);
+		command->response.assign((const char *) res,resp_size);
+		sp->replies.Push(command);
+		answered=true;
+	}
+	if (answered)
+	{
+		sp->Wake();
+	}
 }
 int main (int argc, char *argv[]) {
 
 
-	sem_t sem;
  	
 	ServerPacket sp;  
 //	ServerPacket sp1;
-	std::vector<ServerPacket *> sp_vector;
 
 	OpenPort(&sp/*,&sp1*/);
-	
-	sp_vector.push_back(&sp);
 
-	sp.m_.ReflectorData_.num_reflector=0;
-	sem_t len;
+	/*---Pass-through: no driver, the clients' telegrams are multiplexed onto the sensor---*/
+	bool passthrough = argc > 1 && strcmp(argv[1],"--passthrough") == 0;
+	if (passthrough)
+	{
+		argc--;
+		argv++;
+	}
+
 	pthread_t thread;
-	pthread_create(&thread,NULL,Server,(void *)(&sp));
+	if (!passthrough)
+	{
+		pthread_create(&thread,NULL,Server,(void *)(&sp));
+	}
 /*	pthread_t thread1;
 	pthread_create(&thread1,NULL,Server,(void *)(&sp1));
 */
@@ -178,8 +197,8 @@ int main (int argc, char *argv[]) {
 
   /* Check the num of args */
   if(argc > 2 || (argc == 2 && strcasecmp(argv[1],"--help") == 0)) {
-    cerr << "Usage: nav350_single_sector [SICK IP ADDRESS]" << endl
-	      << "Ex. nav350_single_sector 192.168.1.11" << endl;
+    cerr << "Usage: nav350_server [--passthrough] [SICK IP ADDRESS]" << endl
+	      << "Ex. nav350_server 192.168.1.11" << endl;
     return -1;
   }
   
@@ -188,6 +207,13 @@ int main (int argc, char *argv[]) {
     sick_ip_addr = argv[1];
   }
 
+  if (passthrough) {
+    sp.sensor = new SensorLink(ConnectSensor(sick_ip_addr.c_str(),DEFAULT_SICK_TCP_PORT));
+    printf("passing clients through to %s:%d\n",sick_ip_addr.c_str(),DEFAULT_SICK_TCP_PORT);
+    Server(&sp);
+    return 0;
+  }
+
   /* Define the data buffers */
   double values[SickNav350::SICK_MAX_NUM_MEASUREMENTS] = {0};
   unsigned int num_values = 0;
@@ -224,17 +250,11 @@ sick_nav350.PoseData_.phi=3;
     cerr << "An error occurred!" << endl;
   }  
 int i;
-		sem_post(&(sp.sem1_));
-		sem_post(&(sp.sem2_));
-		 sem_post(&(sp.sem3_));
-		sem_post(&(sp.sem4_));
 
 /*		sem_post(&(sp1.sem1_));
 		sem_post(&(sp1.sem2_));
 		sem_post(&(sp1.sem3_));
 */
-	ServerPacket* spp;
-	pthread_t* threadp;
 	FILE *f;
 int count=0;
 struct timeval  tv;
@@ -246,33 +266,9 @@ struct timeval  tv;
 /*		sem_wait(&(sp.sem1_));
 		GetMeasurements(&sp,&sick_nav350);
 		sem_post(&(sp.sem1_));*/
-//printf("size = %d\n",sp_vector.size());
-		for (i=0;i<sp_vector.size();i++)
-		{
-			sem_wait(&(sp_vector[i]->sem1_));
-			GetMeasurements(sp_vector[i],&sick_nav350);
-			sem_post(&(sp_vector[i]->sem1_));
-		 ProcessCustomRequest(sp_vector[i],&sick_nav350);
-	
-			if (i==sp_vector.size()-1)
-			{
-				sem_wait(&(sp_vector[i]->sem4_));
-				if (sp_vector[i]->accepted==1)
-				{
-					spp=new ServerPacket();
-					sem_post(&(spp->sem1_));
-					sem_post(&(spp->sem2_));
-					sem_post(&(spp->sem3_));
-					sem_post(&(spp->sem4_));
-					spp->sockfd=sp_vector[i]->sockfd;
-					sp_vector.push_back(spp);
-					threadp=new pthread_t();
-					pthread_create(threadp,NULL,Server,(void *)(spp));
-				}
-				sem_post(&(sp_vector[i]->sem4_));
-				break;
-			}		
-		}
+		// every client is served by the one Server thread from these snapshots
+		GetMeasurements(&sp,&sick_nav350);
+		ProcessCustomRequest(&sp,&sick_nav350);
 /*		sem_wait(&(sp1.sem1_));
 		GetMeasurements(&sp1,&sick_nav350);
 		sem_post(&(sp1.sem1_));*/
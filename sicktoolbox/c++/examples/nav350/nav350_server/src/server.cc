@@ -1,43 +1,10 @@
 #include "server.h"
 int ConvertNumberToString(int num,char *str)
 {
-	if (num==0)
-	{
-		str[0]='0';
-//		str[1]='0';
-		return 1;
-	}
-	if (num<0)	
-	{
-		str[0]='-';
-		num=-num;
-	}
-	else
-	{
-		str[0]='+';
-	}
-	int broj_zn=0,num1=num;
-	while (num1>0)
-	{
-		num1=num1/16;
-		broj_zn++;
-	}
-	int i;
-	for (i=broj_zn-1;i>=0;i--)
-	{
-		if (num%16<10)
-		{
-			str[i]=48+num%16;
-		}
-		else
-		{
-			str[i]=65+num%16-10;
-		}
-		num=num/16;
-	}
-	return broj_zn;
+	/* CoLa-A sends signed values as the hex of their 32-bit two's complement */
+	return sick_cola_write_hex(str,(uint32_t) num);
 }
-int GetPoseData(ServerPacket *sp,char *res,char mask)
+int GetPoseData(const Measurements *m,char *res,char mask)
 {
 	int count=0,i;
 	res[count++]=2;
@@ -87,71 +54,29 @@ int GetPoseData(ServerPacket *sp,char *res,char mask)
 	res[count++]=' ';
 	res[count++]='1'; //pose data follow
 	res[count++]=' ';
-	char str[100];
-	int size;
-	size=ConvertNumberToString(sp->m_.PoseData_.x,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.x);
 	res[count++]=' ';
 
 
-	size=ConvertNumberToString(sp->m_.PoseData_.y,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.y);
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.PoseData_.phi,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.phi);
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.PoseData_.optionalPoseData,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
-	if (sp->m_.PoseData_.optionalPoseData==1)
+	count+=sick_cola_write_hex(res+count,m->PoseData_.optionalPoseData);
+	if (m->PoseData_.optionalPoseData==1)
 	{
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.outputMode,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.outputMode);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.timeStamp,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.timeStamp);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.meanDeviation,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.meanDeviation);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.positionMode,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.positionMode);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.infoState,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.infoState);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.numUsedReflectors,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.numUsedReflectors);
 
 	}
 //	printf("gotov pose data (slijedi reflector data)\n");
@@ -163,137 +88,51 @@ int GetPoseData(ServerPacket *sp,char *res,char mask)
 		res[count++]='1'; //landmark data follow
 
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.filter,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.filter);
 
 		 res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.num_reflector,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
-//		printf("ref count= %d\n",sp->m_.ReflectorData_.num_reflector);
-		for (j=0;j<sp->m_.ReflectorData_.num_reflector;j++)
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.num_reflector);
+//		printf("ref count= %d\n",m->ReflectorData_.num_reflector);
+		for (j=0;j<m->ReflectorData_.num_reflector;j++)
 		{
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.cart[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.cart[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.x[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.x[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.y[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.y[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.polar[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.polar[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.dist[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.dist[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.phi[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.phi[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.optional[j],str);
-			for (i=0;i<size;i++)
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.optional[j]);
+			if (m->ReflectorData_.optional[j]==1)
 			{
-				res[count++]=str[i];		
-			}
-			if (sp->m_.ReflectorData_.optional[j]==1)
-			{
-				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.LocalID[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.GlobalID[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.LocalID[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.type[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.GlobalID[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.subtype[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.type[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.quality[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.subtype[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.timestamp[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.quality[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.size[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.timestamp[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.hitCount[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.size[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.hitCount[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.meanEchoAmplitude[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.indexStart[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexStart[j]);
 				res[count++]=' ';
-				size=ConvertNumberToString(sp->m_.ReflectorData_.indexEnd[j],str);
-				for (i=0;i<size;i++)
-				{
-					res[count++]=str[i];		
-				}
+				count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexEnd[j]);
 	
 			}
 	
@@ -327,44 +166,19 @@ int GetPoseData(ServerPacket *sp,char *res,char mask)
 		res[count++]='0'; //offset
 	
 		res[count++]=' ';
-		size=ConvertNumberToString((int) (sp->m_.start_angle*1000),str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,(int) (m->start_angle*1000));
 //		 printf("gotov start %d\n",count);
 		res[count++]=' ';
-//		printf("%d\n",(int)(sp->m_.step_angle*1000));
-		size=ConvertNumberToString((int)(sp->m_.step_angle*1000),str);
-//		printf("%d\n",size);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+//		printf("%d\n",(int)(m->step_angle*1000));
+		count+=sick_cola_write_hex(res+count,(int)(m->step_angle*1000));
 //		printf("gotov step\n");
 		res[count++]=' ';
-		size=ConvertNumberToString((int) (sp->m_.timestamp),str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,(int) (m->timestamp));
 //		printf("gotov timestamp\n");
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.meas_num,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
-//		printf("dist count=%d\n",sp->m_.meas_num);
-		for (j=0;j<sp->m_.meas_num;j++)
-		{
-			res[count++]=' ';
-			size=ConvertNumberToString((int) sp->m_.distance[j],str);
-			for (i=0;i<size;i++)
-			{
-			 	res[count++]=str[i];		
-			}
-		}
+		count+=sick_cola_write_hex(res+count,m->meas_num);
+//		printf("dist count=%d\n",m->meas_num);
+		count+=sick_cola_write_hex_fields(res+count,m->distance,m->meas_num);
 	
 		res[count++]=' ';
 		res[count++]='0'; //remission
@@ -381,10 +195,8 @@ int GetPoseData(ServerPacket *sp,char *res,char mask)
 	return count;
 
 }
-int DoMapping(ServerPacket *sp,char *res)
+int DoMapping(const Measurements *m,char *res)
 {
-	char str[100];
-	int size;
 
 	int count=0,i;
 	res[count++]=2;
@@ -434,122 +246,48 @@ int DoMapping(ServerPacket *sp,char *res)
 	res[count++]='1'; //landmark data follow
 
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.ReflectorData_.filter,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->ReflectorData_.filter);
 
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.ReflectorData_.num_reflector,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->ReflectorData_.num_reflector);
 	int j;
-//	printf("ref count= %d\n",sp->m_.ReflectorData_.num_reflector);
-	for (j=0;j<sp->m_.ReflectorData_.num_reflector;j++)
+//	printf("ref count= %d\n",m->ReflectorData_.num_reflector);
+	for (j=0;j<m->ReflectorData_.num_reflector;j++)
 	{
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.cart[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.cart[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.x[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.x[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.y[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.y[j]);
 		res[count++]=' ';
 		res[count++]='0'; //no polar data follow
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.optional[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
-		if (sp->m_.ReflectorData_.optional[j]==1)
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.optional[j]);
+		if (m->ReflectorData_.optional[j]==1)
 		{
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.LocalID[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.LocalID[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.GlobalID[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.GlobalID[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.type[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.type[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.subtype[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.subtype[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.quality[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.quality[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.timestamp[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
-			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.size[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.timestamp[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.hitCount[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.size[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.hitCount[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.meanEchoAmplitude[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.indexStart[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexStart[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.indexEnd[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexEnd[j]);
 
 		}
 
@@ -573,44 +311,19 @@ int DoMapping(ServerPacket *sp,char *res)
 	res[count++]='0'; //offset
 
 	res[count++]=' ';
-	size=ConvertNumberToString((int) (sp->m_.start_angle*1000),str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,(int) (m->start_angle*1000));
 //	 printf("gotov start %d\n",count);
 	res[count++]=' ';
-//	printf("%d\n",(int)(sp->m_.step_angle*1000));
-	size=ConvertNumberToString((int)(sp->m_.step_angle*1000),str);
-//	printf("%d\n",size);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+//	printf("%d\n",(int)(m->step_angle*1000));
+	count+=sick_cola_write_hex(res+count,(int)(m->step_angle*1000));
 //	printf("gotov step\n");
 	res[count++]=' ';
-	size=ConvertNumberToString((int) (sp->m_.timestamp),str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,(int) (m->timestamp));
 //	printf("gotov timestamp\n");
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.meas_num,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
-//	printf("dist count=%d\n",sp->m_.meas_num);
-	for (j=0;j<sp->m_.meas_num;j++)
-	{
-		res[count++]=' ';
-		size=ConvertNumberToString((int) sp->m_.distance[j],str);
-		for (i=0;i<size;i++)
-		{
-		 	res[count++]=str[i];		
-		}
-	}
+	count+=sick_cola_write_hex(res+count,m->meas_num);
+//	printf("dist count=%d\n",m->meas_num);
+	count+=sick_cola_write_hex_fields(res+count,m->distance,m->meas_num);
 
 	res[count++]=' ';
 	res[count++]='0'; //remission
@@ -627,7 +340,7 @@ int DoMapping(ServerPacket *sp,char *res)
 
 }
 
-int GetPose(ServerPacket *sp,char *res)
+int GetPose(const Measurements *m,char *res)
 {
 	int count=0,i;
 	res[count++]=2;
@@ -675,71 +388,29 @@ int GetPose(ServerPacket *sp,char *res)
 	res[count++]=' ';
 	res[count++]='1'; //pose data follow
 	res[count++]=' ';
-	char str[100];
-	int size;
-	size=ConvertNumberToString(sp->m_.PoseData_.x,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.x);
 	res[count++]=' ';
 
 
-	size=ConvertNumberToString(sp->m_.PoseData_.y,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.y);
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.PoseData_.phi,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->PoseData_.phi);
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.PoseData_.optionalPoseData,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
-	if (sp->m_.PoseData_.optionalPoseData==1)
+	count+=sick_cola_write_hex(res+count,m->PoseData_.optionalPoseData);
+	if (m->PoseData_.optionalPoseData==1)
 	{
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.outputMode,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.outputMode);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.timeStamp,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.timeStamp);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.meanDeviation,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.meanDeviation);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.positionMode,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.positionMode);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.infoState,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.infoState);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.PoseData_.numUsedReflectors,str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->PoseData_.numUsedReflectors);
 
 	}
 	res[count++]=3;
@@ -749,7 +420,7 @@ int GetPose(ServerPacket *sp,char *res)
 
 }
 
-int GetLandmarkData(ServerPacket *sp,char *res)
+int GetLandmarkData(const Measurements *m,char *res)
 {
 	int count=0,i;
 	res[count++]=2;
@@ -800,140 +471,52 @@ int GetLandmarkData(ServerPacket *sp,char *res)
 	res[count++]='1'; //landmark data follow
 
 	res[count++]=' ';
-	char str[100];
-	int size;
-	size=ConvertNumberToString(sp->m_.ReflectorData_.filter,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->ReflectorData_.filter);
 
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.ReflectorData_.num_reflector,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,m->ReflectorData_.num_reflector);
 	int j;
-//	printf("ref count= %d\n",sp->m_.ReflectorData_.num_reflector);
-	for (j=0;j<sp->m_.ReflectorData_.num_reflector;j++)
+//	printf("ref count= %d\n",m->ReflectorData_.num_reflector);
+	for (j=0;j<m->ReflectorData_.num_reflector;j++)
 	{
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.cart[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.cart[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.x[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.x[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.y[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.y[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.polar[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.polar[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.dist[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.dist[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.phi[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.phi[j]);
 		res[count++]=' ';
-		size=ConvertNumberToString(sp->m_.ReflectorData_.optional[j],str);
-		for (i=0;i<size;i++)
-		{
-			res[count++]=str[i];		
-		}
-		if (sp->m_.ReflectorData_.optional[j]==1)
+		count+=sick_cola_write_hex(res+count,m->ReflectorData_.optional[j]);
+		if (m->ReflectorData_.optional[j]==1)
 		{
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.LocalID[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.LocalID[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.GlobalID[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.GlobalID[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.type[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.type[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.subtype[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.subtype[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.quality[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.quality[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.timestamp[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.timestamp[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.size[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.size[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.hitCount[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.hitCount[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.meanEchoAmplitude[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.meanEchoAmplitude[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
-			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.indexStart[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexStart[j]);
 			res[count++]=' ';
-			size=ConvertNumberToString(sp->m_.ReflectorData_.indexEnd[j],str);
-			for (i=0;i<size;i++)
-			{
-				res[count++]=str[i];		
-			}
+			count+=sick_cola_write_hex(res+count,m->ReflectorData_.indexEnd[j]);
 
 		}
 
@@ -957,44 +540,19 @@ int GetLandmarkData(ServerPacket *sp,char *res)
 	res[count++]='0'; //offset
 
 	res[count++]=' ';
-	size=ConvertNumberToString((int) (sp->m_.start_angle*1000),str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,(int) (m->start_angle*1000));
 //	 printf("gotov start %d\n",count);
 	res[count++]=' ';
-//	printf("%d\n",(int)(sp->m_.step_angle*1000));
-	size=ConvertNumberToString((int)(sp->m_.step_angle*1000),str);
-//	printf("%d\n",size);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+//	printf("%d\n",(int)(m->step_angle*1000));
+	count+=sick_cola_write_hex(res+count,(int)(m->step_angle*1000));
 //	printf("gotov step\n");
 	res[count++]=' ';
-	size=ConvertNumberToString((int) (sp->m_.timestamp),str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
+	count+=sick_cola_write_hex(res+count,(int) (m->timestamp));
 //	printf("gotov timestamp\n");
 	res[count++]=' ';
-	size=ConvertNumberToString(sp->m_.meas_num,str);
-	for (i=0;i<size;i++)
-	{
-		res[count++]=str[i];		
-	}
-//	printf("dist count=%d\n",sp->m_.meas_num);
-	for (j=0;j<sp->m_.meas_num;j++)
-	{
-		res[count++]=' ';
-		size=ConvertNumberToString((int) sp->m_.distance[j],str);
-		for (i=0;i<size;i++)
-		{
-		 	res[count++]=str[i];		
-		}
-	}
+	count+=sick_cola_write_hex(res+count,m->meas_num);
+//	printf("dist count=%d\n",m->meas_num);
+	count+=sick_cola_write_hex_fields(res+count,m->distance,m->meas_num);
 
 	res[count++]=' ';
 	res[count++]='0'; //remission
@@ -1066,230 +624,622 @@ int ChangeState(char *res,char c)
 	return count;
 	
 }
-int CheckRequest(char* buffer,int count,ServerPacket *sp,char *res,int &last)
+// answers one STX..ETX request; data replies are encoded once per measurement snapshot,
+// straight from the snapshot, and shared from the cache. Returns a reference to the reply,
+// or NULL if the request has to go to the device (forward) or there are no measurements yet
+ServerBuffer *AnswerRequest(const char *mes,int mescount,ServerPacket *sp,ResponseCache *cache,bool &forward)
 {
-	int i,t=0;
-	int poc=0;
-	int kr=-1;
-	char *mes;
-	int mescount=0;
-	int sval;
-	int resp_size=0;
-	for (i=0;i<count;i++)
+	static char res[20000];
+	int key;
+	forward=false;
+	if  (strncmp(&mes[1],"sMN mNLMDGetData",16)==0)
+	{
+		key=CACHE_LANDMARK;
+	} 
+	else if (strncmp(&mes[1],"sMN mNPOSGetData",16)==0)
+	{
+		key=(unsigned char) mes[mescount-2];
+	} 
+	else if (strncmp(&mes[1],"SMN MNPOSGetPose",16)==0)
+	{
+		key=CACHE_POSE;
+	} 
+	else if (strncmp(&mes[1],"SMN MNMAPDoMapping",17)==0)
 	{
-		if (buffer[i]==2 && t==0) 
+		return new ServerBuffer(res,0);
+	}
+	else if (strncmp(&mes[1],"sMN mNEVAChangeState",17)==0)
+	{
+		printf("change state %c\n",mes[mescount-2]);
+		return new ServerBuffer(res,ChangeState(res,mes[mescount-2]));
+	}
+	else
+	{
+		forward=true;
+		return NULL;
+	}
+
+	bool fresh;
+	const Measurements *m=sp->snapshots.Front(fresh);
+	if (fresh)
+	{
+		cache->Clear();
+	}
+	if (m==NULL)
+	{
+		return NULL;
+	}
+	if (cache->replies[key]==NULL)
+	{
+		int resp_size;
+		if (key==CACHE_LANDMARK)
+		{
+			printf("get landmark data\n");
+			resp_size=GetLandmarkData(m,res);
+		}
+		else if (key==CACHE_POSE)
+		{
+			printf("get pose\n");
+			resp_size=GetPose(m,res);
+		}
+		else
+		{
+			printf("get pose data\n");
+			resp_size=GetPoseData(m,res,(char) key);
+		}
+		cache->replies[key]=new ServerBuffer(res,resp_size);
+	}
+	return RetainBuffer(cache->replies[key]);
+}
+static void SetNonBlocking(int fd)
+{
+	fcntl(fd,F_SETFL,fcntl(fd,F_GETFL,0)|O_NONBLOCK);
+}
+static void WatchClient(int epfd,ServerClient *client,int op)
+{
+	struct epoll_event ev;
+	ev.events=EPOLLIN|(client->out_size==0 ? 0 : (uint32_t)EPOLLOUT);
+	ev.data.ptr=client;
+	epoll_ctl(epfd,op,client->fd,&ev);
+}
+// moves the complete STX..ETX telegrams of a buffer onto a queue and keeps the rest
+static void ExtractTelegrams(char *in,int &in_size,int max_size,std::deque<std::string> &telegrams)
+{
+	int start=0,i;
+	for (i=0;i<in_size;i++)
+	{
+		if (in[i]==2)
+		{
+			start=i;
+		}
+		else if (in[i]==3 && in[start]==2)
+		{
+			telegrams.push_back(std::string(in+start,i-start+1));
+			start=i+1;
+		}
+	}
+	// keep only a telegram that is still arriving
+	if (start>=in_size || in[start]!=2)
+	{
+		in_size=0;
+	}
+	else if (start>0)
+	{
+		memmove(in,in+start,in_size-start);
+		in_size-=start;
+	}
+	else if (in_size==max_size)
+	{
+		in_size=0;	// no ETX in a whole buffer; drop it
+	}
+}
+// returns the index-th space separated token of a telegram (0 is the command type)
+static std::string TelegramToken(const std::string &mes,int index)
+{
+	size_t start=1,end;
+	while (true)
+	{
+		end=mes.find(' ',start);
+		if (end==std::string::npos)
 		{
-			poc=i;
-			t=1;
+			end=mes.size()-1;	// the ETX
+			break;
 		}
-		if (buffer[i]==3 && t==1)
+		if (index--==0)
 		{
-			kr=i;
-			t=2;			
 			break;
 		}
+		start=end+1;
 	}
-//	printf("t=%d\n",t);
-
-	if (t==2)
+	return index>0 || start>end ? std::string() : mes.substr(start,end-start);
+}
+// pass-through: moves a client's requests into the sensor's command stream, one at a time
+// so its replies stay in order; returns whether anything was queued for sending
+static bool ProxyRequests(SensorLink *link,ServerClient *client)
+{
+	bool queued=false;
+	while (!client->waiting && !client->requests.empty())
 	{
-		last=kr+1;
-		mes=buffer+poc;
-		mescount=kr-poc+1;
-//		if (mescount>17)
-//		{
-			if  (strncmp(&mes[1],"sMN mNLMDGetData",16)==0)
+		const std::string &mes=client->requests.front();
+		const std::string type=TelegramToken(mes,0);
+		const std::string name=TelegramToken(mes,1);
+		if (type=="sEN")
+		{
+			// the sensor keeps one subscription however many clients want the event
+			std::vector<unsigned int> &subscribers=link->events[name];
+			std::vector<unsigned int>::iterator it=std::find(subscribers.begin(),subscribers.end(),client->id);
+			const bool subscribe=TelegramToken(mes,2)=="1";
+			const bool others=subscribers.size()>(it==subscribers.end() ? 0u : 1u);
+			if (subscribe && it==subscribers.end())
 			{
-				printf("get landmark data\n");
-				sem_wait(&(sp->sem1_));		
-				resp_size=GetLandmarkData(sp,res);				
-		 		sem_post(&(sp->sem1_));		
-				return resp_size;
-			} 
-			else if (strncmp(&mes[1],"sMN mNPOSGetData",16)==0)
+				subscribers.push_back(client->id);
+			}
+			else if (!subscribe && it!=subscribers.end())
 			{
-				printf("get pose data\n");
-				sem_wait(&(sp->sem1_));		
-				resp_size=GetPoseData(sp,res,mes[mescount-2]);				
-				sem_post(&(sp->sem1_));		
-
-				return resp_size;
-
-			} 
-			else if (strncmp(&mes[1],"SMN MNPOSGetPose",16)==0)
+				subscribers.erase(it);
+			}
+			if (others)
 			{
-				printf("get pose\n");
-				sem_wait(&(sp->sem1_));		
-				resp_size=GetPose(sp,res);				
-		 		sem_post(&(sp->sem1_));		
-				return resp_size;
-			} 
-			else if (strncmp(&mes[1],"SMN MNMAPDoMapping",17)==0)
+				const std::string reply="\x02sEA "+name+(subscribe ? " 1\x03" : " 0\x03");
+				client->Queue(new ServerBuffer(reply.data(),reply.size()));
+				client->requests.pop_front();
+				queued=true;
+				continue;
+			}
+		}
+		// reads that are already in flight are shared instead of sent again
+		const bool shared=type=="sRN" || (type=="sMN" && (name=="mNPOSGetData" || name=="mNPOSGetPose" || name=="mNLMDGetData"));
+		SensorCommand *command=NULL;
+		for (size_t k=0;shared && k<link->pending.size() && command==NULL;k++)
+		{
+			if (link->pending[k]->shared && link->pending[k]->request==mes)
 			{
+				command=link->pending[k];
 			}
-			else if (strncmp(&mes[1],"sMN mNEVAChangeState",17)==0)
+		}
+		if (command==NULL)
+		{
+			command=new SensorCommand(name,mes,shared);
+			link->pending.push_back(command);
+			link->out+=mes;
+		}
+		else if (!command->ack.empty())
+		{
+			client->Queue(new ServerBuffer(command->ack.data(),command->ack.size()));
+			queued=true;
+		}
+		command->clients.push_back(client->id);
+		client->waiting=true;
+	}
+	return queued;
+}
+// pass-through: hands one sensor telegram to the clients it belongs to
+static void RouteTelegram(SensorLink *link,std::vector<ServerClient *> &clients,const std::string &mes)
+{
+	const std::string type=TelegramToken(mes,0);
+	const std::string name=TelegramToken(mes,1);
+	SensorCommand *command=NULL;
+	size_t k = 0;
+	std::vector<unsigned int> receivers;
+	if (type=="sSN")
+	{
+		std::map<std::string,std::vector<unsigned int> >::iterator it=link->events.find(name);
+		if (it!=link->events.end())
+		{
+			receivers=it->second;
+		}
+	}
+	else
+	{
+		// the sensor answers in order: the oldest command of that name (errors carry none)
+		for (k=0;k<link->pending.size();k++)
+		{
+			if (type=="sFA" || link->pending[k]->name==name)
 			{
-printf("change state %c\n",mes[mescount-2]);
-				resp_size=ChangeState(res,mes[mescount-2]);
-				return resp_size;
+				command=link->pending[k];
+				break;
 			}
-			else
+		}
+		if (command==NULL)
+		{
+			printf("unrouted sensor telegram %s %s\n",type.c_str(),name.c_str());
+			return;
+		}
+		receivers=command->clients;
+	}
+	// a method's sMA is followed by its sAN; everything else ends the command
+	const bool done=command!=NULL && type!="sMA";
+	ServerBuffer *buffer=new ServerBuffer(mes.data(),mes.size());
+	for (size_t j=0;j<clients.size();j++)
+	{
+		if (std::find(receivers.begin(),receivers.end(),clients[j]->id)==receivers.end())
+		{
+			continue;
+		}
+		clients[j]->Queue(RetainBuffer(buffer));
+		if (done)
+		{
+			clients[j]->requests.pop_front();
+			clients[j]->waiting=false;
+		}
+	}
+	ReleaseBuffer(buffer);
+	if (command!=NULL && !done)
+	{
+		command->ack=mes;
+	}
+	else if (done)
+	{
+		link->pending.erase(link->pending.begin()+k);
+		delete command;
+	}
+}
+// pass-through: takes what the sensor sent and routes every complete telegram; returns
+// false if the connection is gone
+static bool ReadSensor(SensorLink *link,std::vector<ServerClient *> &clients)
+{
+	int n=recv(link->fd,link->in+link->in_size,SENSOR_BUF-link->in_size,0);
+	if (n==0 || (n<0 && errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR))
+	{
+		return false;
+	}
+	if (n>0)
+	{
+		std::deque<std::string> telegrams;
+		link->in_size+=n;
+		ExtractTelegrams(link->in,link->in_size,SENSOR_BUF,telegrams);
+		for (size_t k=0;k<telegrams.size();k++)
+		{
+			RouteTelegram(link,clients,telegrams[k]);
+		}
+	}
+	return true;
+}
+// pass-through: writes what the sensor socket takes; EPOLLOUT is armed only while some is
+// left. Returns false if the connection is gone
+static bool FlushSensor(int epfd,SensorLink *link)
+{
+	while (!link->out.empty())
+	{
+		ssize_t count=send(link->fd,link->out.data(),link->out.size(),MSG_NOSIGNAL);
+		if (count<0)
+		{
+			if (errno==EINTR)
 			{
-		
-			sem_wait(&(sp->sem2_));			
-				for (i=0;i<mescount;i++)
-				{
-					sp->req[i]=mes[i];
-				}
-				sp->req_size=mescount;
-				sp->request=1;
-				sem_post(&(sp->sem2_));
-//				printf("test\n");
-				while (1)
-				{					
-//					printf("request=%d\n",sp->request);
-					sem_wait(&(sp->sem3_));
-					if (sp->request==0)
-					{
-//						printf("request=%d\n",sp->request);
-//						printf("%d\n",sp->resp_size);
-//						sem_wait(&(sp->sem3_));
-						for (i=0;i<sp->resp_size;i++)
-						{
-							res[i]=sp->resp[i];
-//							printf ("%c %d\n",res[i],i);
-						}							
-//						printf("\n");
-						resp_size=sp->resp_size;	
-						sem_post(&(sp->sem3_));
-						return resp_size;
-					}
-					sem_post(&(sp->sem3_));
-
-					for (i=0;i<10000;i++)
-					{
-					}
-				}
-		//	}
-
+				continue;
+			}
+			if (errno!=EAGAIN && errno!=EWOULDBLOCK)
+			{
+				return false;
+			}
+			break;
 		}
+		link->out.erase(0,count);
 	}
-	else
+	const bool poll_out=!link->out.empty();
+	if (poll_out!=link->polling_out)
 	{
-		last=0;
-		return 0;
+		struct epoll_event ev;
+		ev.events=EPOLLIN|(poll_out ? (uint32_t)EPOLLOUT : 0);
+		ev.data.ptr=link;
+		epoll_ctl(epfd,EPOLL_CTL_MOD,link->fd,&ev);
+		link->polling_out=poll_out;
 	}
-	
+	return true;
 }
-void *Server(void *arg)
+// pass-through: drops a client that left from the pending commands (which stay, so their
+// replies are still taken in order) and from the subscriptions; an event nobody wants any
+// more is switched off at the sensor
+static void ForgetClient(SensorLink *link,unsigned int id)
 {
-	ServerPacket *sp=(ServerPacket *) arg;
-/*	while (1)
+	size_t k = 0;
+	for (k=0;k<link->pending.size();k++)
 	{
-		sem_wait(&(sp->sem1_));
-		printf("ja1\n");
-		sem_post(&(sp->sem1_));
-	}	
-*/
-
-
-
-int sockfd=sp->sockfd;
-	struct sockaddr_in self;
-	char buffer[MAXBUF];
-	char buffer1[1000];
-	char res[20000];
-
-	/*---Create streaming socket---*/
- /*  if ( (sockfd = socket(AF_INET, SOCK_STREAM, 0)) < 0 )
+		std::vector<unsigned int> &ids=link->pending[k]->clients;
+		ids.erase(std::remove(ids.begin(),ids.end(),id),ids.end());
+	}
+	std::map<std::string,std::vector<unsigned int> >::iterator it=link->events.begin();
+	while (it!=link->events.end())
 	{
-		perror("Socket");
-		exit(errno);
+		std::vector<unsigned int> &ids=it->second;
+		const size_t before=ids.size();
+		ids.erase(std::remove(ids.begin(),ids.end(),id),ids.end());
+		if (ids.empty())
+		{
+			if (before>0)
+			{
+				const std::string mes="\x02sEN "+it->first+" 0\x03";
+				link->pending.push_back(new SensorCommand(it->first,mes,false));
+				link->out+=mes;
+			}
+			link->events.erase(it++);
+		}
+		else
+		{
+			++it;
+		}
 	}
-
-	/*---Initialize address/port structure---*/
-/*	bzero(&self, sizeof(self));
-	self.sin_family = AF_INET;
-	self.sin_port = htons(MY_PORT);
-	self.sin_addr.s_addr = INADDR_ANY;
-
-	 /*---Assign a port number to the socket---*/
- /*   if ( bind(sockfd, (struct sockaddr*)&self, sizeof(self)) != 0 )
+}
+// answers a client's queued requests until one has to wait for the device (or for the first
+// measurements); returns whether anything was queued for sending
+static bool ServeRequests(ServerPacket *sp,ResponseCache *cache,ServerClient *client)
+{
+	if (sp->sensor!=NULL)
 	{
-		perror("socket--bind");
-		exit(errno);
+		return ProxyRequests(sp->sensor,client);
+	}
+	bool queued=false;
+	while (!client->waiting && !client->requests.empty())
+	{
+		const std::string &mes=client->requests.front();
+		bool forward;
+		ServerBuffer *reply=AnswerRequest(mes.data(),mes.size(),sp,cache,forward);
+		if (reply==NULL)
+		{
+			if (forward)
+			{
+				sp->commands.Push(new ServerCommand(client->id,mes));
+				client->waiting=true;
+			}
+			break;
+		}
+		client->Queue(reply);
+		client->requests.pop_front();
+		queued=true;
+	}
+	return queued;
+}
+// writes what the socket takes, several queued replies per call; returns false if the
+// client has to go
+static bool FlushClient(int epfd,ServerClient *client)
+{
+	struct iovec iov[MAX_IOV];
+	struct msghdr msg;
+	memset(&msg,0,sizeof(msg));
+	msg.msg_iov=iov;
+	while (!client->out.empty())
+	{
+		size_t i;
+		for (i=0;i<client->out.size() && i<MAX_IOV;i++)
+		{
+			const ServerChunk &chunk=client->out[i];
+			iov[i].iov_base=(void *) (chunk.buffer->data.data()+chunk.offset);
+			iov[i].iov_len=chunk.buffer->data.size()-chunk.offset;
+		}
+		msg.msg_iovlen=i;
+		// sendmsg is writev with MSG_NOSIGNAL: a vanished client must not raise SIGPIPE
+		ssize_t count=sendmsg(client->fd,&msg,MSG_NOSIGNAL);
+		if (count<0)
+		{
+			if (errno==EINTR)
+			{
+				continue;
+			}
+			if (errno!=EAGAIN && errno!=EWOULDBLOCK)
+			{
+				return false;
+			}
+			break;
+		}
+		client->out_size-=count;
+		while (count>0)
+		{
+			ServerChunk &chunk=client->out.front();
+			size_t left=chunk.buffer->data.size()-chunk.offset;
+			if ((size_t) count<left)
+			{
+				chunk.offset+=count;
+				break;
+			}
+			count-=left;
+			ReleaseBuffer(chunk.buffer);
+			client->out.pop_front();
+		}
+	}
+	if (client->out_size>MAX_PENDING_OUTPUT)
+	{
+		return false;
 	}
+	WatchClient(epfd,client,EPOLL_CTL_MOD);
+	return true;
+}
+static void CloseClient(int epfd,std::vector<ServerClient *> &clients,ServerClient *client)
+{
+	printf("client %u disconnected\n",client->id);
+	epoll_ctl(epfd,EPOLL_CTL_DEL,client->fd,NULL);
+	close(client->fd);
+	clients.erase(std::find(clients.begin(),clients.end(),client));
+	delete client;
+}
+// serves every client from one thread: the listening socket, the clients and the device's
+// wake-up eventfd (or, in pass-through mode, the sensor connection) are all waited on with
+// epoll, so nothing sleeps or spins
+void *Server(void *arg)
+{
+	ServerPacket *sp=(ServerPacket *) arg;
+	std::vector<ServerClient *> clients;
+	std::vector<ServerClient *> closing;
+	unsigned int next_id=1;
+	ResponseCache cache;
+	struct epoll_event events[MAX_EVENTS];
+	struct epoll_event ev;
+	int i;
+	unsigned int j;
 
-	/*---Make it a "listening socket"---*/
-/*	if ( listen(sockfd, 20) != 0 )
+	int epfd=epoll_create(MAX_CLIENTS);
+	if (epfd<0)
 	{
-		perror("socket--listen");
+		perror("epoll_create");
 		exit(errno);
 	}
+	SetNonBlocking(sp->sockfd);
+	ev.events=EPOLLIN;
+	ev.data.ptr=NULL;
+	epoll_ctl(epfd,EPOLL_CTL_ADD,sp->sockfd,&ev);
+	ev.events=EPOLLIN;
+	ev.data.ptr=sp;
+	epoll_ctl(epfd,EPOLL_CTL_ADD,sp->wakefd,&ev);
+	if (sp->sensor!=NULL)
+	{
+		SetNonBlocking(sp->sensor->fd);
+		ev.events=EPOLLIN;
+		ev.data.ptr=sp->sensor;
+		epoll_ctl(epfd,EPOLL_CTL_ADD,sp->sensor->fd,&ev);
+	}
 
-	/*---Forever... ---*/
-int count=0,count1=0,count2=0,countres=0;
-	int i,last;
-	int clientfd;
-		 struct sockaddr_in client_addr;
-		int addrlen=sizeof(client_addr);
 	while (1)
-	{	
-
-		/*---accept a connection (creating a data pipe)---*/
-		clientfd = accept(sockfd, (struct sockaddr*)&client_addr, (socklen_t*) &addrlen);
-		sem_wait(&(sp->sem4_));
-		 sp->accepted=1;
-		sem_post(&(sp->sem4_));
-		printf("%s:%d connected\n", inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
-		while (1)
+	{
+		int count=epoll_wait(epfd,events,MAX_EVENTS,-1);
+		if (count<0)
+		{
+			if (errno==EINTR)
+			{
+				continue;
+			}
+			perror("epoll_wait");
+			break;
+		}
+		closing.clear();
+		for (i=0;i<count;i++)
 		{
-			/*---Echo back anything sent---*/
-			/*send(clientfd, buffer, */count=recv(clientfd, buffer, MAXBUF, MSG_DONTWAIT);//, 0);
-			for (i=0;i<count;i++)
+			if (events[i].data.ptr==NULL)
 			{
-//				printf("%d %c\n",clientfd,buffer[i]);
+				/*---accept everyone who is waiting---*/
+				struct sockaddr_in client_addr;
+				socklen_t addrlen=sizeof(client_addr);
+				int clientfd;
+				while ((clientfd=accept(sp->sockfd,(struct sockaddr*)&client_addr,&addrlen))>=0)
+				{
+					if (clients.size()>=MAX_CLIENTS)
+					{
+						printf("%s:%d refused (%d clients)\n",inet_ntoa(client_addr.sin_addr),ntohs(client_addr.sin_port),MAX_CLIENTS);
+						close(clientfd);
+						continue;
+					}
+					SetNonBlocking(clientfd);
+					ServerClient *client=new ServerClient(next_id++,clientfd);
+					if (next_id==0)
+					{
+						next_id=1;
+					}
+					clients.push_back(client);
+					WatchClient(epfd,client,EPOLL_CTL_ADD);
+					printf("%s:%d connected as client %u\n",inet_ntoa(client_addr.sin_addr),ntohs(client_addr.sin_port),client->id);
+					addrlen=sizeof(client_addr);
+				}
 			}
-			if (count>0)
+			else if (events[i].data.ptr==sp)
 			{
-//				printf("duljina klijentske poruke = %d\n",count);
-					
-				for (i=0;i<count;i++)
+				/*---new measurements and/or answers from the device---*/
+				uint64_t wakeups;
+				if (read(sp->wakefd,&wakeups,sizeof(wakeups))<0)
+				{
+					continue;
+				}
+				ServerCommand *command;
+				while ((command=sp->replies.Pop())!=NULL)
 				{
-					buffer1[count1]= buffer[i];
-					count1++;
+					// the client may have disconnected meanwhile; its reply is then dropped
+					for (j=0;j<clients.size();j++)
+					{
+						if (clients[j]->id==command->client)
+						{
+							clients[j]->Queue(new ServerBuffer(command->response.data(),command->response.size()));
+							clients[j]->requests.pop_front();
+							clients[j]->waiting=false;
+							ServeRequests(sp,&cache,clients[j]);
+							if (!FlushClient(epfd,clients[j]))
+							{
+								closing.push_back(clients[j]);
+							}
+						}
+					}
+					delete command;
 				}
-				countres=CheckRequest(buffer1,count1,sp,res,last);
-				if (last>0){
-					for (int i=last;i<count1;i++)
+				// a new snapshot also serves whoever was waiting for the first one
+				for (j=0;j<clients.size();j++)
+				{
+					if (ServeRequests(sp,&cache,clients[j]) && !FlushClient(epfd,clients[j]))
 					{
-						buffer1[i-last]= buffer1[i];				
+						closing.push_back(clients[j]);
 					}
-					count1=count1-last;
 				}
-//				printf("countres=%d\n",countres);
-			}	
-			if ( countres>0)
+			}
+			else if (events[i].data.ptr==sp->sensor)
 			{
-//				printf("clientfd=%d\n",clientfd);
-				send(clientfd,res,countres,0);
-//				printf("poslana poruka duljine %d\n",countres);
-				countres=0;
-
+				/*---replies and events from the sensor (pass-through)---*/
+				if ((events[i].events&(EPOLLIN|EPOLLHUP|EPOLLERR)) && !ReadSensor(sp->sensor,clients))
+				{
+					printf("connection to the sensor lost\n");
+					exit(1);
+				}
+				// whoever got an answer moves on to their next request
+				for (j=0;j<clients.size();j++)
+				{
+					ServeRequests(sp,&cache,clients[j]);
+					if (clients[j]->out_size>0 && !FlushClient(epfd,clients[j]))
+					{
+						closing.push_back(clients[j]);
+					}
+				}
 			}
-			usleep(5000);
-/*			for (i=0;i<10000;i++)
+			else
 			{
-			}*/
+				ServerClient *client=(ServerClient *) events[i].data.ptr;
+				if (std::find(closing.begin(),closing.end(),client)!=closing.end())
+				{
+					continue;
+				}
+				if (events[i].events&EPOLLIN)
+				{
+					int n=recv(client->fd,client->in+client->in_size,MAXBUF-client->in_size,0);
+					if (n==0 || (n<0 && errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR))
+					{
+						closing.push_back(client);
+						continue;
+					}
+					if (n>0)
+					{
+						client->in_size+=n;
+						ExtractTelegrams(client->in,client->in_size,MAXBUF,client->requests);
+						ServeRequests(sp,&cache,client);
+					}
+				}
+				else if (events[i].events&(EPOLLHUP|EPOLLERR))
+				{
+					closing.push_back(client);
+					continue;
+				}
+				if (!FlushClient(epfd,client))
+				{
+					closing.push_back(client);
+				}
+			}
+		}
+		for (j=0;j<closing.size();j++)
+		{
+			if (std::find(clients.begin(),clients.end(),closing[j])!=clients.end())
+			{
+				if (sp->sensor!=NULL)
+				{
+					ForgetClient(sp->sensor,closing[j]->id);
+				}
+				CloseClient(epfd,clients,closing[j]);
+			}
+		}
+		if (sp->sensor!=NULL && !FlushSensor(epfd,sp->sensor))
+		{
+			printf("connection to the sensor lost\n");
+			exit(1);
 		}
-		/*---Close data connection---*/
-		close(clientfd);
 	}
 
 	/*---Clean up (should never get here!)---*/
-	close(sockfd);
-
-
-
-
+	for (j=0;j<clients.size();j++)
+	{
+		close(clients[j]->fd);
+		delete clients[j];
+	}
+	close(epfd);
+	return NULL;
 }
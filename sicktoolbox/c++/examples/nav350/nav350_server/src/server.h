@@ -11,11 +11,28 @@
 #include <string>
 #include <iostream>
 #include <pthread.h>
-#include <semaphore.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <netinet/tcp.h>
+#include <deque>
+#include <vector>
+#include <map>
+#include <algorithm>
 #include <sicktoolbox/SickNAV350.hh>
+#include <sicktoolbox/SickColaFormat.hh>
 
 #define MY_PORT		2111
 #define MAXBUF		6024
+#define MAX_CLIENTS	64	// connections served at once; more are refused
+#define MAX_EVENTS	16	// readiness events taken per epoll_wait
+#define MAX_PENDING_OUTPUT	(1<<20)	// bytes queued for a client that stopped reading before it is dropped
+#define MAX_IOV		16	// queued replies handed to one sendmsg
+#define CACHE_POSE	256	// response cache slots; 0..255 are pose data by mask
+#define CACHE_LANDMARK	257
+#define CACHE_SIZE	258
+#define SENSOR_BUF	(1<<16)	// pass-through: bytes of sensor telegrams buffered (a full scan is ~30 kB)
 using namespace SickToolbox;
 class Measurements{
 public:
@@ -27,24 +44,305 @@ public:
 	double step_angle,start_angle,stop_angle,timestamp;
 
 };
+// hands the newest measurements from the device loop to the server without locks or copies:
+// the device fills the back buffer and swaps it into the middle, the server swaps the middle
+// into the front when it holds something newer and encodes straight from it. Neither side
+// ever waits for the other or touches the buffer the other one holds.
+class MeasurementExchange
+{
+public:
+	MeasurementExchange()
+	{
+		for (int i=0;i<3;i++)
+		{
+			memset(&slots_[i].ReflectorData_,0,sizeof(slots_[i].ReflectorData_));
+			memset(&slots_[i].PoseData_,0,sizeof(slots_[i].PoseData_));
+			slots_[i].meas_num=0;
+		}
+		front_=0;
+		middle_=1;
+		back_=2;
+		loaded_=false;
+	}
+	// device loop: the buffer to fill next
+	Measurements *Back()
+	{
+		return &slots_[back_];
+	}
+	// device loop: makes the filled back buffer the newest snapshot
+	void Publish()
+	{
+		__sync_synchronize();
+		back_=__sync_lock_test_and_set(&middle_,back_|FRESH)&~FRESH;
+	}
+	// server: the newest snapshot (NULL before the first); fresh is set if it changed since
+	// the last call. It stays valid until the next call.
+	const Measurements *Front(bool &fresh)
+	{
+		fresh=false;
+		if (middle_&FRESH)
+		{
+			front_=__sync_lock_test_and_set(&middle_,front_)&~FRESH;
+			__sync_synchronize();
+			fresh=true;
+			loaded_=true;
+		}
+		return loaded_ ? &slots_[front_] : NULL;
+	}
+private:
+	enum { FRESH=4 };
+	Measurements slots_[3];
+	int front_;	// server only
+	volatile int middle_;	// index | FRESH, swapped by both
+	int back_;	// device loop only
+	bool loaded_;	// server only: front_ holds a published snapshot
+};
+// a request for the device, owned by whichever queue (or side) holds it
+class ServerCommand
+{
+public:
+	ServerCommand * volatile next;
+	unsigned int client;	// id of the client that asked
+	std::string request;	// STX..ETX telegram
+	std::string response;	// filled in by the device loop
+	ServerCommand(unsigned int client_,const std::string &request_) : request(request_)
+	{
+		next=NULL;
+		client=client_;
+	}
+};
+// lock-free multi-producer, single-consumer FIFO of commands (intrusive, after D. Vyukov):
+// Push never blocks or fails, Pop never blocks
+class ServerCommandQueue
+{
+public:
+	ServerCommandQueue() : stub_(0,"")
+	{
+		head_=&stub_;
+		tail_=&stub_;
+	}
+	void Push(ServerCommand *command)
+	{
+		command->next=NULL;
+		__sync_synchronize();
+		ServerCommand *prev=__sync_lock_test_and_set(&head_,command);
+		prev->next=command;
+	}
+	// returns NULL when empty (or when a Push is half way through)
+	ServerCommand *Pop()
+	{
+		ServerCommand *tail=tail_;
+		ServerCommand *next=tail->next;
+		if (tail==&stub_)
+		{
+			if (next==NULL)
+			{
+				return NULL;
+			}
+			tail_=next;
+			tail=next;
+			next=next->next;
+		}
+		if (next!=NULL)
+		{
+			__sync_synchronize();
+			tail_=next;
+			return tail;
+		}
+		if (tail!=head_)
+		{
+			return NULL;
+		}
+		Push(&stub_);
+		next=tail->next;
+		if (next!=NULL)
+		{
+			__sync_synchronize();
+			tail_=next;
+			return tail;
+		}
+		return NULL;
+	}
+	~ServerCommandQueue()
+	{
+		ServerCommand *command;
+		while ((command=Pop())!=NULL)
+		{
+			delete command;
+		}
+	}
+private:
+	ServerCommand stub_;
+	ServerCommand * volatile head_;	// producers
+	ServerCommand *tail_;	// consumer
+};
+// an encoded reply, shared by every client it is queued for (server thread only)
+class ServerBuffer
+{
+public:
+	std::string data;
+	int refs;
+	ServerBuffer(const char *bytes,int size) : data(bytes,size)
+	{
+		refs=1;
+	}
+};
+inline ServerBuffer *RetainBuffer(ServerBuffer *buffer)
+{
+	buffer->refs++;
+	return buffer;
+}
+inline void ReleaseBuffer(ServerBuffer *buffer)
+{
+	if (--buffer->refs==0)
+	{
+		delete buffer;
+	}
+}
+// a reply queued for one client; offset is how much of it the socket took
+class ServerChunk
+{
+public:
+	ServerBuffer *buffer;
+	size_t offset;
+	ServerChunk(ServerBuffer *buffer_)
+	{
+		buffer=buffer_;
+		offset=0;
+	}
+};
+// replies encoded from one measurement snapshot; every client asking for the same
+// data before the next update gets the same buffer
+class ResponseCache
+{
+public:
+	ServerBuffer *replies[CACHE_SIZE];
+	ResponseCache()
+	{
+		memset(replies,0,sizeof(replies));
+	}
+	void Clear()
+	{
+		for (int i=0;i<CACHE_SIZE;i++)
+		{
+			if (replies[i])
+			{
+				ReleaseBuffer(replies[i]);
+				replies[i]=NULL;
+			}
+		}
+	}
+	~ResponseCache()
+	{
+		Clear();
+	}
+};
+// one connected client of the relay; requests are answered strictly in order
+class ServerClient
+{
+public:
+	unsigned int id;
+	int fd;
+	char in[MAXBUF];	// bytes of a telegram that is still arriving
+	int in_size;
+	std::deque<std::string> requests;	// complete STX..ETX telegrams, oldest first
+	std::deque<ServerChunk> out;	// replies the socket has not taken yet
+	size_t out_size;	// bytes left in out
+	bool waiting;	// the oldest request is with the device
+	ServerClient(unsigned int id_,int fd_)
+	{
+		id=id_;
+		fd=fd_;
+		in_size=0;
+		out_size=0;
+		waiting=false;
+	}
+	void Queue(ServerBuffer *reply)
+	{
+		if (reply->data.empty())
+		{
+			ReleaseBuffer(reply);
+			return;
+		}
+		out.push_back(ServerChunk(reply));
+		out_size+=reply->data.size();
+	}
+	~ServerClient()
+	{
+		for (size_t i=0;i<out.size();i++)
+		{
+			ReleaseBuffer(out[i].buffer);
+		}
+	}
+};
+// pass-through mode: a request in the sensor's command stream and the clients its replies
+// go to
+class SensorCommand
+{
+public:
+	std::string name;	// command name the replies carry, e.g. mNPOSGetData
+	std::string request;	// the telegram, so identical reads can share it
+	std::string ack;	// the sMA that came before the answer, for clients joining late
+	bool shared;	// a read that identical requests may join while it is in flight
+	std::vector<unsigned int> clients;	// empty for the relay's own requests
+	SensorCommand(const std::string &name_,const std::string &request_,bool shared_)
+		: name(name_), request(request_)
+	{
+		shared=shared_;
+	}
+};
+// pass-through mode: the one connection to the sensor every client is multiplexed onto.
+// Requests are written as they come (the sensor answers in order) and each reply goes to
+// the oldest pending command of its name; event telegrams go to whoever subscribed.
+class SensorLink
+{
+public:
+	int fd;
+	char in[SENSOR_BUF];	// bytes of a telegram that is still arriving
+	int in_size;
+	std::string out;	// requests the socket has not taken yet
+	bool polling_out;	// EPOLLOUT is armed for out
+	std::deque<SensorCommand *> pending;	// in the order they were sent
+	std::map<std::string,std::vector<unsigned int> > events;	// subscribers by event name
+	SensorLink(int fd_)
+	{
+		fd=fd_;
+		in_size=0;
+		polling_out=false;
+	}
+	~SensorLink()
+	{
+		for (size_t i=0;i<pending.size();i++)
+		{
+			delete pending[i];
+		}
+		close(fd);
+	}
+};
+// everything the device loop and the server share; none of it blocks either side
 class ServerPacket
 {
 public:
 	int sockfd;
-	sem_t sem1_;
-	sem_t sem2_;
-	sem_t sem3_;
-	sem_t sem4_;
-	int accepted;
-	Measurements m_;
-	char req[6000];
-	int req_size;
-	int request;
-	char resp[6000];
-	int resp_size;
+	int wakefd;	// eventfd the device loop signals after publishing or answering
+	MeasurementExchange snapshots;
+	ServerCommandQueue commands;	// server -> device loop
+	ServerCommandQueue replies;	// device loop -> server
+	SensorLink *sensor;	// pass-through mode (no device loop) when set
 	ServerPacket()
 	{
-		accepted=0;
+		sockfd=-1;
+		wakefd=-1;
+		sensor=NULL;
+	}
+	// device loop: wakes the server without ever blocking
+	void Wake()
+	{
+		uint64_t one=1;
+		if (write(wakefd,&one,sizeof(one))<0)
+		{
+			// the counter is saturated, so the server is awake anyway
+		}
 	}
 	~ServerPacket()
 	{
@@ -53,13 +351,20 @@ public:
 			close(sockfd);
 			sockfd=-1;			
 		}
+		if (wakefd>-1)
+		{
+			close(wakefd);
+			wakefd=-1;
+		}
+		delete sensor;
 	}
 };
 int ConvertNumberToString(int num,char *str);
-int GetPoseData(ServerPacket *sp,char *res);
-int GetPose(ServerPacket *sp,char *res);
-int DoMapping(ServerPacket *sp,char *res);
-int ChangeState(char *res);
-int CheckRequest(char* buffer,int count,ServerPacket *sp,char *res,int &last);
+int GetPoseData(const Measurements *m,char *res,char mask);
+int GetPose(const Measurements *m,char *res);
+int GetLandmarkData(const Measurements *m,char *res);
+int DoMapping(const Measurements *m,char *res);
+int ChangeState(char *res,char c);
+ServerBuffer *AnswerRequest(const char *mes,int mescount,ServerPacket *sp,ResponseCache *cache,bool &forward);
 void *Server(void *arg);
 #endif
@@ -21,6 +21,10 @@
 #include <pthread.h>
 #include <unistd.h>
 #include "SickException.hh"
+#include "SickTelegramLog.hh"
+#include "SickLatency.hh"
+#include "SickHealth.hh"
+#include "SickMonitorGroup.hh"
 
 /* Associate the namespace */
 namespace SickToolbox {
@@ -39,8 +43,8 @@ namespace SickToolbox {
     /** A method for setting the target data stream */
     void SetDataStream( const unsigned int sick_fd ) throw( SickThreadException );
     
-    /** Start the buffer monitor for the device */
-    void StartMonitor( const unsigned int sick_fd ) throw( SickThreadException );
+    /** Start the buffer monitor for the device (on its own thread, or on the group's if one is given) */
+    void StartMonitor( const unsigned int sick_fd, SickMonitorGroup * const sick_monitor_group = NULL ) throw( SickThreadException );
 
     /** Acquire the most recent message buffered by the monitor */
     bool GetNextMessageFromMonitor( SICK_MSG_CLASS &sick_message ) throw( SickThreadException );
@@ -57,6 +61,12 @@ namespace SickToolbox {
     /** Unlock access to the data stream */
     void ReleaseDataStream( ) throw( SickThreadException );
 
+    /** Records every received telegram w/ the given recorder (NULL stops recording) */
+    void SetRecorder( SickTelegramRecorder * const sick_recorder ) throw( SickThreadException );
+
+    /** Returns the health counters of the data stream */
+    SickHealthCounters & GetHealthCounters( ) const { return _sick_health; }
+
     /** A standard destructor */
     ~SickBufferMonitor( ) throw( SickThreadException );
 
@@ -64,6 +74,9 @@ namespace SickToolbox {
 
     /** Sick data stream file descriptor */
     unsigned int _sick_fd;   
+
+    /** Counts what happens on the data stream (bumped from const readers too) */
+    mutable SickHealthCounters _sick_health;
     
     /** Reads n bytes into the destination buffer */
     void _readBytes( uint8_t * const dest_buffer, const int num_bytes_to_read, const unsigned int timeout_value = 0 ) const throw ( SickTimeoutException, SickIOException );       
@@ -79,6 +92,9 @@ namespace SickToolbox {
     /** Buffer monitor thread ID */
     pthread_t _monitor_thread_id;
 
+    /** The group pumping this monitor (NULL if it runs its own thread) */
+    SickMonitorGroup *_sick_monitor_group;
+
     /** A mutex for guarding the message container */
     pthread_mutex_t _container_mutex;
 
@@ -88,12 +104,32 @@ namespace SickToolbox {
     /** A container to hold the most recent message */
     SICK_MSG_CLASS _recv_msg_container;      
 
+    /** Receives a copy of every assembled telegram (NULL if not recording) */
+    SickTelegramRecorder *_sick_recorder;
+
+    /** Frames published since the driver last took one (guarded by the container mutex) */
+    unsigned int _num_pending_messages;
+
+    /** Number of times the monitor was started */
+    unsigned int _num_monitor_starts;
+
+#ifdef SICK_LATENCY_TRACING
+    /** When _readBytes() got the first byte of the telegram being assembled (nsec, 0 if none yet) */
+    mutable uint64_t _latency_first_byte_nsec;
+#endif
+
     /** Locks access to the message container */
     void _acquireMessageContainer( ) throw( SickThreadException );
 
     /** Unlocks access to the message container */
     void _releaseMessageContainer( ) throw( SickThreadException );   
 
+    /** Assembles and publishes the next message (false once the monitor is told to stop) */
+    bool _monitorOnce( SICK_MSG_CLASS &curr_message ) throw( SickIOException, SickThreadException );
+
+    /** Entry point for the monitor group (pumps the monitor once) */
+    static bool _pollMonitor( void * monitor_instance );
+
     /** Entry point for the monitor thread */
     static void * _bufferMonitorThread( void * thread_args );    
     
@@ -105,7 +141,12 @@ namespace SickToolbox {
    */
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SickBufferMonitor( SICK_MONITOR_CLASS * const monitor_instance ) throw( SickThreadException ) :
-    _sick_monitor_instance(monitor_instance), _continue_grabbing(true), _monitor_thread_id(0) {
+    _sick_monitor_instance(monitor_instance), _continue_grabbing(true), _monitor_thread_id(0), _sick_monitor_group(NULL), _sick_recorder(NULL),
+    _num_pending_messages(0), _num_monitor_starts(0) {
+
+#ifdef SICK_LATENCY_TRACING
+    _latency_first_byte_nsec = 0;
+#endif
     
     /* Initialize the shared message buffer mutex */
     if (pthread_mutex_init(&_container_mutex,NULL) != 0) {
@@ -133,9 +174,17 @@ namespace SickToolbox {
       
       /* Assign the data stream fd */
       _sick_fd = sick_fd;
+      _sick_health.Reconnect();
       
       /* Attempt to release the data stream */
       ReleaseDataStream();
+
+      /* Have the group wait on the new stream */
+      if (_sick_monitor_group) {
+	sick_polled_monitor_t polled_monitor = {_sick_monitor_instance,(int)_sick_fd,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_pollMonitor};
+	_sick_monitor_group->Remove(_sick_monitor_instance);
+	_sick_monitor_group->Add(polled_monitor);
+      }
       
     }
 
@@ -154,21 +203,32 @@ namespace SickToolbox {
   
   /**
    * \brief Creates and starts the buffer monitor thread
-   * \return True upon success, False otherwise
+   * \param sick_fd The data stream file descriptor
+   * \param *sick_monitor_group The group whose thread pumps the monitor (NULL starts a thread of its own)
    */
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
-  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::StartMonitor( const unsigned int sick_fd ) throw ( SickThreadException ) {
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::StartMonitor( const unsigned int sick_fd, SickMonitorGroup * const sick_monitor_group ) throw ( SickThreadException ) {
 
     /* Assign the fd associated with the data stream */
     _sick_fd = sick_fd;
-    
+
+    /* Set the flag to continue grabbing data */
+    _continue_grabbing = true;
+    _sick_monitor_group = sick_monitor_group;
+
     /* Start the buffer monitor */
-    if (pthread_create(&_monitor_thread_id,NULL,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_bufferMonitorThread,_sick_monitor_instance) != 0) {
+    if (_sick_monitor_group) {
+      sick_polled_monitor_t polled_monitor = {_sick_monitor_instance,(int)_sick_fd,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_pollMonitor};
+      _sick_monitor_group->Add(polled_monitor);
+    }
+    else if (pthread_create(&_monitor_thread_id,NULL,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_bufferMonitorThread,_sick_monitor_instance) != 0) {
       throw SickThreadException("SickBufferMonitor::StartMonitor: pthread_create() failed!");
     }
 
-    /* Set the flag to continue grabbing data */
-    _continue_grabbing = true;
+    /* Any start after the first one re-establishes the stream */
+    if (_num_monitor_starts++ > 0) {
+      _sick_health.Reconnect();
+    }
     
   }
 
@@ -193,6 +253,8 @@ namespace SickToolbox {
 	/* Copy the shared message */
 	sick_message = _recv_msg_container;
 	_recv_msg_container.Clear();
+	_num_pending_messages = 0;
+	SICK_LATENCY_STAMP(sick_message,SICK_LATENCY_CONSUMER_DEQUEUE);
 	
 	/* Set the flag indicating success */
 	acquired_message = true;      
@@ -237,7 +299,11 @@ namespace SickToolbox {
       ReleaseDataStream();
 
       /* Wait for the buffer monitor to exit */
-      if (pthread_join(_monitor_thread_id,&monitor_result) != 0) {
+      if (_sick_monitor_group) {
+	_sick_monitor_group->Remove(_sick_monitor_instance);
+	_sick_monitor_group = NULL;
+      }
+      else if (pthread_join(_monitor_thread_id,&monitor_result) != 0) {
       	throw SickThreadException("SickBufferMonitor::StopMonitor: pthread_join() failed!");      
       }
 
@@ -282,6 +348,20 @@ namespace SickToolbox {
     
   }
   
+  /**
+   * \brief Attaches (or detaches) a telegram recorder
+   * \param *sick_recorder The recorder (NULL stops recording)
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetRecorder( SickTelegramRecorder * const sick_recorder ) throw( SickThreadException ) {
+
+    /* The monitor thread only looks at the recorder while holding the stream */
+    AcquireDataStream();
+    _sick_recorder = sick_recorder;
+    ReleaseDataStream();
+
+  }
+
   /**
    * \brief The destructor (kills the mutex)
    */
@@ -376,6 +456,12 @@ namespace SickToolbox {
   	  /* Decide what to do based on the output of read */
   	  if (num_bytes_read > 0) { //Update the number of bytes read so far
   	    total_num_bytes_read += num_bytes_read;
+	    _sick_health.BytesRead(num_bytes_read);
+#ifdef SICK_LATENCY_TRACING
+	    if (!_latency_first_byte_nsec) {
+	      _latency_first_byte_nsec = sick_latency_time_nsec();
+	    }
+#endif
   	  }
   	  else {
   	    /* If this happens, something is wrong */
@@ -402,6 +488,126 @@ namespace SickToolbox {
     
   }
   
+  /**
+   * \brief Pumps the monitor once (the monitor group calls this when the stream is readable)
+   * \param *monitor_instance The monitor instance
+   * \return False if the driver has not taken the last message yet (nothing is read then) or the read failed
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_pollMonitor( void * monitor_instance ) {
+
+    /* Acquire the Sick device instance */
+    SICK_MONITOR_CLASS *buffer_monitor = (SICK_MONITOR_CLASS *)monitor_instance;
+
+    /* Declare a Sick receive object */
+    SICK_MSG_CLASS curr_message;
+
+    try {
+
+      /* Leave the next message in the stream until the driver has taken the last one */
+      buffer_monitor->_acquireMessageContainer();
+      const bool container_full = buffer_monitor->_recv_msg_container.IsPopulated();
+      buffer_monitor->_releaseMessageContainer();
+      if (container_full) {
+	return false;
+      }
+
+      buffer_monitor->_monitorOnce(curr_message);
+      return true;
+    }
+
+    /* Make sure there wasn't a serious error reading from the buffer */
+    catch(SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+    }
+
+    /* Catch any thread exceptions */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+    }
+
+    /* A failsafe */
+    catch(...) {
+      std::cerr << "SickBufferMonitor::_pollMonitor: Unknown exception!" << std::endl;
+    }
+
+    /* Back off (the stream may have gone away) */
+    return false;
+
+  }
+
+  /**
+   * \brief Assembles the next message and hands it to the driver
+   * \param &curr_message Scratch space for the message
+   * \return False if the monitor has been told to stop, true otherwise
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_monitorOnce( SICK_MSG_CLASS &curr_message ) throw( SickIOException, SickThreadException ) {
+
+    /* Acquire the Sick device instance */
+    SICK_MONITOR_CLASS *buffer_monitor = _sick_monitor_instance;
+
+    /* Reset the sick message object */
+    curr_message.Clear();
+
+    /* Acquire the most recent message */
+    buffer_monitor->AcquireDataStream();
+
+    if (!buffer_monitor->_continue_grabbing) { // should the monitor continue grabbing
+      buffer_monitor->ReleaseDataStream();
+      return false;
+    }
+
+#ifdef SICK_LATENCY_TRACING
+    buffer_monitor->_latency_first_byte_nsec = 0;
+#endif
+
+    try {
+      buffer_monitor->GetNextMessageFromDataStream(curr_message);
+    }
+
+    /* Let go of the stream before handing the error up (a dead device would lock it forever) */
+    catch(...) {
+      buffer_monitor->ReleaseDataStream();
+      throw;
+    }
+
+    if (curr_message.IsPopulated()) {
+      buffer_monitor->_sick_health.FrameReceived();
+    }
+
+#ifdef SICK_LATENCY_TRACING
+    if (curr_message.IsPopulated()) {
+      curr_message.SetLatencyStamp(SICK_LATENCY_FIRST_BYTE,buffer_monitor->_latency_first_byte_nsec);
+      SICK_LATENCY_STAMP(curr_message,SICK_LATENCY_FRAME_COMPLETE);
+    }
+#endif
+
+    /* Record the telegram while it is fresh */
+    if (buffer_monitor->_sick_recorder && curr_message.IsPopulated()) {
+      buffer_monitor->_sick_recorder->Record(curr_message,SICK_TELEGRAM_FROM_DEVICE);
+    }
+    buffer_monitor->ReleaseDataStream();
+
+    /* Update message container contents */
+    buffer_monitor->_acquireMessageContainer();
+    SICK_LATENCY_STAMP(curr_message,SICK_LATENCY_QUEUE_PUBLISH);
+
+    /* A frame the driver has not taken yet is lost */
+    if (curr_message.IsPopulated()) {
+      if (buffer_monitor->_recv_msg_container.IsPopulated()) {
+	buffer_monitor->_sick_health.FrameDropped();
+      }
+      buffer_monitor->_sick_health.QueueDepth(++buffer_monitor->_num_pending_messages);
+    }
+
+    buffer_monitor->_recv_msg_container = curr_message;
+    buffer_monitor->_releaseMessageContainer();
+
+    return true;
+
+  }
+
   /**
    * \brief The monitor thread
    * \param *args The thread arguments
@@ -420,25 +626,10 @@ namespace SickToolbox {
 
       try {
 
-	/* Reset the sick message object */
- 	curr_message.Clear();	
-
- 	/* Acquire the most recent message */
-	buffer_monitor->AcquireDataStream();	  
-	
-	if (!buffer_monitor->_continue_grabbing) { // should the thread continue grabbing
-	  buffer_monitor->ReleaseDataStream();
+	if (!buffer_monitor->_monitorOnce(curr_message)) {
 	  break;
 	}
 
-	buffer_monitor->GetNextMessageFromDataStream(curr_message);
-	buffer_monitor->ReleaseDataStream();
-	
-	/* Update message container contents */
-	buffer_monitor->_acquireMessageContainer();	
-	buffer_monitor->_recv_msg_container = curr_message;
- 	buffer_monitor->_releaseMessageContainer();
-
       }
 
       /* Make sure there wasn't a serious error reading from the buffer */
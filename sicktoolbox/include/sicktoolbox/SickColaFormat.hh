@@ -0,0 +1,216 @@
+/*!
+ * \file SickColaFormat.hh
+ * \brief Defines the formatters for the numeric fields of CoLa-A
+ *        (ASCII) telegrams.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_COLA_FORMAT_HH
+#define SICK_COLA_FORMAT_HH
+
+/* Definition dependencies */
+#include <string.h>
+#include <stdint.h>
+#include "SickConfig.hh"
+
+/* Macros */
+#define SICK_COLA_MAX_HEX_LENGTH                                     (8)  ///< Digits of the largest 32-bit hex field
+#define SICK_COLA_MAX_DECIMAL_LENGTH                                (11)  ///< Sign and digits of the longest 32-bit decimal field
+#define SICK_COLA_WRITE_SLACK                                        (8)  ///< Bytes a hex write may touch past the end of its field
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /*
+   * NOTE: The hex writers build all eight digits of a value in one 64-bit
+   *       word (one nibble per byte, then '0'-'9'/'A'-'F' by arithmetic)
+   *       and store the whole word, so a field costs a handful of integer
+   *       ops and no loop or table.  They may write up to
+   *       SICK_COLA_WRITE_SLACK bytes past the end of the field; the output
+   *       buffer must have that much room.  The decimal writers write
+   *       exactly the field.
+   */
+
+  /**
+   * \brief Returns the number of hex digits CoLa-A uses for a value (no leading zeros, "0" for zero)
+   * \param value The value
+   */
+  inline unsigned int sick_cola_hex_length( const uint32_t value ) {
+    return (35 - __builtin_clz(value | 1)) >> 2;
+  }
+
+  /**
+   * \brief Returns the eight upper-case hex digits of a value, most significant first in memory order
+   * \param value The value
+   */
+  inline uint64_t sick_cola_hex_word( const uint32_t value ) {
+
+    /* Nibble k into byte k */
+    uint64_t word = value;
+    word = (word | (word << 16)) & 0x0000FFFF0000FFFFULL;
+    word = (word | (word << 8)) & 0x00FF00FF00FF00FFULL;
+    word = (word | (word << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    /* 0-9 -> '0'-'9', 10-15 -> 'A'-'F' */
+    const uint64_t letters = ((word + 0x0606060606060606ULL) >> 4) & 0x0101010101010101ULL;
+    word += 0x3030303030303030ULL + letters*7;
+
+#ifndef WORDS_BIGENDIAN
+    /* The most significant digit goes first */
+    word = __builtin_bswap64(word);
+#endif
+
+    return word;
+  }
+
+  /**
+   * \brief Writes a value as upper-case hex w/o leading zeros (may touch SICK_COLA_WRITE_SLACK bytes past the field)
+   * \param out Where the field starts
+   * \param value The value (signed values are sent as their 32-bit two's complement)
+   * \return The length of the field
+   */
+  inline unsigned int sick_cola_write_hex( char * const out, const uint32_t value ) {
+
+    const unsigned int length = sick_cola_hex_length(value);
+    uint64_t word = sick_cola_hex_word(value);
+
+    /* Drop the leading zeros */
+#ifndef WORDS_BIGENDIAN
+    word >>= 8*(SICK_COLA_MAX_HEX_LENGTH - length);
+#else
+    word <<= 8*(SICK_COLA_MAX_HEX_LENGTH - length);
+#endif
+
+    memcpy(out,&word,sizeof(word));
+    return length;
+  }
+
+  /**
+   * \brief Writes the low digits of a value as zero-padded upper-case hex (may touch SICK_COLA_WRITE_SLACK bytes past the field)
+   * \param out Where the field starts
+   * \param value The value (digits above width are cut)
+   * \param width Digits in the field (1-8)
+   * \return The length of the field (width)
+   */
+  inline unsigned int sick_cola_write_hex_fixed( char * const out, const uint32_t value, const unsigned int width ) {
+
+    uint64_t word = sick_cola_hex_word(value);
+
+#ifndef WORDS_BIGENDIAN
+    word >>= 8*(SICK_COLA_MAX_HEX_LENGTH - width);
+#else
+    word <<= 8*(SICK_COLA_MAX_HEX_LENGTH - width);
+#endif
+
+    memcpy(out,&word,sizeof(word));
+    return width;
+  }
+
+  /**
+   * \brief Writes a value as decimal digits w/o a sign (exactly the field)
+   * \param out Where the field starts
+   * \param value The value
+   * \return The length of the field
+   */
+  inline unsigned int sick_cola_write_unsigned_decimal( char * const out, uint32_t value ) {
+
+    static const char digit_pairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+
+    const unsigned int length = 1 + (value >= 10) + (value >= 100) + (value >= 1000) + (value >= 10000) +
+      (value >= 100000) + (value >= 1000000) + (value >= 10000000) + (value >= 100000000) + (value >= 1000000000);
+
+    /* Two digits at a time from the right */
+    char *digit = out + length;
+    while (value >= 100) {
+      const unsigned int pair = (value % 100)*2;
+      value /= 100;
+      *--digit = digit_pairs[pair + 1];
+      *--digit = digit_pairs[pair];
+    }
+
+    if (value >= 10) {
+      *--digit = digit_pairs[value*2 + 1];
+      *--digit = digit_pairs[value*2];
+    }
+    else {
+      *--digit = (char)('0' + value);
+    }
+
+    return length;
+  }
+
+  /**
+   * \brief Writes a value as decimal, signed only when negative (as printf's %d; exactly the field)
+   * \param out Where the field starts
+   * \param value The value
+   * \return The length of the field
+   */
+  inline unsigned int sick_cola_write_decimal( char * const out, const int32_t value ) {
+
+    const unsigned int negative = value < 0;
+    out[0] = '-';
+    return negative + sick_cola_write_unsigned_decimal(out + negative,negative ? 0u - (uint32_t)value : (uint32_t)value);
+  }
+
+  /**
+   * \brief Writes a value as CoLa-A signed decimal, always w/ a leading '+' or '-' (exactly the field)
+   * \param out Where the field starts
+   * \param value The value
+   * \return The length of the field
+   */
+  inline unsigned int sick_cola_write_signed_decimal( char * const out, const int32_t value ) {
+
+    out[0] = value < 0 ? '-' : '+';
+    return 1 + sick_cola_write_unsigned_decimal(out + 1,value < 0 ? 0u - (uint32_t)value : (uint32_t)value);
+  }
+
+  /**
+   * \brief Copies a literal token (command type, command name, ...) into the output
+   * \param out Where the token starts
+   * \param token The NUL-terminated token
+   * \return The length of the token
+   */
+  inline unsigned int sick_cola_write_token( char * const out, const char * const token ) {
+
+    const unsigned int length = strlen(token);
+    memcpy(out,token,length);
+    return length;
+  }
+
+  /**
+   * \brief Writes an array (e.g. a range channel) as " <hex> <hex> ..." (may touch SICK_COLA_WRITE_SLACK bytes past the fields)
+   * \param out Where the first separator goes
+   * \param values The values (integers, or doubles truncated like an int cast)
+   * \param num_values Number of values
+   * \return The length of the fields, separators included
+   *
+   * Each value is written with one unaligned store and no branch on its
+   * magnitude, so a 1440-point scan costs ~1440 short straight-line runs.
+   * The output needs num_values*(1 + SICK_COLA_MAX_HEX_LENGTH) +
+   * SICK_COLA_WRITE_SLACK bytes of room.
+   */
+  template< class T >
+  inline unsigned int sick_cola_write_hex_fields( char * const out, const T * const values, const unsigned int num_values ) {
+
+    unsigned int length = 0;
+    for (unsigned int i = 0; i < num_values; i++) {
+      out[length] = ' ';
+      length += 1 + sick_cola_write_hex(out + length + 1,(uint32_t)(int64_t)values[i]);
+    }
+
+    return length;
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_COLA_FORMAT_HH */
@@ -0,0 +1,140 @@
+/*!
+ * \file SickHealth.hh
+ * \brief Defines the lock-free runtime health counters kept by every
+ *        driver instance.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_HEALTH_HH
+#define SICK_HEALTH_HH
+
+/* Definition dependencies */
+#include <stdint.h>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \struct sick_health_counters_tag
+   * \brief A snapshot of a driver's health counters (all counts since
+   *        construction or the last reset)
+   */
+  /**
+   * \typedef sick_health_counters_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_health_counters_tag {
+    uint64_t frames_received;                                  ///< Frames assembled by the buffer monitor
+    uint64_t frames_dropped;                                   ///< Frames that never reached the driver (bad checksum, malformed or overwritten)
+    uint64_t checksum_failures;                                ///< Frames discarded for a bad checksum/CRC
+    uint64_t resyncs;                                          ///< Header searches that had to discard stray bytes
+    uint64_t frame_timeouts;                                   ///< Frames abandoned because the rest did not arrive in time
+    uint64_t reply_timeouts;                                   ///< Expected replies that never arrived
+    uint64_t bytes_read;                                       ///< Bytes read from the device (including discarded ones)
+    uint64_t queue_high_water;                                 ///< Most frames waiting for the driver at once
+    uint64_t reconnects;                                       ///< Times the data stream was re-established
+  } sick_health_counters_t;
+
+  /**
+   * \class SickHealthCounters
+   * \brief Counters the buffer monitor and the driver bump as they go
+   *
+   * Every update is a single atomic operation, so the monitor thread
+   * never waits on a reader and any thread may take a snapshot at any
+   * time.
+   */
+  class SickHealthCounters {
+
+  public:
+
+    /** A standard constructor */
+    SickHealthCounters( ) { Reset(); }
+
+    /** A frame was assembled */
+    void FrameReceived( ) { __sync_fetch_and_add(&_counters.frames_received,1); }
+
+    /** A frame was discarded */
+    void FrameDropped( ) { __sync_fetch_and_add(&_counters.frames_dropped,1); }
+
+    /** A frame failed its checksum (and was discarded) */
+    void ChecksumFailure( ) {
+      __sync_fetch_and_add(&_counters.checksum_failures,1);
+      FrameDropped();
+    }
+
+    /** A header search discarded stray bytes */
+    void Resync( ) { __sync_fetch_and_add(&_counters.resyncs,1); }
+
+    /** A partially received frame timed out */
+    void FrameTimeout( ) { __sync_fetch_and_add(&_counters.frame_timeouts,1); }
+
+    /** An expected reply never arrived */
+    void ReplyTimeout( ) { __sync_fetch_and_add(&_counters.reply_timeouts,1); }
+
+    /** Bytes were read from the device */
+    void BytesRead( const uint64_t num_bytes ) { __sync_fetch_and_add(&_counters.bytes_read,num_bytes); }
+
+    /** Records the number of frames currently waiting for the driver */
+    void QueueDepth( const uint64_t queue_depth ) {
+      uint64_t high_water = _counters.queue_high_water;
+      while (queue_depth > high_water) {
+	const uint64_t prev_high_water = __sync_val_compare_and_swap(&_counters.queue_high_water,high_water,queue_depth);
+	if (prev_high_water == high_water) {
+	  break;
+	}
+	high_water = prev_high_water;
+      }
+    }
+
+    /** The data stream was re-established */
+    void Reconnect( ) { __sync_fetch_and_add(&_counters.reconnects,1); }
+
+    /** Takes a snapshot of the counters */
+    void GetCounters( sick_health_counters_t &counters ) const {
+      counters.frames_received = _read(_counters.frames_received);
+      counters.frames_dropped = _read(_counters.frames_dropped);
+      counters.checksum_failures = _read(_counters.checksum_failures);
+      counters.resyncs = _read(_counters.resyncs);
+      counters.frame_timeouts = _read(_counters.frame_timeouts);
+      counters.reply_timeouts = _read(_counters.reply_timeouts);
+      counters.bytes_read = _read(_counters.bytes_read);
+      counters.queue_high_water = _read(_counters.queue_high_water);
+      counters.reconnects = _read(_counters.reconnects);
+    }
+
+    /** Zeroes the counters (each one atomically, so concurrent updates are not torn) */
+    void Reset( ) {
+      _clear(_counters.frames_received);
+      _clear(_counters.frames_dropped);
+      _clear(_counters.checksum_failures);
+      _clear(_counters.resyncs);
+      _clear(_counters.frame_timeouts);
+      _clear(_counters.reply_timeouts);
+      _clear(_counters.bytes_read);
+      _clear(_counters.queue_high_water);
+      _clear(_counters.reconnects);
+    }
+
+  private:
+
+    /** The counters */
+    sick_health_counters_t _counters;
+
+    /** Reads a counter in one piece (64-bit loads may tear on 32-bit targets) */
+    static uint64_t _read( const uint64_t &counter ) { return __sync_fetch_and_add(const_cast< uint64_t * >(&counter),0); }
+
+    /** Zeroes a counter in one piece */
+    static void _clear( uint64_t &counter ) { __sync_fetch_and_and(&counter,0); }
+
+  };
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_HEALTH_HH */
@@ -40,6 +40,8 @@
 #include "SickLIDAR.hh"
 #include "SickLDBufferMonitor.hh"
 #include "SickLDMessage.hh"
+#include "SickProfileCache.hh"
+#include "SickScanView.hh"
 #include "SickException.hh"
 
 /**
@@ -71,6 +73,7 @@ namespace SickToolbox {
     static const uint16_t SICK_NUM_TICKS_PER_MOTOR_REV = 5760;                          ///< Odometer ticks per revolution of the Sick LD scan head
     static const double SICK_MAX_SCAN_ANGULAR_RESOLUTION = 0.125;                       ///< Minimum valid separation between laser pulses in active scan ares (deg)
     static const double SICK_DEGREES_PER_MOTOR_STEP = 0.0625;                           ///< Each odometer tick is equivalent to rotating the scan head this many degrees
+    static const double SICK_RANGE_SCALE = 0.00390625;                                  ///< Converts a raw range value to meters (raw ranges are in 1/256 m)
     
     /* Sick LD sensor modes of operation */
     static const uint8_t SICK_SENSOR_MODE_IDLE = 0x01;                                  ///< The Sick LD is powered but idle
@@ -337,12 +340,11 @@ namespace SickToolbox {
       unsigned int num_data_points;                                                       ///< The number of data points in the scan area
       unsigned int timestamp_start;                                                       ///< The timestamp (in ms) corresponding to the time the first measurement in the sector was taken 
       unsigned int timestamp_stop;                                                        ///< The timestamp (in ms) corresponding to the time the last measurement in the sector was taken
-      unsigned int echo_values[SICK_MAX_NUM_MEASUREMENTS];                                ///< The corresponding echo/reflectivity values
       double angle_step;                                                                  ///< The angle step used for the given sector (this should be the same for all sectors)
       double angle_start;                                                                 ///< The angle at which the first measurement in the sector was acquired
       double angle_stop;                                                                  ///< The angle at which the last measurement in the sector was acquired
-      double range_values[SICK_MAX_NUM_MEASUREMENTS];                                     ///< The corresponding range values (NOTE: The size of this array is intended to be large enough to accomodate various sector configs.)
-      double scan_angles[SICK_MAX_NUM_MEASUREMENTS];                                      ///< The scan angles corresponding to the respective measurements
+      uint16_t range_values[SICK_MAX_NUM_MEASUREMENTS];                                   ///< The raw range values in 1/256 m (see SICK_RANGE_SCALE; scan angles follow from angle_start/angle_step)
+      uint16_t echo_values[SICK_MAX_NUM_MEASUREMENTS];                                    ///< The corresponding echo/reflectivity values
     } sick_ld_sector_data_t;
     
     /**
@@ -419,6 +421,10 @@ namespace SickToolbox {
 			      unsigned int * const sector_stop_timestamps = NULL )
       throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException );
 
+    /** Acquires measurements for all active sectors and lends out the driver's buffer (no copy) */
+    void GetSickMeasurements( SickScanLease< uint16_t > &scan_lease, const bool get_echoes = false )
+      throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException );
+
     /** Attempts to set a new senor ID for the device (in flash) */
     void SetSickSensorID( const unsigned int sick_sensor_id )
       throw( SickErrorException, SickTimeoutException, SickIOException );
@@ -535,6 +541,9 @@ namespace SickToolbox {
 
     /** Prints the Sick Sector configuration */
     void PrintSickSectorConfig( ) const;
+
+    /** Enables the persistent device-profile cache (must be called before Initialize) */
+    void SetProfileCacheDirectory( const std::string cache_dir );
   
     /** Uninitializes the Sick LD unit */
     void Uninitialize( ) throw( SickIOException, SickTimeoutException, SickErrorException, SickThreadException );
@@ -544,6 +553,9 @@ namespace SickToolbox {
 
   private:
 
+    /** Lets the parser benchmark call the telegram parsers directly */
+    friend class SickParserBenchmark;
+
     /** The Sick LD IP address */
     std::string _sick_ip_address;
 
@@ -580,12 +592,27 @@ namespace SickToolbox {
     /** The current sector configuration for the unit */
     sick_ld_config_sector_t _sick_sector_config;
 
+    /** Cached identity/config from a previous run (disabled by default) */
+    SickProfileCache _sick_profile_cache;
+
+    /** The most recently parsed scan profile (kept here rather than on the stack) */
+    sick_ld_scan_profile_t _sick_scan_profile;
+
+    /** Indicates whether _sick_scan_profile is currently lent out through a SickScanLease */
+    bool _sick_scan_leased;
+
     /** Setup the connection parameters and establish TCP connection! */
     void _setupConnection( ) throw( SickIOException, SickTimeoutException );
   
     /** Synchronizes the driver state with the Sick LD (used for initialization) */
     void _syncDriverWithSick( ) throw( SickIOException, SickTimeoutException, SickErrorException );
 
+    /** Restores identity/config from the profile cache if the device fingerprint matches */
+    bool _loadProfileCache( ) throw( SickTimeoutException, SickIOException );
+
+    /** Writes the current identity/config to the profile cache */
+    void _storeProfileCache( );
+
     /** Set the function for a particular scan secto */
     void _setSickSectorFunction( const uint8_t sector_number, const uint8_t sector_function,
 				 const double sector_angle_stop, const bool write_to_flash = false )
@@ -612,6 +639,10 @@ namespace SickToolbox {
     void _getSickScanProfiles( const uint16_t profile_format, const uint16_t num_profiles = DEFAULT_SICK_NUM_SCAN_PROFILES )
       throw( SickErrorException, SickTimeoutException, SickIOException, SickConfigException );
 
+    /** Receives the next scan profile into _sick_scan_profile */
+    void _acquireSickScanProfile( const bool get_echoes )
+      throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException );
+
     /** Parses a sequence of bytes and populates the profile_data struct w/ the results */
     void _parseScanProfile( uint8_t * const src_buffer, sick_ld_scan_profile_t &profile_data ) const;
 
@@ -772,7 +803,7 @@ namespace SickToolbox {
     void _printSectorProfileData( const sick_ld_sector_data_t &sector_data ) const;
 
     /** Prints the data corresponding to the given scan profile (for debugging purposes) */
-    void _printSickScanProfile( const sick_ld_scan_profile_t profile_data, const bool print_sector_data = true ) const;
+    void _printSickScanProfile( const sick_ld_scan_profile_t &profile_data, const bool print_sector_data = true ) const;
 
     /** Returns the corresponding work service subcode required to transition the Sick LD to the given sensor mode. */
     uint8_t _sickSensorModeToWorkServiceSubcode( const uint8_t sick_sensor_mode ) const;
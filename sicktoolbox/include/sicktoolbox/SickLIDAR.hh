@@ -41,6 +41,10 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include "SickException.hh"
+#include "SickTelegramLog.hh"
+#include "SickLatency.hh"
+#include "SickHealth.hh"
+#include "SickMonitorGroup.hh"
 
 /* Associate the namespace */
 namespace SickToolbox {
@@ -59,6 +63,24 @@ namespace SickToolbox {
 
     /** Indicates whether device is initialized */
     bool IsInitialized() { return _sick_initialized; }
+
+    /** Records all telegrams exchanged w/ the device (NULL stops recording) */
+    void SetTelegramRecorder( SickTelegramRecorder * const sick_recorder ) throw( SickThreadException );
+
+    /** Returns the live scan latency histograms (NULL unless built w/ SICK_LATENCY_TRACING) */
+    const SickLatencyHistograms * GetLatencyHistograms( ) const;
+
+    /** Clears the scan latency histograms */
+    void ResetLatencyHistograms( );
+
+    /** Takes a snapshot of the driver's health counters */
+    void GetHealthCounters( sick_health_counters_t &health_counters ) const;
+
+    /** Zeroes the driver's health counters */
+    void ResetHealthCounters( );
+
+    /** Shares one I/O thread w/ other drivers (call before Initialize; NULL gives the driver its own thread) */
+    void SetMonitorGroup( SickMonitorGroup * const sick_monitor_group ) { _sick_monitor_group = sick_monitor_group; }
     
     /** A virtual destructor */
     virtual ~SickLIDAR( );
@@ -77,6 +99,17 @@ namespace SickToolbox {
     /** Indicates whether the Sick buffer monitor is running */
     bool _sick_monitor_running;
 
+    /** Receives a copy of every telegram sent to the device (NULL if not recording) */
+    SickTelegramRecorder *_sick_recorder;
+
+    /** The group whose thread pumps the buffer monitor (NULL if it runs its own) */
+    SickMonitorGroup *_sick_monitor_group;
+
+#ifdef SICK_LATENCY_TRACING
+    /** Where each scan telegram spent its time on the way to the caller */
+    SickLatencyHistograms _sick_latency;
+#endif
+
     /** A method for setting up a general connection */
     virtual void _setupConnection( ) = 0;
     
@@ -130,7 +163,7 @@ namespace SickToolbox {
    */
   template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SickLIDAR( ) :
-    _sick_fd(0), _sick_initialized(false), _sick_buffer_monitor(NULL), _sick_monitor_running(false) {
+    _sick_fd(0), _sick_initialized(false), _sick_buffer_monitor(NULL), _sick_monitor_running(false), _sick_recorder(NULL), _sick_monitor_group(NULL) {
 
     try {
       /* Attempt to instantiate a new SickBufferMonitor for the device */
@@ -155,6 +188,61 @@ namespace SickToolbox {
     
   }
 
+  /**
+   * \brief Attaches (or detaches) a telegram recorder to the driver and its buffer monitor
+   * \param *sick_recorder The recorder (NULL stops recording; the recorder must outlive the driver's use of it)
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetTelegramRecorder( SickTelegramRecorder * const sick_recorder ) throw( SickThreadException ) {
+
+    _sick_recorder = sick_recorder;
+
+    if (_sick_buffer_monitor) {
+      _sick_buffer_monitor->SetRecorder(sick_recorder);
+    }
+
+  }
+
+  /**
+   * \brief Returns the live scan latency histograms
+   * \return The histograms (NULL unless built w/ SICK_LATENCY_TRACING)
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  const SickLatencyHistograms * SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetLatencyHistograms( ) const {
+#ifdef SICK_LATENCY_TRACING
+    return &_sick_latency;
+#else
+    return NULL;
+#endif
+  }
+
+  /**
+   * \brief Clears the scan latency histograms
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::ResetLatencyHistograms( ) {
+#ifdef SICK_LATENCY_TRACING
+    _sick_latency.Reset();
+#endif
+  }
+
+  /**
+   * \brief Takes a snapshot of the driver's health counters
+   * \param &health_counters Receives the counters
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetHealthCounters( sick_health_counters_t &health_counters ) const {
+    _sick_buffer_monitor->GetHealthCounters().GetCounters(health_counters);
+  }
+
+  /**
+   * \brief Zeroes the driver's health counters
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::ResetHealthCounters( ) {
+    _sick_buffer_monitor->GetHealthCounters().Reset();
+  }
+
   /**
    * \brief Activates the buffer monitor for the driver
    */
@@ -163,7 +251,7 @@ namespace SickToolbox {
 
     /* Try to start the monitor */
     try {
-      _sick_buffer_monitor->StartMonitor(_sick_fd);
+      _sick_buffer_monitor->StartMonitor(_sick_fd,_sick_monitor_group);
     }
 
     /* Handle a thread exception */
@@ -264,6 +352,11 @@ namespace SickToolbox {
     sick_message.GetMessage(message_buffer);
     unsigned int message_length = sick_message.GetMessageLength();
 
+    /* Record the outgoing telegram (used to pace replies during replay) */
+    if (_sick_recorder) {
+      _sick_recorder->Record(message_buffer,message_length,SICK_TELEGRAM_TO_DEVICE);
+    }
+
     /* Check whether a transmission delay between bytes is requested */
     if (byte_interval == 0) {
       
@@ -316,6 +409,7 @@ namespace SickToolbox {
       /* Check whether the allowed time has expired */
       gettimeofday(&end_time,NULL);    
       if (_computeElapsedTime(beg_time,end_time) > timeout_value) {
+	_sick_buffer_monitor->GetHealthCounters().ReplyTimeout();
 	throw SickTimeoutException("SickLIDAR::_recvMessage: Timeout occurred!");
       }
       
@@ -378,6 +472,7 @@ namespace SickToolbox {
       /* Check whether the allowed time has expired */
       gettimeofday(&end_time,NULL);        
       if (_computeElapsedTime(beg_time,end_time) > timeout_value) {
+	_sick_buffer_monitor->GetHealthCounters().ReplyTimeout();
       	throw SickTimeoutException();
       }      
       
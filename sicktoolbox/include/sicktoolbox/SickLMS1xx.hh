@@ -168,6 +168,9 @@ namespace SickToolbox {
 
   private:
 
+    /** Lets the parser benchmark call the telegram parsers directly */
+    friend class SickParserBenchmark;
+
     /*!
      * \struct sick_lms_1xx_scan_config_tag
      * \brief A structure for aggregrating the
@@ -272,6 +275,15 @@ namespace SickToolbox {
     /** Restore device to measuring mode */
     void _restoreMeasuringMode( ) throw( SickTimeoutException, SickIOException );
 
+    /** Parses an LMDscandata telegram into the given buffers */
+    void _parseSickScanData( const SickLMS1xxMessage &recv_message,
+			     unsigned int * const range_1_vals,
+			     unsigned int * const range_2_vals,
+			     unsigned int * const reflect_1_vals,
+			     unsigned int * const reflect_2_vals,
+			     unsigned int & num_measurements,
+			     unsigned int * const dev_status ) const throw ( SickIOException );
+
     /** Ensures a feasible scan area */
     bool _validScanArea( const int start_angle, const int stop_angle ) const;
     
@@ -46,8 +46,8 @@ namespace SickToolbox {
 
   private:
 
-    /* A utility function for flushing the receive buffer */
-    void _flushTCPRecvBuffer( ) const throw ( SickIOException );
+    /* A utility function for flushing the receive buffer (returns the bytes discarded) */
+    unsigned int _flushTCPRecvBuffer( ) const throw ( SickIOException );
     
   };
     
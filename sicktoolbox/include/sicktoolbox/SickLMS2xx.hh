@@ -22,6 +22,8 @@
 
 #include "SickLIDAR.hh"
 #include "SickException.hh"
+#include "SickProfileCache.hh"
+#include "SickScanView.hh"
 
 #include "SickLMS2xxBufferMonitor.hh"
 #include "SickLMS2xxMessage.hh"
@@ -35,6 +37,7 @@
 #define DEFAULT_SICK_LMS_2XX_SICK_SWITCH_MODE_TIMEOUT            (unsigned int)(3e6)  ///< Can take the Sick LD up to 3 seconds to reply (usecs)
 #define DEFAULT_SICK_LMS_2XX_SICK_MEAN_VALUES_MESSAGE_TIMEOUT   (unsigned int)(15e6)  ///< When using mean values, the Sick can sometimes take more than 10s to respond
 #define DEFAULT_SICK_LMS_2XX_SICK_CONFIG_MESSAGE_TIMEOUT        (unsigned int)(15e6)  ///< The sick can take some time to respond to config commands (usecs)
+#define DEFAULT_SICK_LMS_2XX_BAUD_PROBE_TIMEOUT                (unsigned int)(150e3)  ///< First wait for a baud probe reply; doubled each pass up to the message timeout (usecs)
 #define DEFAULT_SICK_LMS_2XX_BYTE_INTERVAL                                      (55)  ///< Minimum time in microseconds between transmitted bytes
 #define DEFAULT_SICK_LMS_2XX_NUM_TRIES                                           (3)  ///< The max number of tries before giving up on a request
     
@@ -594,6 +597,11 @@ namespace SickToolbox {
 		      unsigned int * const sick_telegram_index = NULL,
 		      unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
 
+    /** Gets measurement data from the Sick and lends out the driver's buffer (no copy) */
+    void GetSickScan( SickScanLease< uint16_t > &scan_lease,
+		      unsigned int * const sick_telegram_index = NULL,
+		      unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+
     /** Gets measurement data from the Sick. NOTE: Data can be either range or reflectivity given the Sick mode. */
     void GetSickScanSubrange( const uint16_t sick_subrange_start_index,
 			      const uint16_t sick_subrange_stop_index,
@@ -658,6 +666,12 @@ namespace SickToolbox {
     /** Print the Sick LMS configuration */
     void PrintSickConfig( ) const;
 
+    /** Enables the persistent device-profile cache (must be called before Initialize) */
+    void SetProfileCacheDirectory( const std::string cache_dir );
+
+    /** Enables the low-latency serial mode (must be called before Initialize) */
+    void SetLowLatencySerial( const bool low_latency );
+
     /*
      * NOTE: The following methods are given to make working with our
      *       predefined types a bit more manageable.
@@ -704,6 +718,9 @@ namespace SickToolbox {
 
   protected:
 
+    /** Lets the parser benchmark call the telegram parsers directly */
+    friend class SickParserBenchmark;
+
     /** A path to the device at which the sick can be accessed. */
     std::string _sick_device_path;
 
@@ -740,6 +757,15 @@ namespace SickToolbox {
     /** The device configuration for the Sick */
     sick_lms_2xx_device_config_t _sick_device_config;
 
+    /** Cached type from a previous run (disabled by default) */
+    SickProfileCache _sick_profile_cache;
+
+    /** The most recent scan profile acquired through a SickScanLease */
+    sick_lms_2xx_scan_profile_b0_t _sick_scan_profile;
+
+    /** Indicates whether _sick_scan_profile is currently lent out */
+    bool _sick_scan_leased;
+
     /** Used when the device is streaming mean values */
     uint8_t _sick_mean_value_sample_size;
 
@@ -752,6 +778,9 @@ namespace SickToolbox {
     /** Stores information about the original terminal settings */
     struct termios _old_term;
 
+    /** Whether the serial port is run for low latency (see SetLowLatencySerial) */
+    bool _sick_low_latency;
+
     /** Opens the terminal for serial communication. */
     void _setupConnection() throw( SickIOException, SickThreadException );
     void _setupConnection(const uint32_t delay ) throw( SickIOException, SickThreadException );
@@ -779,7 +808,12 @@ namespace SickToolbox {
     void _setSessionBaud( const sick_lms_2xx_baud_t baud_rate ) throw( SickIOException, SickThreadException, SickTimeoutException );
 
     /** Tests communication wit the LMS at a particular baud rate. */
-    bool _testSickBaud( const sick_lms_2xx_baud_t baud_rate ) throw( SickIOException, SickThreadException );
+    bool _testSickBaud( const sick_lms_2xx_baud_t baud_rate,
+			const unsigned int timeout_value = DEFAULT_SICK_LMS_2XX_SICK_MESSAGE_TIMEOUT,
+			const unsigned int num_tries = DEFAULT_SICK_LMS_2XX_NUM_TRIES ) throw( SickIOException, SickThreadException );
+
+    /** Finds the baud rate the LMS is at, trying the likeliest first */
+    sick_lms_2xx_baud_t _detectSickBaud( const sick_lms_2xx_baud_t hint_baud ) throw( SickIOException, SickThreadException );
 
     /** Changes the terminal's baud rate. */
     void _setTerminalBaud( const sick_lms_2xx_baud_t sick_baud ) throw( SickIOException, SickThreadException );
@@ -790,6 +824,18 @@ namespace SickToolbox {
     /** Gets the current Sick configuration settings */
     void _getSickConfig( ) throw( SickTimeoutException, SickIOException, SickThreadException );
 
+    /** Restores the type from the profile cache if the device fingerprint matches */
+    bool _loadProfileCache( );
+
+    /** Writes the current type to the profile cache */
+    void _storeProfileCache( );
+
+    /** Returns the baud rate the LMS was last seen at (from the profile cache) */
+    sick_lms_2xx_baud_t _loadBaudHint( );
+
+    /** Records the current session baud in the profile cache */
+    void _storeBaudHint( );
+
     /** Sets the Sick configuration in flash */
     void _setSickConfig( const sick_lms_2xx_device_config_t &sick_config ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
     
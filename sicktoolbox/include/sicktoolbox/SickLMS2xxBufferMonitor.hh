@@ -19,6 +19,9 @@
 #define SICK_LMS_2XX_BUFFER_MONITOR_HH
 
 #define DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT      (35000)  ///< Max allowable time between consecutive bytes
+#define SICK_LMS_2XX_CRC_SEGMENT_LENGTH                (32)  ///< Payload bytes read before the running CRC is brought up to date
+#define SICK_LMS_2XX_MAX_READ_MINIMUM                 (255)  ///< Largest VMIN a terminal takes (low-latency mode)
+#define SICK_LMS_2XX_READ_GAP_TIMEOUT                   (1)  ///< Inter-byte timeout of a blocking read (VTIME, 1/10 sec; low-latency mode)
 
 /* Definition dependencies */
 #include "SickLMS2xxMessage.hh"
@@ -41,9 +44,26 @@ namespace SickToolbox {
     /** A method for extracting a single message from the stream */
     void GetNextMessageFromDataStream( SickLMS2xxMessage &sick_message ) throw( SickIOException );
 
+    /** Switches the low-latency serial mode on or off */
+    void SetLowLatency( const bool low_latency ) throw( SickThreadException );
+
     /** A standard destructor */
     ~SickLMS2xxBufferMonitor( );
 
+  private:
+
+    /** Whether frames are read w/ blocking reads of all the bytes still missing */
+    bool _low_latency;
+
+    /** The VMIN the data stream was last given (0 if unknown) */
+    unsigned int _read_minimum;
+
+    /** Reads the given number of bytes w/ blocking reads (low-latency mode) */
+    void _readBlocking( uint8_t * const dest_buffer, const unsigned int num_bytes_to_read ) throw( SickTimeoutException, SickIOException );
+
+    /** Sets VMIN (and VTIME) of the data stream if it changed */
+    void _setReadMinimum( const unsigned int read_minimum ) throw( SickIOException );
+
   };
     
 } /* namespace SickToolbox */
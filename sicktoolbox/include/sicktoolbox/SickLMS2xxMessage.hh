@@ -34,6 +34,31 @@
 /* Associate the namespace */
 namespace SickToolbox {
 
+  /**
+   * \struct sick_lms_2xx_crc_tag
+   * \brief A CRC16 that is brought up to date as the frame arrives
+   */
+  /**
+   * \typedef sick_lms_2xx_crc_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_lms_2xx_crc_tag {
+    uint16_t crc;                                              ///< CRC16 of the bytes so far
+    uint8_t last_byte;                                         ///< The byte before the next one (every step mixes in two)
+  } sick_lms_2xx_crc_t;
+
+  /**
+   * \brief Starts a CRC16 at the first byte of a frame
+   * \param &sick_crc The running CRC
+   */
+  inline void sick_lms_2xx_crc_init( sick_lms_2xx_crc_t &sick_crc ) {
+    sick_crc.crc = 0;
+    sick_crc.last_byte = 0;
+  }
+
+  /** Feeds the next bytes of a frame to a running CRC16 (the same CRC whichever way the frame is split) */
+  void sick_lms_2xx_crc_update( sick_lms_2xx_crc_t &sick_crc, const uint8_t * data, unsigned int data_length );
+
   /**
    * \brief A class to represent all messages sent to and from the Sick LMS 2xx
    *
@@ -90,7 +115,7 @@ namespace SickToolbox {
   private:
 
     /** Computes the checksum of the frame. */
-    uint16_t _computeCRC( uint8_t * data, unsigned int data_length ) const;
+    uint16_t _computeCRC( const uint8_t * data, unsigned int data_length ) const;
 
   };
 
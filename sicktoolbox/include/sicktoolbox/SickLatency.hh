@@ -0,0 +1,407 @@
+/*!
+ * \file SickLatency.hh
+ * \brief Defines the end-to-end latency tracepoints and the lock-free
+ *        per-driver histograms they are recorded in.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_LATENCY_HH
+#define SICK_LATENCY_HH
+
+/* Macros */
+#define SICK_LATENCY_SUB_BUCKET_BITS                          (5)  ///< 32 linear sub-buckets per power of two (~3% resolution)
+#define SICK_LATENCY_MAX_MAGNITUDE                           (37)  ///< Largest tracked value is 2^37 nsec (~137 sec)
+#define SICK_LATENCY_NUM_BUCKETS \
+  ((SICK_LATENCY_MAX_MAGNITUDE - SICK_LATENCY_SUB_BUCKET_BITS + 3) << (SICK_LATENCY_SUB_BUCKET_BITS - 1))  ///< Buckets per histogram
+
+/*
+ * The tracepoints.  Unless the toolbox (and the code using it) is built
+ * w/ SICK_LATENCY_TRACING defined they expand to nothing, and neither the
+ * messages nor the drivers carry any latency state.
+ */
+#ifdef SICK_LATENCY_TRACING
+#define SICK_LATENCY_STAMP(message,stage)           (message).SetLatencyStamp((stage),SickToolbox::sick_latency_time_nsec())
+#define SICK_LATENCY_RECORD(histograms,message)     (histograms).Record((message).GetLatencyStamps(),SickToolbox::sick_latency_time_nsec())
+#define SICK_LATENCY_LABEL(histograms,label)        (histograms).SetLabel(label)
+#else
+#define SICK_LATENCY_STAMP(message,stage)           ((void)0)
+#define SICK_LATENCY_RECORD(histograms,message)     ((void)0)
+#define SICK_LATENCY_LABEL(histograms,label)        ((void)0)
+#endif
+
+/* Definition dependencies */
+#include <string>
+#include <iomanip>
+#include <iostream>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \enum sick_latency_stage_t
+   * \brief The points a telegram passes on its way to the caller
+   */
+  enum sick_latency_stage_t {
+    SICK_LATENCY_FIRST_BYTE = 0,                               ///< The monitor read the telegram's first byte
+    SICK_LATENCY_FRAME_COMPLETE,                               ///< The monitor assembled the whole frame
+    SICK_LATENCY_QUEUE_PUBLISH,                                ///< The monitor published it to the message container
+    SICK_LATENCY_CONSUMER_DEQUEUE,                             ///< The driver took it from the container
+    SICK_LATENCY_PARSE_COMPLETE,                               ///< The driver parsed the payload
+    SICK_LATENCY_USER_RETURN,                                  ///< The driver returned the data to the caller
+    SICK_LATENCY_NUM_STAGES
+  };
+
+  /**
+   * \enum sick_latency_interval_t
+   * \brief The histograms kept per driver (stage i to stage i+1, plus end-to-end)
+   */
+  enum sick_latency_interval_t {
+    SICK_LATENCY_READ = 0,                                     ///< First byte -> frame complete
+    SICK_LATENCY_HANDOFF,                                      ///< Frame complete -> queue publish
+    SICK_LATENCY_QUEUED,                                       ///< Queue publish -> consumer dequeue
+    SICK_LATENCY_PARSE,                                        ///< Consumer dequeue -> parse complete
+    SICK_LATENCY_DELIVER,                                      ///< Parse complete -> user return
+    SICK_LATENCY_TOTAL,                                        ///< First byte -> user return
+    SICK_LATENCY_NUM_INTERVALS
+  };
+
+  /** Returns a monotonic time stamp (nsec) */
+  inline uint64_t sick_latency_time_nsec( ) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    return (uint64_t)now.tv_sec*1000000000ULL + now.tv_nsec;
+  }
+
+  /**
+   * \class SickLatencyHistogram
+   * \brief An HDR-style (log-linear) histogram of nsec values
+   *
+   * Values below 2^SICK_LATENCY_SUB_BUCKET_BITS get a bucket each; above
+   * that every power of two is split into 2^(SICK_LATENCY_SUB_BUCKET_BITS-1)
+   * equal buckets, so the relative error stays below ~3% up to the
+   * largest tracked value.  Recording is a handful of atomic adds and
+   * never blocks, so any thread may record while another one reads.
+   */
+  class SickLatencyHistogram {
+
+  public:
+
+    /** A standard constructor */
+    SickLatencyHistogram( ) { Reset(); }
+
+    /** Adds a value (nsec) */
+    void Record( const uint64_t value ) {
+
+      __sync_fetch_and_add(&_counts[_bucketIndex(value)],1);
+      __sync_fetch_and_add(&_total_count,1);
+      __sync_fetch_and_add(&_total_nsec,value);
+
+      /* Raise the maximum unless another thread got there first */
+      uint64_t max_nsec = _max_nsec;
+      while (value > max_nsec) {
+	const uint64_t prev_max_nsec = __sync_val_compare_and_swap(&_max_nsec,max_nsec,value);
+	if (prev_max_nsec == max_nsec) {
+	  break;
+	}
+	max_nsec = prev_max_nsec;
+      }
+
+    }
+
+    /** Returns the number of recorded values */
+    uint64_t GetCount( ) const { return _total_count; }
+
+    /** Returns the largest recorded value (nsec) */
+    uint64_t GetMax( ) const { return _max_nsec; }
+
+    /** Returns the mean of the recorded values (nsec) */
+    double GetMean( ) const { return _total_count ? (double)_total_nsec/_total_count : 0; }
+
+    /** Returns the value below which the given percentage of recorded values fall (nsec) */
+    uint64_t GetPercentile( const double percentile ) const;
+
+    /** Clears the histogram */
+    void Reset( ) {
+      memset(_counts,0,sizeof(_counts));
+      _total_count = _total_nsec = _max_nsec = 0;
+    }
+
+  private:
+
+    /** Recorded values per bucket */
+    uint32_t _counts[SICK_LATENCY_NUM_BUCKETS];
+
+    /** Number of recorded values */
+    uint64_t _total_count;
+
+    /** Sum of the recorded values (nsec) */
+    uint64_t _total_nsec;
+
+    /** Largest recorded value (nsec) */
+    uint64_t _max_nsec;
+
+    /** Maps a value to its bucket */
+    static unsigned int _bucketIndex( const uint64_t value );
+
+    /** Returns the highest value that maps to the given bucket */
+    static uint64_t _bucketHighestValue( const unsigned int bucket_index );
+
+  };
+
+  /**
+   * \class SickLatencyHistograms
+   * \brief The per-interval histograms of one driver instance
+   *
+   * Drivers stamp every scan telegram as it passes the stages above
+   * (the stamps travel inside the message) and record it here when the
+   * data is handed to the caller.  The histograms can be read at any
+   * time (see SickLIDAR::GetLatencyHistograms) and are printed to
+   * std::cerr on the next recorded telegram after the signal installed
+   * w/ DumpOnSignal() arrives.
+   */
+  class SickLatencyHistograms {
+
+  public:
+
+    /** A standard constructor */
+    SickLatencyHistograms( ) : _label("sick"), _dump_generation(_dumpRequests()) { }
+
+    /** Names the histograms in dumps */
+    void SetLabel( const std::string &label ) { _label = label; }
+
+    /** Returns the label */
+    const std::string & GetLabel( ) const { return _label; }
+
+    /** Records the intervals between the given stamps (nsec, 0 if a stage was not stamped) */
+    void Record( const uint64_t * const stage_stamps, const uint64_t return_nsec );
+
+    /** Returns the histogram of an interval */
+    const SickLatencyHistogram & GetHistogram( const sick_latency_interval_t interval ) const { return _histograms[interval]; }
+
+    /** Prints count, mean, percentiles and max per interval (usec) */
+    void Print( std::ostream &out ) const;
+
+    /** Clears all histograms */
+    void Reset( ) {
+      for (unsigned int i = 0; i < SICK_LATENCY_NUM_INTERVALS; i++) {
+	_histograms[i].Reset();
+      }
+    }
+
+    /** Returns the name of an interval */
+    static const char * IntervalToString( const sick_latency_interval_t interval );
+
+    /** Dumps every driver's histograms when the given signal (e.g. SIGUSR1) arrives */
+    static void DumpOnSignal( const int signal_number );
+
+  private:
+
+    /** The histograms, indexed by sick_latency_interval_t */
+    SickLatencyHistogram _histograms[SICK_LATENCY_NUM_INTERVALS];
+
+    /** The name used in dumps */
+    std::string _label;
+
+    /** The dump request last served */
+    sig_atomic_t _dump_generation;
+
+    /** Counts the dump signals received (the handler only bumps this) */
+    static volatile sig_atomic_t & _dumpRequests( ) {
+      static volatile sig_atomic_t dump_requests = 0;
+      return dump_requests;
+    }
+
+    /** The signal handler */
+    static void _dumpSignalHandler( int ) { _dumpRequests()++; }
+
+  };
+
+  /**
+   * \brief Returns the value below which the given percentage of recorded values fall
+   * \param percentile The percentage (0 - 100)
+   * \return The upper bound of the bucket holding the percentile (nsec)
+   */
+  inline uint64_t SickLatencyHistogram::GetPercentile( const double percentile ) const {
+
+    /* The rank of the requested value (at least the first one) */
+    const uint64_t total_count = _total_count;
+    uint64_t rank = (uint64_t)(percentile/100.0*total_count + 0.5);
+    rank = (rank < 1) ? 1 : rank;
+
+    uint64_t running_count = 0;
+    for (unsigned int i = 0; i < SICK_LATENCY_NUM_BUCKETS; i++) {
+      running_count += _counts[i];
+      if (running_count >= rank) {
+	const uint64_t highest_value = _bucketHighestValue(i);
+	return (highest_value < _max_nsec) ? highest_value : _max_nsec;
+      }
+    }
+
+    return _max_nsec;
+  }
+
+  /**
+   * \brief Maps a value to its bucket
+   * \param value The value (nsec)
+   * \return The bucket index (values past the tracked range land in the last bucket)
+   */
+  inline unsigned int SickLatencyHistogram::_bucketIndex( const uint64_t value ) {
+
+    const unsigned int half_sub_buckets = 1 << (SICK_LATENCY_SUB_BUCKET_BITS - 1);
+
+    /* Small values are counted exactly */
+    if (value < (1ULL << SICK_LATENCY_SUB_BUCKET_BITS)) {
+      return (unsigned int)value;
+    }
+
+    /* The top SICK_LATENCY_SUB_BUCKET_BITS bits select the bucket */
+    const unsigned int magnitude = 63 - __builtin_clzll(value);
+    if (magnitude > SICK_LATENCY_MAX_MAGNITUDE) {
+      return SICK_LATENCY_NUM_BUCKETS - 1;
+    }
+
+    const unsigned int shift = magnitude - (SICK_LATENCY_SUB_BUCKET_BITS - 1);
+    return shift*half_sub_buckets + (unsigned int)(value >> shift);
+  }
+
+  /**
+   * \brief Returns the highest value that maps to the given bucket
+   * \param bucket_index The bucket
+   * \return The value (nsec)
+   */
+  inline uint64_t SickLatencyHistogram::_bucketHighestValue( const unsigned int bucket_index ) {
+
+    const unsigned int half_sub_buckets = 1 << (SICK_LATENCY_SUB_BUCKET_BITS - 1);
+
+    if (bucket_index < 2*half_sub_buckets) {
+      return bucket_index;
+    }
+
+    /* Invert _bucketIndex() */
+    const unsigned int shift = bucket_index/half_sub_buckets - 1;
+    const uint64_t sub_bucket = bucket_index%half_sub_buckets + half_sub_buckets;
+    return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  /**
+   * \brief Records the intervals between the stamps of one telegram
+   * \param *stage_stamps The stamps (nsec) indexed by sick_latency_stage_t (0 if a stage was not stamped)
+   * \param return_nsec The time the data is returned to the caller (nsec)
+   */
+  inline void SickLatencyHistograms::Record( const uint64_t * const stage_stamps, const uint64_t return_nsec ) {
+
+    /* The caller's stamp closes the chain */
+    uint64_t stamps[SICK_LATENCY_NUM_STAGES];
+    memcpy(stamps,stage_stamps,sizeof(stamps));
+    stamps[SICK_LATENCY_USER_RETURN] = return_nsec;
+
+    /* Adjacent stages (skipping any that were not stamped) */
+    for (unsigned int i = 0; i < SICK_LATENCY_USER_RETURN; i++) {
+      if (stamps[i] && stamps[i+1] && stamps[i+1] >= stamps[i]) {
+	_histograms[i].Record(stamps[i+1] - stamps[i]);
+      }
+    }
+
+    /* End-to-end */
+    if (stamps[SICK_LATENCY_FIRST_BYTE] && return_nsec >= stamps[SICK_LATENCY_FIRST_BYTE]) {
+      _histograms[SICK_LATENCY_TOTAL].Record(return_nsec - stamps[SICK_LATENCY_FIRST_BYTE]);
+    }
+
+    /* Serve a pending dump request from the caller's thread (never from the handler) */
+    const sig_atomic_t dump_generation = _dumpRequests();
+    if (dump_generation != _dump_generation) {
+      _dump_generation = dump_generation;
+      Print(std::cerr);
+    }
+
+  }
+
+  /**
+   * \brief Prints count, mean, percentiles and max per interval
+   * \param &out The output stream
+   */
+  inline void SickLatencyHistograms::Print( std::ostream &out ) const {
+
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+
+    out << "Latency (usec) for " << _label << ":" << std::endl
+	<< std::left << std::setw(10) << "interval" << std::right
+	<< std::setw(10) << "count" << std::setw(10) << "mean" << std::setw(10) << "p50"
+	<< std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::endl;
+
+    out << std::fixed << std::setprecision(1);
+    for (unsigned int i = 0; i < SICK_LATENCY_NUM_INTERVALS; i++) {
+      const SickLatencyHistogram &histogram = _histograms[i];
+      out << std::left << std::setw(10) << IntervalToString((sick_latency_interval_t)i) << std::right
+	  << std::setw(10) << histogram.GetCount()
+	  << std::setw(10) << histogram.GetMean()/1e3
+	  << std::setw(10) << histogram.GetPercentile(50)/1e3
+	  << std::setw(10) << histogram.GetPercentile(90)/1e3
+	  << std::setw(10) << histogram.GetPercentile(99)/1e3
+	  << std::setw(10) << histogram.GetPercentile(99.9)/1e3
+	  << std::setw(10) << histogram.GetMax()/1e3 << std::endl;
+    }
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  /**
+   * \brief Returns the name of an interval
+   * \param interval The interval
+   * \return The name
+   */
+  inline const char * SickLatencyHistograms::IntervalToString( const sick_latency_interval_t interval ) {
+
+    switch (interval) {
+    case SICK_LATENCY_READ:
+      return "read";
+    case SICK_LATENCY_HANDOFF:
+      return "handoff";
+    case SICK_LATENCY_QUEUED:
+      return "queued";
+    case SICK_LATENCY_PARSE:
+      return "parse";
+    case SICK_LATENCY_DELIVER:
+      return "deliver";
+    case SICK_LATENCY_TOTAL:
+      return "total";
+    default:
+      return "unknown";
+    }
+
+  }
+
+  /**
+   * \brief Dumps every driver's histograms when the given signal arrives
+   * \param signal_number The signal (e.g. SIGUSR1)
+   *
+   * NOTE: The handler only bumps a counter.  Each driver prints its
+   *       histograms to std::cerr the next time it records a telegram.
+   */
+  inline void SickLatencyHistograms::DumpOnSignal( const int signal_number ) {
+
+    struct sigaction signal_action;
+    memset(&signal_action,0,sizeof(signal_action));
+    signal_action.sa_handler = SickLatencyHistograms::_dumpSignalHandler;
+    sigemptyset(&signal_action.sa_mask);
+    signal_action.sa_flags = SA_RESTART;
+    sigaction(signal_number,&signal_action,NULL);
+
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_LATENCY_HH */
@@ -20,6 +20,7 @@
 #include <arpa/inet.h>
 #include <iomanip>
 #include <iostream>
+#include "SickLatency.hh"
 
 /* Associate the namespace */
 namespace SickToolbox {
@@ -76,6 +77,14 @@ namespace SickToolbox {
     /** Print the contents of the message */
     virtual void Print( ) const;
 
+#ifdef SICK_LATENCY_TRACING
+    /** Stamps a stage of the receive path (see SickLatency.hh) */
+    void SetLatencyStamp( const sick_latency_stage_t stage, const uint64_t stamp_nsec ) { _latency_stamps[stage] = stamp_nsec; }
+
+    /** Returns the stage stamps (nsec, indexed by sick_latency_stage_t) */
+    const uint64_t * GetLatencyStamps( ) const { return _latency_stamps; }
+#endif
+
     /** A virtual destructor */
     virtual ~SickMessage( );
 
@@ -93,6 +102,11 @@ namespace SickToolbox {
     /** Indicates whether the message container/object is populated */
     bool _populated;
 
+#ifdef SICK_LATENCY_TRACING
+    /** When the message passed each stage of the receive path (nsec, 0 if not yet) */
+    uint64_t _latency_stamps[SICK_LATENCY_NUM_STAGES];
+#endif
+
   };
 
 
@@ -100,7 +114,11 @@ namespace SickToolbox {
    * \brief A default constructor
    */
   template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
-  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::SickMessage( ) { }
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::SickMessage( ) {
+#ifdef SICK_LATENCY_TRACING
+    memset(_latency_stamps,0,sizeof(_latency_stamps));
+#endif
+  }
 
   /**
    * \brief Constructs a Sick message given the parameter values
@@ -192,6 +210,10 @@ namespace SickToolbox {
 
     /* Set the flag indicating this message object/container is empty */
     _populated = false;
+
+#ifdef SICK_LATENCY_TRACING
+    memset(_latency_stamps,0,sizeof(_latency_stamps));
+#endif
   }
   
   /**
@@ -0,0 +1,239 @@
+/*!
+ * \file SickMonitorGroup.hh
+ * \brief Defines a single I/O thread that assembles the telegrams of
+ *        several devices.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_MONITOR_GROUP_HH
+#define SICK_MONITOR_GROUP_HH
+
+/* Definition dependencies */
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <sys/time.h>
+#include <pthread.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include "SickException.hh"
+
+/* Macros */
+#define SICK_MONITOR_GROUP_POLL_TIMEOUT                  (50000)  ///< Longest wait for a readable device (usec); bounds how long Add()/Remove() take to be seen
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \struct sick_polled_monitor_tag
+   * \brief A buffer monitor as the group sees it
+   */
+  /**
+   * \typedef sick_polled_monitor_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_polled_monitor_tag {
+    void *monitor;                                             ///< The monitor instance (passed to poll)
+    int fd;                                                    ///< The data stream the group waits on
+    bool (*poll)( void * monitor );                            ///< Assembles and publishes the telegram that is arriving (false if the last one is still waiting for the driver or the read failed)
+  } sick_polled_monitor_t;
+
+  /**
+   * \class SickMonitorGroup
+   * \brief Waits on the data streams of several devices from one thread
+   *
+   * Every registered monitor is pumped once its descriptor turns
+   * readable, so N devices cost one thread (and one stack) instead of N.
+   * The thread runs while at least one monitor is registered.  Remove()
+   * waits for a pump that is in progress, so a monitor may be destroyed
+   * as soon as it returns.  A monitor whose last telegram has not been
+   * taken by the driver yet is passed over, so telegrams that arrive
+   * back to back (an acknowledgement, then the data) wait in the socket
+   * instead of overwriting each other.
+   *
+   * NOTE: A pump reads the whole telegram before the next device gets a
+   *       turn, so this suits monitors that frame what is waiting (NAV350,
+   *       LD, LMS 2xx).  The LMS 1xx monitor flushes before every scan and
+   *       should keep its own thread.
+   */
+  class SickMonitorGroup {
+
+  public:
+
+    /** A standard constructor */
+    SickMonitorGroup( ) throw( SickThreadException ) : _group_thread_id(0), _running(false) {
+
+      /* Initialize the membership mutex */
+      if (pthread_mutex_init(&_monitors_mutex,NULL) != 0) {
+	throw SickThreadException("SickMonitorGroup::SickMonitorGroup: pthread_mutex_init() failed!");
+      }
+
+    }
+
+    /** Registers a monitor (starts the thread w/ the first one) */
+    void Add( const sick_polled_monitor_t &sick_monitor ) throw( SickThreadException ) {
+
+      _lock();
+      _monitors.push_back(sick_monitor);
+
+      if (!_running) {
+	if (pthread_create(&_group_thread_id,NULL,SickMonitorGroup::_groupThread,this) != 0) {
+	  _monitors.pop_back();
+	  _unlock();
+	  throw SickThreadException("SickMonitorGroup::Add: pthread_create() failed!");
+	}
+	_running = true;
+      }
+      _unlock();
+
+    }
+
+    /** Unregisters a monitor (stops the thread w/ the last one) */
+    void Remove( const void * const monitor ) throw( SickThreadException ) {
+
+      /* Holding the lock means no pump is in progress */
+      _lock();
+      for (unsigned int i = 0; i < _monitors.size(); i++) {
+	if (_monitors[i].monitor == monitor) {
+	  _monitors.erase(_monitors.begin()+i);
+	  break;
+	}
+      }
+
+      const bool stop_thread = _running && _monitors.empty();
+      if (stop_thread) {
+	_running = false;
+      }
+      _unlock();
+
+      /* Wait for the thread to exit */
+      if (stop_thread && pthread_join(_group_thread_id,NULL) != 0) {
+	throw SickThreadException("SickMonitorGroup::Remove: pthread_join() failed!");
+      }
+
+    }
+
+    /** Returns the number of registered monitors */
+    unsigned int GetNumMonitors( ) {
+      _lock();
+      const unsigned int num_monitors = _monitors.size();
+      _unlock();
+      return num_monitors;
+    }
+
+    /** A standard destructor (monitors must have been removed) */
+    ~SickMonitorGroup( ) {
+      pthread_mutex_destroy(&_monitors_mutex);
+    }
+
+  private:
+
+    /** The registered monitors (guarded by the membership mutex) */
+    std::vector< sick_polled_monitor_t > _monitors;
+
+    /** Guards the membership and is held while a monitor is pumped */
+    pthread_mutex_t _monitors_mutex;
+
+    /** The I/O thread */
+    pthread_t _group_thread_id;
+
+    /** Whether the I/O thread should keep running */
+    bool _running;
+
+    /** Locks the membership */
+    void _lock( ) throw( SickThreadException ) {
+      if (pthread_mutex_lock(&_monitors_mutex) != 0) {
+	throw SickThreadException("SickMonitorGroup::_lock: pthread_mutex_lock() failed!");
+      }
+    }
+
+    /** Unlocks the membership */
+    void _unlock( ) throw( SickThreadException ) {
+      if (pthread_mutex_unlock(&_monitors_mutex) != 0) {
+	throw SickThreadException("SickMonitorGroup::_unlock: pthread_mutex_unlock() failed!");
+      }
+    }
+
+    /** Entry point for the I/O thread */
+    static void * _groupThread( void * thread_args ) {
+
+      SickMonitorGroup *sick_monitor_group = (SickMonitorGroup *)thread_args;
+      std::vector< sick_polled_monitor_t > &monitors = sick_monitor_group->_monitors;
+
+      for (;;) {
+
+	try {
+
+	  /* Wait on whoever is registered right now */
+	  fd_set file_desc_set;
+	  FD_ZERO(&file_desc_set);
+	  int max_fd = -1;
+
+	  sick_monitor_group->_lock();
+	  if (!sick_monitor_group->_running) {
+	    sick_monitor_group->_unlock();
+	    break;
+	  }
+	  for (unsigned int i = 0; i < monitors.size(); i++) {
+	    FD_SET(monitors[i].fd,&file_desc_set);
+	    max_fd = std::max(max_fd,monitors[i].fd);
+	  }
+	  sick_monitor_group->_unlock();
+
+	  struct timeval timeout_val;
+	  timeout_val.tv_sec = 0;
+	  timeout_val.tv_usec = SICK_MONITOR_GROUP_POLL_TIMEOUT;
+	  if (select(max_fd+1,&file_desc_set,0,0,&timeout_val) <= 0) {
+	    continue;
+	  }
+
+	  /* Pump the readable ones (skipping any removed in the meantime) */
+	  bool pumped = false;
+	  sick_monitor_group->_lock();
+	  for (unsigned int i = 0; i < monitors.size(); i++) {
+	    if (FD_ISSET(monitors[i].fd,&file_desc_set)) {
+	      pumped |= monitors[i].poll(monitors[i].monitor);
+	    }
+	  }
+	  sick_monitor_group->_unlock();
+
+	  /* Give the drivers a moment to take what is waiting */
+	  if (!pumped) {
+	    usleep(1000);
+	  }
+
+	}
+
+	/* Catch any thread exceptions */
+	catch(SickThreadException &sick_thread_exception) {
+	  std::cerr << sick_thread_exception.what() << std::endl;
+	}
+
+	/* A failsafe */
+	catch(...) {
+	  std::cerr << "SickMonitorGroup::_groupThread: Unknown exception!" << std::endl;
+	}
+
+      }
+
+      /* Thread is done */
+      return NULL;
+
+    }
+
+    /** Groups are not copyable */
+    SickMonitorGroup( const SickMonitorGroup & );
+    SickMonitorGroup & operator=( const SickMonitorGroup & );
+
+  };
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_MONITOR_GROUP_HH */
@@ -42,6 +42,7 @@
 #include "sicktoolbox/SickLIDAR.hh"
 #include "sicktoolbox/SickNAV350BufferMonitor.hh"
 #include "sicktoolbox/SickNAV350Message.hh"
+#include "sicktoolbox/SickScanView.hh"
 #include "sicktoolbox/SickException.hh"
 #define SICK_MAX_NUM_REFLECTORS 50
 /**
@@ -248,12 +249,11 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
       unsigned int num_data_points;                                                       ///< The number of data points in the scan area
       unsigned int timestamp_start;                                                       ///< The timestamp (in ms) corresponding to the time the first measurement in the sector was taken 
       unsigned int timestamp_stop;                                                        ///< The timestamp (in ms) corresponding to the time the last measurement in the sector was taken
-      unsigned int echo_values[SICK_MAX_NUM_MEASUREMENTS];                                ///< The corresponding echo/reflectivity values
       double angle_step;                                                                  ///< The angle step used for the given sector (this should be the same for all sectors)
       double angle_start;                                                                 ///< The angle at which the first measurement in the sector was acquired
       double angle_stop;                                                                  ///< The angle at which the last measurement in the sector was acquired
-      double range_values[SICK_MAX_NUM_MEASUREMENTS];                                     ///< The corresponding range values (NOTE: The size of this array is intended to be large enough to accomodate various sector configs.)
-      double scan_angles[SICK_MAX_NUM_MEASUREMENTS];                                      ///< The scan angles corresponding to the respective measurements
+      uint32_t range_values[SICK_MAX_NUM_MEASUREMENTS];                                   ///< The raw range values in mm (scan angles follow from angle_start/angle_step)
+      uint16_t echo_values[SICK_MAX_NUM_MEASUREMENTS];                                    ///< The corresponding echo/reflectivity values
     } sick_nav350_sector_data_t;
     
     /**
@@ -344,6 +344,12 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
 
     void GetDataNavigation(int wait,int dataset);
 
+    /** Sends the navigation data request and returns (the reply is picked up by PollDataNavigation) */
+    void RequestDataNavigation(int wait,int dataset);
+
+    /** Parses the reply to RequestDataNavigation if it is in (never blocks; throws once it is overdue) */
+    bool PollDataNavigation( ) throw( SickTimeoutException, SickConfigException );
+
     void DoMapping();
 
     		/**Get Measurements*/
@@ -354,11 +360,17 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
     		unsigned int *sector_start_timestamp,
     		unsigned int *sector_stop_timestamp);
 
+    /** Lends out the most recent measurements (raw mm, no copy) */
+    void GetSickMeasurements( SickScanLease< uint32_t > &scan_lease ) throw( SickConfigException );
+
     /**Send custom message and get response*/
     void GetResponseFromCustomMessage(uint8_t *req,int req_size,uint8_t *res,int *res_size);
 
     void SetSpeed(double x,double y,double phi,int timestamp,int coordbase);
 
+    /** Sends the velocity and returns (PollDataNavigation skips the acknowledgement) */
+    void RequestSetSpeed(double x,double y,double phi,int timestamp,int coordbase);
+
     /** Sequence for reflector mapping */
     void ConfigureMapping(uint8_t mean,uint8_t neg,double x,double y,double phi);
     void SetCurrentLayer(uint16_t currLayer);
@@ -370,6 +382,10 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
     ~SickNav350();
 
   private:
+
+    /** Lets the parser benchmark call the telegram parsers directly */
+    friend class SickParserBenchmark;
+
 	  std::string* arg;
 	  int argumentcount_;
 
@@ -404,6 +420,18 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
     /** The current sector configuration for the unit */
     sick_nav350_config_sector_t _sick_sector_config;
 
+    /** Indicates whether MeasuredData_ is currently lent out through a SickScanLease */
+    bool _sick_scan_leased;
+
+    /** Whether a RequestDataNavigation reply is still outstanding */
+    bool _navigation_request_pending;
+
+    /** When the outstanding navigation data request was sent */
+    struct timeval _navigation_request_time;
+
+    /** Throws if MeasuredData_ is lent out (called before a new scan overwrites it) */
+    void _checkScanLease( const std::string &caller ) const throw( SickConfigException );
+
     /** Setup the connection parameters and establish TCP connection! */
     void _setupConnection( ) throw( SickIOException, SickTimeoutException );
   
@@ -631,11 +659,26 @@ class SickNav350 : public SickLIDAR< SickNav350BufferMonitor, SickNav350Message
 
     void _ParseScanDataNavigation();
 
+    /** Builds the navigation data request */
+    void _buildDataNavigationRequest(int wait,int dataset,SickNav350Message &send_message) const;
+
+    /** Builds the velocity message */
+    void _buildSetSpeedRequest(double x,double y,double phi,int timestamp,int coordbase,SickNav350Message &send_message) const;
+
+    /** Splits and parses a navigation data reply */
+    void _parseDataNavigationReply(SickNav350Message &recv_message);
+
     void _ParseScanDataMapping();
 
     /**Convert Hex to number*/
     int _ConvertHexToDec(std::string num);
 
+    /** Parse a reflector count and clamp it to SICK_MAX_NUM_REFLECTORS */
+    int _ParseReflectorCount(const std::string &num, int &num_reported);
+
+    /** Skip the arguments of one reflector the caller has no room for */
+    void _SkipReflectorData(int &count);
+
   };
 
 
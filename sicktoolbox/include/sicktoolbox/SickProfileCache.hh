@@ -0,0 +1,299 @@
+/*!
+ * \file SickProfileCache.hh
+ * \brief Defines a small persistent store for caching a device's
+ *        identity and configuration between driver runs.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_PROFILE_CACHE_HH
+#define SICK_PROFILE_CACHE_HH
+
+/* Macros */
+#define SICK_PROFILE_CACHE_MAGIC                 "sicktoolbox-profile"  ///< First token of every profile file
+#define SICK_PROFILE_CACHE_VERSION                                 (2)  ///< Bump whenever a cached struct layout changes
+
+/* Definition dependencies */
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \class SickProfileCache
+   * \brief Stores a flat set of named fields for a single device in
+   *        <cache_dir>/<device_key>.profile so that a driver can skip
+   *        its full identity/config sync on restart.
+   *
+   * The cache is disabled until a directory is given.  A driver is
+   * expected to store a cheap fingerprint (e.g. the serial number)
+   * alongside the profile and to compare it against the live device
+   * before trusting any other cached field.
+   */
+  class SickProfileCache {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param cache_dir Directory holding the profile files (empty disables the cache)
+     */
+    SickProfileCache( const std::string cache_dir = "" ) : _cache_dir(cache_dir) { }
+
+    /** Indicates whether a cache directory has been assigned */
+    bool IsEnabled( ) const { return !_cache_dir.empty(); }
+
+    /** Assigns the cache directory (empty disables the cache) */
+    void SetDirectory( const std::string cache_dir ) { _cache_dir = cache_dir; }
+
+    /** Returns the cache directory */
+    std::string GetDirectory( ) const { return _cache_dir; }
+
+    /** Drops all fields held in memory */
+    void Clear( ) { _fields.clear(); }
+
+    /**
+     * \brief Loads the profile for the given device into memory
+     * \param device_key Identifies the device (e.g. IP address or device path)
+     * \return True if a well-formed profile of the current version was read
+     */
+    bool Load( const std::string &device_key ) {
+
+      _fields.clear();
+
+      if (!IsEnabled()) {
+	return false;
+      }
+
+      std::ifstream profile_file(_profilePath(device_key).c_str());
+      if (!profile_file) {
+	return false;
+      }
+
+      /* Check the header line */
+      std::string magic;
+      int version = 0;
+      profile_file >> magic >> version;
+      if (magic != SICK_PROFILE_CACHE_MAGIC || version != SICK_PROFILE_CACHE_VERSION) {
+	return false;
+      }
+
+      /* Each remaining line is "<name> <value>" */
+      std::string line;
+      std::getline(profile_file,line);
+      while (std::getline(profile_file,line)) {
+
+	size_t split = line.find(' ');
+	if (split == std::string::npos || split == 0) {
+	  continue;
+	}
+
+	_fields[line.substr(0,split)] = line.substr(split+1);
+
+      }
+
+      return true;
+    }
+
+    /**
+     * \brief Writes the fields held in memory as the profile of the given device
+     * \param device_key Identifies the device (e.g. IP address or device path)
+     * \return True if the profile was written
+     *
+     * NOTE: The file is written to a temporary and then renamed over the old
+     *       profile so a reader never observes a partially written file.
+     */
+    bool Store( const std::string &device_key ) const {
+
+      if (!IsEnabled()) {
+	return false;
+      }
+
+      /* Create the directory if needed (only the last path component) */
+      if (mkdir(_cache_dir.c_str(),0755) != 0 && errno != EEXIST) {
+	std::cerr << "SickProfileCache::Store: Unable to create " << _cache_dir << std::endl;
+	return false;
+      }
+
+      std::string profile_path = _profilePath(device_key);
+      std::string temp_path = profile_path + ".tmp";
+
+      {
+	std::ofstream profile_file(temp_path.c_str(),std::ios::out | std::ios::trunc);
+	if (!profile_file) {
+	  std::cerr << "SickProfileCache::Store: Unable to write " << temp_path << std::endl;
+	  return false;
+	}
+
+	profile_file << SICK_PROFILE_CACHE_MAGIC << " " << SICK_PROFILE_CACHE_VERSION << std::endl;
+	for (std::map< std::string, std::string >::const_iterator it = _fields.begin(); it != _fields.end(); it++) {
+	  profile_file << it->first << " " << it->second << std::endl;
+	}
+
+	if (!profile_file) {
+	  std::cerr << "SickProfileCache::Store: Unable to write " << temp_path << std::endl;
+	  return false;
+	}
+      }
+
+      if (rename(temp_path.c_str(),profile_path.c_str()) != 0) {
+	std::cerr << "SickProfileCache::Store: Unable to rename " << temp_path << std::endl;
+	remove(temp_path.c_str());
+	return false;
+      }
+
+      return true;
+    }
+
+    /**
+     * \brief Removes the stored profile of the given device (forces a full sync next time)
+     * \param device_key Identifies the device (e.g. IP address or device path)
+     */
+    void Invalidate( const std::string &device_key ) {
+
+      _fields.clear();
+
+      if (IsEnabled()) {
+	remove(_profilePath(device_key).c_str());
+      }
+
+    }
+
+    /**
+     * \brief Sets a string field
+     * \param name The field name (must not contain whitespace)
+     * \param value The field value (must not contain a newline)
+     */
+    void SetString( const std::string &name, const std::string &value ) {
+      _fields[name] = value;
+    }
+
+    /**
+     * \brief Gets a string field
+     * \param name The field name
+     * \param value Destination for the field value
+     * \return True if the field exists
+     */
+    bool GetString( const std::string &name, std::string &value ) const {
+
+      std::map< std::string, std::string >::const_iterator it = _fields.find(name);
+      if (it == _fields.end()) {
+	return false;
+      }
+
+      value = it->second;
+      return true;
+    }
+
+    /**
+     * \brief Stores an array of numbers as a space-separated list
+     * \param name The field name
+     * \param values The values to store (integers or floating point)
+     * \param num_values The number of values
+     *
+     * NOTE: Structs are stored one member per field, so the file never
+     *       depends on their layout or padding.
+     */
+    template < class T >
+    void SetValues( const std::string &name, const T * const values, const unsigned int num_values ) {
+
+      std::ostringstream value_stream;
+      value_stream.precision(17);
+      for (unsigned int i = 0; i < num_values; i++) {
+	value_stream << (i > 0 ? " " : "") << (double)values[i];
+      }
+
+      _fields[name] = value_stream.str();
+    }
+
+    /**
+     * \brief Restores an array of numbers previously stored w/ SetValues
+     * \param name The field name
+     * \param values Destination array (left untouched on failure)
+     * \param num_values The number of values expected
+     * \return True if the field exists and holds exactly num_values numbers
+     */
+    template < class T >
+    bool GetValues( const std::string &name, T * const values, const unsigned int num_values ) const {
+
+      std::string value;
+      if (!GetString(name,value)) {
+	return false;
+      }
+
+      std::vector< double > parsed_values(num_values);
+      std::istringstream value_stream(value);
+      for (unsigned int i = 0; i < num_values; i++) {
+	if (!(value_stream >> parsed_values[i])) {
+	  return false;
+	}
+      }
+
+      /* Nothing may follow the expected values */
+      std::string trailing;
+      if (value_stream >> trailing) {
+	return false;
+      }
+
+      for (unsigned int i = 0; i < num_values; i++) {
+	values[i] = (T)parsed_values[i];
+      }
+
+      return true;
+    }
+
+    /** Stores a single number (see SetValues) */
+    template < class T >
+    void SetValue( const std::string &name, const T &value ) { SetValues(name,&value,1); }
+
+    /** Restores a single number (see GetValues) */
+    template < class T >
+    bool GetValue( const std::string &name, T &value ) const { return GetValues(name,&value,1); }
+
+  private:
+
+    /** The directory holding the profile files */
+    std::string _cache_dir;
+
+    /** The fields of the currently loaded profile */
+    std::map< std::string, std::string > _fields;
+
+    /**
+     * \brief Maps a device key onto a file name (e.g. "/dev/ttyUSB0" -> "_dev_ttyUSB0.profile")
+     * \param device_key Identifies the device
+     */
+    std::string _profilePath( const std::string &device_key ) const {
+
+      std::string file_name = device_key;
+      for (unsigned int i = 0; i < file_name.length(); i++) {
+	char c = file_name[i];
+	if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '-')) {
+	  file_name[i] = '_';
+	}
+      }
+
+      return _cache_dir + "/" + file_name + ".profile";
+    }
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_PROFILE_CACHE_HH */
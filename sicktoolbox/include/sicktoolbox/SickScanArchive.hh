@@ -0,0 +1,580 @@
+/*!
+ * \file SickScanArchive.hh
+ * \brief Defines a compact, streamable archive format for scans
+ *        (delta + varint coded ranges, diffed reflector sets).
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_SCAN_ARCHIVE_HH
+#define SICK_SCAN_ARCHIVE_HH
+
+/* Macros */
+#define SICK_SCAN_ARCHIVE_MAGIC                           "SICKARC1"  ///< First 8 bytes of every archive
+#define SICK_SCAN_ARCHIVE_MAX_VALUES                          (2881)  ///< Default largest scan
+#define SICK_SCAN_ARCHIVE_MAX_REFLECTORS                        (64)  ///< Largest reflector set
+#define SICK_SCAN_ARCHIVE_KEYFRAME_INTERVAL                    (100)  ///< Default scans between keyframes
+#define SICK_SCAN_ARCHIVE_NUM_REFLECTOR_FIELDS                   (6)  ///< Fields per archived reflector
+
+/* Frame flags */
+#define SICK_SCAN_ARCHIVE_FLAG_KEYFRAME                       (0x01)  ///< Ranges/echoes/reflectors are not deltas against the previous scan
+#define SICK_SCAN_ARCHIVE_FLAG_ECHOES                         (0x02)  ///< The frame carries echo values
+#define SICK_SCAN_ARCHIVE_FLAG_REFLECTORS                     (0x04)  ///< The frame carries a reflector set
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdint.h>
+#include "SickException.hh"
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \struct sick_archive_reflector_tag
+   * \brief A reflector as stored in the archive (device units)
+   */
+  /**
+   * \typedef sick_archive_reflector_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_archive_reflector_tag {
+    int32_t global_id;                                         ///< Global landmark id
+    int32_t x;                                                 ///< Cartesian x (mm)
+    int32_t y;                                                 ///< Cartesian y (mm)
+    int32_t dist;                                              ///< Polar distance (mm)
+    int32_t phi;                                               ///< Polar angle (mdeg)
+    int32_t quality;                                           ///< Detection quality
+  } sick_archive_reflector_t;
+
+  /**
+   * \struct sick_archive_scan_tag
+   * \brief One archived scan. Buffers are owned by the caller when
+   *        writing and by the reader (until its next Next()) when reading.
+   *
+   * The buffer types follow the driver so a scan is written straight from
+   * its buffers: uint32_t/uint16_t for the NAV350 (sick_archive_scan_t),
+   * uint16_t/uint16_t for the LD and LMS 2xx, unsigned int/unsigned int
+   * for the LMS 1xx.  The reader always returns sick_archive_scan_t.
+   */
+  template < class RANGE_T = uint32_t, class ECHO_T = uint16_t >
+  struct sick_archive_scan_tag {
+    uint64_t timestamp_usec;                                   ///< Host time since the epoch (usec)
+    uint32_t device_timestamp;                                 ///< Device timestamp (device units)
+    int32_t angle_start;                                       ///< Angle of the first value (mdeg)
+    int32_t angle_step;                                        ///< Angle between values (mdeg)
+    uint32_t num_values;                                       ///< Number of range values
+    const RANGE_T *range_values;                               ///< Raw ranges (device units)
+    const ECHO_T *echo_values;                                 ///< Raw echoes (NULL if none; up to 16 bits are kept)
+    uint32_t num_reflectors;                                   ///< Number of reflectors (0 if none)
+    const sick_archive_reflector_t *reflectors;                ///< The reflector set (NULL if none)
+  };
+
+  /**
+   * \typedef sick_archive_scan_t
+   * \brief Adopt c-style convention (the NAV350's buffer types)
+   */
+  typedef sick_archive_scan_tag< > sick_archive_scan_t;
+
+  /** Maps a signed value onto an unsigned one so that small magnitudes stay small */
+  inline uint64_t sick_archive_zigzag( const int64_t value ) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+
+  /** Inverts sick_archive_zigzag */
+  inline int64_t sick_archive_unzigzag( const uint64_t value ) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+  /** Appends a LEB128 varint */
+  inline void sick_archive_put_varint( uint8_t *&dest, uint64_t value ) {
+    while (value >= 0x80) {
+      *dest++ = (uint8_t)(value | 0x80);
+      value >>= 7;
+    }
+    *dest++ = (uint8_t)value;
+  }
+
+  /** Reads a LEB128 varint (false if it runs past end) */
+  inline bool sick_archive_get_varint( const uint8_t *&src, const uint8_t * const end, uint64_t &value ) {
+    value = 0;
+    for (unsigned int shift = 0; src < end && shift < 64; shift += 7) {
+      uint8_t byte = *src++;
+      value |= (uint64_t)(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+	return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * \brief Appends residuals as run-length coded zigzag varints
+   *
+   * Each token is a varint whose low bit selects between a literal
+   * (zigzag residual << 1) and a run of zero residuals ((run-1) << 1 | 1).
+   */
+  template < class T, class REF_T >
+  inline void sick_archive_put_residuals( uint8_t *&dest, const T * const values, const REF_T * const reference, const unsigned int num_values ) {
+
+    unsigned int zero_run = 0;
+    for (unsigned int i = 0; i < num_values; i++) {
+
+      int64_t residual = (int64_t)values[i] - (reference ? (int64_t)reference[i] : (i > 0 ? (int64_t)values[i-1] : 0));
+      if (residual == 0) {
+	zero_run++;
+	continue;
+      }
+
+      if (zero_run > 0) {
+	sick_archive_put_varint(dest,((uint64_t)(zero_run - 1) << 1) | 1);
+	zero_run = 0;
+      }
+
+      sick_archive_put_varint(dest,sick_archive_zigzag(residual) << 1);
+    }
+
+    if (zero_run > 0) {
+      sick_archive_put_varint(dest,((uint64_t)(zero_run - 1) << 1) | 1);
+    }
+
+  }
+
+  /** Inverts sick_archive_put_residuals (false on a malformed frame) */
+  template < class T >
+  inline bool sick_archive_get_residuals( const uint8_t *&src, const uint8_t * const end, T * const values,
+					  const T * const reference, const unsigned int num_values ) {
+
+    unsigned int i = 0;
+    while (i < num_values) {
+
+      uint64_t token = 0;
+      if (!sick_archive_get_varint(src,end,token)) {
+	return false;
+      }
+
+      if (token & 1) {
+
+	uint64_t run = (token >> 1) + 1;
+	if (run > num_values - i) {
+	  return false;
+	}
+
+	for (; run > 0; run--, i++) {
+	  values[i] = reference ? reference[i] : (i > 0 ? values[i-1] : 0);
+	}
+
+      }
+      else {
+	values[i] = (T)((reference ? (int64_t)reference[i] : (i > 0 ? (int64_t)values[i-1] : 0)) + sick_archive_unzigzag(token >> 1));
+	i++;
+      }
+
+    }
+
+    return true;
+  }
+
+  /**
+   * \class SickScanArchiveWriter
+   * \brief Appends scans to an archive
+   *
+   * Ranges and echoes are coded against the previous scan (or spatially in
+   * keyframes), reflector sets field-by-field against the previous set.
+   * Memory use is fixed at construction; per-scan CPU is one pass over the
+   * values.
+   */
+  class SickScanArchiveWriter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param keyframe_interval Scans between self-contained keyframes (bounds the loss from a corrupt frame)
+     * \param max_values Largest scan that will be written
+     */
+    SickScanArchiveWriter( const unsigned int keyframe_interval = SICK_SCAN_ARCHIVE_KEYFRAME_INTERVAL,
+			   const unsigned int max_values = SICK_SCAN_ARCHIVE_MAX_VALUES ) :
+      _archive_file(NULL), _keyframe_interval(keyframe_interval ? keyframe_interval : 1), _max_values(max_values),
+      _frames_since_keyframe(0), _bytes_written(0), _prev_has_echoes(false),
+      _frame(_maxFrameLength(max_values)), _prev_ranges(max_values), _prev_echoes(max_values),
+      _prev_reflectors(SICK_SCAN_ARCHIVE_MAX_REFLECTORS) {
+      memset(&_prev_scan,0,sizeof(sick_archive_scan_t));
+    }
+
+    /** A standard destructor */
+    ~SickScanArchiveWriter( ) { Close(); }
+
+    /**
+     * \brief Opens (creating or appending to) an archive
+     * \param archive_path Path of the archive
+     */
+    void Open( const std::string &archive_path ) throw( SickIOException ) {
+
+      Close();
+
+      if ((_archive_file = fopen(archive_path.c_str(),"ab")) == NULL) {
+	throw SickIOException("SickScanArchiveWriter::Open: Unable to open " + archive_path);
+      }
+
+      /* Write the header to a new archive */
+      fseek(_archive_file,0,SEEK_END);
+      if (ftell(_archive_file) == 0 && fwrite(SICK_SCAN_ARCHIVE_MAGIC,8,1,_archive_file) != 1) {
+	Close();
+	throw SickIOException("SickScanArchiveWriter::Open: fwrite() failed!");
+      }
+
+      /* The first frame of every session is a keyframe */
+      _frames_since_keyframe = _keyframe_interval;
+    }
+
+    /** Flushes and closes the archive */
+    void Close( ) {
+      if (_archive_file) {
+	fclose(_archive_file);
+	_archive_file = NULL;
+      }
+    }
+
+    /** Indicates whether an archive is open */
+    bool IsOpen( ) const { return _archive_file != NULL; }
+
+    /** Returns the number of bytes written since construction */
+    uint64_t GetBytesWritten( ) const { return _bytes_written; }
+
+    /**
+     * \brief Appends a scan
+     * \param &scan The scan (num_values is clipped to max_values; num_reflectors to SICK_SCAN_ARCHIVE_MAX_REFLECTORS)
+     */
+    template < class RANGE_T, class ECHO_T >
+    void Write( const sick_archive_scan_tag< RANGE_T, ECHO_T > &scan ) throw( SickIOException ) {
+
+      if (!_archive_file) {
+	throw SickIOException("SickScanArchiveWriter::Write: Archive not open!");
+      }
+
+      const uint32_t num_values = (scan.num_values < _max_values) ? scan.num_values : _max_values;
+      const uint32_t num_reflectors = (scan.reflectors == NULL) ? 0 :
+	((scan.num_reflectors < SICK_SCAN_ARCHIVE_MAX_REFLECTORS) ? scan.num_reflectors : SICK_SCAN_ARCHIVE_MAX_REFLECTORS);
+
+      /* Start a new keyframe periodically or whenever the geometry changes */
+      const bool keyframe = (_frames_since_keyframe >= _keyframe_interval || num_values != _prev_scan.num_values ||
+			     (scan.echo_values != NULL) != _prev_has_echoes);
+
+      uint8_t flags = (keyframe ? SICK_SCAN_ARCHIVE_FLAG_KEYFRAME : 0) | (scan.echo_values ? SICK_SCAN_ARCHIVE_FLAG_ECHOES : 0) |
+	(num_reflectors > 0 ? SICK_SCAN_ARCHIVE_FLAG_REFLECTORS : 0);
+
+      uint8_t *dest = &_frame[0];
+      *dest++ = flags;
+
+      /* Scan header (deltas against the previous scan) */
+      sick_archive_put_varint(dest,sick_archive_zigzag((int64_t)(scan.timestamp_usec - (keyframe ? 0 : _prev_scan.timestamp_usec))));
+      sick_archive_put_varint(dest,sick_archive_zigzag((int64_t)scan.device_timestamp - (keyframe ? 0 : (int64_t)_prev_scan.device_timestamp)));
+      sick_archive_put_varint(dest,sick_archive_zigzag(scan.angle_start));
+      sick_archive_put_varint(dest,sick_archive_zigzag(scan.angle_step));
+      sick_archive_put_varint(dest,num_values);
+
+      /* Ranges and echoes */
+      sick_archive_put_residuals(dest,scan.range_values,(keyframe ? (const uint32_t *)NULL : &_prev_ranges[0]),num_values);
+      if (scan.echo_values) {
+	sick_archive_put_residuals(dest,scan.echo_values,(keyframe ? (const uint32_t *)NULL : &_prev_echoes[0]),num_values);
+      }
+
+      /* Reflectors (each field against the same slot of the previous set) */
+      if (num_reflectors > 0) {
+
+	sick_archive_put_varint(dest,num_reflectors);
+	for (unsigned int i = 0; i < num_reflectors; i++) {
+
+	  const int32_t *fields = (const int32_t *)&scan.reflectors[i];
+	  const int32_t *prev_fields = (!keyframe && i < _prev_scan.num_reflectors) ? (const int32_t *)&_prev_reflectors[i] : NULL;
+	  for (unsigned int j = 0; j < SICK_SCAN_ARCHIVE_NUM_REFLECTOR_FIELDS; j++) {
+	    sick_archive_put_varint(dest,sick_archive_zigzag((int64_t)fields[j] - (prev_fields ? prev_fields[j] : 0)));
+	  }
+
+	}
+
+      }
+
+      /* Emit the frame (length prefixed so a reader can skip it) */
+      uint8_t length_buffer[10];
+      uint8_t *length_dest = length_buffer;
+      const uint64_t frame_length = dest - &_frame[0];
+      sick_archive_put_varint(length_dest,frame_length);
+
+      if (fwrite(length_buffer,length_dest - length_buffer,1,_archive_file) != 1 ||
+	  fwrite(&_frame[0],frame_length,1,_archive_file) != 1) {
+	throw SickIOException("SickScanArchiveWriter::Write: fwrite() failed!");
+      }
+
+      _bytes_written += (length_dest - length_buffer) + frame_length;
+
+      /* Remember this scan for the next delta */
+      std::copy(scan.range_values,scan.range_values + num_values,_prev_ranges.begin());
+      if (scan.echo_values) {
+	std::copy(scan.echo_values,scan.echo_values + num_values,_prev_echoes.begin());
+      }
+      if (num_reflectors > 0) {
+	memcpy(&_prev_reflectors[0],scan.reflectors,num_reflectors*sizeof(sick_archive_reflector_t));
+      }
+
+      _prev_scan.timestamp_usec = scan.timestamp_usec;
+      _prev_scan.device_timestamp = scan.device_timestamp;
+      _prev_scan.num_values = num_values;
+      _prev_scan.num_reflectors = num_reflectors;
+      _prev_has_echoes = scan.echo_values != NULL;
+      _frames_since_keyframe = keyframe ? 1 : _frames_since_keyframe + 1;
+    }
+
+  private:
+
+    /** The archive */
+    FILE *_archive_file;
+
+    /** Scans between keyframes */
+    unsigned int _keyframe_interval;
+
+    /** Largest scan */
+    unsigned int _max_values;
+
+    /** Frames written since the last keyframe */
+    unsigned int _frames_since_keyframe;
+
+    /** Bytes written since construction */
+    uint64_t _bytes_written;
+
+    /** The previous scan's header fields (its buffers are not kept) */
+    sick_archive_scan_t _prev_scan;
+
+    /** Whether the previous scan carried echoes */
+    bool _prev_has_echoes;
+
+    /** The frame being encoded (sized for the worst case) */
+    std::vector< uint8_t > _frame;
+
+    /** The previous scan's ranges */
+    std::vector< uint32_t > _prev_ranges;
+
+    /** The previous scan's echoes (wide enough for any driver's echo type) */
+    std::vector< uint32_t > _prev_echoes;
+
+    /** The previous scan's reflectors */
+    std::vector< sick_archive_reflector_t > _prev_reflectors;
+
+    /** Worst-case encoded frame length */
+    static unsigned int _maxFrameLength( const unsigned int max_values ) {
+      return 1 + 5*10 + 10 + max_values*(10 + 10) + 10 + SICK_SCAN_ARCHIVE_MAX_REFLECTORS*SICK_SCAN_ARCHIVE_NUM_REFLECTOR_FIELDS*10;
+    }
+
+    /** Writers are not copyable */
+    SickScanArchiveWriter( const SickScanArchiveWriter & );
+    SickScanArchiveWriter & operator=( const SickScanArchiveWriter & );
+
+  };
+
+  /**
+   * \class SickScanArchiveReader
+   * \brief Streams scans back out of an archive
+   *
+   * Delta frames that arrive before any keyframe (or after a corrupt
+   * frame) are skipped until the next keyframe.
+   */
+  class SickScanArchiveReader {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param max_values Largest scan that will be read
+     */
+    SickScanArchiveReader( const unsigned int max_values = SICK_SCAN_ARCHIVE_MAX_VALUES ) :
+      _archive_file(NULL), _max_values(max_values), _synchronized(false),
+      _frame(1 + 5*10 + 10 + max_values*(10 + 10) + 10 + SICK_SCAN_ARCHIVE_MAX_REFLECTORS*SICK_SCAN_ARCHIVE_NUM_REFLECTOR_FIELDS*10),
+      _ranges(max_values), _echoes(max_values), _reflectors(SICK_SCAN_ARCHIVE_MAX_REFLECTORS) {
+      memset(&_scan,0,sizeof(sick_archive_scan_t));
+    }
+
+    /** A standard destructor */
+    ~SickScanArchiveReader( ) { Close(); }
+
+    /**
+     * \brief Opens an archive
+     * \param archive_path Path of the archive
+     */
+    void Open( const std::string &archive_path ) throw( SickIOException ) {
+
+      Close();
+
+      if ((_archive_file = fopen(archive_path.c_str(),"rb")) == NULL) {
+	throw SickIOException("SickScanArchiveReader::Open: Unable to open " + archive_path);
+      }
+
+      char magic[8];
+      if (fread(magic,8,1,_archive_file) != 1 || memcmp(magic,SICK_SCAN_ARCHIVE_MAGIC,8) != 0) {
+	Close();
+	throw SickIOException("SickScanArchiveReader::Open: Not a scan archive - " + archive_path);
+      }
+
+      _synchronized = false;
+    }
+
+    /** Closes the archive */
+    void Close( ) {
+      if (_archive_file) {
+	fclose(_archive_file);
+	_archive_file = NULL;
+      }
+    }
+
+    /**
+     * \brief Decodes the next scan
+     * \param &scan Receives the scan (buffers valid until the next call)
+     * \return False at the end of the archive
+     */
+    bool Next( sick_archive_scan_t &scan ) {
+
+      while (_archive_file) {
+
+	/* Read the frame length */
+	uint64_t frame_length = 0;
+	unsigned int shift = 0;
+	int byte = 0;
+	do {
+	  if ((byte = fgetc(_archive_file)) == EOF || shift >= 64) {
+	    return false;
+	  }
+	  frame_length |= (uint64_t)(byte & 0x7F) << shift;
+	  shift += 7;
+	} while (byte & 0x80);
+
+	if (frame_length == 0 || frame_length > _frame.size()) {
+	  /* Nothing sensible can follow a bad length */
+	  return false;
+	}
+
+	if (fread(&_frame[0],frame_length,1,_archive_file) != 1) {
+	  return false;
+	}
+
+	if (_decodeFrame(&_frame[0],&_frame[0] + frame_length)) {
+	  scan = _scan;
+	  return true;
+	}
+
+	/* Resynchronize on the next keyframe */
+	_synchronized = false;
+      }
+
+      return false;
+    }
+
+  private:
+
+    /** The archive */
+    FILE *_archive_file;
+
+    /** Largest scan */
+    unsigned int _max_values;
+
+    /** Indicates whether the previous frame decoded (deltas can be applied) */
+    bool _synchronized;
+
+    /** The last decoded scan */
+    sick_archive_scan_t _scan;
+
+    /** The frame being decoded */
+    std::vector< uint8_t > _frame;
+
+    /** Decoded ranges (also the reference for the next delta) */
+    std::vector< uint32_t > _ranges;
+
+    /** Decoded echoes */
+    std::vector< uint16_t > _echoes;
+
+    /** Decoded reflectors */
+    std::vector< sick_archive_reflector_t > _reflectors;
+
+    /** Decodes one frame into _scan (false if it is malformed or cannot be applied) */
+    bool _decodeFrame( const uint8_t *src, const uint8_t * const end ) {
+
+      const uint8_t flags = *src++;
+      const bool keyframe = (flags & SICK_SCAN_ARCHIVE_FLAG_KEYFRAME) != 0;
+
+      if (!keyframe && !_synchronized) {
+	return false;
+      }
+
+      uint64_t timestamp_delta = 0, device_timestamp_delta = 0, angle_start = 0, angle_step = 0, num_values = 0;
+      if (!sick_archive_get_varint(src,end,timestamp_delta) || !sick_archive_get_varint(src,end,device_timestamp_delta) ||
+	  !sick_archive_get_varint(src,end,angle_start) || !sick_archive_get_varint(src,end,angle_step) ||
+	  !sick_archive_get_varint(src,end,num_values) || num_values > _max_values ||
+	  (!keyframe && num_values != _scan.num_values)) {
+	return false;
+      }
+
+      _scan.timestamp_usec = (keyframe ? 0 : _scan.timestamp_usec) + sick_archive_unzigzag(timestamp_delta);
+      _scan.device_timestamp = (uint32_t)((keyframe ? 0 : (int64_t)_scan.device_timestamp) + sick_archive_unzigzag(device_timestamp_delta));
+      _scan.angle_start = (int32_t)sick_archive_unzigzag(angle_start);
+      _scan.angle_step = (int32_t)sick_archive_unzigzag(angle_step);
+      _scan.num_values = (uint32_t)num_values;
+
+      /* Ranges and echoes are decoded in place over the previous scan */
+      if (!sick_archive_get_residuals(src,end,&_ranges[0],(keyframe ? (const uint32_t *)NULL : &_ranges[0]),_scan.num_values)) {
+	return false;
+      }
+      _scan.range_values = &_ranges[0];
+
+      _scan.echo_values = NULL;
+      if (flags & SICK_SCAN_ARCHIVE_FLAG_ECHOES) {
+	if (!sick_archive_get_residuals(src,end,&_echoes[0],(keyframe ? (const uint16_t *)NULL : &_echoes[0]),_scan.num_values)) {
+	  return false;
+	}
+	_scan.echo_values = &_echoes[0];
+      }
+
+      const uint32_t prev_num_reflectors = keyframe ? 0 : _scan.num_reflectors;
+      _scan.num_reflectors = 0;
+      _scan.reflectors = NULL;
+      if (flags & SICK_SCAN_ARCHIVE_FLAG_REFLECTORS) {
+
+	uint64_t num_reflectors = 0;
+	if (!sick_archive_get_varint(src,end,num_reflectors) || num_reflectors > SICK_SCAN_ARCHIVE_MAX_REFLECTORS) {
+	  return false;
+	}
+
+	for (unsigned int i = 0; i < num_reflectors; i++) {
+
+	  int32_t *fields = (int32_t *)&_reflectors[i];
+	  const bool has_prev = i < prev_num_reflectors;
+	  for (unsigned int j = 0; j < SICK_SCAN_ARCHIVE_NUM_REFLECTOR_FIELDS; j++) {
+	    uint64_t field_delta = 0;
+	    if (!sick_archive_get_varint(src,end,field_delta)) {
+	      return false;
+	    }
+	    fields[j] = (int32_t)((has_prev ? fields[j] : 0) + sick_archive_unzigzag(field_delta));
+	  }
+
+	}
+
+	_scan.num_reflectors = (uint32_t)num_reflectors;
+	_scan.reflectors = &_reflectors[0];
+      }
+
+      _synchronized = (src == end);
+      return _synchronized;
+    }
+
+    /** Readers are not copyable */
+    SickScanArchiveReader( const SickScanArchiveReader & );
+    SickScanArchiveReader & operator=( const SickScanArchiveReader & );
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_SCAN_ARCHIVE_HH */
@@ -0,0 +1,321 @@
+/*!
+ * \file SickScanConverter.hh
+ * \brief Defines a polar-to-Cartesian conversion stage for the
+ *        scans returned by the drivers.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_SCAN_CONVERTER_HH
+#define SICK_SCAN_CONVERTER_HH
+
+/* Macros */
+#define SICK_SCAN_CONVERTER_MAX_TABLES                              (16)  ///< Cached angle tables before the cache is flushed
+#define SICK_SCAN_CONVERTER_DEG_TO_RAD   (0.017453292519943295769236907684886)  ///< Degrees to radians
+
+/* Definition dependencies */
+#include <map>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <stdint.h>
+#include "SickScanView.hh"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SICK_SCAN_CONVERTER_AVX
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SICK_SCAN_CONVERTER_NEON
+#endif
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \class SickScanConverter
+   * \brief Converts polar scans (range + angle_start/angle_step) into
+   *        structure-of-arrays float x/y buffers.
+   *
+   * The sin/cos of every beam angle is computed once per distinct
+   * (angle_start, angle_step, num_values) triple -- i.e. once per LD
+   * sector config, LMS variant or NAV350 resolution -- and reused for
+   * every later scan with the same geometry.  The mounting yaw is folded
+   * into the tables, so each point costs two multiply-adds (vectorized w/
+   * AVX or NEON when the compiler targets them).
+   *
+   * Points whose range falls outside [min_range,max_range] are written as
+   * NaN and flagged 0 in the optional validity mask.
+   */
+  class SickScanConverter {
+
+  public:
+
+    /** A standard constructor */
+    SickScanConverter( ) : _unit_scale(1.0), _min_range(0.0), _max_range(std::numeric_limits< double >::max()),
+			   _offset_x(0.0), _offset_y(0.0), _offset_yaw(0.0) { }
+
+    /**
+     * \brief Sets the sensor's mounting pose in the output frame
+     * \param offset_x Translation along x (output units)
+     * \param offset_y Translation along y (output units)
+     * \param offset_yaw Rotation about z (deg)
+     */
+    void SetMountingTransform( const double offset_x, const double offset_y, const double offset_yaw ) {
+
+      /* The tables depend on the yaw */
+      if (offset_yaw != _offset_yaw) {
+	_tables.clear();
+      }
+
+      _offset_x = offset_x;
+      _offset_y = offset_y;
+      _offset_yaw = offset_yaw;
+    }
+
+    /**
+     * \brief Sets the valid range interval (in output units); points outside it are masked
+     * \param min_range Smallest valid range (e.g. > 0 to drop "no return" values)
+     * \param max_range Largest valid range
+     */
+    void SetRangeLimits( const double min_range, const double max_range ) {
+      _min_range = min_range;
+      _max_range = max_range;
+    }
+
+    /**
+     * \brief Sets an extra factor applied to every range (e.g. 0.001 for NAV350 mm -> m)
+     * \param unit_scale Multiplier from the view's range units to the output units
+     */
+    void SetUnitScale( const double unit_scale ) { _unit_scale = unit_scale; }
+
+    /** Drops all cached angle tables */
+    void ClearTables( ) { _tables.clear(); }
+
+    /**
+     * \brief Converts a single sector view
+     * \param &scan_view The sector to convert
+     * \param *x_values Destination x buffer (must hold scan_view.Size() values)
+     * \param *y_values Destination y buffer (must hold scan_view.Size() values)
+     * \param *valid_mask Optional destination mask (1 = valid point, 0 = masked)
+     * \return The number of valid points
+     */
+    template < class RANGE_T >
+    unsigned int Convert( const SickScanView< RANGE_T > &scan_view, float * const x_values, float * const y_values,
+			  uint8_t * const valid_mask = NULL ) {
+
+      /* Expand the raw ranges into output units */
+      _ranges.resize(scan_view.Size());
+      const float scale = (float)(scan_view.range_scale*_unit_scale);
+      for (unsigned int i = 0; i < scan_view.Size(); i++) {
+	_ranges[i] = (float)scan_view.range_values[i]*scale;
+      }
+
+      return _convert(scan_view.Size() ? &_ranges[0] : NULL,scan_view.Size(),scan_view.angle_start,scan_view.angle_step,
+		      x_values,y_values,valid_mask);
+    }
+
+    /**
+     * \brief Converts every sector held by a lease into consecutive output entries
+     * \param &scan_lease The leased scan
+     * \param *x_values Destination x buffer (must hold scan_lease.GetNumValues() values)
+     * \param *y_values Destination y buffer (must hold scan_lease.GetNumValues() values)
+     * \param *valid_mask Optional destination mask (1 = valid point, 0 = masked)
+     * \return The number of valid points
+     */
+    template < class RANGE_T >
+    unsigned int Convert( const SickScanLease< RANGE_T > &scan_lease, float * const x_values, float * const y_values,
+			  uint8_t * const valid_mask = NULL ) {
+
+      unsigned int num_valid = 0;
+      for (unsigned int i = 0, offset = 0; i < scan_lease.GetNumSectors(); i++) {
+	num_valid += Convert(scan_lease.GetSector(i),&x_values[offset],&y_values[offset],(valid_mask ? &valid_mask[offset] : NULL));
+	offset += scan_lease.GetSector(i).Size();
+      }
+
+      return num_valid;
+    }
+
+    /**
+     * \brief Converts a range array as returned by the copying driver APIs
+     * \param *range_values The ranges (already in the desired units before SetUnitScale)
+     * \param num_values Number of ranges
+     * \param angle_start Angle of the first range (deg)
+     * \param angle_step Angle between consecutive ranges (deg)
+     * \param *x_values Destination x buffer (must hold num_values values)
+     * \param *y_values Destination y buffer (must hold num_values values)
+     * \param *valid_mask Optional destination mask (1 = valid point, 0 = masked)
+     * \return The number of valid points
+     */
+    template < class T >
+    unsigned int Convert( const T * const range_values, const unsigned int num_values,
+			  const double angle_start, const double angle_step,
+			  float * const x_values, float * const y_values, uint8_t * const valid_mask = NULL ) {
+      return Convert(SickScanView< T >(range_values,NULL,num_values,1.0,angle_start,angle_step,0,0),x_values,y_values,valid_mask);
+    }
+
+  private:
+
+    /** Identifies a scan geometry */
+    typedef struct sick_scan_geometry_tag {
+      double angle_start;                                      ///< Angle of the first value (deg)
+      double angle_step;                                       ///< Angle between values (deg)
+      unsigned int num_values;                                 ///< Number of values
+
+      bool operator<( const sick_scan_geometry_tag &other ) const {
+	if (angle_start != other.angle_start) {
+	  return angle_start < other.angle_start;
+	}
+	if (angle_step != other.angle_step) {
+	  return angle_step < other.angle_step;
+	}
+	return num_values < other.num_values;
+      }
+    } sick_scan_geometry_t;
+
+    /** Precomputed cos/sin of every beam angle (yaw included) */
+    typedef struct sick_scan_angle_table_tag {
+      std::vector< float > cos_values;                         ///< cos(angle_i + yaw)
+      std::vector< float > sin_values;                         ///< sin(angle_i + yaw)
+    } sick_scan_angle_table_t;
+
+    /** Multiplier from view units to output units */
+    double _unit_scale;
+
+    /** Smallest valid range (output units) */
+    double _min_range;
+
+    /** Largest valid range (output units) */
+    double _max_range;
+
+    /** Mounting x offset (output units) */
+    double _offset_x;
+
+    /** Mounting y offset (output units) */
+    double _offset_y;
+
+    /** Mounting yaw (deg) */
+    double _offset_yaw;
+
+    /** Angle tables keyed by scan geometry */
+    std::map< sick_scan_geometry_t, sick_scan_angle_table_t > _tables;
+
+    /** Scratch buffer for the expanded ranges (capacity is kept across scans) */
+    std::vector< float > _ranges;
+
+    /** Returns (building if needed) the angle table for a geometry */
+    const sick_scan_angle_table_t & _getTable( const double angle_start, const double angle_step, const unsigned int num_values ) {
+
+      sick_scan_geometry_t geometry;
+      geometry.angle_start = angle_start;
+      geometry.angle_step = angle_step;
+      geometry.num_values = num_values;
+
+      std::map< sick_scan_geometry_t, sick_scan_angle_table_t >::iterator it = _tables.find(geometry);
+      if (it != _tables.end()) {
+	return it->second;
+      }
+
+      /* Bound the cache in case the geometry keeps changing */
+      if (_tables.size() >= SICK_SCAN_CONVERTER_MAX_TABLES) {
+	_tables.clear();
+      }
+
+      sick_scan_angle_table_t &table = _tables[geometry];
+      table.cos_values.resize(num_values);
+      table.sin_values.resize(num_values);
+      for (unsigned int i = 0; i < num_values; i++) {
+	double angle = (angle_start + i*angle_step + _offset_yaw)*SICK_SCAN_CONVERTER_DEG_TO_RAD;
+	table.cos_values[i] = (float)cos(angle);
+	table.sin_values[i] = (float)sin(angle);
+      }
+
+      return table;
+    }
+
+    /** Converts ranges (output units) using the cached tables */
+    unsigned int _convert( const float * const ranges, const unsigned int num_values,
+			   const double angle_start, const double angle_step,
+			   float * const x_values, float * const y_values, uint8_t * const valid_mask ) {
+
+      if (num_values == 0) {
+	return 0;
+      }
+
+      const sick_scan_angle_table_t &table = _getTable(angle_start,angle_step,num_values);
+      const float * const cos_values = &table.cos_values[0];
+      const float * const sin_values = &table.sin_values[0];
+
+      const float offset_x = (float)_offset_x;
+      const float offset_y = (float)_offset_y;
+      const float min_range = (float)_min_range;
+      const float max_range = (_max_range > std::numeric_limits< float >::max()) ? std::numeric_limits< float >::max() : (float)_max_range;
+      const float nan_value = std::numeric_limits< float >::quiet_NaN();
+
+      unsigned int i = 0;
+
+#if defined(SICK_SCAN_CONVERTER_AVX)
+      const __m256 v_offset_x = _mm256_set1_ps(offset_x);
+      const __m256 v_offset_y = _mm256_set1_ps(offset_y);
+      const __m256 v_min_range = _mm256_set1_ps(min_range);
+      const __m256 v_max_range = _mm256_set1_ps(max_range);
+      const __m256 v_nan = _mm256_set1_ps(nan_value);
+      for (; i + 8 <= num_values; i += 8) {
+	__m256 v_range = _mm256_loadu_ps(&ranges[i]);
+	__m256 v_valid = _mm256_and_ps(_mm256_cmp_ps(v_range,v_min_range,_CMP_GE_OQ),_mm256_cmp_ps(v_range,v_max_range,_CMP_LE_OQ));
+	__m256 v_x = _mm256_add_ps(_mm256_mul_ps(v_range,_mm256_loadu_ps(&cos_values[i])),v_offset_x);
+	__m256 v_y = _mm256_add_ps(_mm256_mul_ps(v_range,_mm256_loadu_ps(&sin_values[i])),v_offset_y);
+	_mm256_storeu_ps(&x_values[i],_mm256_blendv_ps(v_nan,v_x,v_valid));
+	_mm256_storeu_ps(&y_values[i],_mm256_blendv_ps(v_nan,v_y,v_valid));
+      }
+#elif defined(SICK_SCAN_CONVERTER_NEON)
+      const float32x4_t v_offset_x = vdupq_n_f32(offset_x);
+      const float32x4_t v_offset_y = vdupq_n_f32(offset_y);
+      const float32x4_t v_min_range = vdupq_n_f32(min_range);
+      const float32x4_t v_max_range = vdupq_n_f32(max_range);
+      const float32x4_t v_nan = vdupq_n_f32(nan_value);
+      for (; i + 4 <= num_values; i += 4) {
+	float32x4_t v_range = vld1q_f32(&ranges[i]);
+	uint32x4_t v_valid = vandq_u32(vcgeq_f32(v_range,v_min_range),vcleq_f32(v_range,v_max_range));
+	float32x4_t v_x = vmlaq_f32(v_offset_x,v_range,vld1q_f32(&cos_values[i]));
+	float32x4_t v_y = vmlaq_f32(v_offset_y,v_range,vld1q_f32(&sin_values[i]));
+	vst1q_f32(&x_values[i],vbslq_f32(v_valid,v_x,v_nan));
+	vst1q_f32(&y_values[i],vbslq_f32(v_valid,v_y,v_nan));
+      }
+#endif
+
+      /* Remainder (or everything when no vector unit is targeted) */
+      for (; i < num_values; i++) {
+	if (ranges[i] >= min_range && ranges[i] <= max_range) {
+	  x_values[i] = ranges[i]*cos_values[i] + offset_x;
+	  y_values[i] = ranges[i]*sin_values[i] + offset_y;
+	}
+	else {
+	  x_values[i] = y_values[i] = nan_value;
+	}
+      }
+
+      /* Count the valid points (and fill in the mask if requested) */
+      unsigned int num_valid = 0;
+      for (i = 0; i < num_values; i++) {
+	uint8_t valid = (ranges[i] >= min_range && ranges[i] <= max_range) ? 1 : 0;
+	num_valid += valid;
+	if (valid_mask) {
+	  valid_mask[i] = valid;
+	}
+      }
+
+      return num_valid;
+    }
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_SCAN_CONVERTER_HH */
@@ -0,0 +1,576 @@
+/*!
+ * \file SickScanFilter.hh
+ * \brief Defines a composable, in-place filter chain for the
+ *        scans returned by the drivers.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_SCAN_FILTER_HH
+#define SICK_SCAN_FILTER_HH
+
+/* Macros */
+#define SICK_SCAN_FILTER_MAX_VALUES                               (2881)  ///< Default scratch size (largest sector of any supported device)
+#define SICK_SCAN_FILTER_MAX_WINDOW                                  (9)  ///< Largest median window/depth
+#define SICK_SCAN_FILTER_DEG_TO_RAD (0.017453292519943295769236907684886)  ///< Degrees to radians
+
+/* Definition dependencies */
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define SICK_SCAN_FILTER_AVX
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SICK_SCAN_FILTER_NEON
+#endif
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \class SickScanFilter
+   * \brief Base class for a single in-place filter stage.
+   *
+   * Ranges are float in any unit; a filtered-out value is replaced by NaN
+   * (the same convention SickScanConverter uses for masked points) so that
+   * index <-> angle correspondence is preserved.  Intensities may be NULL.
+   * Stages size their scratch space at construction and never allocate
+   * while filtering.
+   */
+  class SickScanFilter {
+
+  public:
+
+    /** A standard destructor */
+    virtual ~SickScanFilter( ) { }
+
+    /**
+     * \brief Filters a scan in place
+     * \param *ranges The range values
+     * \param *intensities The intensity values (NULL if none)
+     * \param num_values Number of values
+     * \param angle_start Angle of the first value (deg)
+     * \param angle_step Angle between consecutive values (deg)
+     */
+    virtual void Apply( float * const ranges, float * const intensities, const unsigned int num_values,
+			const double angle_start, const double angle_step ) = 0;
+
+  protected:
+
+    /** Returns the NaN used to mark filtered values */
+    static float _invalidValue( ) { return std::numeric_limits< float >::quiet_NaN(); }
+
+    /** Sorts a (tiny) window in place and returns its median */
+    static float _median( float * const window, const unsigned int size ) {
+
+      for (unsigned int i = 1; i < size; i++) {
+	float value = window[i];
+	int j = i - 1;
+	for (; j >= 0 && window[j] > value; j--) {
+	  window[j+1] = window[j];
+	}
+	window[j+1] = value;
+      }
+
+      return window[size/2];
+    }
+
+  };
+
+  /**
+   * \class SickRangeFilter
+   * \brief Invalidates ranges outside [min_range,max_range]
+   */
+  class SickRangeFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param min_range Smallest valid range
+     * \param max_range Largest valid range
+     */
+    SickRangeFilter( const float min_range, const float max_range ) : _min_range(min_range), _max_range(max_range) { }
+
+    void Apply( float * const ranges, float * const /* intensities */, const unsigned int num_values,
+		const double /* angle_start */, const double /* angle_step */ ) {
+
+      const float nan_value = _invalidValue();
+      unsigned int i = 0;
+
+#if defined(SICK_SCAN_FILTER_AVX)
+      const __m256 v_min_range = _mm256_set1_ps(_min_range);
+      const __m256 v_max_range = _mm256_set1_ps(_max_range);
+      const __m256 v_nan = _mm256_set1_ps(nan_value);
+      for (; i + 8 <= num_values; i += 8) {
+	__m256 v_range = _mm256_loadu_ps(&ranges[i]);
+	__m256 v_valid = _mm256_and_ps(_mm256_cmp_ps(v_range,v_min_range,_CMP_GE_OQ),_mm256_cmp_ps(v_range,v_max_range,_CMP_LE_OQ));
+	_mm256_storeu_ps(&ranges[i],_mm256_blendv_ps(v_nan,v_range,v_valid));
+      }
+#elif defined(SICK_SCAN_FILTER_NEON)
+      const float32x4_t v_min_range = vdupq_n_f32(_min_range);
+      const float32x4_t v_max_range = vdupq_n_f32(_max_range);
+      const float32x4_t v_nan = vdupq_n_f32(nan_value);
+      for (; i + 4 <= num_values; i += 4) {
+	float32x4_t v_range = vld1q_f32(&ranges[i]);
+	uint32x4_t v_valid = vandq_u32(vcgeq_f32(v_range,v_min_range),vcleq_f32(v_range,v_max_range));
+	vst1q_f32(&ranges[i],vbslq_f32(v_valid,v_range,v_nan));
+      }
+#endif
+
+      for (; i < num_values; i++) {
+	if (!(ranges[i] >= _min_range && ranges[i] <= _max_range)) {
+	  ranges[i] = nan_value;
+	}
+      }
+
+    }
+
+  private:
+
+    /** Smallest valid range */
+    float _min_range;
+
+    /** Largest valid range */
+    float _max_range;
+
+  };
+
+  /**
+   * \class SickIntensityFilter
+   * \brief Invalidates ranges whose intensity lies outside [min_intensity,max_intensity]
+   */
+  class SickIntensityFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param min_intensity Smallest accepted intensity
+     * \param max_intensity Largest accepted intensity
+     */
+    SickIntensityFilter( const float min_intensity, const float max_intensity = std::numeric_limits< float >::max() ) :
+      _min_intensity(min_intensity), _max_intensity(max_intensity) { }
+
+    void Apply( float * const ranges, float * const intensities, const unsigned int num_values,
+		const double /* angle_start */, const double /* angle_step */ ) {
+
+      /* Nothing to gate on */
+      if (intensities == NULL) {
+	return;
+      }
+
+      const float nan_value = _invalidValue();
+      unsigned int i = 0;
+
+#if defined(SICK_SCAN_FILTER_AVX)
+      const __m256 v_min_intensity = _mm256_set1_ps(_min_intensity);
+      const __m256 v_max_intensity = _mm256_set1_ps(_max_intensity);
+      const __m256 v_nan = _mm256_set1_ps(nan_value);
+      for (; i + 8 <= num_values; i += 8) {
+	__m256 v_intensity = _mm256_loadu_ps(&intensities[i]);
+	__m256 v_valid = _mm256_and_ps(_mm256_cmp_ps(v_intensity,v_min_intensity,_CMP_GE_OQ),
+				       _mm256_cmp_ps(v_intensity,v_max_intensity,_CMP_LE_OQ));
+	_mm256_storeu_ps(&ranges[i],_mm256_blendv_ps(v_nan,_mm256_loadu_ps(&ranges[i]),v_valid));
+      }
+#elif defined(SICK_SCAN_FILTER_NEON)
+      const float32x4_t v_min_intensity = vdupq_n_f32(_min_intensity);
+      const float32x4_t v_max_intensity = vdupq_n_f32(_max_intensity);
+      const float32x4_t v_nan = vdupq_n_f32(nan_value);
+      for (; i + 4 <= num_values; i += 4) {
+	float32x4_t v_intensity = vld1q_f32(&intensities[i]);
+	uint32x4_t v_valid = vandq_u32(vcgeq_f32(v_intensity,v_min_intensity),vcleq_f32(v_intensity,v_max_intensity));
+	vst1q_f32(&ranges[i],vbslq_f32(v_valid,vld1q_f32(&ranges[i]),v_nan));
+      }
+#endif
+
+      for (; i < num_values; i++) {
+	if (!(intensities[i] >= _min_intensity && intensities[i] <= _max_intensity)) {
+	  ranges[i] = nan_value;
+	}
+      }
+
+    }
+
+  private:
+
+    /** Smallest accepted intensity */
+    float _min_intensity;
+
+    /** Largest accepted intensity */
+    float _max_intensity;
+
+  };
+
+  /**
+   * \class SickAngularCropFilter
+   * \brief Invalidates every value whose beam angle lies outside [min_angle,max_angle] (deg)
+   */
+  class SickAngularCropFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param min_angle Smallest kept angle (deg)
+     * \param max_angle Largest kept angle (deg)
+     */
+    SickAngularCropFilter( const double min_angle, const double max_angle ) : _min_angle(min_angle), _max_angle(max_angle) { }
+
+    void Apply( float * const ranges, float * const /* intensities */, const unsigned int num_values,
+		const double angle_start, const double angle_step ) {
+
+      if (num_values == 0 || angle_step == 0) {
+	return;
+      }
+
+      /* Turn the angular window into an index window */
+      double index_a = (_min_angle - angle_start)/angle_step;
+      double index_b = (_max_angle - angle_start)/angle_step;
+      double first = ceil(((index_a < index_b) ? index_a : index_b) - 1e-9);
+      double last = floor(((index_a < index_b) ? index_b : index_a) + 1e-9);
+
+      const unsigned int keep_start = (first <= 0) ? 0 : (first >= num_values ? num_values : (unsigned int)first);
+      const unsigned int keep_stop = (last < 0) ? 0 : (last >= num_values - 1 ? num_values : (unsigned int)last + 1);
+
+      const float nan_value = _invalidValue();
+      for (unsigned int i = 0; i < num_values; i++) {
+	if (i < keep_start || i >= keep_stop) {
+	  ranges[i] = nan_value;
+	}
+      }
+
+    }
+
+  private:
+
+    /** Smallest kept angle (deg) */
+    double _min_angle;
+
+    /** Largest kept angle (deg) */
+    double _max_angle;
+
+  };
+
+  /**
+   * \class SickMedianFilter
+   * \brief Replaces each range with the median of its valid neighbours (spatial median)
+   */
+  class SickMedianFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param window_size Number of neighbouring beams considered (odd, <= SICK_SCAN_FILTER_MAX_WINDOW)
+     * \param max_values Largest scan that will be filtered
+     */
+    SickMedianFilter( const unsigned int window_size = 3, const unsigned int max_values = SICK_SCAN_FILTER_MAX_VALUES ) :
+      _half_window(_clampWindow(window_size)/2), _input(max_values) { }
+
+    void Apply( float * const ranges, float * const /* intensities */, const unsigned int num_values,
+		const double /* angle_start */, const double /* angle_step */ ) {
+
+      const unsigned int n = (num_values < _input.size()) ? num_values : _input.size();
+      if (n == 0) {
+	return;
+      }
+
+      memcpy(&_input[0],ranges,n*sizeof(float));
+
+      float window[SICK_SCAN_FILTER_MAX_WINDOW];
+      for (unsigned int i = 0; i < n; i++) {
+
+	/* Leave invalid values invalid */
+	if (_input[i] != _input[i]) {
+	  continue;
+	}
+
+	unsigned int first = (i < _half_window) ? 0 : i - _half_window;
+	unsigned int last = (i + _half_window >= n) ? n - 1 : i + _half_window;
+
+	unsigned int size = 0;
+	for (unsigned int j = first; j <= last; j++) {
+	  if (_input[j] == _input[j]) {
+	    window[size++] = _input[j];
+	  }
+	}
+
+	ranges[i] = _median(window,size);
+      }
+
+    }
+
+  protected:
+
+    /** Clamps a window size to an odd value in [1,SICK_SCAN_FILTER_MAX_WINDOW] */
+    static unsigned int _clampWindow( const unsigned int window_size ) {
+      unsigned int size = (window_size > SICK_SCAN_FILTER_MAX_WINDOW) ? SICK_SCAN_FILTER_MAX_WINDOW : window_size;
+      return (size == 0) ? 1 : (size | 1);
+    }
+
+  private:
+
+    /** Half of the (odd) window size */
+    unsigned int _half_window;
+
+    /** Copy of the unfiltered ranges */
+    std::vector< float > _input;
+
+  };
+
+  /**
+   * \class SickTemporalMedianFilter
+   * \brief Replaces each range with the median of the same beam over the last few scans
+   */
+  class SickTemporalMedianFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param depth Number of scans considered (<= SICK_SCAN_FILTER_MAX_WINDOW)
+     * \param max_values Largest scan that will be filtered
+     */
+    SickTemporalMedianFilter( const unsigned int depth = 3, const unsigned int max_values = SICK_SCAN_FILTER_MAX_VALUES ) :
+      _depth((depth == 0) ? 1 : (depth > SICK_SCAN_FILTER_MAX_WINDOW ? SICK_SCAN_FILTER_MAX_WINDOW : depth)),
+      _max_values(max_values), _num_values(0), _num_scans(0), _next_scan(0), _history(_depth*max_values) { }
+
+    /** Forgets all previous scans */
+    void Reset( ) { _num_scans = _next_scan = 0; }
+
+    void Apply( float * const ranges, float * const /* intensities */, const unsigned int num_values,
+		const double /* angle_start */, const double /* angle_step */ ) {
+
+      const unsigned int n = (num_values < _max_values) ? num_values : _max_values;
+
+      /* A change in geometry invalidates the history */
+      if (n != _num_values) {
+	Reset();
+	_num_values = n;
+      }
+
+      memcpy(&_history[_next_scan*_max_values],ranges,n*sizeof(float));
+      _next_scan = (_next_scan + 1) % _depth;
+      if (_num_scans < _depth) {
+	_num_scans++;
+      }
+
+      float window[SICK_SCAN_FILTER_MAX_WINDOW];
+      for (unsigned int i = 0; i < n; i++) {
+
+	unsigned int size = 0;
+	for (unsigned int k = 0; k < _num_scans; k++) {
+	  float value = _history[k*_max_values + i];
+	  if (value == value) {
+	    window[size++] = value;
+	  }
+	}
+
+	ranges[i] = (size > 0) ? _median(window,size) : _invalidValue();
+      }
+
+    }
+
+  private:
+
+    /** Number of scans considered */
+    unsigned int _depth;
+
+    /** Values per scan the history can hold */
+    unsigned int _max_values;
+
+    /** Values per scan in the current history */
+    unsigned int _num_values;
+
+    /** Number of scans currently held */
+    unsigned int _num_scans;
+
+    /** Slot the next scan is written to */
+    unsigned int _next_scan;
+
+    /** The last _depth scans (ring buffer of _max_values-sized rows) */
+    std::vector< float > _history;
+
+  };
+
+  /**
+   * \class SickShadowFilter
+   * \brief Removes veiling/mixed-pixel points on depth discontinuities
+   *
+   * A point is dropped when the segment to any of its next few neighbours
+   * is nearly parallel to the beam, i.e. the angle between the beam and the
+   * segment is below min_angle (or above 180 - min_angle).
+   */
+  class SickShadowFilter : public SickScanFilter {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param min_angle Smallest accepted beam/segment angle (deg, e.g. 10)
+     * \param num_neighbors Neighbours checked on each side
+     * \param max_values Largest scan that will be filtered
+     */
+    SickShadowFilter( const double min_angle = 10.0, const unsigned int num_neighbors = 1,
+		      const unsigned int max_values = SICK_SCAN_FILTER_MAX_VALUES ) :
+      _tan_min_angle((float)tan(min_angle*SICK_SCAN_FILTER_DEG_TO_RAD)),
+      _num_neighbors((num_neighbors == 0) ? 1 : (num_neighbors > SICK_SCAN_FILTER_MAX_WINDOW ? SICK_SCAN_FILTER_MAX_WINDOW : num_neighbors)),
+      _angle_step(0), _input(max_values) { _setAngleStep(0); }
+
+    void Apply( float * const ranges, float * const /* intensities */, const unsigned int num_values,
+		const double /* angle_start */, const double angle_step ) {
+
+      const unsigned int n = (num_values < _input.size()) ? num_values : _input.size();
+      if (n == 0) {
+	return;
+      }
+
+      /* Recompute the neighbour offsets when the resolution changes */
+      if (angle_step != _angle_step) {
+	_setAngleStep(angle_step);
+      }
+
+      memcpy(&_input[0],ranges,n*sizeof(float));
+
+      const float nan_value = _invalidValue();
+      for (unsigned int i = 0; i < n; i++) {
+
+	const float r_i = _input[i];
+	if (r_i != r_i) {
+	  continue;
+	}
+
+	for (unsigned int k = 1; k <= _num_neighbors; k++) {
+
+	  /* Each neighbour contributes the components of the segment i->j
+	   * perpendicular and parallel to beam i; the angle between them is
+	   * below min_angle iff perp < |par|*tan(min_angle).
+	   */
+	  bool shadow = false;
+	  if (i >= k && _input[i-k] == _input[i-k]) {
+	    float perp = _input[i-k]*_sin_step[k];
+	    float par = r_i - _input[i-k]*_cos_step[k];
+	    shadow = perp < fabsf(par)*_tan_min_angle;
+	  }
+	  if (!shadow && i + k < n && _input[i+k] == _input[i+k]) {
+	    float perp = _input[i+k]*_sin_step[k];
+	    float par = r_i - _input[i+k]*_cos_step[k];
+	    shadow = perp < fabsf(par)*_tan_min_angle;
+	  }
+
+	  if (shadow) {
+	    ranges[i] = nan_value;
+	    break;
+	  }
+
+	}
+
+      }
+
+    }
+
+  private:
+
+    /** tan of the smallest accepted beam/segment angle */
+    float _tan_min_angle;
+
+    /** Neighbours checked on each side */
+    unsigned int _num_neighbors;
+
+    /** The resolution the neighbour tables were built for (deg) */
+    double _angle_step;
+
+    /** |sin| of k steps */
+    float _sin_step[SICK_SCAN_FILTER_MAX_WINDOW+1];
+
+    /** cos of k steps */
+    float _cos_step[SICK_SCAN_FILTER_MAX_WINDOW+1];
+
+    /** Copy of the unfiltered ranges */
+    std::vector< float > _input;
+
+    /** Rebuilds the neighbour tables for the given resolution (deg) */
+    void _setAngleStep( const double angle_step ) {
+      _angle_step = angle_step;
+      for (unsigned int k = 0; k <= SICK_SCAN_FILTER_MAX_WINDOW; k++) {
+	_sin_step[k] = (float)fabs(sin(k*angle_step*SICK_SCAN_FILTER_DEG_TO_RAD));
+	_cos_step[k] = (float)cos(k*angle_step*SICK_SCAN_FILTER_DEG_TO_RAD);
+      }
+    }
+
+  };
+
+  /**
+   * \class SickScanFilterChain
+   * \brief Runs a fixed sequence of filter stages over each scan
+   *
+   * Stages are added once (the chain takes ownership) and then applied in
+   * order on every scan.
+   */
+  class SickScanFilterChain {
+
+  public:
+
+    /** A standard constructor */
+    SickScanFilterChain( ) { }
+
+    /** A standard destructor (deletes the stages) */
+    ~SickScanFilterChain( ) { Clear(); }
+
+    /**
+     * \brief Appends a stage (the chain takes ownership)
+     * \param *filter The stage, allocated with new
+     */
+    void AddFilter( SickScanFilter * const filter ) { _filters.push_back(filter); }
+
+    /** Deletes all stages */
+    void Clear( ) {
+      for (unsigned int i = 0; i < _filters.size(); i++) {
+	delete _filters[i];
+      }
+      _filters.clear();
+    }
+
+    /** Indicates whether the chain has no stages */
+    bool Empty( ) const { return _filters.empty(); }
+
+    /**
+     * \brief Runs every stage over the scan, in place
+     * \param *ranges The range values
+     * \param *intensities The intensity values (NULL if none)
+     * \param num_values Number of values
+     * \param angle_start Angle of the first value (deg)
+     * \param angle_step Angle between consecutive values (deg)
+     */
+    void Apply( float * const ranges, float * const intensities, const unsigned int num_values,
+		const double angle_start, const double angle_step ) {
+      for (unsigned int i = 0; i < _filters.size(); i++) {
+	_filters[i]->Apply(ranges,intensities,num_values,angle_start,angle_step);
+      }
+    }
+
+  private:
+
+    /** The stages, in application order */
+    std::vector< SickScanFilter * > _filters;
+
+    /** Chains are not copyable (they own their stages) */
+    SickScanFilterChain( const SickScanFilterChain & );
+    SickScanFilterChain & operator=( const SickScanFilterChain & );
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_SCAN_FILTER_HH */
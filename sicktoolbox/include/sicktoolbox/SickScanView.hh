@@ -0,0 +1,217 @@
+/*!
+ * \file SickScanView.hh
+ * \brief Defines a non-owning view over the compact (raw integer)
+ *        scan buffers kept by the drivers, and a lease object that
+ *        lends those buffers to the caller without copying them.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_SCAN_VIEW_HH
+#define SICK_SCAN_VIEW_HH
+
+/* Definition dependencies */
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \class SickScanView
+   * \brief A read-only window onto one sector of a scan as stored by a driver.
+   *
+   * Ranges are kept in the device's native integer resolution (RANGE_T is
+   * uint16_t or uint32_t) together with the scale that converts them into
+   * the driver's public range units.  Angles are not stored; they follow
+   * from angle_start + i*angle_step.  A view never owns its buffers, so it
+   * is only valid until the driver acquires the next scan.
+   */
+  template < class RANGE_T >
+  class SickScanView {
+
+  public:
+
+    /** A standard constructor (empty view) */
+    SickScanView( ) : range_values(NULL), echo_values(NULL), num_values(0), range_scale(1.0),
+		      angle_start(0.0), angle_step(0.0), timestamp_start(0), timestamp_stop(0) { }
+
+    /**
+     * \brief A standard constructor
+     * \param ranges Raw range buffer
+     * \param echoes Raw echo buffer (NULL if none)
+     * \param num Number of values in the buffers
+     * \param scale Multiplier converting a raw range to the driver's units
+     * \param start Angle of the first value (deg)
+     * \param step Angle between consecutive values (deg)
+     * \param ts_start Timestamp of the first value
+     * \param ts_stop Timestamp of the last value
+     */
+    SickScanView( const RANGE_T * const ranges, const uint16_t * const echoes, const unsigned int num,
+		  const double scale, const double start, const double step,
+		  const unsigned int ts_start, const unsigned int ts_stop ) :
+      range_values(ranges), echo_values(echoes), num_values(num), range_scale(scale),
+      angle_start(start), angle_step(step), timestamp_start(ts_start), timestamp_stop(ts_stop) { }
+
+    const RANGE_T *range_values;                     ///< Raw range values
+    const uint16_t *echo_values;                     ///< Raw echo/reflectivity values (NULL if not acquired)
+    unsigned int num_values;                         ///< Number of values in the sector
+    double range_scale;                              ///< Raw range * range_scale = range in the driver's units
+    double angle_start;                              ///< Angle of the first value (deg)
+    double angle_step;                               ///< Angular step between values (deg)
+    unsigned int timestamp_start;                    ///< Device timestamp of the first value
+    unsigned int timestamp_stop;                     ///< Device timestamp of the last value
+
+    /** Returns the number of values in the sector */
+    unsigned int Size( ) const { return num_values; }
+
+    /** Returns the ith range in the driver's units */
+    double Range( const unsigned int i ) const { return range_values[i]*range_scale; }
+
+    /** Returns the angle of the ith value (deg) */
+    double Angle( const unsigned int i ) const { return angle_start + i*angle_step; }
+
+    /** Returns the angle of the last value (deg) */
+    double AngleStop( ) const { return num_values > 0 ? Angle(num_values-1) : angle_start; }
+
+    /**
+     * \brief Expands the ranges into a caller buffer
+     * \param dst Destination buffer (must hold Size() values)
+     *
+     * NOTE: The scaling is done in double, so an integer T gets the
+     *       truncated range rather than a truncated scale.
+     */
+    template < class T >
+    void GetRanges( T * const dst ) const {
+      for (unsigned int i = 0; i < num_values; i++) {
+	dst[i] = (T)(range_values[i]*range_scale);
+      }
+    }
+
+    /**
+     * \brief Expands the angles into a caller buffer
+     * \param dst Destination buffer (must hold Size() values)
+     */
+    template < class T >
+    void GetAngles( T * const dst ) const {
+      for (unsigned int i = 0; i < num_values; i++) {
+	dst[i] = (T)Angle(i);
+      }
+    }
+
+    /**
+     * \brief Expands the echoes into a caller buffer (zeros if none were acquired)
+     * \param dst Destination buffer (must hold Size() values)
+     */
+    template < class T >
+    void GetEchoes( T * const dst ) const {
+      for (unsigned int i = 0; i < num_values; i++) {
+	dst[i] = echo_values ? (T)echo_values[i] : (T)0;
+      }
+    }
+
+  };
+
+  /**
+   * \class SickScanLease
+   * \brief Lends the caller read-only views of a driver's latest scan buffer.
+   *
+   * While a lease is held the driver refuses to acquire a new scan into
+   * the leased buffer (it throws instead of overwriting data the caller
+   * is still reading).  The lease is returned by calling Release(), by
+   * passing the same lease to the next acquisition, or by destroying it.
+   * A lease must not outlive the driver that granted it.
+   */
+  template < class RANGE_T >
+  class SickScanLease {
+
+  public:
+
+    /** A standard constructor (holds nothing) */
+    SickScanLease( ) : _lease_flag(NULL) { }
+
+    /** A standard destructor (returns the lease) */
+    ~SickScanLease( ) { Release(); }
+
+    /** Indicates whether the lease currently holds a driver buffer */
+    bool IsHeld( ) const { return _lease_flag != NULL; }
+
+    /** Returns the buffer to the driver and drops the views */
+    void Release( ) {
+
+      if (_lease_flag) {
+	*_lease_flag = false;
+	_lease_flag = NULL;
+      }
+
+      _sectors.clear();
+      _sector_ids.clear();
+    }
+
+    /** Returns the number of sectors in the leased scan */
+    unsigned int GetNumSectors( ) const { return _sectors.size(); }
+
+    /** Returns the view of the ith sector */
+    const SickScanView< RANGE_T > & GetSector( const unsigned int i ) const { return _sectors[i]; }
+
+    /** Returns the device's id for the ith sector */
+    unsigned int GetSectorID( const unsigned int i ) const { return _sector_ids[i]; }
+
+    /** Returns the total number of values across all sectors */
+    unsigned int GetNumValues( ) const {
+
+      unsigned int num_values = 0;
+      for (unsigned int i = 0; i < _sectors.size(); i++) {
+	num_values += _sectors[i].Size();
+      }
+
+      return num_values;
+    }
+
+    /**
+     * \brief Takes the lease on a driver buffer (driver use only)
+     * \param lease_flag The driver's flag marking its buffer as leased
+     */
+    void Grant( bool * const lease_flag ) {
+      Release();
+      _lease_flag = lease_flag;
+      *_lease_flag = true;
+    }
+
+    /**
+     * \brief Appends a sector view to the lease (driver use only)
+     * \param sector_view View of the sector's data
+     * \param sector_id The device's id for the sector
+     */
+    void AddSector( const SickScanView< RANGE_T > &sector_view, const unsigned int sector_id = 0 ) {
+      _sectors.push_back(sector_view);
+      _sector_ids.push_back(sector_id);
+    }
+
+  private:
+
+    /** Points at the granting driver's lease flag (NULL if nothing is held) */
+    bool *_lease_flag;
+
+    /** Views of the leased sectors (capacity is kept across leases) */
+    std::vector< SickScanView< RANGE_T > > _sectors;
+
+    /** The device's ids for the leased sectors */
+    std::vector< unsigned int > _sector_ids;
+
+    /** Leases are not copyable (a copy would release the buffer twice) */
+    SickScanLease( const SickScanLease & );
+    SickScanLease & operator=( const SickScanLease & );
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_SCAN_VIEW_HH */
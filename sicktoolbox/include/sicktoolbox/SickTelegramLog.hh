@@ -0,0 +1,882 @@
+/*!
+ * \file SickTelegramLog.hh
+ * \brief Defines a binary telegram log along with a recorder, an
+ *        mmap-based reader and a replay back end for the drivers.
+ *
+ * Written for the sicknav350 fork of the Sick LIDAR Matlab/C++ Toolbox.
+ *
+ * Copyright (c) 2026, the sicknav350 contributors
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_TELEGRAM_LOG_HH
+#define SICK_TELEGRAM_LOG_HH
+
+/* Macros */
+#define SICK_TELEGRAM_LOG_MAGIC                           "SICKTLG1"  ///< First 8 bytes of every log
+#define SICK_TELEGRAM_LOG_VERSION                                (1)  ///< Bump whenever the record layout changes
+#define SICK_TELEGRAM_INDEX_SUFFIX                            ".idx"  ///< Suffix of the time index file
+#define SICK_TELEGRAM_INDEX_INTERVAL_USEC                   (100000)  ///< Minimum time between index entries (usec)
+#define SICK_TELEGRAM_RECORD_ALIGNMENT                           (8)  ///< Records start on 8-byte boundaries
+#define SICK_TELEGRAM_REPLAY_REQUEST_TIMEOUT_USEC          (5000000)  ///< Longest wait for a recorded request before moving on
+#define SICK_TELEGRAM_REPLAY_POLL_USEC                      (100000)  ///< Granularity at which the replay thread checks for Stop()
+
+/* Definition dependencies */
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <termios.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "SickException.hh"
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \enum sick_telegram_direction_t
+   * \brief Identifies which side sent a recorded telegram
+   */
+  enum sick_telegram_direction_t {
+    SICK_TELEGRAM_FROM_DEVICE = 0x00,                          ///< Received from the device (replayed)
+    SICK_TELEGRAM_TO_DEVICE = 0x01                             ///< Sent by the driver (used to pace replies)
+  };
+
+  /**
+   * \struct sick_telegram_log_header_tag
+   * \brief The header at offset 0 of a telegram log
+   */
+  /**
+   * \typedef sick_telegram_log_header_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_telegram_log_header_tag {
+    char magic[8];                                             ///< SICK_TELEGRAM_LOG_MAGIC
+    uint32_t version;                                          ///< SICK_TELEGRAM_LOG_VERSION
+    uint32_t header_length;                                    ///< sizeof(sick_telegram_log_header_t)
+  } sick_telegram_log_header_t;
+
+  /**
+   * \struct sick_telegram_record_header_tag
+   * \brief Precedes every telegram in the log. The telegram is padded
+   *        so that the next record header is 8-byte aligned.
+   */
+  /**
+   * \typedef sick_telegram_record_header_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_telegram_record_header_tag {
+    uint64_t timestamp_usec;                                   ///< Receive (or send) time since the epoch (usec)
+    uint32_t length;                                           ///< Telegram length (bytes, excluding padding)
+    uint8_t direction;                                         ///< A sick_telegram_direction_t
+    uint8_t reserved[3];                                       ///< Zero
+  } sick_telegram_record_header_t;
+
+  /**
+   * \struct sick_telegram_index_entry_tag
+   * \brief One entry of the time index (<log>.idx)
+   */
+  /**
+   * \typedef sick_telegram_index_entry_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_telegram_index_entry_tag {
+    uint64_t timestamp_usec;                                   ///< Timestamp of the record at offset
+    uint64_t offset;                                           ///< Byte offset of the record header in the log
+  } sick_telegram_index_entry_t;
+
+  /**
+   * \struct sick_telegram_tag
+   * \brief A telegram read back from a log (points into the mapping)
+   */
+  /**
+   * \typedef sick_telegram_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_telegram_tag {
+    uint64_t timestamp_usec;                                   ///< Receive (or send) time since the epoch (usec)
+    uint8_t direction;                                         ///< A sick_telegram_direction_t
+    uint32_t length;                                           ///< Telegram length (bytes)
+    const uint8_t *data;                                       ///< The raw telegram (valid while the log is open)
+  } sick_telegram_t;
+
+  /** Returns the current time since the epoch (usec) */
+  inline uint64_t sick_telegram_time_usec( ) {
+    struct timeval now;
+    gettimeofday(&now,NULL);
+    return (uint64_t)now.tv_sec*1000000 + now.tv_usec;
+  }
+
+  /** Returns the padded size of a record holding a telegram of the given length */
+  inline uint64_t sick_telegram_record_size( const uint32_t length ) {
+    return sizeof(sick_telegram_record_header_t) +
+      ((length + SICK_TELEGRAM_RECORD_ALIGNMENT - 1)/SICK_TELEGRAM_RECORD_ALIGNMENT)*SICK_TELEGRAM_RECORD_ALIGNMENT;
+  }
+
+  /**
+   * \class SickTelegramRecorder
+   * \brief Appends raw telegrams to a log (and its time index)
+   *
+   * Attach a recorder to any driver w/ SetTelegramRecorder(); the buffer
+   * monitor then records every telegram it assembles and the driver records
+   * every telegram it sends.  Each record is written with a single writev()
+   * to a file opened O_APPEND, so a log may be read while it is recorded.
+   */
+  class SickTelegramRecorder {
+
+  public:
+
+    /** A standard constructor */
+    SickTelegramRecorder( ) throw( SickThreadException ) : _log_fd(-1), _index_fd(-1), _log_offset(0), _last_index_usec(0), _num_records(0) {
+      if (pthread_mutex_init(&_record_mutex,NULL) != 0) {
+	throw SickThreadException("SickTelegramRecorder::SickTelegramRecorder: pthread_mutex_init() failed!");
+      }
+    }
+
+    /** A standard destructor */
+    ~SickTelegramRecorder( ) {
+      Close();
+      pthread_mutex_destroy(&_record_mutex);
+    }
+
+    /**
+     * \brief Opens (creating or appending to) a log
+     * \param log_path Path of the log (the index is written to log_path + ".idx")
+     */
+    void Open( const std::string &log_path ) throw( SickIOException ) {
+
+      Close();
+
+      if ((_log_fd = open(log_path.c_str(),O_WRONLY | O_CREAT | O_APPEND,0644)) < 0) {
+	throw SickIOException("SickTelegramRecorder::Open: Unable to open " + log_path);
+      }
+
+      struct stat log_stat;
+      if (fstat(_log_fd,&log_stat) != 0) {
+	Close();
+	throw SickIOException("SickTelegramRecorder::Open: fstat() failed!");
+      }
+
+      /* Write the header to a new log */
+      _log_offset = log_stat.st_size;
+      if (_log_offset == 0) {
+
+	sick_telegram_log_header_t log_header;
+	memset(&log_header,0,sizeof(sick_telegram_log_header_t));
+	memcpy(log_header.magic,SICK_TELEGRAM_LOG_MAGIC,sizeof(log_header.magic));
+	log_header.version = SICK_TELEGRAM_LOG_VERSION;
+	log_header.header_length = sizeof(sick_telegram_log_header_t);
+
+	if (write(_log_fd,&log_header,sizeof(sick_telegram_log_header_t)) != (ssize_t)sizeof(sick_telegram_log_header_t)) {
+	  Close();
+	  throw SickIOException("SickTelegramRecorder::Open: write() failed!");
+	}
+
+	_log_offset = sizeof(sick_telegram_log_header_t);
+      }
+
+      if ((_index_fd = open((log_path + SICK_TELEGRAM_INDEX_SUFFIX).c_str(),O_WRONLY | O_CREAT | O_APPEND,0644)) < 0) {
+	Close();
+	throw SickIOException("SickTelegramRecorder::Open: Unable to open " + log_path + SICK_TELEGRAM_INDEX_SUFFIX);
+      }
+
+      _last_index_usec = 0;
+    }
+
+    /** Closes the log */
+    void Close( ) {
+
+      pthread_mutex_lock(&_record_mutex);
+
+      if (_log_fd >= 0) {
+	close(_log_fd);
+	_log_fd = -1;
+      }
+
+      if (_index_fd >= 0) {
+	close(_index_fd);
+	_index_fd = -1;
+      }
+
+      pthread_mutex_unlock(&_record_mutex);
+    }
+
+    /** Indicates whether a log is open */
+    bool IsOpen( ) const { return _log_fd >= 0; }
+
+    /** Returns the number of records written since construction */
+    unsigned long GetNumRecords( ) const { return _num_records; }
+
+    /**
+     * \brief Appends a raw telegram
+     * \param *telegram The raw telegram bytes
+     * \param length Number of bytes
+     * \param direction A sick_telegram_direction_t
+     *
+     * NOTE: Errors are reported on stderr but never thrown, since this is
+     *       called from the buffer monitor thread.
+     */
+    void Record( const uint8_t * const telegram, const uint32_t length, const uint8_t direction ) {
+
+      const uint64_t timestamp_usec = sick_telegram_time_usec();
+
+      static const uint8_t padding[SICK_TELEGRAM_RECORD_ALIGNMENT] = {0};
+
+      sick_telegram_record_header_t record_header;
+      memset(&record_header,0,sizeof(sick_telegram_record_header_t));
+      record_header.timestamp_usec = timestamp_usec;
+      record_header.length = length;
+      record_header.direction = direction;
+
+      const uint64_t record_size = sick_telegram_record_size(length);
+
+      struct iovec record_iov[3];
+      record_iov[0].iov_base = &record_header;
+      record_iov[0].iov_len = sizeof(sick_telegram_record_header_t);
+      record_iov[1].iov_base = const_cast< uint8_t * >(telegram);
+      record_iov[1].iov_len = length;
+      record_iov[2].iov_base = const_cast< uint8_t * >(padding);
+      record_iov[2].iov_len = record_size - sizeof(sick_telegram_record_header_t) - length;
+
+      pthread_mutex_lock(&_record_mutex);
+
+      if (_log_fd >= 0) {
+
+	if ((uint64_t)writev(_log_fd,record_iov,3) != record_size) {
+	  std::cerr << "SickTelegramRecorder::Record: writev() failed!" << std::endl;
+	}
+	else {
+
+	  /* Add an index entry every so often */
+	  if (timestamp_usec >= _last_index_usec + SICK_TELEGRAM_INDEX_INTERVAL_USEC) {
+
+	    sick_telegram_index_entry_t index_entry;
+	    index_entry.timestamp_usec = timestamp_usec;
+	    index_entry.offset = _log_offset;
+	    if (write(_index_fd,&index_entry,sizeof(sick_telegram_index_entry_t)) != (ssize_t)sizeof(sick_telegram_index_entry_t)) {
+	      std::cerr << "SickTelegramRecorder::Record: write() failed!" << std::endl;
+	    }
+
+	    _last_index_usec = timestamp_usec;
+	  }
+
+	  _log_offset += record_size;
+	  _num_records++;
+	}
+
+      }
+
+      pthread_mutex_unlock(&_record_mutex);
+    }
+
+    /**
+     * \brief Appends a driver message
+     * \param &sick_message The message
+     * \param direction A sick_telegram_direction_t
+     */
+    template < class SICK_MSG_CLASS >
+    void Record( const SICK_MSG_CLASS &sick_message, const uint8_t direction ) {
+      uint8_t message_buffer[SICK_MSG_CLASS::MESSAGE_MAX_LENGTH];
+      sick_message.GetMessage(message_buffer);
+      Record(message_buffer,sick_message.GetMessageLength(),direction);
+    }
+
+  private:
+
+    /** The log file descriptor */
+    int _log_fd;
+
+    /** The index file descriptor */
+    int _index_fd;
+
+    /** Offset at which the next record will land */
+    uint64_t _log_offset;
+
+    /** Timestamp of the last index entry */
+    uint64_t _last_index_usec;
+
+    /** Number of records written */
+    unsigned long _num_records;
+
+    /** Serializes the monitor thread (receive) and the driver (send) */
+    pthread_mutex_t _record_mutex;
+
+    /** Recorders are not copyable */
+    SickTelegramRecorder( const SickTelegramRecorder & );
+    SickTelegramRecorder & operator=( const SickTelegramRecorder & );
+
+  };
+
+  /**
+   * \class SickTelegramLog
+   * \brief Reads a telegram log through a read-only mapping
+   *
+   * Telegrams are returned as pointers into the mapping (no copies).  The
+   * time index is loaded from <log>.idx when present and rebuilt by
+   * scanning the log otherwise.  A truncated final record (e.g. a log that
+   * is still being written) is treated as the end of the log.
+   */
+  class SickTelegramLog {
+
+  public:
+
+    /** A standard constructor */
+    SickTelegramLog( ) : _log_data(NULL), _log_size(0), _read_offset(0) { }
+
+    /** A standard destructor */
+    ~SickTelegramLog( ) { Close(); }
+
+    /**
+     * \brief Maps a log and loads its index
+     * \param log_path Path of the log
+     */
+    void Open( const std::string &log_path ) throw( SickIOException ) {
+
+      Close();
+
+      int log_fd = open(log_path.c_str(),O_RDONLY);
+      if (log_fd < 0) {
+	throw SickIOException("SickTelegramLog::Open: Unable to open " + log_path);
+      }
+
+      struct stat log_stat;
+      if (fstat(log_fd,&log_stat) != 0 || log_stat.st_size < (off_t)sizeof(sick_telegram_log_header_t)) {
+	close(log_fd);
+	throw SickIOException("SickTelegramLog::Open: Not a telegram log - " + log_path);
+      }
+
+      _log_size = log_stat.st_size;
+      void *log_data = mmap(NULL,_log_size,PROT_READ,MAP_SHARED,log_fd,0);
+      close(log_fd);
+
+      if (log_data == MAP_FAILED) {
+	_log_size = 0;
+	throw SickIOException("SickTelegramLog::Open: mmap() failed!");
+      }
+
+      _log_data = (const uint8_t *)log_data;
+
+      /* Check the header */
+      const sick_telegram_log_header_t *log_header = (const sick_telegram_log_header_t *)_log_data;
+      if (memcmp(log_header->magic,SICK_TELEGRAM_LOG_MAGIC,sizeof(log_header->magic)) != 0 ||
+	  log_header->version != SICK_TELEGRAM_LOG_VERSION) {
+	Close();
+	throw SickIOException("SickTelegramLog::Open: Unsupported telegram log - " + log_path);
+      }
+
+      _loadIndex(log_path + SICK_TELEGRAM_INDEX_SUFFIX);
+      Rewind();
+    }
+
+    /** Unmaps the log */
+    void Close( ) {
+
+      if (_log_data) {
+	munmap(const_cast< uint8_t * >(_log_data),_log_size);
+	_log_data = NULL;
+      }
+
+      _log_size = _read_offset = 0;
+      _index.clear();
+    }
+
+    /** Indicates whether a log is open */
+    bool IsOpen( ) const { return _log_data != NULL; }
+
+    /** Moves back to the first record */
+    void Rewind( ) { _read_offset = sizeof(sick_telegram_log_header_t); }
+
+    /**
+     * \brief Moves to the first record stamped at or after the given time
+     * \param timestamp_usec The target time since the epoch (usec)
+     */
+    void Seek( const uint64_t timestamp_usec ) {
+
+      Rewind();
+
+      /* Binary search the index for the last entry at or before the target */
+      unsigned int low = 0, high = _index.size();
+      while (low < high) {
+	unsigned int mid = (low + high)/2;
+	if (_index[mid].timestamp_usec <= timestamp_usec) {
+	  low = mid + 1;
+	}
+	else {
+	  high = mid;
+	}
+      }
+
+      if (low > 0 && _index[low-1].offset < _log_size) {
+	_read_offset = _index[low-1].offset;
+      }
+
+      /* Scan forward to the first record at or after the target */
+      uint64_t record_offset = _read_offset;
+      sick_telegram_t telegram;
+      while (Next(telegram) && telegram.timestamp_usec < timestamp_usec) {
+	record_offset = _read_offset;
+      }
+      _read_offset = record_offset;
+    }
+
+    /**
+     * \brief Reads the next record
+     * \param &telegram Receives the record (data points into the mapping)
+     * \return False at the end of the log
+     */
+    bool Next( sick_telegram_t &telegram ) {
+
+      if (_read_offset + sizeof(sick_telegram_record_header_t) > _log_size) {
+	return false;
+      }
+
+      const sick_telegram_record_header_t *record_header = (const sick_telegram_record_header_t *)&_log_data[_read_offset];
+      const uint64_t record_size = sick_telegram_record_size(record_header->length);
+      if (_read_offset + record_size > _log_size) {
+	return false;
+      }
+
+      telegram.timestamp_usec = record_header->timestamp_usec;
+      telegram.direction = record_header->direction;
+      telegram.length = record_header->length;
+      telegram.data = &_log_data[_read_offset + sizeof(sick_telegram_record_header_t)];
+
+      _read_offset += record_size;
+      return true;
+    }
+
+  private:
+
+    /** The mapped log */
+    const uint8_t *_log_data;
+
+    /** Size of the mapping */
+    uint64_t _log_size;
+
+    /** Offset of the next record */
+    uint64_t _read_offset;
+
+    /** The time index */
+    std::vector< sick_telegram_index_entry_t > _index;
+
+    /** Loads the index file, or rebuilds the index if it is missing */
+    void _loadIndex( const std::string &index_path ) {
+
+      _index.clear();
+
+      FILE *index_file = fopen(index_path.c_str(),"rb");
+      if (index_file) {
+
+	sick_telegram_index_entry_t index_entry;
+	while (fread(&index_entry,sizeof(sick_telegram_index_entry_t),1,index_file) == 1) {
+	  _index.push_back(index_entry);
+	}
+
+	fclose(index_file);
+	return;
+      }
+
+      /* No index, so build one in memory */
+      Rewind();
+      uint64_t record_offset = _read_offset, last_index_usec = 0;
+      sick_telegram_t telegram;
+      while (Next(telegram)) {
+
+	if (_index.empty() || telegram.timestamp_usec >= last_index_usec + SICK_TELEGRAM_INDEX_INTERVAL_USEC) {
+	  sick_telegram_index_entry_t index_entry;
+	  index_entry.timestamp_usec = telegram.timestamp_usec;
+	  index_entry.offset = record_offset;
+	  _index.push_back(index_entry);
+	  last_index_usec = telegram.timestamp_usec;
+	}
+
+	record_offset = _read_offset;
+      }
+
+    }
+
+    /** Logs are not copyable (they own the mapping) */
+    SickTelegramLog( const SickTelegramLog & );
+    SickTelegramLog & operator=( const SickTelegramLog & );
+
+  };
+
+  /**
+   * \class SickTelegramReplay
+   * \brief Serves a recorded log to an unmodified driver
+   *
+   * The replay either listens on a loopback TCP port (point SickNav350,
+   * SickLD or SickLMS1xx at 127.0.0.1:<port>) or opens a pseudo-terminal
+   * (construct SickLMS2xx w/ the returned device path).  Device telegrams
+   * are written in order; each recorded driver telegram makes the replay
+   * wait until the driver sends something, so request/reply exchanges stay
+   * in step provided the driver is configured as it was when recording.
+   *
+   * Between requests, device telegrams are paced by their recorded
+   * timestamps divided by the speed factor (1.0 = real time, 0 = as fast
+   * as possible).
+   */
+  class SickTelegramReplay {
+
+  public:
+
+    /**
+     * \brief A standard constructor
+     * \param log_path Path of the log to replay
+     * \param speed Playback speed factor (1.0 = real time, 0 = as fast as possible)
+     */
+    SickTelegramReplay( const std::string &log_path, const double speed = 1.0 ) throw( SickIOException ) :
+      _speed(speed), _listen_fd(-1), _stream_fd(-1), _continue_replay(false), _replay_finished(false), _replay_running(false) {
+      _log.Open(log_path);
+    }
+
+    /** A standard destructor */
+    ~SickTelegramReplay( ) {
+
+      Stop();
+
+      if (_stream_fd >= 0) {
+	close(_stream_fd);
+      }
+
+      if (_listen_fd >= 0) {
+	close(_listen_fd);
+      }
+
+    }
+
+    /**
+     * \brief Listens on a loopback TCP port for the driver
+     * \param port The port to listen on (0 picks a free port)
+     * \return The port being listened on
+     */
+    uint16_t ListenTCP( const uint16_t port = 0 ) throw( SickIOException ) {
+
+      if ((_listen_fd = socket(AF_INET,SOCK_STREAM,0)) < 0) {
+	throw SickIOException("SickTelegramReplay::ListenTCP: socket() failed!");
+      }
+
+      int reuse_addr = 1;
+      setsockopt(_listen_fd,SOL_SOCKET,SO_REUSEADDR,&reuse_addr,sizeof(reuse_addr));
+
+      struct sockaddr_in listen_addr;
+      memset(&listen_addr,0,sizeof(listen_addr));
+      listen_addr.sin_family = AF_INET;
+      listen_addr.sin_port = htons(port);
+      listen_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+      if (bind(_listen_fd,(struct sockaddr *)&listen_addr,sizeof(listen_addr)) != 0 || listen(_listen_fd,1) != 0) {
+	throw SickIOException("SickTelegramReplay::ListenTCP: Unable to listen on the requested port!");
+      }
+
+      socklen_t addr_length = sizeof(listen_addr);
+      if (getsockname(_listen_fd,(struct sockaddr *)&listen_addr,&addr_length) != 0) {
+	throw SickIOException("SickTelegramReplay::ListenTCP: getsockname() failed!");
+      }
+
+      return ntohs(listen_addr.sin_port);
+    }
+
+    /**
+     * \brief Opens a pseudo-terminal for a serial driver
+     * \return The device path the driver should open
+     */
+    std::string OpenPTY( ) throw( SickIOException ) {
+
+      if ((_stream_fd = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(_stream_fd) != 0 || unlockpt(_stream_fd) != 0) {
+	throw SickIOException("SickTelegramReplay::OpenPTY: Unable to open a pseudo-terminal!");
+      }
+
+      /* Pass the bytes through untouched */
+      struct termios pty_term;
+      if (tcgetattr(_stream_fd,&pty_term) == 0) {
+	cfmakeraw(&pty_term);
+	tcsetattr(_stream_fd,TCSANOW,&pty_term);
+      }
+
+      return ptsname(_stream_fd);
+    }
+
+    /** Starts replaying (returns immediately) */
+    void Start( ) throw( SickThreadException ) {
+
+      _continue_replay = true;
+      _replay_finished = false;
+
+      if (pthread_create(&_replay_thread_id,NULL,SickTelegramReplay::_replayThread,this) != 0) {
+	throw SickThreadException("SickTelegramReplay::Start: pthread_create() failed!");
+      }
+
+      _replay_running = true;
+    }
+
+    /** Stops replaying and waits for the replay thread */
+    void Stop( ) {
+
+      if (_replay_running) {
+	_continue_replay = false;
+	pthread_join(_replay_thread_id,NULL);
+	_replay_running = false;
+      }
+
+    }
+
+    /** Indicates whether every recorded telegram has been served */
+    bool IsFinished( ) const { return _replay_finished; }
+
+  private:
+
+    /** The log being replayed */
+    SickTelegramLog _log;
+
+    /** Playback speed factor (0 = as fast as possible) */
+    double _speed;
+
+    /** The listening socket (TCP mode) */
+    int _listen_fd;
+
+    /** The connection to the driver (TCP connection or PTY master) */
+    int _stream_fd;
+
+    /** Cleared by Stop() */
+    volatile bool _continue_replay;
+
+    /** Set once the log is exhausted */
+    volatile bool _replay_finished;
+
+    /** Indicates whether the replay thread exists */
+    bool _replay_running;
+
+    /** The replay thread */
+    pthread_t _replay_thread_id;
+
+    /** Bytes the driver has sent that no recorded request has taken yet */
+    std::vector< uint8_t > _request_bytes;
+
+    /**
+     * \brief Waits until the fd is readable, polling for Stop()
+     * \param timeout_usec Longest wait (usec)
+     * \return True if the fd became readable
+     */
+    bool _waitReadable( const int fd, const uint64_t timeout_usec ) const {
+
+      const uint64_t deadline_usec = sick_telegram_time_usec() + timeout_usec;
+      while (_continue_replay && sick_telegram_time_usec() < deadline_usec) {
+
+	struct pollfd poll_fd;
+	poll_fd.fd = fd;
+	poll_fd.events = POLLIN;
+	poll_fd.revents = 0;
+
+	int num_ready = poll(&poll_fd,1,SICK_TELEGRAM_REPLAY_POLL_USEC/1000);
+	if (num_ready > 0) {
+	  return true;
+	}
+	if (num_ready < 0 && errno != EINTR) {
+	  return false;
+	}
+
+      }
+
+      return false;
+    }
+
+    /**
+     * \brief Returns the length of the request at the front of a buffer
+     * \param buffer The bytes the driver has sent
+     * \param num_bytes Number of bytes in the buffer
+     * \param cola Whether the device speaks CoLa-A (STX ... ETX)
+     * \return The length of the request (0 if it is not complete yet)
+     *
+     * NOTE: The buffer must start w/ an STX.  Besides CoLa-A this frames
+     *       the binary requests of the LD (four STX, 32-bit length, payload
+     *       and checksum) and the LMS 2xx (STX, address, 16-bit length,
+     *       payload and CRC).
+     */
+    static uint32_t _requestLength( const uint8_t * const buffer, const uint32_t num_bytes, const bool cola ) {
+
+      if (cola) {
+	const uint8_t * const etx = (const uint8_t *)memchr(buffer,0x03,num_bytes);
+	return etx ? etx - buffer + 1 : 0;
+      }
+
+      /* LD */
+      if (num_bytes >= 4 && buffer[1] == 0x02 && buffer[2] == 0x02 && buffer[3] == 0x02) {
+	if (num_bytes < 8) {
+	  return 0;
+	}
+	const uint32_t length = 8 + ((buffer[4] << 24) | (buffer[5] << 16) | (buffer[6] << 8) | buffer[7]) + 1;
+	return num_bytes >= length ? length : 0;
+      }
+
+      /* LMS 2xx */
+      if (num_bytes < 4) {
+	return 0;
+      }
+      const uint32_t length = 4 + (buffer[2] | (buffer[3] << 8)) + 2;
+      return num_bytes >= length ? length : 0;
+    }
+
+    /**
+     * \brief Takes one request from the driver (the one a recorded request stands for)
+     * \param recorded The recorded request (tells which framing the device uses)
+     * \return True if a whole request was taken before the timeout
+     *
+     * Requests the driver sends back to back stay buffered for the next
+     * recorded ones.
+     */
+    bool _takeRequest( const sick_telegram_t &recorded ) {
+
+      /* CoLa-A requests are printable between the STX and the ETX */
+      bool cola = recorded.length >= 2 && recorded.data[recorded.length-1] == 0x03;
+      for (uint32_t i = 1; cola && i < recorded.length-1; i++) {
+	cola = recorded.data[i] >= 0x20 && recorded.data[i] < 0x7F;
+      }
+
+      const uint64_t deadline_usec = sick_telegram_time_usec() + SICK_TELEGRAM_REPLAY_REQUEST_TIMEOUT_USEC;
+      for (;;) {
+
+	/* Skip anything in front of the next STX */
+	std::vector< uint8_t >::iterator stx = std::find(_request_bytes.begin(),_request_bytes.end(),(uint8_t)0x02);
+	_request_bytes.erase(_request_bytes.begin(),stx);
+
+	const uint32_t length = _request_bytes.empty() ? 0 : _requestLength(&_request_bytes[0],_request_bytes.size(),cola);
+	if (length > 0) {
+	  _request_bytes.erase(_request_bytes.begin(),_request_bytes.begin()+length);
+	  return true;
+	}
+
+	/* Wait for (the rest of) it */
+	const uint64_t now_usec = sick_telegram_time_usec();
+	if (now_usec >= deadline_usec || !_waitReadable(_stream_fd,deadline_usec - now_usec)) {
+	  return false;
+	}
+
+	uint8_t request_buffer[4096];
+	ssize_t num_bytes = read(_stream_fd,request_buffer,sizeof(request_buffer));
+	if (num_bytes < 0 && errno == EINTR) {
+	  continue;
+	}
+	if (num_bytes <= 0) {
+	  return false;
+	}
+	_request_bytes.insert(_request_bytes.end(),request_buffer,request_buffer+num_bytes);
+
+      }
+    }
+
+    /** Writes a whole telegram */
+    bool _writeTelegram( const sick_telegram_t &telegram ) const {
+
+      uint32_t num_bytes_written = 0;
+      while (num_bytes_written < telegram.length) {
+
+	ssize_t num_bytes = write(_stream_fd,&telegram.data[num_bytes_written],telegram.length - num_bytes_written);
+	if (num_bytes < 0 && errno == EINTR) {
+	  continue;
+	}
+	if (num_bytes <= 0) {
+	  return false;
+	}
+
+	num_bytes_written += num_bytes;
+      }
+
+      return true;
+    }
+
+    /** The replay thread */
+    static void * _replayThread( void * thread_args ) {
+
+      SickTelegramReplay *replay = (SickTelegramReplay *)thread_args;
+
+      /* Wait for the driver to connect (TCP mode) */
+      if (replay->_stream_fd < 0) {
+
+	while (replay->_continue_replay && !replay->_waitReadable(replay->_listen_fd,SICK_TELEGRAM_REPLAY_POLL_USEC)) { }
+	if (!replay->_continue_replay || (replay->_stream_fd = accept(replay->_listen_fd,NULL,NULL)) < 0) {
+	  return NULL;
+	}
+
+	/* Send each telegram as soon as it is due */
+	int no_delay = 1;
+	setsockopt(replay->_stream_fd,IPPROTO_TCP,TCP_NODELAY,&no_delay,sizeof(no_delay));
+
+      }
+
+      /* The replay clock: record time base_log_usec plays at wall time base_wall_usec */
+      uint64_t base_log_usec = 0, base_wall_usec = 0;
+      bool clock_started = false;
+
+      sick_telegram_t telegram;
+      while (replay->_continue_replay && replay->_log.Next(telegram)) {
+
+	if (telegram.direction == SICK_TELEGRAM_TO_DEVICE) {
+
+	  /* Wait for the driver's request and restart the clock from here */
+	  replay->_takeRequest(telegram);
+
+	  base_log_usec = telegram.timestamp_usec;
+	  base_wall_usec = sick_telegram_time_usec();
+	  clock_started = true;
+	  continue;
+	}
+
+	if (!clock_started) {
+	  base_log_usec = telegram.timestamp_usec;
+	  base_wall_usec = sick_telegram_time_usec();
+	  clock_started = true;
+	}
+
+	/* Pace the telegram */
+	if (replay->_speed > 0 && telegram.timestamp_usec > base_log_usec) {
+
+	  const uint64_t due_usec = base_wall_usec + (uint64_t)((telegram.timestamp_usec - base_log_usec)/replay->_speed);
+	  uint64_t now_usec = 0;
+	  while (replay->_continue_replay && (now_usec = sick_telegram_time_usec()) < due_usec) {
+	    uint64_t wait_usec = due_usec - now_usec;
+	    usleep(wait_usec < SICK_TELEGRAM_REPLAY_POLL_USEC ? wait_usec : SICK_TELEGRAM_REPLAY_POLL_USEC);
+	  }
+
+	}
+
+	if (!replay->_writeTelegram(telegram)) {
+	  std::cerr << "SickTelegramReplay::_replayThread: write() failed!" << std::endl;
+	  break;
+	}
+
+      }
+
+      replay->_replay_finished = true;
+      return NULL;
+    }
+
+    /** Replays are not copyable */
+    SickTelegramReplay( const SickTelegramReplay & );
+    SickTelegramReplay & operator=( const SickTelegramReplay & );
+
+  };
+
+} //namespace SickToolbox
+
+#endif /* SICK_TELEGRAM_LOG_HH */